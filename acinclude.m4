@@ -107,6 +107,11 @@ dnl     some particular tests) via a new configure option.
 dnl gettimeofday is not defined for MinGW
 AC_CHECK_FUNCS([memmove memset setlocale strtol gettimeofday signal])
 
+dnl mmap is used by mpfr_import_cache if available (otherwise the file
+dnl is read into memory)
+AC_CHECK_HEADERS([sys/mman.h])
+AC_CHECK_FUNCS([mmap])
+
 dnl We cannot use AC_CHECK_FUNCS on sigaction, because while this
 dnl function may be provided by the C library, its prototype and
 dnl associated structure may not be available, e.g. when compiling
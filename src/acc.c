@@ -0,0 +1,420 @@
+/* mpfr_acc_* -- exact accumulator for sums of floating-point numbers
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* An accumulator holds the exact sum of the regular numbers added so far,
+   as a sparse superaccumulator, and in _mpfr_state, the kinds of the
+   special numbers added so far (which determine the result if there is a
+   NaN or an infinity, and the sign of an exact zero result).
+
+   The bits are grouped into chunks of ACC_N limbs, the chunk of index c
+   corresponding to the bits of weight 2^(c*ACC_BITS) to
+   2^((c+1)*ACC_BITS-1). Only the chunks touched by the added numbers are
+   stored, sorted by increasing indices in _mpfr_idx; the chunk at position
+   i is stored in ACC_N+1 limbs from _mpfr_d + i*(ACC_N+1): the ACC_N limbs
+   of an unsigned integer D (least significant limb first), followed by a
+   carry limb C, which is a signed integer in two's complement, and the
+   value of the chunk is (D + C * 2^ACC_BITS) * 2^(c*ACC_BITS). Thus a gap
+   between the exponents of the added numbers takes no memory (1 + 2^(-N)
+   needs two chunks), and the memory is bounded by the exponents and the
+   precisions of the added numbers, not by their number.
+
+   A number is added to the D parts of the chunks it overlaps, and the
+   carry or borrow out of each chunk goes to its own C (carry-save), so that
+   adding a number of precision p costs O(p/GMP_NUMB_BITS) (plus a binary
+   search, and the insertion of the new chunks, if any), whatever the signs
+   of the numbers: there is no carry propagation through the accumulator.
+   When |C| reaches ACC_CARRY_MAX, which needs at least ACC_CARRY_MAX
+   additions or merges, it is moved to the next chunk.
+
+   The final rounding is done by mpfr_sum_wide on the non-zero chunks,
+   like in mpfr_sum (same rounding of the exact sum, with MPFR_RNDF
+   treated as MPFR_RNDZ), so that the result is the same as the one of
+   mpfr_sum on all the added numbers. */
+
+#define ACC_NAN       1
+#define ACC_POS_INF   2
+#define ACC_NEG_INF   4
+#define ACC_POS_ZERO  8
+#define ACC_NEG_ZERO 16
+#define ACC_REGULAR  32
+
+#define ACC_N 4
+#define ACC_BITS (ACC_N * GMP_NUMB_BITS)
+#define ACC_CARRY_MAX (MPFR_LIMB_HIGHBIT >> 1)
+
+/* limbs of the chunk at position i */
+#define ACC_CHUNK(a,i) ((a)->_mpfr_d + (i) * (ACC_N + 1))
+
+/* absolute value of the carry limb l */
+#define ACC_CARRY_ABS(l) (MPFR_LIMB_MSB (l) != 0 ? - (l) : (l))
+
+void
+mpfr_acc_init (mpfr_acc_ptr a)
+{
+  a->_mpfr_size = 0;
+  a->_mpfr_alloc = 0;
+  a->_mpfr_idx = NULL;
+  a->_mpfr_d = NULL;
+  a->_mpfr_state = 0;
+}
+
+void
+mpfr_acc_clear (mpfr_acc_ptr a)
+{
+  if (a->_mpfr_alloc != 0)
+    {
+      (*__gmp_free_func) (a->_mpfr_idx, a->_mpfr_alloc * sizeof (mpfr_exp_t));
+      (*__gmp_free_func) (a->_mpfr_d,
+                          a->_mpfr_alloc * (ACC_N + 1) * sizeof (mp_limb_t));
+    }
+}
+
+/* Return the position of the chunk of index c, inserting a zero chunk if
+   it does not exist yet. The chunks at positions less than lo have indices
+   less than c. */
+static mp_size_t
+acc_chunk (mpfr_acc_ptr a, mpfr_exp_t c, mp_size_t lo)
+{
+  mp_size_t hi = a->_mpfr_size, size = hi, alloc = a->_mpfr_alloc;
+  mpfr_exp_t *idx = a->_mpfr_idx;
+
+  /* Usual case: the chunk is the next one. */
+  if (lo < size && idx[lo] >= c)
+    hi = lo;
+  while (lo < hi)
+    {
+      mp_size_t m = lo + (hi - lo) / 2;
+
+      if (idx[m] < c)
+        lo = m + 1;
+      else
+        hi = m;
+    }
+  if (lo < size && idx[lo] == c)
+    return lo;
+
+  if (size == alloc)
+    {
+      mp_size_t new_alloc = alloc == 0 ? 4 : 2 * alloc;
+
+      a->_mpfr_idx = alloc == 0 ?
+        (mpfr_exp_t *) (*__gmp_allocate_func)
+        (new_alloc * sizeof (mpfr_exp_t)) :
+        (mpfr_exp_t *) (*__gmp_reallocate_func)
+        (a->_mpfr_idx, alloc * sizeof (mpfr_exp_t),
+         new_alloc * sizeof (mpfr_exp_t));
+      a->_mpfr_d = alloc == 0 ?
+        (mp_limb_t *) (*__gmp_allocate_func)
+        (new_alloc * (ACC_N + 1) * sizeof (mp_limb_t)) :
+        (mp_limb_t *) (*__gmp_reallocate_func)
+        (a->_mpfr_d, alloc * (ACC_N + 1) * sizeof (mp_limb_t),
+         new_alloc * (ACC_N + 1) * sizeof (mp_limb_t));
+      a->_mpfr_alloc = new_alloc;
+      idx = a->_mpfr_idx;
+    }
+  if (lo < size)
+    {
+      memmove (idx + lo + 1, idx + lo, (size - lo) * sizeof (mpfr_exp_t));
+      MPN_COPY_DECR (ACC_CHUNK (a, lo + 1), ACC_CHUNK (a, lo),
+                     (size - lo) * (ACC_N + 1));
+    }
+  idx[lo] = c;
+  MPN_ZERO (ACC_CHUNK (a, lo), ACC_N + 1);
+  a->_mpfr_size = size + 1;
+  return lo;
+}
+
+/* Move the carry of the chunk at position i to the next chunks, while it
+   is too large. */
+static void
+acc_carry (mpfr_acc_ptr a, mp_size_t i)
+{
+  mp_limb_t *d = ACC_CHUNK (a, i), cl, cy;
+
+  while (ACC_CARRY_ABS (d[ACC_N]) >= ACC_CARRY_MAX)
+    {
+      cl = d[ACC_N];
+      d[ACC_N] = 0;
+      i = acc_chunk (a, a->_mpfr_idx[i] + 1, i + 1);
+      d = ACC_CHUNK (a, i);
+      if (MPFR_LIMB_MSB (cl) == 0)
+        {
+          cy = mpn_add_1 (d, d, ACC_N, cl);
+          d[ACC_N] += cy;
+        }
+      else
+        {
+          cy = mpn_sub_1 (d, d, ACC_N, - cl);
+          d[ACC_N] -= cy;
+        }
+    }
+}
+
+/* Add (-1)^neg * {xp, xn} * 2^lsb to the accumulator a, where xn >= 1. */
+static void
+acc_add_raw (mpfr_acc_ptr a, const mp_limb_t *xp, mp_size_t xn,
+             mpfr_exp_t lsb, int neg)
+{
+  mp_limb_t *tp, *d, cy;
+  mp_size_t o, tn, j, len, i;
+  mpfr_exp_t c;
+  mpfr_uexp_t off;
+  int sh;
+  MPFR_TMP_DECL (marker);
+
+  /* c = floor(lsb / ACC_BITS) and off = lsb - c * ACC_BITS */
+  c = lsb >= 0 ? lsb / ACC_BITS : - ((- (lsb + 1)) / ACC_BITS) - 1;
+  off = (mpfr_uexp_t) lsb - (mpfr_uexp_t) c * ACC_BITS;
+  o = off / GMP_NUMB_BITS;
+  sh = off % GMP_NUMB_BITS;
+
+  /* {tp, tn} = {xp, xn} * 2^off */
+  MPFR_TMP_MARK (marker);
+  tn = o + xn + 1;
+  tp = MPFR_TMP_LIMBS_ALLOC (tn);
+  if (o != 0)
+    MPN_ZERO (tp, o);
+  if (sh != 0)
+    tp[o + xn] = mpn_lshift (tp + o, xp, xn, sh);
+  else
+    {
+      MPN_COPY (tp + o, xp, xn);
+      tp[o + xn] = 0;
+    }
+  if (tp[tn - 1] == 0)
+    tn--;
+
+  for (j = 0, i = 0; j < tn; j += ACC_N, c++)
+    {
+      /* After the first chunk, the next one usually exists already. */
+      if (j == 0 || i >= a->_mpfr_size || a->_mpfr_idx[i] != c)
+        i = acc_chunk (a, c, i);
+      d = ACC_CHUNK (a, i);
+      len = MIN (ACC_N, tn - j);
+      if (neg == 0)
+        {
+          cy = mpn_add (d, d, ACC_N, tp + j, len);
+          d[ACC_N] += cy;
+        }
+      else
+        {
+          cy = mpn_sub (d, d, ACC_N, tp + j, len);
+          d[ACC_N] -= cy;
+        }
+      if (MPFR_UNLIKELY (ACC_CARRY_ABS (d[ACC_N]) >= ACC_CARRY_MAX))
+        acc_carry (a, i);
+      i++;
+    }
+  MPFR_TMP_FREE (marker);
+}
+
+/* Add (-1)^neg * {xp, xn} * 2^lsb to the accumulator a, where xn >= 1 and
+   xp[xn-1] != 0, the weights of the bits being in [MPFR_ACC_LSB_MIN,
+   MPFR_ACC_MSB_MAX]. This allows mpfr_dot to add its exact products, whose
+   exponents may be outside the extended exponent range, without creating
+   mpfr_t's. */
+void
+mpfr_acc_add_raw (mpfr_acc_ptr a, const mp_limb_t *xp, mp_size_t xn,
+                  mpfr_exp_t lsb, int neg)
+{
+  /* The margin covers the carries out of the chunk of the most significant
+     bit (at most 2 chunks above it) and the rounding of lsb down to a
+     multiple of ACC_BITS. */
+  MPFR_STAT_STATIC_ASSERT (MPFR_ACC_MARGIN >= 3 * ACC_BITS);
+  MPFR_ASSERTD (xn >= 1 && xp[xn - 1] != 0);
+  MPFR_ASSERTD (lsb >= MPFR_ACC_LSB_MIN);
+
+  a->_mpfr_state |= ACC_REGULAR;
+  /* The finite part no longer matters after a NaN or an infinity. */
+  if (MPFR_LIKELY ((a->_mpfr_state &
+                    (ACC_NAN | ACC_POS_INF | ACC_NEG_INF)) == 0))
+    acc_add_raw (a, xp, xn, lsb, neg);
+}
+
+void
+mpfr_acc_add (mpfr_acc_ptr a, mpfr_srcptr x)
+{
+  if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (x)))
+    {
+      if (MPFR_IS_NAN (x))
+        a->_mpfr_state |= ACC_NAN;
+      else if (MPFR_IS_INF (x))
+        a->_mpfr_state |= MPFR_IS_POS (x) ? ACC_POS_INF : ACC_NEG_INF;
+      else
+        a->_mpfr_state |= MPFR_IS_POS (x) ? ACC_POS_ZERO : ACC_NEG_ZERO;
+    }
+  else
+    {
+      mp_size_t xn = MPFR_LIMB_SIZE (x);
+
+      mpfr_acc_add_raw (a, MPFR_MANT (x), xn,
+                        MPFR_GET_EXP (x) - (mpfr_exp_t) xn * GMP_NUMB_BITS,
+                        MPFR_IS_NEG (x));
+    }
+}
+
+void
+mpfr_acc_add_array (mpfr_acc_ptr a, mpfr_ptr *const x, unsigned long n)
+{
+  unsigned long i;
+
+  for (i = 0; i < n; i++)
+    mpfr_acc_add (a, x[i]);
+}
+
+void
+mpfr_acc_merge (mpfr_acc_ptr a, mpfr_acc_srcptr b)
+{
+  a->_mpfr_state |= b->_mpfr_state;
+  if (b->_mpfr_size != 0 &&
+      (a->_mpfr_state & (ACC_NAN | ACC_POS_INF | ACC_NEG_INF)) == 0)
+    {
+      mp_size_t n = b->_mpfr_size, j, i;
+      const mpfr_exp_t *idx = b->_mpfr_idx;
+      const mp_limb_t *bp = b->_mpfr_d;
+      mp_limb_t *d, cy;
+      MPFR_TMP_DECL (marker);
+
+      /* The chunks are copied first if b = a, since a may be modified. */
+      MPFR_TMP_MARK (marker);
+      if (b == a)
+        {
+          mpfr_exp_t *ti;
+          mp_limb_t *tp;
+
+          ti = (mpfr_exp_t *) MPFR_TMP_ALLOC (n * sizeof (mpfr_exp_t));
+          tp = MPFR_TMP_LIMBS_ALLOC (n * (ACC_N + 1));
+          memcpy (ti, idx, n * sizeof (mpfr_exp_t));
+          MPN_COPY (tp, bp, n * (ACC_N + 1));
+          idx = ti;
+          bp = tp;
+        }
+
+      /* The chunks have the same alignment: add them chunk by chunk. */
+      for (j = 0, i = 0; j < n; j++, bp += ACC_N + 1)
+        {
+          i = acc_chunk (a, idx[j], i);
+          d = ACC_CHUNK (a, i);
+          cy = mpn_add_n (d, d, bp, ACC_N);
+          d[ACC_N] += bp[ACC_N] + cy;
+          if (MPFR_UNLIKELY (ACC_CARRY_ABS (d[ACC_N]) >= ACC_CARRY_MAX))
+            acc_carry (a, i);
+          i++;
+        }
+      MPFR_TMP_FREE (marker);
+    }
+}
+
+int
+mpfr_acc_get (mpfr_ptr r, mpfr_acc_srcptr a, mpfr_rnd_t rnd)
+{
+  int state = a->_mpfr_state;
+  mpfr_wide_term_t *p;
+  mpfr_ptr z;
+  mp_limb_t *tp;
+  const mp_limb_t *d;
+  mp_size_t i, k, n;
+  int cnt, inex;
+  MPFR_TMP_DECL (marker);
+
+  if (MPFR_UNLIKELY (state & (ACC_NAN | ACC_POS_INF | ACC_NEG_INF)))
+    {
+      if ((state & ACC_NAN) ||
+          (state & (ACC_POS_INF | ACC_NEG_INF)) ==
+          (ACC_POS_INF | ACC_NEG_INF))
+        {
+          MPFR_SET_NAN (r);
+          MPFR_RET_NAN;
+        }
+      MPFR_SET_INF (r);
+      if (state & ACC_POS_INF)
+        MPFR_SET_POS (r);
+      else
+        MPFR_SET_NEG (r);
+      MPFR_RET (0);
+    }
+
+  /* The rounding toward zero is faithful (as in mpfr_sum). */
+  if (rnd == MPFR_RNDF)
+    rnd = MPFR_RNDZ;
+
+  /* Each non-zero chunk gives a term of mpfr_sum_wide, whose significand
+     is the absolute value of D + C * 2^ACC_BITS, normalized. */
+  MPFR_TMP_MARK (marker);
+  n = a->_mpfr_size;
+  p = (mpfr_wide_term_t *) MPFR_TMP_ALLOC (n * sizeof (mpfr_wide_term_t));
+  z = (mpfr_ptr) MPFR_TMP_ALLOC (n * sizeof (__mpfr_struct));
+  tp = MPFR_TMP_LIMBS_ALLOC (n * (ACC_N + 1));
+  for (i = 0, k = 0, d = a->_mpfr_d; i < n; i++, d += ACC_N + 1)
+    {
+      mp_size_t tn = ACC_N + 1;
+      int neg = MPFR_LIMB_MSB (d[ACC_N]) != 0;
+
+      if (neg)
+        {
+          mp_size_t j;
+
+          for (j = 0; j < tn; j++)
+            tp[j] = ~d[j];
+          mpn_add_1 (tp, tp, tn, MPFR_LIMB_ONE);
+        }
+      else
+        MPN_COPY (tp, d, tn);
+      while (tn > 0 && tp[tn - 1] == 0)
+        tn--;
+      if (tn == 0)
+        continue;
+      count_leading_zeros (cnt, tp[tn - 1]);
+      if (cnt != 0)
+        mpn_lshift (tp, tp, tn, cnt);
+      MPFR_TMP_INIT1 (tp, z + k, tn * GMP_NUMB_BITS);
+      MPFR_SET_SIGN (z + k, neg ? MPFR_SIGN_NEG : MPFR_SIGN_POS);
+      p[k].e = a->_mpfr_idx[i] * ACC_BITS +
+        (mpfr_exp_t) (tn * GMP_NUMB_BITS - cnt);
+      p[k].z = z + k;
+      k++;
+      tp += tn;
+    }
+
+  if (k != 0)
+    inex = mpfr_sum_wide (r, p, k, rnd);
+  else
+    {
+      /* Exact zero: same rules as mpfr_sum. */
+      MPFR_SET_ZERO (r);
+      if ((state & ACC_REGULAR) ||
+          (state & (ACC_POS_ZERO | ACC_NEG_ZERO)) ==
+          (ACC_POS_ZERO | ACC_NEG_ZERO))
+        MPFR_SET_SIGN (r, rnd == MPFR_RNDD ?
+                       MPFR_SIGN_NEG : MPFR_SIGN_POS);
+      else if (state & ACC_NEG_ZERO)
+        MPFR_SET_NEG (r);
+      else
+        MPFR_SET_POS (r);
+      inex = 0;
+    }
+  MPFR_TMP_FREE (marker);
+  MPFR_RET (inex);
+}
@@ -71,7 +71,10 @@ mpfr_add1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   exp = MPFR_GET_EXP (b);
   MPFR_SET_SAME_SIGN(a, b);
   MPFR_UPDATE2_RND_MODE(rnd_mode, MPFR_SIGN(b));
-  /* now rnd_mode is either MPFR_RNDN, MPFR_RNDZ or MPFR_RNDA */
+  /* now rnd_mode is either MPFR_RNDN, MPFR_RNDZ, MPFR_RNDA or MPFR_RNDF;
+     MPFR_RNDF is handled like MPFR_RNDZ, except that once the following
+     bits are known to be 0 (thus no carry can occur any longer), the
+     remaining limbs are not read just to get the sticky bit. */
   /* Note: exponents can be negative, but the unsigned subtraction is
      a modular subtraction, so that one gets the correct result. */
   diff_exp = (mpfr_uexp_t) exp - MPFR_GET_EXP(c);
@@ -374,7 +377,7 @@ mpfr_add1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 
           /* b has entirely been read */
 
-          if (fb || ck < 0)
+          if (fb || ck < 0 || rnd_mode == MPFR_RNDF)
             goto rounding;
           if (difs && cprev << (GMP_NUMB_BITS - difs))
             {
@@ -406,7 +409,7 @@ mpfr_add1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
                 }
               fb = bb != 0;
             } /* fb < 0 */
-          if (fb)
+          if (fb || rnd_mode == MPFR_RNDF)
             goto rounding;
           while (bk)
             {
@@ -458,6 +461,12 @@ mpfr_add1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
                   rb = cc >> (GMP_NUMB_BITS - 1);
                   cc &= ~MPFR_LIMB_HIGHBIT;
                 }
+              if (rnd_mode == MPFR_RNDF)
+                {
+                  /* only the sticky bit remains to be determined */
+                  fb = cc != 0;
+                  goto rounding;
+                }
               while (cc == 0)
                 {
                   if (ck == 0)
@@ -473,7 +482,7 @@ mpfr_add1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
     } /* fb != 1 */
 
  rounding:
-  /* rnd_mode should be one of MPFR_RNDN, MPFR_RNDZ or MPFR_RNDA */
+  /* rnd_mode should be one of MPFR_RNDN, MPFR_RNDZ, MPFR_RNDA or MPFR_RNDF */
   if (MPFR_LIKELY(rnd_mode == MPFR_RNDN))
     {
       if (fb == 0)
@@ -502,7 +511,7 @@ mpfr_add1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
           goto add_one_ulp;
         }
     }
-  else if (rnd_mode == MPFR_RNDZ)
+  else if (rnd_mode == MPFR_RNDZ || rnd_mode == MPFR_RNDF)
     {
       inex = rb || fb ? (MPFR_IS_NEG(a) ? 1 : -1) : 0;
       goto set_exponent;
@@ -27,12 +27,16 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 /* Check if we have to check the result of mpfr_add1sp with mpfr_add1 */
 #if MPFR_WANT_ASSERT >= 2
 
-int mpfr_add1sp2 (mpfr_ptr, mpfr_srcptr, mpfr_srcptr, mpfr_rnd_t);
+int mpfr_add1sp_ref (mpfr_ptr, mpfr_srcptr, mpfr_srcptr, mpfr_rnd_t);
 int mpfr_add1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 {
   mpfr_t tmpa, tmpb, tmpc;
   int inexb, inexc, inexact, inexact2;
 
+  /* with MPFR_RNDF, the results may differ */
+  if (rnd_mode == MPFR_RNDF)
+    return mpfr_add1sp_ref (a, b, c, rnd_mode);
+
   mpfr_init2 (tmpa, MPFR_PREC (a));
   mpfr_init2 (tmpb, MPFR_PREC (b));
   mpfr_init2 (tmpc, MPFR_PREC (c));
@@ -44,7 +48,7 @@ int mpfr_add1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   MPFR_ASSERTN (inexc == 0);
 
   inexact2 = mpfr_add1 (tmpa, tmpb, tmpc, rnd_mode);
-  inexact  = mpfr_add1sp2 (a, b, c, rnd_mode);
+  inexact  = mpfr_add1sp_ref (a, b, c, rnd_mode);
 
   if (mpfr_cmp (tmpa, a) || inexact != inexact2)
     {
@@ -68,7 +72,7 @@ int mpfr_add1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   mpfr_clears (tmpa, tmpb, tmpc, (mpfr_ptr) 0);
   return inexact;
 }
-# define mpfr_add1sp mpfr_add1sp2
+# define mpfr_add1sp mpfr_add1sp_ref
 #endif  /* MPFR_WANT_ASSERT >= 2 */
 
 /* Debugging support */
@@ -79,6 +83,175 @@ int mpfr_add1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 # define DEBUG(x) /**/
 #endif
 
+/* Special code for p < GMP_NUMB_BITS: the significands fit in one limb
+   and are kept in registers; rb and sb are the round and sticky bits. */
+static int
+mpfr_add1sp1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode,
+              mpfr_prec_t p)
+{
+  mpfr_exp_t bx = MPFR_GET_EXP (b);
+  mpfr_uexp_t d = (mpfr_uexp_t) bx - MPFR_GET_EXP (c);
+  mp_limb_t b0 = MPFR_MANT (b)[0];
+  mp_limb_t c0 = MPFR_MANT (c)[0];
+  unsigned int sh = GMP_NUMB_BITS - p;
+  mp_limb_t mask = MPFR_LIMB_MASK (sh);
+  mp_limb_t a0, rb, sb;
+  int inexact;
+
+  MPFR_ASSERTD (p < GMP_NUMB_BITS);
+
+  if (d == 0)
+    {
+      /* there is always a carry, and b + c fits on p+1 bits */
+      a0 = MPFR_LIMB_HIGHBIT | ((b0 >> 1) + (c0 >> 1));
+      bx++;
+      rb = a0 & (MPFR_LIMB_ONE << (sh - 1));
+      sb = 0;
+      a0 ^= rb;
+    }
+  else if (d < GMP_NUMB_BITS)
+    {
+      sb = c0 << (GMP_NUMB_BITS - d); /* bits of c shifted out */
+      a0 = b0 + (c0 >> d);
+      if (a0 < b0) /* carry */
+        {
+          sb |= a0 & MPFR_LIMB_ONE;
+          a0 = MPFR_LIMB_HIGHBIT | (a0 >> 1);
+          bx++;
+        }
+      rb = a0 & (MPFR_LIMB_ONE << (sh - 1));
+      sb |= (a0 & mask) ^ rb;
+      a0 &= ~mask;
+    }
+  else
+    {
+      /* d > p, thus 0 < c < 1/2 ulp(b) */
+      a0 = b0;
+      rb = 0;
+      sb = 1;
+    }
+
+  MPFR_SET_SAME_SIGN (a, b);
+
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inexact = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (a0 & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF
+             || MPFR_IS_LIKE_RNDZ (rnd_mode, MPFR_IS_NEG (a)))
+    inexact = -1; /* truncate */
+  else
+    {
+      inexact = 1; /* add one ulp */
+      a0 += MPFR_LIMB_ONE << sh;
+      if (MPFR_UNLIKELY (a0 == 0))
+        {
+          a0 = MPFR_LIMB_HIGHBIT;
+          bx++;
+        }
+    }
+
+  if (MPFR_UNLIKELY (bx > __gmpfr_emax))
+    return mpfr_overflow (a, rnd_mode, MPFR_SIGN (a));
+  MPFR_MANT (a)[0] = a0;
+  MPFR_SET_EXP (a, bx);
+  MPFR_RET (inexact * MPFR_INT_SIGN (a));
+}
+
+/* Special code for GMP_NUMB_BITS < p < 2 * GMP_NUMB_BITS. */
+static int
+mpfr_add1sp2 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode,
+              mpfr_prec_t p)
+{
+  mpfr_exp_t bx = MPFR_GET_EXP (b);
+  mpfr_uexp_t d = (mpfr_uexp_t) bx - MPFR_GET_EXP (c);
+  mp_limb_t b0 = MPFR_MANT (b)[0], b1 = MPFR_MANT (b)[1];
+  mp_limb_t c0 = MPFR_MANT (c)[0], c1 = MPFR_MANT (c)[1];
+  mp_limb_t *ap = MPFR_MANT (a);
+  unsigned int sh = 2 * GMP_NUMB_BITS - p;
+  mp_limb_t mask = MPFR_LIMB_MASK (sh);
+  mp_limb_t a0, a1, rb, sb;
+  int inexact;
+
+  MPFR_ASSERTD (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS);
+
+  if (d == 0)
+    {
+      /* there is always a carry, and b + c fits on p+1 bits */
+      a0 = b0 + c0;
+      a1 = b1 + c1 + (a0 < b0);
+      a0 = (a1 << (GMP_NUMB_BITS - 1)) | (a0 >> 1);
+      a1 = MPFR_LIMB_HIGHBIT | (a1 >> 1);
+      bx++;
+      rb = a0 & (MPFR_LIMB_ONE << (sh - 1));
+      sb = 0;
+      a0 ^= rb;
+    }
+  else if (d < 2 * GMP_NUMB_BITS)
+    {
+      if (d < GMP_NUMB_BITS)
+        {
+          sb = c0 << (GMP_NUMB_BITS - d); /* bits of c shifted out */
+          a0 = b0 + ((c1 << (GMP_NUMB_BITS - d)) | (c0 >> d));
+          a1 = b1 + (c1 >> d) + (a0 < b0);
+        }
+      else
+        {
+          /* c0 is entirely shifted out */
+          sb = d == GMP_NUMB_BITS ? c0
+            : c0 | (c1 << (2 * GMP_NUMB_BITS - d));
+          a0 = b0 + (c1 >> (d - GMP_NUMB_BITS));
+          a1 = b1 + (a0 < b0);
+        }
+      if (a1 < b1) /* carry */
+        {
+          sb |= a0 & MPFR_LIMB_ONE;
+          a0 = (a1 << (GMP_NUMB_BITS - 1)) | (a0 >> 1);
+          a1 = MPFR_LIMB_HIGHBIT | (a1 >> 1);
+          bx++;
+        }
+      rb = a0 & (MPFR_LIMB_ONE << (sh - 1));
+      sb |= (a0 & mask) ^ rb;
+      a0 &= ~mask;
+    }
+  else
+    {
+      /* d > p, thus 0 < c < 1/2 ulp(b) */
+      a0 = b0;
+      a1 = b1;
+      rb = 0;
+      sb = 1;
+    }
+
+  MPFR_SET_SAME_SIGN (a, b);
+
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inexact = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (a0 & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF
+             || MPFR_IS_LIKE_RNDZ (rnd_mode, MPFR_IS_NEG (a)))
+    inexact = -1; /* truncate */
+  else
+    {
+      inexact = 1; /* add one ulp */
+      a0 += MPFR_LIMB_ONE << sh;
+      a1 += a0 == 0;
+      if (MPFR_UNLIKELY (a1 == 0))
+        {
+          a1 = MPFR_LIMB_HIGHBIT;
+          bx++;
+        }
+    }
+
+  if (MPFR_UNLIKELY (bx > __gmpfr_emax))
+    return mpfr_overflow (a, rnd_mode, MPFR_SIGN (a));
+  ap[0] = a0;
+  ap[1] = a1;
+  MPFR_SET_EXP (a, bx);
+  MPFR_RET (inexact * MPFR_INT_SIGN (a));
+}
+
 /* compute sign(b) * (|b| + |c|)
    Returns 0 iff result is exact,
    a negative value when the result is less than the exact value,
@@ -96,8 +269,6 @@ mpfr_add1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   int inexact;
   MPFR_TMP_DECL(marker);
 
-  MPFR_TMP_MARK(marker);
-
   MPFR_ASSERTD(MPFR_PREC(a) == MPFR_PREC(b) && MPFR_PREC(b) == MPFR_PREC(c));
   MPFR_ASSERTD(MPFR_IS_PURE_FP(b));
   MPFR_ASSERTD(MPFR_IS_PURE_FP(c));
@@ -105,6 +276,15 @@ mpfr_add1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 
   /* Read prec and num of limbs */
   p = MPFR_GET_PREC (b);
+
+  if (p < GMP_NUMB_BITS)
+    return mpfr_add1sp1 (a, b, c, rnd_mode, p);
+
+  if (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS)
+    return mpfr_add1sp2 (a, b, c, rnd_mode, p);
+
+  MPFR_TMP_MARK(marker);
+
   n = MPFR_PREC2LIMBS (p);
   MPFR_UNSIGNED_MINUS_MODULO(sh, p);
   bx = MPFR_GET_EXP(b);
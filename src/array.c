@@ -0,0 +1,134 @@
+/* mpfr_array_init2, mpfr_array_clear, mpfr_array_resize -- arrays of
+   numbers of the same precision with a single allocation
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* The elements are initialized with the custom interface: the significands
+   of the alloc elements come first in the block, with a stride of
+   mpfr_custom_get_size (prec) bytes (so that they are contiguous and aligned
+   like the block returned by the memory functions), followed by the table
+   of the alloc elements. Since the significands have no size field (like
+   those of the custom interface), the elements must not be reallocated,
+   e.g. by mpfr_set_prec, or freed by mpfr_clear, and mpfr_swap must not be
+   used on them, as the significand of the i-th element is identified by
+   its position in the block. */
+
+/* Return the size in bytes of the block for alloc elements, aborting if it
+   cannot be represented. */
+static size_t
+array_bytes (size_t alloc, size_t stride)
+{
+  MPFR_ASSERTN (alloc <= ((size_t) -1) / (stride + sizeof (__mpfr_struct)));
+  return alloc * (stride + sizeof (__mpfr_struct));
+}
+
+void
+mpfr_array_init2 (mpfr_array_ptr a, size_t n, mpfr_prec_t p)
+{
+  MPFR_ASSERTN (MPFR_PREC_COND (p));
+  a->_mpfr_prec = p;
+  a->_mpfr_size = 0;
+  a->_mpfr_alloc = 0;
+  a->_mpfr_tab = NULL;
+  a->_mpfr_mant = NULL;
+  mpfr_array_resize (a, n);
+}
+
+void
+mpfr_array_clear (mpfr_array_ptr a)
+{
+  if (a->_mpfr_alloc != 0)
+    (*__gmp_free_func) (a->_mpfr_mant,
+                        array_bytes (a->_mpfr_alloc,
+                                     mpfr_custom_get_size (a->_mpfr_prec)));
+  a->_mpfr_size = 0;
+  a->_mpfr_alloc = 0;
+  a->_mpfr_tab = NULL;
+  a->_mpfr_mant = NULL;
+}
+
+/* Set the number of elements of a to n. The first elements keep their
+   values, and the new ones are set to NaN. When the block is too small,
+   it is replaced by a block for max(n, 2 * alloc) elements, so that a
+   sequence of resizes by one element takes a linear time. */
+void
+mpfr_array_resize (mpfr_array_ptr a, size_t n)
+{
+  mpfr_prec_t p = a->_mpfr_prec;
+  size_t stride = mpfr_custom_get_size (p);
+  mp_size_t limbs = MPFR_PREC2LIMBS (p);
+  size_t i;
+
+  if (n > a->_mpfr_alloc)
+    {
+      size_t alloc = a->_mpfr_alloc, size = a->_mpfr_size;
+      mp_limb_t *mant;
+      mpfr_ptr tab;
+
+      alloc = alloc != 0 && n / 2 < alloc && alloc <= ((size_t) -1) / 2 ?
+        2 * alloc : n;
+      mant = (mp_limb_t *) (*__gmp_allocate_func) (array_bytes (alloc,
+                                                                stride));
+      tab = (mpfr_ptr) ((char *) mant + alloc * stride);
+      if (size != 0)
+        {
+          memcpy (mant, a->_mpfr_mant, size * stride);
+          memcpy (tab, a->_mpfr_tab, size * sizeof (__mpfr_struct));
+          for (i = 0; i < size; i++)
+            mpfr_custom_move (tab + i, mant + i * limbs);
+        }
+      if (a->_mpfr_alloc != 0)
+        (*__gmp_free_func) (a->_mpfr_mant,
+                            array_bytes (a->_mpfr_alloc, stride));
+      a->_mpfr_alloc = alloc;
+      a->_mpfr_tab = tab;
+      a->_mpfr_mant = mant;
+    }
+
+  for (i = a->_mpfr_size; i < n; i++)
+    mpfr_custom_init_set (a->_mpfr_tab + i, MPFR_NAN_KIND, 0, p,
+                          a->_mpfr_mant + i * limbs);
+  a->_mpfr_size = n;
+}
+
+#undef mpfr_array_get
+mpfr_ptr
+mpfr_array_get (mpfr_array_ptr a, size_t i)
+{
+  MPFR_ASSERTD (i < a->_mpfr_size);
+  return a->_mpfr_tab + i;
+}
+
+#undef mpfr_array_size
+size_t
+mpfr_array_size (mpfr_array_srcptr a)
+{
+  return a->_mpfr_size;
+}
+
+#undef mpfr_array_get_prec
+mpfr_prec_t
+mpfr_array_get_prec (mpfr_array_srcptr a)
+{
+  return a->_mpfr_prec;
+}
@@ -130,9 +130,8 @@ mpfr_atan2 (mpfr_ptr dest, mpfr_srcptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
                   mpfr_const_pi (tmp2, MPFR_RNDN);
                   mpfr_mul_ui (tmp2, tmp2, 3, MPFR_RNDN); /* Error <= 2  */
                   mpfr_div_2ui (tmp2, tmp2, 2, MPFR_RNDN);
-                  if (mpfr_round_p (MPFR_MANT (tmp2), MPFR_LIMB_SIZE (tmp2),
-                                    MPFR_PREC (tmp2) - 2,
-                                    MPFR_PREC (dest) + (rnd_mode == MPFR_RNDN)))
+                  if (MPFR_CAN_ROUND (tmp2, MPFR_PREC (tmp2) - 2,
+                                      MPFR_PREC (dest), rnd_mode))
                     break;
                   MPFR_ZIV_NEXT (loop2, prec2);
                   mpfr_set_prec (tmp2, prec2);
@@ -0,0 +1,143 @@
+/* mpfr_bs_split, mpfr_bs_mul -- parallel binary splitting
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* Support for the parallel evaluation of the binary splitting recursions
+   (constants log(2), Euler, Catalan, and exp). A recursion has a thread
+   budget nthreads (initially mpfr_get_nthreads()): when a node has at least
+   MPFR_BS_MT_THRESHOLD terms and nthreads > 1, its two halves are computed
+   by two parallel tasks, the left one with ceil(nthreads/2) threads and the
+   right one with floor(nthreads/2) threads; otherwise they are computed in
+   the current thread with a budget of 1. Thus tasks are only created in the
+   first levels of the recursion (this is the depth cutoff), and at most
+   nthreads threads are used at the same time. The products that combine
+   the two halves of a node are done by mpfr_bs_mul with the budget of the
+   node. Since all these operations are exact, the results are the same as
+   with the serial code. */
+
+typedef struct {
+  mpfr_bs_func f;
+  void *arg;
+  unsigned long n1, n2;
+  unsigned int nthreads;
+} mpfr_bs_task_t;
+
+static void
+mpfr_bs_task (void *p)
+{
+  mpfr_bs_task_t *t = (mpfr_bs_task_t *) p;
+
+  t->f (t->arg, t->n1, t->n2, t->nthreads);
+}
+
+/* Compute f (left, n1, m, ...) and f (right, m, n2, ...), which must be
+   independent (in particular, they must not share temporary variables). */
+void
+mpfr_bs_split (mpfr_bs_func f, void *left, void *right, unsigned long n1,
+               unsigned long m, unsigned long n2, unsigned int nthreads)
+{
+  mpfr_bs_task_t t[2];
+
+  MPFR_ASSERTD (n1 <= m && m <= n2);
+  t[0].f = t[1].f = f;
+  t[0].arg = left;
+  t[0].n1 = n1;
+  t[0].n2 = m;
+  t[1].arg = right;
+  t[1].n1 = m;
+  t[1].n2 = n2;
+  if (MPFR_BS_SPLIT_P (nthreads, n2 - n1))
+    {
+      t[0].nthreads = (nthreads + 1) / 2;
+      t[1].nthreads = nthreads / 2;
+      mpfr_parallel_run (mpfr_bs_task, t, sizeof (mpfr_bs_task_t), 2);
+    }
+  else
+    {
+      t[0].nthreads = t[1].nthreads = 1;
+      mpfr_bs_task (&t[0]);
+      mpfr_bs_task (&t[1]);
+    }
+}
+
+typedef struct {
+  mpz_ptr *r;
+  mpz_srcptr *a, *b;
+  int n, step;
+} mpfr_bs_mul_t;
+
+static void
+mpfr_bs_mul_task (void *p)
+{
+  mpfr_bs_mul_t *t = (mpfr_bs_mul_t *) p;
+  int i;
+
+  for (i = 0; i < t->n; i += t->step)
+    mpz_mul (t->r[i], t->a[i], t->b[i]);
+}
+
+/* Set r[i] to a[i]*b[i] for 0 <= i < n. The r[i] must be different from
+   each other, and r[i] may be equal to a[i] or b[i], but not to a[j] or
+   b[j] for j != i. If nthreads > 1 and an operand has at least
+   MPFR_BS_MT_LIMBS limbs, the products are distributed among
+   min(n, nthreads) parallel tasks. */
+void
+mpfr_bs_mul (mpz_ptr *r, mpz_srcptr *a, mpz_srcptr *b, int n,
+             unsigned int nthreads)
+{
+  mpfr_bs_mul_t *t;
+  mp_size_t size = 0;
+  unsigned int j, ntasks;
+  int i;
+  MPFR_TMP_DECL (marker);
+
+  for (i = 0; i < n; i++)
+    {
+      if ((mp_size_t) mpz_size (a[i]) > size)
+        size = mpz_size (a[i]);
+      if ((mp_size_t) mpz_size (b[i]) > size)
+        size = mpz_size (b[i]);
+    }
+
+  if (nthreads <= 1 || n <= 1 || size < MPFR_BS_MT_LIMBS)
+    {
+      for (i = 0; i < n; i++)
+        mpz_mul (r[i], a[i], b[i]);
+      return;
+    }
+
+  ntasks = nthreads < (unsigned int) n ? nthreads : (unsigned int) n;
+  MPFR_TMP_MARK (marker);
+  t = (mpfr_bs_mul_t *) MPFR_TMP_ALLOC (ntasks * sizeof (mpfr_bs_mul_t));
+  for (j = 0; j < ntasks; j++)
+    {
+      /* task j computes the products j, j + ntasks, j + 2*ntasks... */
+      t[j].r = r + j;
+      t[j].a = a + j;
+      t[j].b = b + j;
+      t[j].n = n - j;
+      t[j].step = ntasks;
+    }
+  mpfr_parallel_run (mpfr_bs_mul_task, t, sizeof (mpfr_bs_mul_t), ntasks);
+  MPFR_TMP_FREE (marker);
+}
@@ -53,6 +53,26 @@ mpfr_buildopt_gmpinternals_p (void)
 #endif
 }
 
+int
+mpfr_buildopt_zivstats_p (void)
+{
+#ifdef MPFR_WANT_ZIV_STATS
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+int
+mpfr_buildopt_scratch_p (void)
+{
+#ifdef MPFR_WANT_SCRATCH_ARENA
+  return 1;
+#else
+  return 0;
+#endif
+}
+
 const char *mpfr_buildopt_tune_case (void)
 {
   /* MPFR_TUNE_CASE is always defined (can be "default"). */
@@ -31,28 +31,50 @@ mpfr_init_cache (mpfr_cache_t cache, int (*func)(mpfr_ptr, mpfr_rnd_t))
   MPFR_PREC (cache->x) = 0; /* Invalid prec to detect that the cache is not
                                valid. Maybe add a flag? */
   cache->func = func;
+  cache->mapped = 0;
 }
 #endif
 
 void
 mpfr_clear_cache (mpfr_cache_t cache)
 {
+  MPFR_LOCK_WRITE (cache->lock);
   if (MPFR_UNLIKELY (MPFR_PREC (cache->x) != 0))
     {
-      mpfr_clear (cache->x);
+      if (! cache->mapped)
+        mpfr_clear (cache->x);
       MPFR_PREC (cache->x) = 0;
+      cache->mapped = 0;
     }
+  MPFR_UNLOCK (cache->lock);
 }
 
-int
-mpfr_cache (mpfr_ptr dest, mpfr_cache_t cache, mpfr_rnd_t rnd)
+/* With --enable-shared-cache, the cache is shared by all the threads. It is
+   read under a read lock, so that several threads can get the constant at
+   the same time. When the precision of the cache is not sufficient, the
+   read lock is replaced by a write lock, so that only one thread computes
+   the constant while the others wait for the result, instead of computing
+   it too. */
+
+/* Lock the cache and make sure that its precision is at least prec. On
+   return, the cache is locked (for reading or writing), so that the caller
+   can read cache->x, then it must release the lock with MPFR_UNLOCK.
+   Must be called with an extended exponent range. */
+void
+mpfr_cache_lock (mpfr_cache_t cache, mpfr_prec_t prec)
 {
-  mpfr_prec_t prec = MPFR_PREC (dest);
-  mpfr_prec_t pold = MPFR_PREC (cache->x);
-  int inexact, sign;
-  MPFR_SAVE_EXPO_DECL (expo);
+  mpfr_prec_t pold;
 
-  MPFR_SAVE_EXPO_MARK (expo);
+  MPFR_LOCK_READ (cache->lock);
+  pold = MPFR_PREC (cache->x);
+  if (MPFR_UNLIKELY (prec > pold))
+    {
+      /* Another thread may have updated the cache between the unlock and
+         the write lock, thus the precision must be read again. */
+      MPFR_UNLOCK (cache->lock);
+      MPFR_LOCK_WRITE (cache->lock);
+      pold = MPFR_PREC (cache->x);
+    }
 
   if (MPFR_UNLIKELY (prec > pold))
     {
@@ -70,12 +92,32 @@ mpfr_cache (mpfr_ptr dest, mpfr_cache_t cache, mpfr_rnd_t rnd)
         pold = prec;
 
       /* no need to keep the previous value */
-      mpfr_set_prec (cache->x, pold);
+      if (MPFR_UNLIKELY (cache->mapped))
+        {
+          mpfr_init2 (cache->x, pold);
+          cache->mapped = 0;
+        }
+      else
+        mpfr_set_prec (cache->x, pold);
       cache->inexact = (*cache->func) (cache->x, MPFR_RNDN);
     }
 
   MPFR_ASSERTD (pold >= prec);
   MPFR_ASSERTD (MPFR_PREC (cache->x) == pold);
+}
+
+int
+mpfr_cache (mpfr_ptr dest, mpfr_cache_t cache, mpfr_rnd_t rnd)
+{
+  mpfr_prec_t prec = MPFR_PREC (dest);
+  mpfr_prec_t pold;
+  int inexact, sign;
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  mpfr_cache_lock (cache, prec);
+  pold = MPFR_PREC (cache->x);
 
   /* First, check if the cache has the exact value (unlikely).
      Else the exact value is between (assuming x=cache->x > 0):
@@ -150,6 +192,7 @@ mpfr_cache (mpfr_ptr dest, mpfr_cache_t cache, mpfr_rnd_t rnd)
         }
     }
 
+  MPFR_UNLOCK (cache->lock);
   MPFR_SAVE_EXPO_FREE (expo);
   return mpfr_check_range (dest, inexact, rnd);
 }
@@ -0,0 +1,375 @@
+/* mpfr_export_cache, mpfr_import_cache -- save and load the cached constants
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+
+#include "mpfr-impl.h"
+
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+# define MPFR_CACHE_MMAP 1
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+/* The cached constants (pi, log(2), Euler, Catalan) are saved in a file
+   in the native format of the limbs, so that the file can be mapped into
+   memory with mmap and the significands used in place, without any copy
+   or conversion (contrary to the portable format of mpfr_fpif_export).
+   Such a file can thus only be read on a machine with the same limb size
+   and endianness, which is checked by mpfr_import_cache.
+
+   The file is an array of limbs:
+     - header: MPFR_CACHE_FILE_MAGIC, MPFR_CACHE_FILE_VERSION,
+       GMP_NUMB_BITS, n (number of constants);
+     - n entries of MPFR_CACHE_FILE_ENTRY limbs: constant (MPFR_CACHE_PI,
+       etc.), precision, exponent (nonnegative for these constants),
+       ternary value + 1, offset of the significand from the beginning of
+       the file (in limbs), checksum of the previous limbs of the entry and
+       of the significand (see mpfr_cache_checksum);
+     - the significands. */
+
+#define MPFR_CACHE_FILE_MAGIC   ((mp_limb_t) 0x4d504652) /* "MPFR" */
+#define MPFR_CACHE_FILE_VERSION 2
+#define MPFR_CACHE_FILE_HEADER  4
+#define MPFR_CACHE_FILE_ENTRY   6
+#define MPFR_CACHE_FILE_NCONST  4
+#define MPFR_CACHE_FILE_MULT    ((mp_limb_t) 0x9e3779b1)
+
+#ifdef MPFR_CACHE_MMAP
+/* The mappings of the imported files that are used by the caches. They
+   have the same scope as the caches of the constants (thread-local, or
+   global with --enable-shared-cache), and are unmapped by mpfr_free_cache
+   (see mpfr_cache_unmap_files). */
+typedef struct mpfr_cache_mapping_s {
+  void *base;
+  size_t bytes;
+  struct mpfr_cache_mapping_s *next;
+} mpfr_cache_mapping_t;
+
+static MPFR_CACHE_ATTR struct {
+  mpfr_cache_mapping_t *first;
+  MPFR_LOCK_DECL(lock)
+} mpfr_cache_mappings = { NULL MPFR_LOCK_INITIALIZER };
+#endif
+
+static mpfr_cache_ptr
+mpfr_cache_get (int c)
+{
+  switch (c)
+    {
+    case MPFR_CACHE_PI:
+      return __gmpfr_cache_const_pi;
+    case MPFR_CACHE_LOG2:
+      return __gmpfr_cache_const_log2;
+    case MPFR_CACHE_EULER:
+      return __gmpfr_cache_const_euler;
+    case MPFR_CACHE_CATALAN:
+      return __gmpfr_cache_const_catalan;
+    default:
+      return NULL;
+    }
+}
+
+/* Return the checksum of the entry e (except its last limb, which is the
+   checksum) and of the significand {s, n}. Each limb is added to the
+   previous value multiplied by an odd constant (modulo 2^GMP_NUMB_BITS),
+   so that a change of a single limb is always detected, and most other
+   changes are. */
+static mp_limb_t
+mpfr_cache_checksum (const mp_limb_t *e, const mp_limb_t *s, mp_size_t n)
+{
+  mp_limb_t h = 0;
+  mp_size_t i;
+
+  for (i = 0; i < MPFR_CACHE_FILE_ENTRY - 1; i++)
+    h = h * MPFR_CACHE_FILE_MULT + e[i];
+  for (i = 0; i < n; i++)
+    h = h * MPFR_CACHE_FILE_MULT + s[i];
+  return h;
+}
+
+/* Save the constants that are currently in the cache into the file.
+   Return 0 if successful. */
+int
+mpfr_export_cache (const char *filename)
+{
+  mp_limb_t buf[MPFR_CACHE_FILE_HEADER
+                + MPFR_CACHE_FILE_NCONST * MPFR_CACHE_FILE_ENTRY];
+  mpfr_cache_ptr cache[MPFR_CACHE_FILE_NCONST];
+  mp_size_t offset;
+  FILE *fh;
+  int c, i, n, ret = 0;
+
+  fh = fopen (filename, "wb");
+  if (fh == NULL)
+    return -1;
+
+  /* The caches are locked until the end, so that the significands that
+     are written are those described in the header. */
+  for (c = MPFR_CACHE_PI, n = 0; c <= MPFR_CACHE_CATALAN; c <<= 1)
+    {
+      mpfr_cache_ptr p = mpfr_cache_get (c);
+
+      MPFR_LOCK_READ (p->lock);
+      if (MPFR_PREC (p->x) == 0)
+        {
+          MPFR_UNLOCK (p->lock);
+          continue;
+        }
+      MPFR_ASSERTN (MPFR_GET_EXP (p->x) >= 0);
+      cache[n] = p;
+      buf[MPFR_CACHE_FILE_HEADER + n * MPFR_CACHE_FILE_ENTRY] = c;
+      n++;
+    }
+  buf[0] = MPFR_CACHE_FILE_MAGIC;
+  buf[1] = MPFR_CACHE_FILE_VERSION;
+  buf[2] = GMP_NUMB_BITS;
+  buf[3] = n;
+  offset = MPFR_CACHE_FILE_HEADER + n * MPFR_CACHE_FILE_ENTRY;
+  for (i = 0; i < n; i++)
+    {
+      mp_limb_t *e = buf + MPFR_CACHE_FILE_HEADER + i * MPFR_CACHE_FILE_ENTRY;
+
+      e[1] = MPFR_PREC (cache[i]->x);
+      e[2] = MPFR_GET_EXP (cache[i]->x);
+      e[3] = cache[i]->inexact + 1;
+      e[4] = offset;
+      e[5] = mpfr_cache_checksum (e, MPFR_MANT (cache[i]->x),
+                                  MPFR_LIMB_SIZE (cache[i]->x));
+      offset += MPFR_LIMB_SIZE (cache[i]->x);
+    }
+
+  if (fwrite (buf, sizeof (mp_limb_t), MPFR_CACHE_FILE_HEADER
+              + n * MPFR_CACHE_FILE_ENTRY, fh) !=
+      MPFR_CACHE_FILE_HEADER + n * MPFR_CACHE_FILE_ENTRY)
+    ret = -1;
+  for (i = 0; i < n; i++)
+    {
+      if (ret == 0 &&
+          fwrite (MPFR_MANT (cache[i]->x), sizeof (mp_limb_t),
+                  MPFR_LIMB_SIZE (cache[i]->x), fh) !=
+          (size_t) MPFR_LIMB_SIZE (cache[i]->x))
+        ret = -1;
+      MPFR_UNLOCK (cache[i]->lock);
+    }
+
+  if (fclose (fh) != 0)
+    ret = -1;
+  return ret;
+}
+
+/* Check that the entry e of the file of size limbs at base describes
+   a valid constant. Since these limbs come from a file, everything is
+   checked: the fields of the entry, the checksum of the entry and of the
+   whole significand, which detects an accidental corruption of the file
+   (truncation, bit flips), and the first 2*GMP_NUMB_BITS bits of the
+   constant, which are recomputed, so that a file for another constant or
+   in another format is rejected. But the checksum is not a cryptographic
+   hash: a file modified on purpose can pass these checks, thus the files
+   must come from a trusted source (see the manual). */
+static int
+mpfr_cache_check_entry (const mp_limb_t *base, mp_size_t size,
+                        const mp_limb_t *e)
+{
+  mpfr_cache_ptr p = mpfr_cache_get ((int) e[0]);
+  mpfr_prec_t prec;
+  mp_size_t n;
+  mpfr_t x, y, z;
+  int ok;
+
+  if (p == NULL || e[1] < MPFR_PREC_MIN || e[1] > MPFR_PREC_MAX ||
+      e[2] > 2 || e[3] > 2 || e[4] > (mp_limb_t) size)
+    return 0;
+  prec = e[1];
+  n = MPFR_PREC2LIMBS (prec);
+  if (e[4] + n > (mp_limb_t) size || ! MPFR_LIMB_MSB (base[e[4] + n - 1]) ||
+      (base[e[4]] & MPFR_LIMB_MASK (n * GMP_NUMB_BITS - prec)) != 0 ||
+      mpfr_cache_checksum (e, base + e[4], n) != e[5])
+    return 0;
+
+  /* x is a read-only header for the significand in the file */
+  MPFR_PREC (x) = prec;
+  MPFR_SET_POS (x);
+  MPFR_EXP (x) = e[2];
+  MPFR_MANT (x) = (mp_limb_t *) base + e[4];
+  mpfr_init2 (y, 2 * GMP_NUMB_BITS);
+  mpfr_init2 (z, 2 * GMP_NUMB_BITS);
+  mpfr_set (y, x, MPFR_RNDN);
+  (*p->func) (z, MPFR_RNDN);
+  if (! mpfr_equal_p (y, z))
+    mpfr_nextabove (y);
+  if (! mpfr_equal_p (y, z))
+    {
+      mpfr_nextbelow (y);
+      mpfr_nextbelow (y);
+    }
+  ok = mpfr_equal_p (y, z);
+  mpfr_clear (y);
+  mpfr_clear (z);
+  return ok;
+}
+
+/* Seed the caches from the file, for the constants whose precision in the
+   file is larger than in the cache. With mmap, the file is mapped into
+   memory, and the significands of the cached constants point to this
+   mapping; once used, it is kept until mpfr_free_cache (a later computation
+   at a larger precision just stops using it). Without mmap, the significands
+   are copied. Only the caches of the current thread are seeded, unless they
+   are shared (--enable-shared-cache).
+   Return 0 if successful; in case of error, the caches are not modified. */
+int
+mpfr_import_cache (const char *filename)
+{
+  mp_limb_t *base;
+  mp_size_t size;
+  mp_limb_t i, n;
+  int ret = -1;
+  MPFR_SAVE_EXPO_DECL (expo);
+#ifdef MPFR_CACHE_MMAP
+  struct stat st;
+  int fd, used = 0;
+
+  fd = open (filename, O_RDONLY);
+  if (fd < 0)
+    return -1;
+  if (fstat (fd, &st) != 0 || st.st_size < (off_t) sizeof (mp_limb_t)
+      * MPFR_CACHE_FILE_HEADER || st.st_size % sizeof (mp_limb_t) != 0)
+    {
+      close (fd);
+      return -1;
+    }
+  size = st.st_size / sizeof (mp_limb_t);
+  base = (mp_limb_t *) mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (base == (mp_limb_t *) MAP_FAILED)
+    return -1;
+#else
+  FILE *fh;
+  long len;
+
+  fh = fopen (filename, "rb");
+  if (fh == NULL)
+    return -1;
+  if (fseek (fh, 0, SEEK_END) != 0 || (len = ftell (fh)) < 0 ||
+      len < (long) (sizeof (mp_limb_t) * MPFR_CACHE_FILE_HEADER) ||
+      len % sizeof (mp_limb_t) != 0 || fseek (fh, 0, SEEK_SET) != 0)
+    {
+      fclose (fh);
+      return -1;
+    }
+  size = len / sizeof (mp_limb_t);
+  base = (mp_limb_t *) (*__gmp_allocate_func) (size * sizeof (mp_limb_t));
+  if (fread (base, sizeof (mp_limb_t), size, fh) != (size_t) size)
+    {
+      fclose (fh);
+      (*__gmp_free_func) (base, size * sizeof (mp_limb_t));
+      return -1;
+    }
+  fclose (fh);
+#endif
+
+  MPFR_SAVE_EXPO_MARK (expo);
+  n = base[3];
+  if (base[0] != MPFR_CACHE_FILE_MAGIC || base[1] != MPFR_CACHE_FILE_VERSION
+      || base[2] != GMP_NUMB_BITS || n > MPFR_CACHE_FILE_NCONST ||
+      MPFR_CACHE_FILE_HEADER + n * MPFR_CACHE_FILE_ENTRY > (mp_limb_t) size)
+    goto end;
+  for (i = 0; i < n; i++)
+    if (! mpfr_cache_check_entry (base, size, base + MPFR_CACHE_FILE_HEADER
+                                  + i * MPFR_CACHE_FILE_ENTRY))
+      goto end;
+
+  for (i = 0; i < n; i++)
+    {
+      const mp_limb_t *e = base + MPFR_CACHE_FILE_HEADER
+        + i * MPFR_CACHE_FILE_ENTRY;
+      mpfr_cache_ptr p = mpfr_cache_get ((int) e[0]);
+      mpfr_prec_t prec = e[1];
+
+      MPFR_LOCK_WRITE (p->lock);
+      if (prec > MPFR_PREC (p->x))
+        {
+          if (MPFR_PREC (p->x) != 0 && ! p->mapped)
+            mpfr_clear (p->x);
+#ifdef MPFR_CACHE_MMAP
+          MPFR_PREC (p->x) = prec;
+          MPFR_MANT (p->x) = base + e[4];
+          p->mapped = 1;
+          used = 1;
+#else
+          mpfr_init2 (p->x, prec);
+          MPN_COPY (MPFR_MANT (p->x), base + e[4], MPFR_PREC2LIMBS (prec));
+          p->mapped = 0;
+#endif
+          MPFR_SET_POS (p->x);
+          MPFR_EXP (p->x) = e[2];
+          p->inexact = (int) e[3] - 1;
+        }
+      MPFR_UNLOCK (p->lock);
+    }
+  ret = 0;
+
+ end:
+  MPFR_SAVE_EXPO_FREE (expo);
+#ifdef MPFR_CACHE_MMAP
+  if (used)
+    {
+      mpfr_cache_mapping_t *m;
+
+      m = (mpfr_cache_mapping_t *)
+        (*__gmp_allocate_func) (sizeof (mpfr_cache_mapping_t));
+      m->base = base;
+      m->bytes = size * sizeof (mp_limb_t);
+      MPFR_LOCK_WRITE (mpfr_cache_mappings.lock);
+      m->next = mpfr_cache_mappings.first;
+      mpfr_cache_mappings.first = m;
+      MPFR_UNLOCK (mpfr_cache_mappings.lock);
+    }
+  else
+    munmap (base, size * sizeof (mp_limb_t));
+#else
+  (*__gmp_free_func) (base, size * sizeof (mp_limb_t));
+#endif
+  return ret;
+}
+
+/* Unmap the files imported by mpfr_import_cache. Called by mpfr_free_cache2
+   once the caches of the constants have been cleared, so that they no
+   longer use these mappings. */
+void
+mpfr_cache_unmap_files (void)
+{
+#ifdef MPFR_CACHE_MMAP
+  mpfr_cache_mapping_t *m;
+
+  MPFR_LOCK_WRITE (mpfr_cache_mappings.lock);
+  while ((m = mpfr_cache_mappings.first) != NULL)
+    {
+      mpfr_cache_mappings.first = m->next;
+      munmap (m->base, m->bytes);
+      (*__gmp_free_func) (m, sizeof (mpfr_cache_mapping_t));
+    }
+  MPFR_UNLOCK (mpfr_cache_mappings.lock);
+#endif
+}
@@ -53,6 +53,8 @@ mpfr_check (mpfr_srcptr x)
     return 0;
   /* Check size of mantissa */
   s = MPFR_GET_ALLOC_SIZE(x);
+  if (s < 0 && s >= - MP_SIZE_T_MAX)
+    s = - s;  /* inline significand (mpfr_init2_inline) */
   if (s <= 0 || s > MP_SIZE_T_MAX ||
       prec > (mpfr_prec_t) s * GMP_NUMB_BITS)
     return 0;
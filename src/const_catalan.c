@@ -33,9 +33,27 @@ mpfr_const_catalan (mpfr_ptr x, mpfr_rnd_t rnd_mode) {
   return mpfr_cache (x, __gmpfr_cache_const_catalan, rnd_mode);
 }
 
-/* return T, Q such that T/Q = sum(k!^2/(2k)!/(2k+1)^2, k=n1..n2-1) */
+/* return T, Q such that T/Q = sum(k!^2/(2k)!/(2k+1)^2, k=n1..n2-1),
+   using at most nthreads threads (see mpfr_bs_split) */
 static void
-S (mpz_t T, mpz_t P, mpz_t Q, unsigned long n1, unsigned long n2)
+S (mpz_t T, mpz_t P, mpz_t Q, unsigned long n1, unsigned long n2,
+   unsigned int nthreads);
+
+typedef struct {
+  mpz_ptr T, P, Q;
+} mpfr_catalan_S_t;
+
+static void
+S_task (void *p, unsigned long n1, unsigned long n2, unsigned int nthreads)
+{
+  mpfr_catalan_S_t *s = (mpfr_catalan_S_t *) p;
+
+  S (s->T, s->P, s->Q, n1, n2, nthreads);
+}
+
+static void
+S (mpz_t T, mpz_t P, mpz_t Q, unsigned long n1, unsigned long n2,
+   unsigned int nthreads)
 {
   if (n2 == n1 + 1)
     {
@@ -57,22 +75,104 @@ S (mpz_t T, mpz_t P, mpz_t Q, unsigned long n1, unsigned long n2)
     {
       unsigned long m = (n1 + n2) / 2;
       mpz_t T2, P2, Q2;
-      S (T, P, Q, n1, m);
+      mpz_ptr r[4];
+      mpz_srcptr a[4], b[4];
+
       mpz_init (T2);
       mpz_init (P2);
       mpz_init (Q2);
-      S (T2, P2, Q2, m, n2);
-      mpz_mul (T, T, Q2);
-      mpz_mul (T2, T2, P);
+      if (MPFR_BS_SPLIT_P (nthreads, n2 - n1))
+        {
+          mpfr_catalan_S_t l, h;
+
+          l.T = T;
+          l.P = P;
+          l.Q = Q;
+          h.T = T2;
+          h.P = P2;
+          h.Q = Q2;
+          mpfr_bs_split (S_task, &l, &h, n1, m, n2, nthreads);
+        }
+      else
+        {
+          S (T, P, Q, n1, m, 1);
+          S (T2, P2, Q2, m, n2, 1);
+        }
+      /* T <- T Q2, T2 <- T2 P, Q <- Q Q2 and P <- P P2 (computed in P2
+         since P is still read) */
+      r[0] = T;
+      a[0] = T;
+      b[0] = Q2;
+      r[1] = T2;
+      a[1] = T2;
+      b[1] = P;
+      r[2] = Q;
+      a[2] = Q;
+      b[2] = Q2;
+      r[3] = P2;
+      a[3] = P;
+      b[3] = P2;
+      mpfr_bs_mul (r, a, b, 4, nthreads);
       mpz_add (T, T, T2);
-      mpz_mul (P, P, P2);
-      mpz_mul (Q, Q, Q2);
+      mpz_swap (P, P2);
       mpz_clear (T2);
       mpz_clear (P2);
       mpz_clear (Q2);
     }
 }
 
+/* x <- Pi*log(2+sqrt(3)), using t as a temporary variable */
+static void
+mpfr_catalan_log (mpfr_ptr x, mpfr_ptr t)
+{
+  mpfr_sqrt_ui (x, 3, MPFR_RNDU);
+  mpfr_add_ui (x, x, 2, MPFR_RNDU);
+  mpfr_log (x, x, MPFR_RNDU);
+  mpfr_const_pi (t, MPFR_RNDU);
+  mpfr_mul (x, x, t, MPFR_RNDN);
+}
+
+/* y <- 3*T/Q, where T/Q is the sum of the n first terms, using z as a
+   temporary variable */
+static void
+mpfr_catalan_sum (mpfr_ptr y, mpfr_ptr z, mpz_ptr T, mpz_ptr P, mpz_ptr Q,
+                  unsigned long n, unsigned int nthreads)
+{
+  S (T, P, Q, 0, n, nthreads);
+  mpz_mul_ui (T, T, 3);
+  mpfr_set_z (y, T, MPFR_RNDU);
+  mpfr_set_z (z, Q, MPFR_RNDD);
+  mpfr_div (y, y, z, MPFR_RNDN);
+}
+
+/* Threaded mode (see mpfr_set_nthreads): Pi*log(2+sqrt(3)) is computed by
+   task 0, i.e., in the current thread, since it uses the caches of the
+   constants, while task 1 computes the sum, including its division, with
+   the other threads. */
+typedef struct {
+  mpfr_ptr y, z;
+  mpz_ptr T, P, Q;
+  unsigned long n;
+  unsigned int task, nthreads;
+} mpfr_catalan_task_t;
+
+static void
+mpfr_catalan_task (void *p)
+{
+  mpfr_catalan_task_t *t = (mpfr_catalan_task_t *) p;
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  if (t->task == 0)
+    {
+      mpfr_catalan_log (t->y, t->z);
+      return;
+    }
+  /* The exponent range of a new thread is the default one. */
+  MPFR_SAVE_EXPO_MARK (expo);
+  mpfr_catalan_sum (t->y, t->z, t->T, t->P, t->Q, t->n, t->nthreads);
+  MPFR_SAVE_EXPO_FREE (expo);
+}
+
 /* Don't need to save/restore exponent range: the cache does it.
    Catalan's constant is G = sum((-1)^k/(2*k+1)^2, k=0..infinity).
    We compute it using formula (31) of Victor Adamchik's page
@@ -84,10 +184,12 @@ S (mpz_t T, mpz_t P, mpz_t Q, unsigned long n1, unsigned long n2)
 int
 mpfr_const_catalan_internal (mpfr_ptr g, mpfr_rnd_t rnd_mode)
 {
-  mpfr_t x, y, z;
+  mpfr_t x, y, z, w;
   mpz_t T, P, Q;
   mpfr_prec_t pg, p;
   int inex;
+  unsigned int nthreads = mpfr_get_nthreads ();
+  mpfr_catalan_task_t task[2];
   MPFR_ZIV_DECL (loop);
   MPFR_GROUP_DECL (group);
 
@@ -115,23 +217,35 @@ mpfr_const_catalan_internal (mpfr_ptr g, mpfr_rnd_t rnd_mode)
   pg = MPFR_PREC (g);
   p = pg + MPFR_INT_CEIL_LOG2 (pg) + 7;
 
-  MPFR_GROUP_INIT_3 (group, p, x, y, z);
+  MPFR_GROUP_INIT_4 (group, p, x, y, z, w);
   mpz_init (T);
   mpz_init (P);
   mpz_init (Q);
 
   MPFR_ZIV_INIT (loop, p);
   for (;;) {
-    mpfr_sqrt_ui (x, 3, MPFR_RNDU);
-    mpfr_add_ui (x, x, 2, MPFR_RNDU);
-    mpfr_log (x, x, MPFR_RNDU);
-    mpfr_const_pi (y, MPFR_RNDU);
-    mpfr_mul (x, x, y, MPFR_RNDN);
-    S (T, P, Q, 0, (p - 1) / 2);
-    mpz_mul_ui (T, T, 3);
-    mpfr_set_z (y, T, MPFR_RNDU);
-    mpfr_set_z (z, Q, MPFR_RNDD);
-    mpfr_div (y, y, z, MPFR_RNDN);
+    if (nthreads > 1)
+      {
+        /* x and w for Pi*log(2+sqrt(3)), y and z for the sum */
+        task[0].y = x;
+        task[0].z = w;
+        task[0].task = 0;
+        task[1].y = y;
+        task[1].z = z;
+        task[1].T = T;
+        task[1].P = P;
+        task[1].Q = Q;
+        task[1].n = (p - 1) / 2;
+        task[1].task = 1;
+        task[1].nthreads = nthreads - 1;
+        mpfr_parallel_run (mpfr_catalan_task, task,
+                           sizeof (mpfr_catalan_task_t), 2);
+      }
+    else
+      {
+        mpfr_catalan_log (x, y);
+        mpfr_catalan_sum (y, z, T, P, Q, (p - 1) / 2, 1);
+      }
     mpfr_add (x, x, y, MPFR_RNDN);
     mpfr_div_2ui (x, x, 3, MPFR_RNDN);
 
@@ -139,7 +253,7 @@ mpfr_const_catalan_internal (mpfr_ptr g, mpfr_rnd_t rnd_mode)
       break;
 
     MPFR_ZIV_NEXT (loop, p);
-    MPFR_GROUP_REPREC_3 (group, p, x, y, z);
+    MPFR_GROUP_REPREC_4 (group, p, x, y, z, w);
   }
   MPFR_ZIV_FREE (loop);
   inex = mpfr_set (g, x, rnd_mode);
@@ -71,10 +71,33 @@ mpfr_const_euler_bs_clear (mpfr_const_euler_bs_t s)
   mpz_clear (s->V);
 }
 
+/* The two binary splitting recursions below use at most nthreads threads
+   (see mpfr_bs_split). */
+
 static void
 mpfr_const_euler_bs_1 (mpfr_const_euler_bs_t s,
                        unsigned long n1, unsigned long n2, unsigned long N,
-                       int cont)
+                       int cont, unsigned int nthreads);
+
+typedef struct
+{
+  mpfr_const_euler_bs_struct *s;
+  unsigned long N;
+} mpfr_const_euler_bs_1_t;
+
+static void
+mpfr_const_euler_bs_1_task (void *p, unsigned long n1, unsigned long n2,
+                            unsigned int nthreads)
+{
+  mpfr_const_euler_bs_1_t *t = (mpfr_const_euler_bs_1_t *) p;
+
+  mpfr_const_euler_bs_1 (t->s, n1, n2, t->N, 1, nthreads);
+}
+
+static void
+mpfr_const_euler_bs_1 (mpfr_const_euler_bs_t s,
+                       unsigned long n1, unsigned long n2, unsigned long N,
+                       int cont, unsigned int nthreads)
 {
   if (n2 - n1 == 1)
     {
@@ -90,41 +113,70 @@ mpfr_const_euler_bs_1 (mpfr_const_euler_bs_t s,
   else
     {
       mpfr_const_euler_bs_t L, R;
-      mpz_t t, u, v;
+      mpz_t t, u, v, w, x;
+      mpz_ptr r[9];
+      mpz_srcptr a[9], b[9];
+      int k = 0;
       unsigned long m = (n1 + n2) / 2;
 
       mpfr_const_euler_bs_init (L);
       mpfr_const_euler_bs_init (R);
-      mpfr_const_euler_bs_1 (L, n1, m, N, 1);
-      mpfr_const_euler_bs_1 (R, m, n2, N, 1);
+      if (MPFR_BS_SPLIT_P (nthreads, n2 - n1))
+        {
+          mpfr_const_euler_bs_1_t l, h;
+
+          l.s = L;
+          l.N = N;
+          h.s = R;
+          h.N = N;
+          mpfr_bs_split (mpfr_const_euler_bs_1_task, &l, &h, n1, m, n2,
+                         nthreads);
+        }
+      else
+        {
+          mpfr_const_euler_bs_1 (L, n1, m, N, 1, 1);
+          mpfr_const_euler_bs_1 (R, m, n2, N, 1, 1);
+        }
 
       mpz_init (t);
       mpz_init (u);
       mpz_init (v);
+      mpz_init (w);
+      mpz_init (x);
 
+      /* First the products of the components of L and R:
+         P = LP RP, Q = LQ RQ, D = LD RD, t = LP RT, v = RQ LT,
+         C = LC RD, w = RC LD, u = LP RV and x = RQ LV. */
+#define MPFR_EULER_MUL(Z,X,Y) (r[k] = (Z), a[k] = (X), b[k] = (Y), k++)
       if (cont)
-        mpz_mul (s->P, L->P, R->P);
-
-      mpz_mul (s->Q, L->Q, R->Q);
-      mpz_mul (s->D, L->D, R->D);
+        MPFR_EULER_MUL (s->P, L->P, R->P);
+      MPFR_EULER_MUL (s->Q, L->Q, R->Q);
+      MPFR_EULER_MUL (s->D, L->D, R->D);
+      MPFR_EULER_MUL (t, L->P, R->T);
+      MPFR_EULER_MUL (v, R->Q, L->T);
+      if (cont)
+        {
+          MPFR_EULER_MUL (s->C, L->C, R->D);
+          MPFR_EULER_MUL (w, R->C, L->D);
+        }
+      MPFR_EULER_MUL (u, L->P, R->V);
+      MPFR_EULER_MUL (x, R->Q, L->V);
+      mpfr_bs_mul (r, a, b, k, nthreads);
 
       /* T = LP RT + RQ LT*/
-      mpz_mul (t, L->P, R->T);
-      mpz_mul (v, R->Q, L->T);
       mpz_add (s->T, t, v);
 
       /* C = LC RD + RC LD */
       if (cont)
-        {
-          mpz_mul (s->C, L->C, R->D);
-          mpz_addmul (s->C, R->C, L->D);
-        }
+        mpz_add (s->C, s->C, w);
 
       /* V = RD (RQ LV + LC LP RT) + LD LP RV */
-      mpz_mul (u, L->P, R->V);
-      mpz_mul (u, u, L->D);
-      mpz_mul (v, R->Q, L->V);
-      mpz_addmul (v, t, L->C);
+      k = 0;
+      MPFR_EULER_MUL (u, u, L->D);
+      MPFR_EULER_MUL (v, t, L->C);
+      mpfr_bs_mul (r, a, b, k, nthreads);
+#undef MPFR_EULER_MUL
+      mpz_add (v, v, x);
       mpz_mul (v, v, R->D);
       mpz_add (s->V, u, v);
 
@@ -133,13 +185,35 @@ mpfr_const_euler_bs_1 (mpfr_const_euler_bs_t s,
       mpz_clear (t);
       mpz_clear (u);
       mpz_clear (v);
+      mpz_clear (w);
+      mpz_clear (x);
   }
 }
 
 static void
 mpfr_const_euler_bs_2 (mpz_t P, mpz_t Q, mpz_t T,
                        unsigned long n1, unsigned long n2, unsigned long N,
-                       int cont)
+                       int cont, unsigned int nthreads);
+
+typedef struct
+{
+  mpz_ptr P, Q, T;
+  unsigned long N;
+} mpfr_const_euler_bs_2_t;
+
+static void
+mpfr_const_euler_bs_2_task (void *p, unsigned long n1, unsigned long n2,
+                            unsigned int nthreads)
+{
+  mpfr_const_euler_bs_2_t *t = (mpfr_const_euler_bs_2_t *) p;
+
+  mpfr_const_euler_bs_2 (t->P, t->Q, t->T, n1, n2, t->N, 1, nthreads);
+}
+
+static void
+mpfr_const_euler_bs_2 (mpz_t P, mpz_t Q, mpz_t T,
+                       unsigned long n1, unsigned long n2, unsigned long N,
+                       int cont, unsigned int nthreads)
 {
   if (n2 - n1 == 1)
     {
@@ -161,34 +235,153 @@ mpfr_const_euler_bs_2 (mpz_t P, mpz_t Q, mpz_t T,
   else
     {
       mpz_t P2, Q2, T2;
+      mpz_ptr r[4];
+      mpz_srcptr a[4], b[4];
       unsigned long m = (n1 + n2) / 2;
 
       mpz_init (P2);
       mpz_init (Q2);
       mpz_init (T2);
-      mpfr_const_euler_bs_2 (P, Q, T, n1, m, N, 1);
-      mpfr_const_euler_bs_2 (P2, Q2, T2, m, n2, N, 1);
-      mpz_mul (T, T, Q2);
-      mpz_mul (T2, T2, P);
+      if (MPFR_BS_SPLIT_P (nthreads, n2 - n1))
+        {
+          mpfr_const_euler_bs_2_t l, h;
+
+          l.P = P;
+          l.Q = Q;
+          l.T = T;
+          l.N = N;
+          h.P = P2;
+          h.Q = Q2;
+          h.T = T2;
+          h.N = N;
+          mpfr_bs_split (mpfr_const_euler_bs_2_task, &l, &h, n1, m, n2,
+                         nthreads);
+        }
+      else
+        {
+          mpfr_const_euler_bs_2 (P, Q, T, n1, m, N, 1, 1);
+          mpfr_const_euler_bs_2 (P2, Q2, T2, m, n2, N, 1, 1);
+        }
+      /* T <- T Q2, T2 <- T2 P, Q <- Q Q2 and P <- P P2 (computed in P2
+         since P is still read) */
+      r[0] = T;
+      a[0] = T;
+      b[0] = Q2;
+      r[1] = T2;
+      a[1] = T2;
+      b[1] = P;
+      r[2] = Q;
+      a[2] = Q;
+      b[2] = Q2;
+      r[3] = P2;
+      a[3] = P;
+      b[3] = P2;
+      mpfr_bs_mul (r, a, b, cont ? 4 : 3, nthreads);
       mpz_add (T, T, T2);
       if (cont)
-        mpz_mul (P, P, P2);
-      mpz_mul (Q, Q, Q2);
+        mpz_swap (P, P2);
       mpz_clear (P2);
       mpz_clear (Q2);
       mpz_clear (T2);
     }
 }
 
+/* v <- V 2^wp / ((T + Q) D), where T already contains T + Q */
+static void
+mpfr_const_euler_q1 (mpz_ptr v, mpfr_const_euler_bs_struct *sum,
+                     mpfr_prec_t wp)
+{
+  mpz_t t, u;
+
+  mpz_init (t);
+  mpz_init (u);
+  mpz_mul (t, sum->T, sum->D);
+  mpz_mul_2exp (u, sum->V, wp);
+  mpz_tdiv_q (v, u, t);
+  mpz_clear (t);
+  mpz_clear (u);
+}
+
+/* t <- Q^2 T2 2^wp / (T^2 Q2), where T already contains T + Q, and T2/Q2
+   is the second series */
+static void
+mpfr_const_euler_q2 (mpz_ptr t, mpfr_const_euler_bs_struct *sum,
+                     mpz_srcptr Q2, mpz_srcptr T2, mpfr_prec_t wp)
+{
+  mpz_t u;
+
+  mpz_init (u);
+  mpz_mul (t, sum->Q, sum->Q);
+  mpz_mul (t, t, T2);
+  mpz_mul (u, sum->T, sum->T);
+  mpz_mul (u, u, Q2);
+  mpz_mul_2exp (t, t, wp);
+  mpz_div (t, t, u);
+  mpz_clear (u);
+}
+
+/* y <- log(n) rounded toward zero, with an error < 2^-wp */
+static void
+mpfr_const_euler_log (mpfr_ptr y, unsigned long n, mpfr_prec_t wp)
+{
+  mpfr_prec_t magn;
+
+  /* log(n) < 2^ceil(log2(n)) */
+  magn = MPFR_INT_CEIL_LOG2(n);
+  mpfr_set_prec (y, wp + magn);
+  mpfr_set_ui (y, n, MPFR_RNDZ); /* exact */
+  mpfr_log (y, y, MPFR_RNDZ); /* error < 2^-wp */
+}
+
+/* Threaded mode (see mpfr_set_nthreads): the two series and log(n) are
+   computed by two parallel tasks, the first one (in the current thread,
+   since it uses the caches of the constants) computing log(n) and the
+   second series, the other one the first series with the remaining
+   threads. Then the two quotients are computed by two parallel tasks. */
+typedef struct
+{
+  int what;
+  mpfr_const_euler_bs_struct *sum;
+  mpz_ptr P2, Q2, T2, q;
+  mpfr_ptr y;
+  unsigned long n, N;
+  mpfr_prec_t wp;
+  unsigned int nthreads;
+} mpfr_const_euler_task_t;
+
+static void
+mpfr_const_euler_task (void *p)
+{
+  mpfr_const_euler_task_t *t = (mpfr_const_euler_task_t *) p;
+
+  switch (t->what)
+    {
+    case 0:
+      mpfr_const_euler_log (t->y, t->n, t->wp);
+      mpfr_const_euler_bs_2 (t->P2, t->Q2, t->T2, 0, 2 * t->n, t->n, 0, 1);
+      break;
+    case 1:
+      mpfr_const_euler_bs_1 (t->sum, 0, t->N, t->n, 0, t->nthreads);
+      break;
+    case 2:
+      mpfr_const_euler_q1 (t->q, t->sum, t->wp);
+      break;
+    default:
+      mpfr_const_euler_q2 (t->q, t->sum, t->Q2, t->T2, t->wp);
+    }
+}
+
 int
 mpfr_const_euler_internal (mpfr_t x, mpfr_rnd_t rnd)
 {
   mpfr_const_euler_bs_t sum;
-  mpz_t t, u, v;
+  mpz_t t, v, P2, Q2, T2;
   unsigned long n, N;
-  mpfr_prec_t prec, wp, magn;
+  mpfr_prec_t prec, wp;
   mpfr_t y;
-  int inexact;
+  int i, inexact;
+  unsigned int nthreads = mpfr_get_nthreads ();
+  mpfr_const_euler_task_t task[2];
   MPFR_ZIV_DECL (loop);
 
   prec = mpfr_get_prec (x);
@@ -197,8 +390,10 @@ mpfr_const_euler_internal (mpfr_t x, mpfr_rnd_t rnd)
   mpfr_init2 (y, wp);
   mpfr_const_euler_bs_init (sum);
   mpz_init (t);
-  mpz_init (u);
   mpz_init (v);
+  mpz_init (P2);
+  mpz_init (Q2);
+  mpz_init (T2);
 
   MPFR_ZIV_INIT (loop, wp);
   for (;;)
@@ -222,35 +417,52 @@ mpfr_const_euler_internal (mpfr_t x, mpfr_rnd_t rnd)
 
       /* V / ((T + Q) * D) = S / I
          where S = sum_{k=0}^{N-1} H_k n^(2k) / (k!)^2,
-               I = sum_{k=0}^{N-1} n^(2k) / (k!)^2 */
-      mpfr_const_euler_bs_1 (sum, 0, N, n, 0);
-      mpz_add (sum->T, sum->T, sum->Q);
-      mpz_mul (t, sum->T, sum->D);
-      mpz_mul_2exp (u, sum->V, wp);
-      mpz_tdiv_q (v, u, t);
+               I = sum_{k=0}^{N-1} n^(2k) / (k!)^2
+         C / (D * V) = U where
+         U = (1/(4n)) sum_{k=0}^{2n-1} [(2k)!]^3 / ((k!)^4 8^(2k) (2n)^(2k))
+         (C, D, V being the second series, computed in P2, Q2, T2 in the
+         threaded mode, and in sum->C, sum->D, sum->V otherwise) */
+      if (nthreads > 1)
+        {
+          for (i = 0; i < 2; i++)
+            {
+              task[i].what = i;
+              task[i].sum = sum;
+              task[i].P2 = P2;
+              task[i].Q2 = Q2;
+              task[i].T2 = T2;
+              task[i].y = y;
+              task[i].n = n;
+              task[i].N = N;
+              task[i].wp = wp;
+              task[i].nthreads = i == 0 ? 1 : nthreads - 1;
+            }
+          mpfr_parallel_run (mpfr_const_euler_task, task,
+                             sizeof (mpfr_const_euler_task_t), 2);
+          mpz_add (sum->T, sum->T, sum->Q);
+          task[0].what = 2;
+          task[0].q = v;
+          task[1].what = 3;
+          task[1].q = t;
+          mpfr_parallel_run (mpfr_const_euler_task, task,
+                             sizeof (mpfr_const_euler_task_t), 2);
+        }
+      else
+        {
+          mpfr_const_euler_bs_1 (sum, 0, N, n, 0, 1);
+          mpz_add (sum->T, sum->T, sum->Q);
+          mpfr_const_euler_q1 (v, sum, wp);
+          mpfr_const_euler_bs_2 (sum->C, sum->D, sum->V, 0, 2*n, n, 0, 1);
+          mpfr_const_euler_q2 (t, sum, sum->D, sum->V, wp);
+          mpfr_const_euler_log (y, n, wp);
+        }
       /* v * 2^-wp = S/I with error < 1 */
-
-      /* C / (D * V) = U where
-         U = (1/(4n)) sum_{k=0}^{2n-1} [(2k)!]^3 / ((k!)^4 8^(2k) (2n)^(2k)) */
-      mpfr_const_euler_bs_2 (sum->C, sum->D, sum->V, 0, 2*n, n, 0);
-      mpz_mul (t, sum->Q, sum->Q);
-      mpz_mul (t, t, sum->V);
-      mpz_mul (u, sum->T, sum->T);
-      mpz_mul (u, u, sum->D);
-      mpz_mul_2exp (t, t, wp);
-      mpz_div (t, t, u);
       /* t * 2^-wp = U/I^2 with error < 1 */
 
       /* gamma = S/I - U/I^2 - log(n) with error at most 2^-wp */
       mpz_sub (v, v, t);
       /* v * 2^-wp now equals gamma + log(n) with error at most 3*2^-wp */
 
-      /* log(n) < 2^ceil(log2(n)) */
-      magn = MPFR_INT_CEIL_LOG2(n);
-      mpfr_set_prec (y, wp + magn);
-      mpfr_set_ui (y, n, MPFR_RNDZ); /* exact */
-      mpfr_log (y, y, MPFR_RNDZ); /* error < 2^-wp */
-
       mpfr_mul_2exp (y, y, wp, MPFR_RNDZ);
       mpfr_z_sub (y, v, y, MPFR_RNDZ);
       mpfr_div_2exp (y, y, wp, MPFR_RNDZ);
@@ -268,8 +480,10 @@ mpfr_const_euler_internal (mpfr_t x, mpfr_rnd_t rnd)
 
   mpfr_clear (y);
   mpz_clear (t);
-  mpz_clear (u);
   mpz_clear (v);
+  mpz_clear (P2);
+  mpz_clear (Q2);
+  mpz_clear (T2);
   mpfr_const_euler_bs_clear (sum);
 
   return inexact; /* always inexact */
@@ -44,9 +44,62 @@ mpfr_const_log2 (mpfr_ptr x, mpfr_rnd_t rnd_mode) {
    Numerator is T[0], denominator is Q[0],
    Compute P[0] only when need_P is non-zero.
    Need 1+ceil(log(n2-n1)/log(2)) cells in T[],P[],Q[].
+   Use at most nthreads threads (see mpfr_bs_split).
 */
 static void
-S (mpz_t *T, mpz_t *P, mpz_t *Q, unsigned long n1, unsigned long n2, int need_P)
+S (mpz_t *T, mpz_t *P, mpz_t *Q, unsigned long n1, unsigned long n2,
+   int need_P, unsigned int nthreads);
+
+typedef struct {
+  mpz_t *T, *P, *Q;
+  int need_P;
+} mpfr_log2_S_t;
+
+static void
+S_task (void *p, unsigned long n1, unsigned long n2, unsigned int nthreads)
+{
+  mpfr_log2_S_t *s = (mpfr_log2_S_t *) p;
+
+  S (s->T, s->P, s->Q, n1, n2, s->need_P, nthreads);
+}
+
+/* Same as S (T, P, Q, n1, m, 1, ...) and S (T + 1, P + 1, Q + 1, m, n2,
+   need_P, ...), but with two parallel tasks; the second one needs its own
+   cells, since the first one uses T[1], P[1], Q[1]... as temporaries. */
+static void
+S_split (mpz_t *T, mpz_t *P, mpz_t *Q, unsigned long n1, unsigned long m,
+         unsigned long n2, int need_P, unsigned int nthreads)
+{
+  mpfr_log2_S_t s[2];
+  mpz_t *T2;
+  unsigned long lg, i;
+  MPFR_TMP_DECL(marker);
+
+  MPFR_TMP_MARK(marker);
+  lg = MPFR_INT_CEIL_LOG2 (n2 - m) + 1;
+  T2 = (mpz_t *) MPFR_TMP_ALLOC (3 * lg * sizeof (mpz_t));
+  for (i = 0; i < 3 * lg; i++)
+    mpz_init (T2[i]);
+  s[0].T = T;
+  s[0].P = P;
+  s[0].Q = Q;
+  s[0].need_P = 1;
+  s[1].T = T2;
+  s[1].P = T2 + lg;
+  s[1].Q = T2 + 2*lg;
+  s[1].need_P = need_P;
+  mpfr_bs_split (S_task, &s[0], &s[1], n1, m, n2, nthreads);
+  mpz_swap (T[1], T2[0]);
+  mpz_swap (P[1], T2[lg]);
+  mpz_swap (Q[1], T2[2*lg]);
+  for (i = 0; i < 3 * lg; i++)
+    mpz_clear (T2[i]);
+  MPFR_TMP_FREE(marker);
+}
+
+static void
+S (mpz_t *T, mpz_t *P, mpz_t *Q, unsigned long n1, unsigned long n2,
+   int need_P, unsigned int nthreads)
 {
   if (n2 == n1 + 1)
     {
@@ -72,15 +125,34 @@ S (mpz_t *T, mpz_t *P, mpz_t *Q, unsigned long n1, unsigned long n2, int need_P)
     {
       unsigned long m = (n1 / 2) + (n2 / 2) + (n1 & 1UL & n2);
       unsigned long v, w;
+      mpz_ptr r[4];
+      mpz_srcptr a[4], b[4];
 
-      S (T, P, Q, n1, m, 1);
-      S (T + 1, P + 1, Q + 1, m, n2, need_P);
-      mpz_mul (T[0], T[0], Q[1]);
-      mpz_mul (T[1], T[1], P[0]);
+      if (MPFR_BS_SPLIT_P (nthreads, n2 - n1))
+        S_split (T, P, Q, n1, m, n2, need_P, nthreads);
+      else
+        {
+          S (T, P, Q, n1, m, 1, 1);
+          S (T + 1, P + 1, Q + 1, m, n2, need_P, 1);
+        }
+      /* T[0] <- T[0]*Q[1], T[1] <- T[1]*P[0], Q[0] <- Q[0]*Q[1] and
+         P[0] <- P[0]*P[1] (computed in P[1] since P[0] is still read) */
+      r[0] = T[0];
+      a[0] = T[0];
+      b[0] = Q[1];
+      r[1] = T[1];
+      a[1] = T[1];
+      b[1] = P[0];
+      r[2] = Q[0];
+      a[2] = Q[0];
+      b[2] = Q[1];
+      r[3] = P[1];
+      a[3] = P[0];
+      b[3] = P[1];
+      mpfr_bs_mul (r, a, b, need_P ? 4 : 3, nthreads);
       mpz_add (T[0], T[0], T[1]);
       if (need_P)
-        mpz_mul (P[0], P[0], P[1]);
-      mpz_mul (Q[0], Q[0], Q[1]);
+        mpz_swap (P[0], P[1]);
 
       /* remove common trailing zeroes if any */
       v = mpz_scan1 (T[0], 0);
@@ -107,6 +179,126 @@ S (mpz_t *T, mpz_t *P, mpz_t *Q, unsigned long n1, unsigned long n2, int need_P)
     }
 }
 
+/* State of the binary splitting, kept from one computation to the next,
+   so that a computation at a larger precision only needs the new terms:
+   T/Q is the sum of the terms 0 to N-1 (as computed by S), and P/Q is the
+   product of the ratios, needed to append the following terms. Since the
+   common factors 2^v removed by S do not change T/Q, mpfr_set_z and
+   mpfr_div give exactly the same result as with S (T, P, Q, 0, N, 0).
+   It is kept along with the cache of log(2) (thus it is thread-local unless
+   the cache is shared), and has its own lock since mpfr_const_log2_internal
+   may also be called directly. The mpz_t's are allocated with the GMP
+   functions, not from the mpz_t cache, as they can live longer. */
+typedef struct {
+  unsigned long N;  /* 0 if not initialized */
+  MPFR_LOCK_DECL(lock)
+  mpz_t T, P, Q;
+} mpfr_log2_bs_t;
+
+#ifndef MPFR_USE_LOGGING
+static MPFR_CACHE_ATTR mpfr_log2_bs_t log2_bs = { 0 MPFR_LOCK_INITIALIZER };
+
+/* Set log2_bs to the terms from 0 to N-1, with N >= log2_bs.N, using at
+   most nthreads threads. */
+static void
+mpfr_log2_bs_extend (unsigned long N, unsigned int nthreads)
+{
+  mpz_t *T, *P, *Q;
+  unsigned long lgN, i, v, w;
+  mpz_ptr r[4];
+  mpz_srcptr a[4], b[4];
+  MPFR_TMP_DECL(marker);
+
+  MPFR_ASSERTD (N >= log2_bs.N);
+  if (N == log2_bs.N)
+    return;
+
+  MPFR_TMP_MARK(marker);
+  lgN = MPFR_INT_CEIL_LOG2 (N - log2_bs.N) + 1;
+  T  = (mpz_t *) MPFR_TMP_ALLOC (3 * lgN * sizeof (mpz_t));
+  P  = T + lgN;
+  Q  = T + 2*lgN;
+  for (i = 0; i < lgN; i++)
+    {
+      mpz_init (T[i]);
+      mpz_init (P[i]);
+      mpz_init (Q[i]);
+    }
+
+  if (log2_bs.N == 0)
+    {
+      (__gmpz_init) (log2_bs.T);
+      (__gmpz_init) (log2_bs.P);
+      (__gmpz_init) (log2_bs.Q);
+      S (T, P, Q, 0, N, 1, nthreads);
+      mpz_swap (log2_bs.T, T[0]);
+      mpz_swap (log2_bs.P, P[0]);
+      mpz_swap (log2_bs.Q, Q[0]);
+    }
+  else
+    {
+      /* same combination as in S, with the old terms on the left */
+      S (T, P, Q, log2_bs.N, N, 1, nthreads);
+      r[0] = log2_bs.T;
+      a[0] = log2_bs.T;
+      b[0] = Q[0];
+      r[1] = T[0];
+      a[1] = T[0];
+      b[1] = log2_bs.P;
+      r[2] = log2_bs.Q;
+      a[2] = log2_bs.Q;
+      b[2] = Q[0];
+      r[3] = P[0];
+      a[3] = log2_bs.P;
+      b[3] = P[0];
+      mpfr_bs_mul (r, a, b, 4, nthreads);
+      mpz_add (log2_bs.T, log2_bs.T, T[0]);
+      mpz_swap (log2_bs.P, P[0]);
+
+      v = mpz_scan1 (log2_bs.T, 0);
+      w = mpz_scan1 (log2_bs.Q, 0);
+      if (w < v)
+        v = w;
+      w = mpz_scan1 (log2_bs.P, 0);
+      if (w < v)
+        v = w;
+      if (v > 0)
+        {
+          mpz_fdiv_q_2exp (log2_bs.T, log2_bs.T, v);
+          mpz_fdiv_q_2exp (log2_bs.Q, log2_bs.Q, v);
+          mpz_fdiv_q_2exp (log2_bs.P, log2_bs.P, v);
+        }
+    }
+  log2_bs.N = N;
+
+  for (i = 0; i < lgN; i++)
+    {
+      mpz_clear (T[i]);
+      mpz_clear (P[i]);
+      mpz_clear (Q[i]);
+    }
+  MPFR_TMP_FREE(marker);
+}
+#endif
+
+/* Free the state of the binary splitting (called by mpfr_free_cache2,
+   together with the cache of log(2)). */
+void
+mpfr_const_log2_freecache (void)
+{
+#ifndef MPFR_USE_LOGGING
+  MPFR_LOCK_WRITE (log2_bs.lock);
+  if (log2_bs.N != 0)
+    {
+      (__gmpz_clear) (log2_bs.T);
+      (__gmpz_clear) (log2_bs.P);
+      (__gmpz_clear) (log2_bs.Q);
+      log2_bs.N = 0;
+    }
+  MPFR_UNLOCK (log2_bs.lock);
+#endif
+}
+
 /* Don't need to save / restore exponent range: the cache does it */
 int
 mpfr_const_log2_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
@@ -119,6 +311,7 @@ mpfr_const_log2_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
   int inexact;
   int ok = 1; /* ensures that the 1st try will give correct rounding */
   unsigned long lgN, i;
+  unsigned int nthreads = mpfr_get_nthreads ();
   MPFR_GROUP_DECL(group);
   MPFR_TMP_DECL(marker);
   MPFR_ZIV_DECL(loop);
@@ -157,6 +350,23 @@ mpfr_const_log2_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
       /* the following are needed for error analysis (see algorithms.tex) */
       MPFR_ASSERTD(w >= 3 && N >= 2);
 
+#ifndef MPFR_USE_LOGGING
+      /* Usual case (from mpfr_cache, with an increasing precision): only
+         compute the new terms. With logging, mpfr_set_z and mpfr_div could
+         call this function recursively. */
+      MPFR_LOCK_WRITE (log2_bs.lock);
+      if (N >= log2_bs.N)
+        {
+          mpfr_log2_bs_extend (N, nthreads);
+          mpfr_set_z (t, log2_bs.T, MPFR_RNDN);
+          mpfr_set_z (q, log2_bs.Q, MPFR_RNDN);
+          MPFR_UNLOCK (log2_bs.lock);
+          mpfr_div (t, t, q, MPFR_RNDN);
+          goto can_round;
+        }
+      MPFR_UNLOCK (log2_bs.lock);
+#endif
+
       lgN = MPFR_INT_CEIL_LOG2 (N) + 1;
       T  = (mpz_t *) MPFR_TMP_ALLOC (3 * lgN * sizeof (mpz_t));
       P  = T + lgN;
@@ -168,7 +378,7 @@ mpfr_const_log2_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
           mpz_init (Q[i]);
         }
 
-      S (T, P, Q, 0, N, 0);
+      S (T, P, Q, 0, N, 0, nthreads);
 
       mpfr_set_z (t, T[0], MPFR_RNDN);
       mpfr_set_z (q, Q[0], MPFR_RNDN);
@@ -181,6 +391,9 @@ mpfr_const_log2_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
           mpz_clear (Q[i]);
         }
 
+#ifndef MPFR_USE_LOGGING
+    can_round:
+#endif
       if (MPFR_LIKELY (ok != 0
                        || mpfr_can_round (t, w - 2, MPFR_RNDN, rnd_mode, n)))
         break;
@@ -175,8 +175,15 @@ mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 
   K0 = __gmpfr_isqrt (precy / 3);
   m = precy + 2 * MPFR_INT_CEIL_LOG2 (precy) + 2 * K0;
+  MPFR_ZIV_ADAPT (loop, m);
 
-  if (expx >= 3)
+  if (expx >= MPFR_PAYNE_HANEK_THRESHOLD)
+    {
+      /* reduce with mpfr_payne_hanek, c is not needed */
+      reduce = 2;
+      mpfr_init2 (xr, m);
+    }
+  else if (expx >= 3)
     {
       reduce = 1;
       /* As expx + m - 1 will silently be converted into mpfr_prec_t
@@ -202,9 +209,15 @@ mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
          It follows |cos(xr) - cos(x)| <= 2^(2-m). */
       if (reduce)
         {
-          mpfr_const_pi (c, MPFR_RNDN);
-          mpfr_mul_2ui (c, c, 1, MPFR_RNDN); /* 2Pi */
-          mpfr_remainder (xr, x, c, MPFR_RNDN);
+          if (reduce == 2)
+            /* same bound |xr - x - 2kPi| <= 2^(2-m) */
+            mpfr_payne_hanek (xr, NULL, x);
+          else
+            {
+              mpfr_const_pi (c, MPFR_RNDN);
+              mpfr_mul_2ui (c, c, 1, MPFR_RNDN); /* 2Pi */
+              mpfr_remainder (xr, x, c, MPFR_RNDN);
+            }
           if (MPFR_IS_ZERO(xr))
             goto ziv_next;
           /* now |xr| <= 4, thus r <= 16 below */
@@ -279,19 +292,17 @@ mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       MPFR_ZIV_NEXT (loop, m);
       MPFR_GROUP_REPREC_2 (group, m, r, s);
       if (reduce)
-        {
-          mpfr_set_prec (xr, m);
-          mpfr_set_prec (c, expx + m - 1);
-        }
+        mpfr_set_prec (xr, m);
+      if (reduce == 1)
+        mpfr_set_prec (c, expx + m - 1);
     }
   MPFR_ZIV_FREE (loop);
   inexact = mpfr_set (y, s, rnd_mode);
   MPFR_GROUP_CLEAR (group);
   if (reduce)
-    {
-      mpfr_clear (xr);
-      mpfr_clear (c);
-    }
+    mpfr_clear (xr);
+  if (reduce == 1)
+    mpfr_clear (c);
 
  end:
   MPFR_SAVE_EXPO_FREE (expo);
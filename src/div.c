@@ -224,9 +224,12 @@ mpfr_div_with_mpz_tdiv_q (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v,
      in posiiton less than GMP_NUMB_BITS+1.
      For rounding to nearest, the first set bit has to be in position less
      than GMP_NUMB_BITS-1 for k=0 (or less than GMP_NUMB_BITS for k=1).
+     For faithful rounding, since the error is less than 4 ulps of qm,
+     thus much less than 1/2 ulp of q, no check is needed.
   */
-  if (mpz_scan1 (qm, k + 1) < GMP_NUMB_BITS + k - (rnd_mode == MPFR_RNDN) &&
-      mpz_scan0 (qm, k + 1) < GMP_NUMB_BITS + k - (rnd_mode == MPFR_RNDN))
+  if (rnd_mode == MPFR_RNDF ||
+      (mpz_scan1 (qm, k + 1) < GMP_NUMB_BITS + k - (rnd_mode == MPFR_RNDN) &&
+       mpz_scan0 (qm, k + 1) < GMP_NUMB_BITS + k - (rnd_mode == MPFR_RNDN)))
     {
       MPFR_SAVE_EXPO_DECL (expo);
       ok = 1;
@@ -250,6 +253,165 @@ mpfr_div_with_mpz_tdiv_q (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v,
   return ok;
 }
 
+/* Special code for PREC(q) < GMP_NUMB_BITS and u, v with one limb each:
+   the quotient is computed with a single udiv_qrnnd and rounded inline.
+   If dinv is not NULL, it points to invert_limb (v0), and the quotient is
+   computed with udiv_qrnnd_preinv (see mpfr_div_pre). */
+static int
+mpfr_div_1 (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode,
+            mpfr_prec_t p, const mp_limb_t *dinv)
+{
+  mpfr_exp_t qx;
+  int sign, inex;
+  mpfr_prec_t sh = GMP_NUMB_BITS - p;
+  mp_limb_t u0 = MPFR_MANT (u)[0], v0 = MPFR_MANT (v)[0];
+  mp_limb_t q0, rb, sb, mask = MPFR_LIMB_MASK (sh);
+
+  MPFR_ASSERTD (p < GMP_NUMB_BITS);
+
+  sign = MPFR_MULT_SIGN (MPFR_SIGN (u), MPFR_SIGN (v));
+  qx = MPFR_GET_EXP (u) - MPFR_GET_EXP (v);
+  if (u0 >= v0)
+    {
+      /* u0/v0 is in [1, 2): we divide (u0 - v0) * B by v0 and shift the
+         quotient right by one bit, putting back the leading 1 */
+      if (dinv != NULL)
+        udiv_qrnnd_preinv (q0, sb, u0 - v0, 0, v0, *dinv);
+      else
+        udiv_qrnnd (q0, sb, u0 - v0, 0, v0);
+      sb |= q0 & MPFR_LIMB_ONE;
+      q0 = MPFR_LIMB_HIGHBIT | (q0 >> 1);
+      qx ++;
+    }
+  else if (dinv != NULL)
+    udiv_qrnnd_preinv (q0, sb, u0, 0, v0, *dinv);
+  else
+    udiv_qrnnd (q0, sb, u0, 0, v0);
+  rb = q0 & (MPFR_LIMB_ONE << (sh - 1));
+  sb |= (q0 & mask) ^ rb;
+  q0 &= ~mask;
+
+  MPFR_SET_SIGN (q, sign);
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inex = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (q0 & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF || MPFR_IS_LIKE_RNDZ (rnd_mode,
+                                                         MPFR_IS_NEG (q)))
+    inex = -1; /* truncate */
+  else
+    {
+      inex = 1;
+      q0 += MPFR_LIMB_ONE << sh;
+      if (MPFR_UNLIKELY (q0 == 0))
+        {
+          q0 = MPFR_LIMB_HIGHBIT;
+          /* qx may be MPFR_EXP_MAX here, since EXP(u) - EXP(v) + 1 can
+             reach it: then one will still get an overflow */
+          if (MPFR_LIKELY (qx < MPFR_EXP_MAX))
+            qx ++;
+        }
+    }
+
+  MPFR_MANT (q)[0] = q0;
+  if (MPFR_UNLIKELY (qx > __gmpfr_emax))
+    return mpfr_overflow (q, rnd_mode, sign);
+  if (MPFR_UNLIKELY (qx < __gmpfr_emin))
+    {
+      /* same as in the generic code below */
+      if (rnd_mode == MPFR_RNDN &&
+          (qx < __gmpfr_emin - 1 ||
+           (inex >= 0 && q0 == MPFR_LIMB_HIGHBIT)))
+        rnd_mode = MPFR_RNDZ;
+      return mpfr_underflow (q, rnd_mode, sign);
+    }
+  MPFR_SET_EXP (q, qx);
+  MPFR_RET (inex * MPFR_INT_SIGN (q));
+}
+
+/* Special code for GMP_NUMB_BITS < PREC(q) < 2*GMP_NUMB_BITS and u, v with
+   two limbs each: the two quotient limbs are obtained with udiv_qr_3by2,
+   using the 3/2 inverse of the divisor, which is computed unless dinv is
+   not NULL and points to it (see mpfr_div_pre). */
+static int
+mpfr_div_2 (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode,
+            mpfr_prec_t p, const mpfr_pi1_t *dinv)
+{
+  mpfr_exp_t qx;
+  int sign, inex;
+  mpfr_prec_t sh = 2 * GMP_NUMB_BITS - p;
+  mp_limb_t u1 = MPFR_MANT (u)[1], u0 = MPFR_MANT (u)[0];
+  mp_limb_t v1 = MPFR_MANT (v)[1], v0 = MPFR_MANT (v)[0];
+  mp_limb_t q1, q0, r1, r0, rb, sb, mask = MPFR_LIMB_MASK (sh);
+  mpfr_pi1_t inv;
+  int extra;
+
+  MPFR_ASSERTD (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS);
+
+  sign = MPFR_MULT_SIGN (MPFR_SIGN (u), MPFR_SIGN (v));
+  qx = MPFR_GET_EXP (u) - MPFR_GET_EXP (v);
+  extra = u1 > v1 || (u1 == v1 && u0 >= v0);
+  if (extra)
+    sub_ddmmss (u1, u0, u1, u0, v1, v0);
+
+  /* now {u1, u0} < {v1, v0}, thus both partial quotients fit in a limb */
+  if (dinv != NULL)
+    inv = *dinv;
+  else
+    invert_pi1 (inv, v1, v0);
+  udiv_qr_3by2 (q1, r1, r0, u1, u0, MPFR_LIMB_ZERO, v1, v0, inv.inv32);
+  udiv_qr_3by2 (q0, u1, u0, r1, r0, MPFR_LIMB_ZERO, v1, v0, inv.inv32);
+  sb = u1 | u0;
+
+  if (extra)
+    {
+      /* the quotient is in [1, 2) */
+      sb |= q0 & MPFR_LIMB_ONE;
+      q0 = (q1 << (GMP_NUMB_BITS - 1)) | (q0 >> 1);
+      q1 = MPFR_LIMB_HIGHBIT | (q1 >> 1);
+      qx ++;
+    }
+  rb = q0 & (MPFR_LIMB_ONE << (sh - 1));
+  sb |= (q0 & mask) ^ rb;
+  q0 &= ~mask;
+
+  MPFR_SET_SIGN (q, sign);
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inex = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (q0 & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF || MPFR_IS_LIKE_RNDZ (rnd_mode,
+                                                         MPFR_IS_NEG (q)))
+    inex = -1; /* truncate */
+  else
+    {
+      inex = 1;
+      q0 += MPFR_LIMB_ONE << sh;
+      q1 += q0 == 0;
+      if (MPFR_UNLIKELY (q1 == 0 && q0 == 0))
+        {
+          q1 = MPFR_LIMB_HIGHBIT;
+          if (MPFR_LIKELY (qx < MPFR_EXP_MAX))
+            qx ++;
+        }
+    }
+
+  MPFR_MANT (q)[0] = q0;
+  MPFR_MANT (q)[1] = q1;
+  if (MPFR_UNLIKELY (qx > __gmpfr_emax))
+    return mpfr_overflow (q, rnd_mode, sign);
+  if (MPFR_UNLIKELY (qx < __gmpfr_emin))
+    {
+      if (rnd_mode == MPFR_RNDN &&
+          (qx < __gmpfr_emin - 1 ||
+           (inex >= 0 && q1 == MPFR_LIMB_HIGHBIT && q0 == 0)))
+        rnd_mode = MPFR_RNDZ;
+      return mpfr_underflow (q, rnd_mode, sign);
+    }
+  MPFR_SET_EXP (q, qx);
+  MPFR_RET (inex * MPFR_INT_SIGN (q));
+}
+
 MPFR_HOT_FUNCTION_ATTR int
 mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
 {
@@ -347,6 +509,13 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
    *                                                                        *
    **************************************************************************/
 
+  if (MPFR_GET_PREC (q) < GMP_NUMB_BITS && usize == 1 && vsize == 1)
+    return mpfr_div_1 (q, u, v, rnd_mode, MPFR_GET_PREC (q), NULL);
+
+  if (GMP_NUMB_BITS < MPFR_GET_PREC (q) &&
+      MPFR_GET_PREC (q) < 2 * GMP_NUMB_BITS && usize == 2 && vsize == 2)
+    return mpfr_div_2 (q, u, v, rnd_mode, MPFR_GET_PREC (q), NULL);
+
   /* when the divisor has one limb, we can use mpfr_div_ui, which should be
      faster, assuming there is no intermediate overflow or underflow.
      The divisor interpreted as an integer satisfies
@@ -417,7 +586,11 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
   /* sh is the number of zero bits in the low limb of the quotient */
   MPFR_UNSIGNED_MINUS_MODULO(sh, MPFR_PREC(q));
 
-  like_rndz = rnd_mode == MPFR_RNDZ ||
+  /* When the quotient is computed exactly (i.e., except with Mulders'
+     short division), MPFR_RNDF is handled like MPFR_RNDZ, which is the
+     cheapest mode since neither the round bit nor an extra limb of the
+     quotient are needed. */
+  like_rndz = rnd_mode == MPFR_RNDZ || rnd_mode == MPFR_RNDF ||
     rnd_mode == (sign_quotient < 0 ? MPFR_RNDU : MPFR_RNDD);
 
   /**************************************************************************
@@ -461,8 +634,12 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
       p = n * GMP_NUMB_BITS - MPFR_INT_CEIL_LOG2 (2 * n + 2);
       /* if qh is 1, then we need only PREC(q)-1 bits of {qp,n},
          if rnd=RNDN, we need to be able to round with a directed rounding
-            and one more bit */
-      if (MPFR_LIKELY (mpfr_round_p (qp, n, p,
+            and one more bit,
+         if rnd=RNDF, the error must be at most 1/2 ulp, in which case the
+            rounding to nearest of the approximation is faithful */
+      if (MPFR_LIKELY (rnd_mode == MPFR_RNDF ?
+                       p > MPFR_PREC(q) - qh :
+                       mpfr_round_p (qp, n, p,
                                  MPFR_PREC(q) + (rnd_mode == MPFR_RNDN) - qh)))
         {
           /* we can round correctly whatever the rounding mode */
@@ -475,8 +652,8 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
             }
           q0p[0] &= ~MPFR_LIMB_MASK(sh); /* put to zero low sh bits */
 
-          if (rnd_mode == MPFR_RNDN) /* round to nearest */
-            {
+          if (rnd_mode == MPFR_RNDN || rnd_mode == MPFR_RNDF)
+            { /* round to nearest */
               /* we know we can round, thus we are never in the even rule case:
                  if the round bit is 0, we truncate
                  if the round bit is 1, we add 1 */
@@ -937,3 +1114,133 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
   inex *= sign_quotient;
   MPFR_RET (inex);
 }
+
+/* Divisor with precomputed data, for several divisions by the same number:
+   the inverse of the divisor limb (for mpfr_div_1), the 3/2 inverse of
+   the two divisor limbs (for mpfr_div_2), or, for large precisions, an
+   approximation of the inverse of the significand, computed once with
+   PREC(v) + 2*GMP_NUMB_BITS bits, so that u/v is obtained with a single
+   multiplication (see mpfr_div_pre_inv). */
+
+void
+mpfr_divisor_init (mpfr_divisor_ptr d, mpfr_srcptr v)
+{
+  mpfr_ptr dv = &d->_mpfr_v, inv = &d->_mpfr_inv;
+  mpfr_prec_t p = MPFR_PREC (v);
+  mp_size_t n = MPFR_LIMB_SIZE (v);
+
+  mpfr_init2 (dv, p);
+  MPFR_SIGN (dv) = MPFR_SIGN (v);
+  MPFR_EXP (dv) = MPFR_EXP (v);
+  d->_mpfr_dinv = MPFR_LIMB_ZERO;
+  MPFR_MANT (inv) = NULL;
+  if (MPFR_IS_SINGULAR (v))
+    return;
+
+  MPN_COPY (MPFR_MANT (dv), MPFR_MANT (v), n);
+  if (n == 1)
+    invert_limb (d->_mpfr_dinv, MPFR_MANT (v)[0]);
+  else if (n == 2)
+    {
+      mpfr_pi1_t dinv;
+
+      invert_pi1 (dinv, MPFR_MANT (v)[1], MPFR_MANT (v)[0]);
+      d->_mpfr_dinv = dinv.inv32;
+    }
+
+  /* the inverse is used for PREC(q) <= PREC(v) + GMP_NUMB_BITS only */
+  if (MPFR_PREC2LIMBS (p + GMP_NUMB_BITS) >= MPFR_DIV_PRE_THRESHOLD)
+    {
+      mpfr_t w;
+      MPFR_SAVE_EXPO_DECL (expo);
+
+      MPFR_ALIAS (w, v, MPFR_SIGN_POS, 0);
+      mpfr_init2 (inv, p + 2 * GMP_NUMB_BITS);
+      MPFR_SAVE_EXPO_MARK (expo);
+      mpfr_ui_div (inv, 1, w, MPFR_RNDN);
+      MPFR_SAVE_EXPO_FREE (expo);
+    }
+}
+
+void
+mpfr_divisor_clear (mpfr_divisor_ptr d)
+{
+  mpfr_clear (&d->_mpfr_v);
+  if (MPFR_MANT (&d->_mpfr_inv) != NULL)
+    mpfr_clear (&d->_mpfr_inv);
+}
+
+/* Try to compute q = u/v with the approximate inverse of d, for
+   PREC(q) + GMP_NUMB_BITS <= PREC(inv) and no possible overflow or
+   underflow. If the correct rounding can be determined, return 1 and put
+   the ternary value in inex, otherwise return 0 (q is then unchanged). */
+static int
+mpfr_div_pre_inv (mpfr_ptr q, mpfr_srcptr u, mpfr_divisor_srcptr d,
+                  mpfr_rnd_t rnd_mode, int *inex)
+{
+  mpfr_srcptr v = &d->_mpfr_v;
+  mpfr_prec_t w = MPFR_PREC (q) + GMP_NUMB_BITS;
+  mpfr_exp_t qx;
+  mpfr_t t, uu;
+  mpfr_limb_ptr tp;
+  int ok;
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_TMP_DECL (marker);
+
+  /* u/v = (u'/v') * 2^qx with u', v' in [1/2,1), and u'/v' rounded to
+     PREC(q) bits is in [1/2,2], thus its exponent is 0, 1 or 2 */
+  qx = MPFR_GET_EXP (u) - MPFR_GET_EXP (v);
+  if (qx < __gmpfr_emin || qx > __gmpfr_emax - 2)
+    return 0;
+
+  MPFR_TMP_MARK (marker);
+  MPFR_TMP_INIT (tp, t, w, MPFR_PREC2LIMBS (w));
+  MPFR_ALIAS (uu, u, MPFR_MULT_SIGN (MPFR_SIGN (u), MPFR_SIGN (v)), 0);
+  MPFR_SAVE_EXPO_MARK (expo);
+  /* inv = 1/v' (1 + a) and t = uu * inv (1 + b) with |a|, |b| <= 2^(-w),
+     thus |t - u'/v'| < |t| 2^(2-w) < 2^(EXP(t)-(w-2)) */
+  mpfr_mul (t, uu, &d->_mpfr_inv, MPFR_RNDN);
+  ok = MPFR_CAN_ROUND (t, w - 2, MPFR_PREC (q), rnd_mode);
+  if (ok)
+    *inex = mpfr_set (q, t, rnd_mode);
+  MPFR_SAVE_EXPO_FREE (expo);
+  MPFR_TMP_FREE (marker);
+  if (ok)
+    MPFR_SET_EXP (q, MPFR_GET_EXP (q) + qx);
+  return ok;
+}
+
+/* Same as mpfr_div (q, u, v, rnd_mode) where d was initialized from v:
+   the result, the ternary value and the flags are the same. */
+int
+mpfr_div_pre (mpfr_ptr q, mpfr_srcptr u, mpfr_divisor_srcptr d,
+              mpfr_rnd_t rnd_mode)
+{
+  mpfr_srcptr v = &d->_mpfr_v;
+  mpfr_prec_t p = MPFR_GET_PREC (q);
+  mp_size_t usize = MPFR_LIMB_SIZE (u);
+  mp_size_t vsize = MPFR_LIMB_SIZE (v);
+  int inex;
+
+  if (MPFR_UNLIKELY (MPFR_ARE_SINGULAR (u, v)))
+    return mpfr_div (q, u, v, rnd_mode);
+
+  if (p < GMP_NUMB_BITS && usize == 1 && vsize == 1)
+    return mpfr_div_1 (q, u, v, rnd_mode, p, &d->_mpfr_dinv);
+
+  if (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS && usize == 2 && vsize == 2)
+    {
+      mpfr_pi1_t dinv;
+
+      dinv.inv32 = d->_mpfr_dinv;
+      return mpfr_div_2 (q, u, v, rnd_mode, p, &dinv);
+    }
+
+  if (MPFR_MANT (&d->_mpfr_inv) != NULL &&
+      MPFR_LIMB_SIZE (q) >= MPFR_DIV_PRE_THRESHOLD &&
+      p + GMP_NUMB_BITS <= MPFR_PREC (&d->_mpfr_inv) &&
+      mpfr_div_pre_inv (q, u, d, rnd_mode, &inex))
+    MPFR_RET (inex);
+
+  return mpfr_div (q, u, v, rnd_mode);
+}
@@ -0,0 +1,211 @@
+/* mpfr_dot -- correctly rounded dot product of two arrays
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* Set r to x[0]*y[0] + ... + x[n-1]*y[n-1], correctly rounded.
+
+   The exact products x[i]*y[i] are computed with the mpn layer into a
+   temporary block of limbs (no allocation per product, and no rounding
+   code), and added to an accumulator (see acc.c) as soon as they are
+   computed, so that the memory does not depend on n, but only on the
+   precisions and the exponents of the products. The only rounding is the
+   final one, done by mpfr_acc_get.
+
+   Adding a product to the accumulator costs more than its part in
+   mpfr_sum, which only reads the bits needed for the rounding. So when the
+   products take at most MPFR_DOT_KEEP_MAX limbs in total, they are all
+   computed first, and summed by mpfr_sum_wide from their exponents (sums
+   of two exponents, which are representable, while a product may be
+   outside the extended exponent range). This is also done for any number
+   of products if one of them is too close to the bounds of the maximum
+   exponent range for the accumulator (see MPFR_ACC_LSB_MIN). */
+
+/* Set {zp, xn+yn} to the product of the significands of the regular
+   numbers x and y, and return the weight of the least significant bit. */
+static mpfr_exp_t
+dot_mul (mp_limb_t *zp, mpfr_srcptr x, mpfr_srcptr y)
+{
+  mp_size_t xn = MPFR_LIMB_SIZE (x), yn = MPFR_LIMB_SIZE (y);
+  mp_limb_t *xp = MPFR_MANT (x), *yp = MPFR_MANT (y);
+
+  if (xn == 1 && yn == 1)
+    umul_ppmm (zp[1], zp[0], xp[0], yp[0]);
+  else if (xn >= yn)
+    mpn_mul (zp, xp, xn, yp, yn);
+  else
+    mpn_mul (zp, yp, yn, xp, xn);
+  return MPFR_GET_EXP (x) + MPFR_GET_EXP (y)
+    - (mpfr_exp_t) (xn + yn) * GMP_NUMB_BITS;
+}
+
+/* Compute the rn regular products, then sum them with mpfr_sum_wide (see
+   above). zs is the total number of limbs of these products. */
+static int
+dot_sum (mpfr_ptr r, mpfr_ptr *const x, mpfr_ptr *const y, unsigned long n,
+          unsigned long rn, mp_size_t zs, mpfr_rnd_t rnd)
+{
+  mpfr_wide_term_t *p;  /* the products with their exponents */
+  mpfr_ptr z;           /* headers of the products */
+  mp_limb_t *zp;        /* limbs of the products */
+  mpfr_exp_t e;
+  unsigned long i;
+  int inex;
+  MPFR_TMP_DECL (marker);
+
+  MPFR_TMP_MARK (marker);
+  zp = MPFR_TMP_LIMBS_ALLOC (zs);
+  z = (mpfr_ptr) MPFR_TMP_ALLOC (rn * sizeof (__mpfr_struct));
+  p = (mpfr_wide_term_t *) MPFR_TMP_ALLOC (rn * sizeof (mpfr_wide_term_t));
+
+  for (i = 0, rn = 0; i < n; i++)
+    if (! MPFR_IS_SINGULAR (x[i]) && ! MPFR_IS_SINGULAR (y[i]))
+      {
+        mp_size_t pn = MPFR_LIMB_SIZE (x[i]) + MPFR_LIMB_SIZE (y[i]);
+
+        dot_mul (zp, x[i], y[i]);
+        e = MPFR_GET_EXP (x[i]) + MPFR_GET_EXP (y[i]);
+        if (MPFR_LIMB_MSB (zp[pn - 1]) == 0)
+          {
+            mpn_lshift (zp, zp, pn, 1);
+            e--;
+          }
+        MPFR_TMP_INIT1 (zp, z + rn, pn * GMP_NUMB_BITS);
+        MPFR_SET_SIGN (z + rn, MPFR_MULT_SIGN (MPFR_SIGN (x[i]),
+                                               MPFR_SIGN (y[i])));
+        p[rn].e = e;
+        p[rn].z = z + rn;
+        rn++;
+        zp += pn;
+      }
+
+  inex = mpfr_sum_wide (r, p, rn, rnd);
+  MPFR_TMP_FREE (marker);
+  return inex;
+}
+
+int
+mpfr_dot (mpfr_ptr r, mpfr_ptr *const x, mpfr_ptr *const y, unsigned long n,
+          mpfr_rnd_t rnd)
+{
+  mpfr_acc_t acc;
+  mp_limb_t *zp;        /* limbs of the current product */
+  mp_size_t zs = 0;     /* total number of limbs of the products */
+  mp_size_t zmax = 0;   /* maximum number of limbs of a product */
+  mpfr_exp_t e;
+  unsigned long i, rn = 0;  /* rn: number of regular products */
+  int sign_inf = 0, sign_zero = 0, wide = 0, inex;
+  MPFR_TMP_DECL (marker);
+
+  MPFR_LOG_FUNC
+    (("n=%lu rnd=%d", n, rnd),
+     ("r[%Pu]=%.*Rg inexact=%d",
+      mpfr_get_prec (r), mpfr_log_prec, r, inex));
+
+  /* First pass: special values (with the same rules as a succession of
+     mpfr_mul and mpfr_add in infinite precision), and sizes of the
+     regular products. */
+  for (i = 0; i < n; i++)
+    {
+      int sign = MPFR_MULT_SIGN (MPFR_SIGN (x[i]), MPFR_SIGN (y[i]));
+
+      if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (x[i]) ||
+                         MPFR_IS_SINGULAR (y[i])))
+        {
+          if (MPFR_IS_NAN (x[i]) || MPFR_IS_NAN (y[i]))
+            {
+            nan:
+              MPFR_SET_NAN (r);
+              MPFR_RET_NAN;
+            }
+          else if (MPFR_IS_INF (x[i]) || MPFR_IS_INF (y[i]))
+            {
+              /* 0 * Inf is NaN, as well as +Inf + -Inf */
+              if (MPFR_IS_ZERO (x[i]) || MPFR_IS_ZERO (y[i]))
+                goto nan;
+              if (sign_inf == 0)
+                sign_inf = sign;
+              else if (sign != sign_inf)
+                goto nan;
+            }
+          else if (sign_zero == 0)
+            sign_zero = sign;
+          else if (sign != sign_zero)
+            sign_zero = rnd == MPFR_RNDD ? -1 : 1;
+        }
+      else
+        {
+          mp_size_t pn = MPFR_LIMB_SIZE (x[i]) + MPFR_LIMB_SIZE (y[i]);
+
+          /* The bits of the product have weights in [e - pn*B, e), where
+             e is at least 2 * MPFR_EMIN_MIN, thus representable. */
+          e = MPFR_GET_EXP (x[i]) + MPFR_GET_EXP (y[i]);
+          if (MPFR_UNLIKELY (e > MPFR_ACC_MSB_MAX || e < MPFR_ACC_LSB_MIN ||
+                             (mpfr_uexp_t) e - (mpfr_uexp_t) MPFR_ACC_LSB_MIN
+                             < (mpfr_uexp_t) pn * GMP_NUMB_BITS))
+            wide = 1;
+          zs += pn;
+          if (pn > zmax)
+            zmax = pn;
+          rn++;
+        }
+    }
+
+  if (MPFR_UNLIKELY (sign_inf != 0))
+    {
+      MPFR_SET_INF (r);
+      MPFR_SET_SIGN (r, sign_inf);
+      MPFR_RET (0);
+    }
+
+  if (MPFR_UNLIKELY (rn == 0))
+    {
+      /* All the products are zeros (or n = 0, in which case the sum is +0,
+         as with mpfr_sum). The zero products do not matter otherwise. */
+      MPFR_SET_ZERO (r);
+      MPFR_SET_SIGN (r, sign_zero == 0 ? MPFR_SIGN_POS : sign_zero);
+      MPFR_RET (0);
+    }
+
+  if (zs <= MPFR_DOT_KEEP_MAX || MPFR_UNLIKELY (wide))
+    return dot_sum (r, x, y, n, rn, zs, rnd);
+
+  /* Second pass: accumulate the exact regular products. */
+  MPFR_TMP_MARK (marker);
+  zp = MPFR_TMP_LIMBS_ALLOC (zmax);
+  mpfr_acc_init (acc);
+  for (i = 0; i < n; i++)
+    if (! MPFR_IS_SINGULAR (x[i]) && ! MPFR_IS_SINGULAR (y[i]))
+      {
+        mp_size_t pn = MPFR_LIMB_SIZE (x[i]) + MPFR_LIMB_SIZE (y[i]);
+
+        e = dot_mul (zp, x[i], y[i]);
+        mpfr_acc_add_raw (acc, zp, pn, e,
+                          MPFR_MULT_SIGN (MPFR_SIGN (x[i]),
+                                          MPFR_SIGN (y[i])) < 0);
+      }
+  inex = mpfr_acc_get (r, acc, rnd);
+  mpfr_acc_clear (acc);
+  MPFR_TMP_FREE (marker);
+  return inex;
+}
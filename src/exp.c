@@ -178,7 +178,9 @@ mpfr_exp (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       else
         {
           MPFR_SAVE_EXPO_MARK (expo);
-          inexact = mpfr_exp_2 (y, x, rnd_mode); /* O(n^(1/3) M(n)) */
+          if (precy > MPFR_EXPLOG_TAB_THRESHOLD ||
+              ! mpfr_exp_tab (y, x, rnd_mode, &inexact)) /* tables */
+            inexact = mpfr_exp_2 (y, x, rnd_mode); /* O(n^(1/3) M(n)) */
           MPFR_SAVE_EXPO_UPDATE_FLAGS (expo, __gmpfr_flags);
           MPFR_SAVE_EXPO_FREE (expo);
         }
@@ -23,6 +23,23 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #define MPFR_NEED_LONGLONG_H /* for MPFR_MPZ_SIZEINBASE2 */
 #include "mpfr-impl.h"
 
+/* S[k] <- S[k]*ptoj, S[k-1] <- S[k-1]*Q[k], Q[k-1] <- Q[k-1]*Q[k] */
+static void
+mpfr_exp_mul3 (mpz_t *S, mpz_srcptr ptoj, mpz_t *Q, int k,
+               unsigned int nthreads)
+{
+  mpz_ptr r[3];
+  mpz_srcptr b[3];
+
+  r[0] = S[k];
+  b[0] = ptoj;
+  r[1] = S[k-1];
+  b[1] = Q[k];
+  r[2] = Q[k-1];
+  b[2] = Q[k];
+  mpfr_bs_mul (r, (mpz_srcptr *) r, b, 3, nthreads);
+}
+
 /* y <- exp(p/2^r) within 1 ulp, using 2^m terms from the series
    Assume |p/2^r| < 1.
    We use the following binary splitting formula:
@@ -37,10 +54,14 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 
    Since Q(a,b) is divisible by 2^(r*(b-a-1)), we don't compute the power of
    two part.
+
+   The three products of a combination step may be done by parallel tasks,
+   with at most nthreads threads (see mpfr_bs_mul); since these products are
+   exact, this does not change the result.
 */
 static void
 mpfr_exp_rational (mpfr_ptr y, mpz_ptr p, long r, int m,
-                   mpz_t *Q, mpfr_prec_t *mult)
+                   mpz_t *Q, mpfr_prec_t *mult, unsigned int nthreads)
 {
   mp_bitcnt_t n, i, j;  /* unsigned type, which is >= unsigned long */
   mpz_t *S, *ptoj;
@@ -89,15 +110,13 @@ mpfr_exp_rational (mpfr_ptr y, mpz_ptr p, long r, int m,
       while ((j & 1) == 0) /* combine and reduce */
         {
           /* invariant: S[k] corresponds to 2^l consecutive terms */
-          mpz_mul (S[k], S[k], ptoj[l]);
-          mpz_mul (S[k-1], S[k-1], Q[k]);
+          mpfr_exp_mul3 (S, ptoj[l], Q, k, nthreads);
           /* Q[k] corresponds to 2^l consecutive terms too.
              Since it does not contains the factor 2^(r*2^l),
              when going from l to l+1 we need to multiply
              by 2^(r*2^(l+1))/2^(r*2^l) = 2^(r*2^l) */
           mpz_mul_2exp (S[k-1], S[k-1], r << l);
           mpz_add (S[k-1], S[k-1], S[k]);
-          mpz_mul (Q[k-1], Q[k-1], Q[k]);
           log2_nb_terms[k-1] ++; /* number of terms in S[k-1]
                                     is a power of 2 by construction */
           MPFR_MPZ_SIZEINBASE2 (prec_i_have, Q[k]);
@@ -118,12 +137,10 @@ mpfr_exp_rational (mpfr_ptr y, mpz_ptr p, long r, int m,
   while (k > 0)
     {
       j = log2_nb_terms[k-1];
-      mpz_mul (S[k], S[k], ptoj[j]);
-      mpz_mul (S[k-1], S[k-1], Q[k]);
+      mpfr_exp_mul3 (S, ptoj[j], Q, k, nthreads);
       l += 1 << log2_nb_terms[k];
       mpz_mul_2exp (S[k-1], S[k-1], r * l);
       mpz_add (S[k-1], S[k-1], S[k]);
-      mpz_mul (Q[k-1], Q[k-1], Q[k]);
       k--;
     }
 
@@ -153,6 +170,150 @@ mpfr_exp_rational (mpfr_ptr y, mpz_ptr p, long r, int m,
 
 #define shift (GMP_NUMB_BITS/2)
 
+/* Threaded mode (see mpfr_set_nthreads): the values exp(u_i/2^(...)) for
+   the chunks u_i of x (see mpfr_exp_3 below) are independent, so that they
+   are computed by different tasks, then multiplied in the same order as in
+   the serial code. Since each value is computed exactly as in the serial
+   code, the result does not depend on the number of threads. The tasks are
+   run by the threads of the pool (see parallel.c), which is grown by
+   mpfr_set_nthreads: there are at most nthreads tasks, so that no thread
+   is created here, and the threads keep their caches between the calls. */
+
+/* Minimum working precision (in bits) for the threaded mode. */
+#ifndef MPFR_EXP_3_MT_THRESHOLD
+# define MPFR_EXP_3_MT_THRESHOLD 50000
+#endif
+
+typedef struct {
+  mpfr_ptr y;        /* y <- exp(u/2^r), then squared nsqr times */
+  mpz_t u;
+  long r;
+  int m, nsqr;
+  unsigned int task; /* task that computes this chunk */
+} mpfr_exp_3_chunk_t;
+
+typedef struct {
+  mpfr_exp_3_chunk_t *c;
+  int nc, k;
+  unsigned int task, nthreads;
+} mpfr_exp_3_task_t;
+
+static void
+mpfr_exp_3_task (void *p)
+{
+  mpfr_exp_3_task_t *t = (mpfr_exp_3_task_t *) p;
+  mpz_t *P;
+  mpfr_prec_t *mult;
+  int i, loop;
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  /* The exponent range of a thread of the pool is not the one of the
+     caller. */
+  MPFR_SAVE_EXPO_MARK (expo);
+  P = (mpz_t*) (*__gmp_allocate_func) (3*(t->k+2)*sizeof(mpz_t));
+  for (i = 0; i < 3*(t->k+2); i++)
+    mpz_init (P[i]);
+  mult = (mpfr_prec_t*)
+    (*__gmp_allocate_func) (2*(t->k+2)*sizeof(mpfr_prec_t));
+  for (i = 0; i < t->nc; i++)
+    if (t->c[i].task == t->task)
+      {
+        mpfr_exp_rational (t->c[i].y, t->c[i].u, t->c[i].r, t->c[i].m,
+                           P, mult, t->nthreads);
+        for (loop = 0; loop < t->c[i].nsqr; loop++)
+          mpfr_sqr (t->c[i].y, t->c[i].y, MPFR_RNDD);
+      }
+  for (i = 0; i < 3*(t->k+2); i++)
+    mpz_clear (P[i]);
+  (*__gmp_free_func) (P, 3*(t->k+2)*sizeof(mpz_t));
+  (*__gmp_free_func) (mult, 2*(t->k+2)*sizeof(mpfr_prec_t));
+  MPFR_SAVE_EXPO_FREE (expo);
+}
+
+/* Same computation of tmp as the serial code of mpfr_exp_3, with iter+1
+   chunks and tables of size k, using up to nthreads threads. */
+static void
+mpfr_exp_3_mt (mpfr_ptr tmp, mpfr_srcptr x_copy, mpfr_exp_t ttt, int k,
+               int iter, unsigned int nthreads)
+{
+  mpfr_exp_3_chunk_t *c;
+  mpfr_exp_3_task_t *t;
+  unsigned long twopoweri, *load;
+  unsigned int j, n;
+  int i, nc;
+  MPFR_TMP_DECL (marker);
+
+  MPFR_TMP_MARK (marker);
+  c = (mpfr_exp_3_chunk_t *)
+    MPFR_TMP_ALLOC ((iter + 1) * sizeof (mpfr_exp_3_chunk_t));
+
+  /* Extract the chunks, ignoring the zero ones except the first one. */
+  twopoweri = GMP_NUMB_BITS;
+  for (i = nc = 0; i <= iter; i++)
+    {
+      mpz_init (c[nc].u);
+      mpfr_extract (c[nc].u, x_copy, i);
+      MPFR_ASSERTD (i != 0 || mpz_cmp_ui (c[nc].u, 0) != 0);
+      if (i == 0 || mpz_cmp_ui (c[nc].u, 0) != 0)
+        {
+          c[nc].y = tmp;
+          if (i != 0)
+            {
+              c[nc].y = (mpfr_ptr) MPFR_TMP_ALLOC (sizeof (mpfr_t));
+              mpfr_init2 (c[nc].y, MPFR_PREC (tmp));
+            }
+          c[nc].r = (i == 0 ? shift : 0) + twopoweri - ttt;
+          c[nc].m = k - i + 1;
+          c[nc].nsqr = i == 0 ? shift : 0;
+          nc++;
+        }
+      else
+        mpz_clear (c[nc].u);
+      MPFR_ASSERTN (twopoweri <= LONG_MAX/2);
+      twopoweri *= 2;
+    }
+
+  /* Assign the chunks to the tasks, each one to the task with the lowest
+     load so far. The first chunk, with its shift squarings, costs about
+     as much as shift/8 other chunks (which have similar costs). */
+  n = nthreads < (unsigned int) nc ? nthreads : (unsigned int) nc;
+  load = (unsigned long *) MPFR_TMP_ALLOC (n * sizeof (unsigned long));
+  for (j = 0; j < n; j++)
+    load[j] = 0;
+  for (i = 0; i < nc; i++)
+    {
+      unsigned int jmin = 0;
+
+      for (j = 1; j < n; j++)
+        if (load[j] < load[jmin])
+          jmin = j;
+      c[i].task = jmin;
+      load[jmin] += i == 0 ? shift / 8 : 1;
+    }
+
+  t = (mpfr_exp_3_task_t *) MPFR_TMP_ALLOC (n * sizeof (mpfr_exp_3_task_t));
+  for (j = 0; j < n; j++)
+    {
+      t[j].c = c;
+      t[j].nc = nc;
+      t[j].k = k;
+      t[j].task = j;
+      /* If some threads remain, they are used for the products in the
+         first chunk, which is then alone in task 0. */
+      t[j].nthreads = j == 0 ? nthreads - n + 1 : 1;
+    }
+  mpfr_parallel_run (mpfr_exp_3_task, t, sizeof (mpfr_exp_3_task_t), n);
+
+  mpz_clear (c[0].u);
+  for (i = 1; i < nc; i++)
+    {
+      mpfr_mul (tmp, tmp, c[i].y, MPFR_RNDD);
+      mpfr_clear (c[i].y);
+      mpz_clear (c[i].u);
+    }
+  MPFR_TMP_FREE (marker);
+}
+
 int
 mpfr_exp_3 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 {
@@ -167,6 +328,7 @@ mpfr_exp_3 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpfr_prec_t realprec, Prec;
   int iter;
   int inexact = 0;
+  unsigned int nthreads = mpfr_get_nthreads ();
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_ZIV_DECL (ziv_loop);
 
@@ -215,42 +377,50 @@ mpfr_exp_3 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 
       k = MPFR_INT_CEIL_LOG2 (Prec) - MPFR_LOG2_GMP_NUMB_BITS;
 
-      /* now we have to extract */
-      twopoweri = GMP_NUMB_BITS;
-
-      /* Allocate tables */
-      P    = (mpz_t*) (*__gmp_allocate_func) (3*(k+2)*sizeof(mpz_t));
-      for (i = 0; i < 3*(k+2); i++)
-        mpz_init (P[i]);
-      mult = (mpfr_prec_t*) (*__gmp_allocate_func) (2*(k+2)*sizeof(mpfr_prec_t));
-
-      /* Particular case for i==0 */
-      mpfr_extract (uk, x_copy, 0);
-      MPFR_ASSERTD (mpz_cmp_ui (uk, 0) != 0);
-      mpfr_exp_rational (tmp, uk, shift + twopoweri - ttt, k + 1, P, mult);
-      for (loop = 0; loop < shift; loop++)
-        mpfr_sqr (tmp, tmp, MPFR_RNDD);
-      twopoweri *= 2;
-
-      /* General case */
       iter = (k <= prec_x) ? k : prec_x;
-      for (i = 1; i <= iter; i++)
+      if (nthreads > 1 && Prec >= MPFR_EXP_3_MT_THRESHOLD)
+        mpfr_exp_3_mt (tmp, x_copy, ttt, k, iter, nthreads);
+      else
         {
-          mpfr_extract (uk, x_copy, i);
-          if (MPFR_LIKELY (mpz_cmp_ui (uk, 0) != 0))
+          /* now we have to extract */
+          twopoweri = GMP_NUMB_BITS;
+
+          /* Allocate tables */
+          P    = (mpz_t*) (*__gmp_allocate_func) (3*(k+2)*sizeof(mpz_t));
+          for (i = 0; i < 3*(k+2); i++)
+            mpz_init (P[i]);
+          mult = (mpfr_prec_t*)
+            (*__gmp_allocate_func) (2*(k+2)*sizeof(mpfr_prec_t));
+
+          /* Particular case for i==0 */
+          mpfr_extract (uk, x_copy, 0);
+          MPFR_ASSERTD (mpz_cmp_ui (uk, 0) != 0);
+          mpfr_exp_rational (tmp, uk, shift + twopoweri - ttt, k + 1,
+                             P, mult, 1);
+          for (loop = 0; loop < shift; loop++)
+            mpfr_sqr (tmp, tmp, MPFR_RNDD);
+          twopoweri *= 2;
+
+          /* General case */
+          for (i = 1; i <= iter; i++)
             {
-              mpfr_exp_rational (t, uk, twopoweri - ttt, k  - i + 1, P, mult);
-              mpfr_mul (tmp, tmp, t, MPFR_RNDD);
+              mpfr_extract (uk, x_copy, i);
+              if (MPFR_LIKELY (mpz_cmp_ui (uk, 0) != 0))
+                {
+                  mpfr_exp_rational (t, uk, twopoweri - ttt, k  - i + 1,
+                                     P, mult, 1);
+                  mpfr_mul (tmp, tmp, t, MPFR_RNDD);
+                }
+              MPFR_ASSERTN (twopoweri <= LONG_MAX/2);
+              twopoweri *=2;
             }
-          MPFR_ASSERTN (twopoweri <= LONG_MAX/2);
-          twopoweri *=2;
-        }
 
-      /* Clear tables */
-      for (i = 0; i < 3*(k+2); i++)
-        mpz_clear (P[i]);
-      (*__gmp_free_func) (P, 3*(k+2)*sizeof(mpz_t));
-      (*__gmp_free_func) (mult, 2*(k+2)*sizeof(mpfr_prec_t));
+          /* Clear tables */
+          for (i = 0; i < 3*(k+2); i++)
+            mpz_clear (P[i]);
+          (*__gmp_free_func) (P, 3*(k+2)*sizeof(mpz_t));
+          (*__gmp_free_func) (mult, 2*(k+2)*sizeof(mpfr_prec_t));
+        }
 
       if (shift_x > 0)
         {
@@ -287,8 +457,8 @@ mpfr_exp_3 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
             }
         }
 
-      if (mpfr_can_round (shift_x > 0 ? t : tmp, realprec, MPFR_RNDN, MPFR_RNDZ,
-                          MPFR_PREC(y) + (rnd_mode == MPFR_RNDN)))
+      if (MPFR_CAN_ROUND (shift_x > 0 ? t : tmp, realprec, MPFR_PREC(y),
+                          rnd_mode))
         {
           inexact = mpfr_set (y, shift_x > 0 ? t : tmp, rnd_mode);
           if (MPFR_UNLIKELY (scaled && MPFR_IS_PURE_FP (y)))
@@ -0,0 +1,428 @@
+/* mpfr_exp_tab, mpfr_log_tab -- table-driven exponential and logarithm
+   for small precisions
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* Tang-style evaluation of exp(x) and log(x) for a target precision of at
+   most MPFR_EXPLOG_TAB_THRESHOLD bits.
+
+   All the computations are done in fixed point on n+1 limbs, without any
+   mpfr_t or heap temporary: {p, n+1} represents p[n] + {p, n} / 2^(n*B),
+   where B = GMP_NUMB_BITS, i.e. p[n] is the integer part. The working
+   precision is W = n*B fractional bits, with n = ceil(prec/B) + 1.
+
+   exp(x): x = k*log(2) + r with 0 <= r < 1, r = j1/2^6 + j2/2^12 + s with
+   0 <= s < 2^(-12), and exp(x) = 2^k * E1[j1] * E2[j2] * exp(s), where
+   E1[j] = exp(j/2^6), E2[j] = exp(j/2^12), and exp(s) is evaluated by
+   its Taylor series (about W/12 terms).
+
+   log(x): x = 2^e * m with 1 <= m < 2. With a1 = ceil(2^19/(64+j1)) where
+   j1 = floor((m-1)*2^6), we get 1 <= m*a1/2^13 < 1 + 2^(-5.9), then with
+   a2 = ceil(2^31/(4096+j2)), j2 = floor((m*a1/2^13-1)*2^12) <= 65, we get
+   1 <= m*a1/2^13*a2/2^19 = 1+z < 1 + 2^(-11.9). Since a1 and a2 are small
+   integers, these products are computed exactly up to the final
+   truncation. Then log(x) = e*log(2) + L1[j1] + L2[j2] + log(1+z), where
+   L1[j] = log(2^13/a1), L2[j] = log(2^19/a2), and log(1+z) is evaluated
+   by its Taylor series.
+
+   The tables are computed once per thread with TAB_LIMBS fractional limbs
+   (at least 192 bits more than the largest target precision, see the
+   error analysis of e*log(2) and k*log(2) below), and only their n most
+   significant fractional limbs are used. If the result cannot be rounded,
+   or in the few cases not handled here (huge exponents, cancellation in
+   log(x) for x close to 1), the caller falls back to the generic
+   algorithm. */
+
+#define TAB_LIMBS ((MPFR_EXPLOG_TAB_THRESHOLD + 191) / GMP_NUMB_BITS + 1)
+#define TAB_SIZE 64
+#define TAB_LOG2_SIZE (TAB_SIZE + 2)  /* j2 <= 65 in log(x) */
+
+#define TAB_A1(j) (((MPFR_LIMB_ONE << 19) + 63 + (j)) / (64 + (j)))
+#define TAB_A2(j) (((MPFR_LIMB_ONE << 31) + 4095 + (j)) / (4096 + (j)))
+
+/* Layout of the table: log(2), E1[0..63], E2[0..63], L1[0..63],
+   L2[0..65], each entry with TAB_LIMBS+1 limbs. */
+#define TAB_ENTRY(i) (explog_tab + (i) * (TAB_LIMBS + 1))
+#define TAB_LN2      TAB_ENTRY (0)
+#define TAB_E1(j)    TAB_ENTRY (1 + (j))
+#define TAB_E2(j)    TAB_ENTRY (1 + TAB_SIZE + (j))
+#define TAB_L1(j)    TAB_ENTRY (1 + 2 * TAB_SIZE + (j))
+#define TAB_L2(j)    TAB_ENTRY (1 + 3 * TAB_SIZE + (j))
+#define TAB_ENTRIES  (1 + 3 * TAB_SIZE + TAB_LOG2_SIZE)
+
+static MPFR_THREAD_ATTR mp_limb_t *explog_tab = NULL;
+
+/* Set {fp, fn+1} to floor(|x| * 2^(fn*B)) where |x| = 0.{xp, xn} * 2^e.
+   Assumes e < B, so that the integer part fits in fp[fn]. Only the fn+2
+   most significant limbs of {xp, xn} are read. */
+static void
+fix_set (mp_limb_t *fp, mp_size_t fn, mp_limb_t *xp, mp_size_t xn,
+         mpfr_exp_t e)
+{
+  mpfr_exp_t d, q, j;
+  int r;
+  mp_size_t i;
+
+  MPFR_ASSERTD (e < GMP_NUMB_BITS);
+  if (e <= - (mpfr_exp_t) (fn + 1) * GMP_NUMB_BITS)
+    {
+      MPN_ZERO (fp, fn + 1);
+      return;
+    }
+
+  /* bit 0 of the result is bit d of {xp, xn} */
+  d = (mpfr_exp_t) (xn - fn) * GMP_NUMB_BITS - e;
+  if (d >= 0)
+    {
+      q = d / GMP_NUMB_BITS;
+      r = d % GMP_NUMB_BITS;
+    }
+  else
+    {
+      q = - ((- d + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
+      r = d - q * GMP_NUMB_BITS;
+    }
+  for (i = 0; i <= fn; i++)
+    {
+      mp_limb_t lo, hi;
+
+      j = q + i;
+      lo = (j >= 0 && j < xn) ? xp[j] : 0;
+      hi = (j + 1 >= 0 && j + 1 < xn) ? xp[j + 1] : 0;
+      fp[i] = r == 0 ? lo : (lo >> r) | (hi << (GMP_NUMB_BITS - r));
+    }
+}
+
+/* Make z a positive number whose significand is {p, n+1}, normalized in
+   place, with the value of the fixed-point number {p, n+1}. Return 0 if
+   this number is zero. */
+static int
+fix_get (mpfr_ptr z, mp_limb_t *p, mp_size_t n)
+{
+  mp_size_t h;
+  int cnt;
+
+  for (h = n; h >= 0 && p[h] == 0; h--)
+    ;
+  if (h < 0)
+    return 0;
+  count_leading_zeros (cnt, p[h]);
+  if (cnt != 0)
+    mpn_lshift (p, p, h + 1, cnt);
+  MPFR_TMP_INIT1 (p, z, (mpfr_prec_t) (h + 1) * GMP_NUMB_BITS);
+  MPFR_SET_EXP (z, (mpfr_exp_t) (h + 1 - n) * GMP_NUMB_BITS - cnt);
+  return 1;
+}
+
+static int
+fix_zero_p (mp_limb_t *p, mp_size_t n)
+{
+  while (n > 0)
+    if (p[--n] != 0)
+      return 0;
+  return 1;
+}
+
+/* Set the entry {t, TAB_LIMBS+1} to the value of x, truncated. */
+static void
+tab_set (mp_limb_t *t, mpfr_srcptr x)
+{
+  if (MPFR_IS_ZERO (x))
+    MPN_ZERO (t, TAB_LIMBS + 1);
+  else
+    fix_set (t, TAB_LIMBS, MPFR_MANT (x), MPFR_LIMB_SIZE (x),
+             MPFR_GET_EXP (x));
+}
+
+/* Compute the tables of the current thread, if not done yet. Each entry
+   is within 1 ulp of the exact value (rounding to nearest on TAB_LIMBS*B+2
+   bits, then truncation). */
+static void
+explog_tab_init (void)
+{
+  mpfr_t t;
+  int j;
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  if (MPFR_LIKELY (explog_tab != NULL))
+    return;
+
+  /* This precision is larger than MPFR_EXPLOG_TAB_THRESHOLD, so that the
+     functions below do not use the tables. */
+  MPFR_SAVE_EXPO_MARK (expo);
+  mpfr_init2 (t, TAB_LIMBS * GMP_NUMB_BITS + 2);
+  explog_tab = (mp_limb_t *) (*__gmp_allocate_func)
+    (TAB_ENTRIES * (TAB_LIMBS + 1) * sizeof (mp_limb_t));
+
+  mpfr_const_log2 (t, MPFR_RNDN);
+  tab_set (TAB_LN2, t);
+  for (j = 0; j < TAB_SIZE; j++)
+    {
+      mpfr_set_ui_2exp (t, j, -6, MPFR_RNDN);
+      mpfr_exp (t, t, MPFR_RNDN);
+      tab_set (TAB_E1 (j), t);
+      mpfr_set_ui_2exp (t, j, -12, MPFR_RNDN);
+      mpfr_exp (t, t, MPFR_RNDN);
+      tab_set (TAB_E2 (j), t);
+      /* log(2^13/a1) = -log(a1/2^13) */
+      mpfr_set_ui_2exp (t, TAB_A1 (j), -13, MPFR_RNDN);
+      mpfr_log (t, t, MPFR_RNDN);
+      mpfr_neg (t, t, MPFR_RNDN);
+      tab_set (TAB_L1 (j), t);
+    }
+  for (j = 0; j < TAB_LOG2_SIZE; j++)
+    {
+      mpfr_set_ui_2exp (t, TAB_A2 (j), -19, MPFR_RNDN);
+      mpfr_log (t, t, MPFR_RNDN);
+      mpfr_neg (t, t, MPFR_RNDN);
+      tab_set (TAB_L2 (j), t);
+    }
+
+  mpfr_clear (t);
+  MPFR_SAVE_EXPO_FREE (expo);
+}
+
+void
+mpfr_explog_tab_freecache (void)
+{
+  if (explog_tab != NULL)
+    {
+      (*__gmp_free_func) (explog_tab,
+                          TAB_ENTRIES * (TAB_LIMBS + 1) * sizeof (mp_limb_t));
+      explog_tab = NULL;
+    }
+}
+
+/* Round the fixed-point approximation {p, n+1} of |f(x)|, with an error of
+   at most err ulps (of 2^(-n*B)), to y with the sign neg. Return 0 if this
+   is not possible, otherwise store the ternary value in *inexp. */
+static int
+explog_tab_round (mpfr_ptr y, mp_limb_t *p, mp_size_t n, unsigned long err,
+                  int neg, mpfr_rnd_t rnd_mode, int *inexp)
+{
+  mpfr_t z;
+
+  if (! fix_get (z, p, n))
+    return 0;
+  if (neg)
+    MPFR_SET_NEG (z);
+  if (! MPFR_CAN_ROUND (z, MPFR_GET_EXP (z) + (mpfr_exp_t) n * GMP_NUMB_BITS
+                        - MPFR_INT_CEIL_LOG2 (err), MPFR_PREC (y), rnd_mode))
+    return 0;
+  *inexp = mpfr_set (y, z, rnd_mode);
+  return 1;
+}
+
+/* Try to set y to exp(x) rounded with rnd_mode, where x is a regular
+   number. Return 0 on failure, otherwise store the ternary value in *inexp.
+   Must be called with an extended exponent range. */
+int
+mpfr_exp_tab (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode, int *inexp)
+{
+  mp_limb_t xf[TAB_LIMBS + 1], rf[TAB_LIMBS + 1], kl[TAB_LIMBS + 1];
+  mp_limb_t s[TAB_LIMBS], t[TAB_LIMBS], f[TAB_LIMBS + 1], e[TAB_LIMBS + 1];
+  mp_limb_t u[2 * TAB_LIMBS + 2];
+  mp_limb_t *ln2;
+  mp_size_t n;
+  double d;
+  long k;
+  unsigned long i;
+  int j1, j2;
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x));
+  MPFR_ASSERTD (MPFR_PREC (y) <= MPFR_EXPLOG_TAB_THRESHOLD);
+
+  /* so that |k| < 2^31 */
+  if (MPFR_GET_EXP (x) > 30)
+    return 0;
+
+  explog_tab_init ();
+  ln2 = TAB_LN2;
+  n = MPFR_PREC2LIMBS (MPFR_PREC (y)) + 1;
+  MPFR_ASSERTD (n < TAB_LIMBS);
+
+  /* k = floor(x/log(2)), or off by one, corrected below */
+  d = mpfr_get_d (x, MPFR_RNDN) * 1.4426950408889634074;
+  k = (long) d;
+  if (d < (double) k)
+    k--;
+
+  /* r = x - k*log(2) on TAB_LIMBS fractional limbs, in two's complement.
+     The error on r is at most 2^(-TAB_LIMBS*B) from the truncation of x,
+     plus |k| < 2^31 times the error on log(2): in all, less than
+     2^(32-TAB_LIMBS*B) < 2^(-W), since TAB_LIMBS*B >= W + 64. */
+  fix_set (xf, TAB_LIMBS, MPFR_MANT (x), MPFR_LIMB_SIZE (x),
+           MPFR_GET_EXP (x));
+  i = mpn_mul_1 (kl, ln2, TAB_LIMBS + 1, k >= 0 ? k : -k);
+  MPFR_ASSERTD (i == 0);
+  if (MPFR_IS_POS (x))
+    mpn_sub_n (rf, xf, kl, TAB_LIMBS + 1);
+  else
+    mpn_sub_n (rf, kl, xf, TAB_LIMBS + 1);
+  while (rf[TAB_LIMBS] >> (GMP_NUMB_BITS - 1))  /* r < 0 */
+    {
+      mpn_add_n (rf, rf, ln2, TAB_LIMBS + 1);
+      k--;
+    }
+  while (rf[TAB_LIMBS] != 0)  /* r >= 1 */
+    {
+      mpn_sub_n (rf, rf, ln2, TAB_LIMBS + 1);
+      k++;
+    }
+
+  /* r = j1/2^6 + j2/2^12 + s, s truncated to W bits: error(s) <= 2 ulps */
+  j1 = rf[TAB_LIMBS - 1] >> (GMP_NUMB_BITS - 6);
+  j2 = (rf[TAB_LIMBS - 1] >> (GMP_NUMB_BITS - 12)) & (TAB_SIZE - 1);
+  MPN_COPY (s, rf + TAB_LIMBS - n, n);
+  s[n - 1] &= MPFR_LIMB_MASK (GMP_NUMB_BITS - 12);
+
+  /* f = exp(s) = 1 + s + s^2/2 + ... Each term t_i = t_(i-1)*s/i has an
+     error of at most 2 ulps (two truncations, the error on t_(i-1) being
+     multiplied by s < 2^(-12)), t_1 = s has 2 ulps, and the neglected
+     terms are less than 1 ulp: f has an error of at most 2i+4 ulps. */
+  MPN_COPY (f, s, n);
+  f[n] = 1;
+  MPN_COPY (t, s, n);
+  for (i = 2; ; i++)
+    {
+      mpn_mul_n (u, t, s, n);
+      mpn_divrem_1 (t, 0, u + n, n, i);
+      if (fix_zero_p (t, n))
+        break;
+      f[n] += mpn_add_n (f, f, t, n);
+    }
+
+  /* e = E1[j1] * E2[j2] < 2.72*1.02, where the entries truncated to W bits
+     have an error of at most 2 ulps: error(e) <= 1.02*2 + 2.72*2 + 1 < 9
+     ulps. Then exp(r) = e * f < 2.72*1.0003: the error is at most
+     1.0003*9 + 2.72*(2i+4) + 1 < 6i + 22 ulps. */
+  mpn_mul_n (u, TAB_E1 (j1) + TAB_LIMBS - n, TAB_E2 (j2) + TAB_LIMBS - n,
+             n + 1);
+  MPN_COPY (e, u + n, n + 1);
+  mpn_mul_n (u, e, f, n + 1);
+  MPFR_ASSERTD (u[2 * n + 1] == 0);
+
+  if (! explog_tab_round (y, u + n, n, 6 * i + 22, 0, rnd_mode, inexp))
+    return 0;
+  /* exact in the extended exponent range */
+  mpfr_mul_2si (y, y, k, MPFR_RNDN);
+  return 1;
+}
+
+/* Try to set y to log(x) rounded with rnd_mode, where x > 0 is a regular
+   number different from 1. Return 0 on failure, otherwise store the
+   ternary value in *inexp. Must be called with an extended exponent
+   range. */
+int
+mpfr_log_tab (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode, int *inexp)
+{
+  mp_limb_t m[TAB_LIMBS + 1], z[TAB_LIMBS], p[TAB_LIMBS], t[TAB_LIMBS];
+  mp_limb_t v[TAB_LIMBS + 1], el[TAB_LIMBS + 1];
+  mp_limb_t w[2 * TAB_LIMBS];
+  mp_limb_t *l;
+  mp_size_t n;
+  mpfr_exp_t e;
+  mp_limb_t ae;
+  unsigned long i;
+  int j1, j2, neg;
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x) && MPFR_IS_POS (x));
+  MPFR_ASSERTD (MPFR_PREC (y) <= MPFR_EXPLOG_TAB_THRESHOLD);
+
+  /* x = 2^e * m with 1 <= m < 2. The error on e*log(2) is |e| times the
+     error on log(2), i.e. less than 2^(B-2-TAB_LIMBS*B) < 2^(-W-2). */
+  e = MPFR_GET_EXP (x) - 1;
+  ae = e >= 0 ? (mp_limb_t) e : - (mp_limb_t) e;
+  if (ae >> (GMP_NUMB_BITS - 2))
+    return 0;
+
+  explog_tab_init ();
+  n = MPFR_PREC2LIMBS (MPFR_PREC (y)) + 1;
+  MPFR_ASSERTD (n < TAB_LIMBS);
+
+  /* m truncated to W bits: error <= 1 ulp */
+  fix_set (m, n, MPFR_MANT (x), MPFR_LIMB_SIZE (x), 1);
+  MPFR_ASSERTD (m[n] == 1);
+
+  /* 1+z = m * a1/2^13 * a2/2^19, each product being exact before its
+     truncation, which rounds toward 1 + z >= 1 since 1 is representable:
+     error(z) <= 3 ulps. */
+  j1 = m[n - 1] >> (GMP_NUMB_BITS - 6);
+  mpn_mul_1 (m, m, n + 1, TAB_A1 (j1));
+  mpn_rshift (m, m, n + 1, 13);
+  MPFR_ASSERTD (m[n] == 1);
+  j2 = m[n - 1] >> (GMP_NUMB_BITS - 12);
+  MPFR_ASSERTD (j2 < TAB_LOG2_SIZE);
+  mpn_mul_1 (m, m, n + 1, TAB_A2 (j2));
+  mpn_rshift (m, m, n + 1, 19);
+  MPFR_ASSERTD (m[n] == 1);
+  MPN_COPY (z, m, n);
+  MPFR_ASSERTD ((z[n - 1] >> (GMP_NUMB_BITS - 11)) == 0);
+
+  /* v = log(1+z) = z - z^2/2 + z^3/3 - ... The powers p_i of z have an
+     error of at most 2 ulps, thus each term has at most 3 ulps, and the
+     neglected terms are less than 1 ulp; the error on z adds 3 ulps since
+     the derivative of log(1+z) is at most 1: error(v) <= 3i + 4 ulps. The
+     partial sums stay in [0, z]. */
+  MPN_COPY (v, z, n);
+  v[n] = 0;
+  MPN_COPY (p, z, n);
+  for (i = 2; ; i++)
+    {
+      mpn_mul_n (w, p, z, n);
+      MPN_COPY (p, w + n, n);
+      mpn_divrem_1 (t, 0, p, n, i);
+      if (fix_zero_p (t, n))
+        break;
+      if (i & 1)
+        mpn_add (v, v, n + 1, t, n);
+      else
+        mpn_sub (v, v, n + 1, t, n);
+    }
+
+  /* v = L1[j1] + L2[j2] + log(1+z) = log(m), with error <= 3i + 8 ulps */
+  mpn_add_n (v, v, TAB_L1 (j1) + TAB_LIMBS - n, n + 1);
+  mpn_add_n (v, v, TAB_L2 (j2) + TAB_LIMBS - n, n + 1);
+
+  /* log(x) = e*log(2) + v, with e*log(2) computed on TAB_LIMBS fractional
+     limbs then truncated: error <= 3i + 10 ulps. When e < 0, |log(x)| =
+     |e|*log(2) - v, which may cancel (x close to 1), in which case the
+     rounding test fails. */
+  neg = e < 0;
+  if (e != 0)
+    {
+      i = mpn_mul_1 (el, TAB_LN2, TAB_LIMBS + 1, ae);
+      MPFR_ASSERTD (i == 0);
+      l = el + TAB_LIMBS - n;
+      if (neg)
+        {
+          if (mpn_sub_n (v, l, v, n + 1))
+            return 0;
+        }
+      else
+        mpn_add_n (v, v, l, n + 1);
+    }
+
+  return explog_tab_round (y, v, n, 3 * i + 10, neg, rnd_mode, inexp);
+}
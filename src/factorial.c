@@ -56,6 +56,7 @@ mpfr_fac_ui (mpfr_ptr y, unsigned long int x, mpfr_rnd_t rnd_mode)
 
   /* compute the size of intermediary variable */
   Nt = Ny + 2 * MPFR_INT_CEIL_LOG2 (x) + 7;
+  MPFR_ZIV_ADAPT (loop, Nt);
 
   mpfr_init2 (t, Nt); /* initialize of intermediary variable */
 
@@ -76,8 +77,10 @@ mpfr_fac_ui (mpfr_ptr y, unsigned long int x, mpfr_rnd_t rnd_mode)
 
       err = Nt - 1 - MPFR_INT_CEIL_LOG2 (Nt);
 
-      round = !inexact || mpfr_can_round (t, err, rnd, MPFR_RNDZ,
-                                          Ny + (rnd_mode == MPFR_RNDN));
+      round = !inexact ||
+        (rnd_mode == MPFR_RNDF ? err > Ny :
+         mpfr_can_round (t, err, rnd, MPFR_RNDZ,
+                         Ny + (rnd_mode == MPFR_RNDN)));
 
       if (MPFR_LIKELY (round))
         {
@@ -90,7 +93,8 @@ mpfr_fac_ui (mpfr_ptr y, unsigned long int x, mpfr_rnd_t rnd_mode)
               inexact = round;
               break;
             }
-          else if ((inexact < 0 && round <= 0)
+          else if (rnd_mode == MPFR_RNDF /* ternary value not needed */
+                   || (inexact < 0 && round <= 0)
                    || (inexact > 0 && round >= 0))
             break;
           else /* inexact and round have opposite signs: we cannot
@@ -71,31 +71,68 @@ mpfr_mpz_clear (mpz_t z)
 
 #endif
 
+/* Free the caches of temporary memory of the current thread (the mpz_t's
+   and the scratch arena), but not the caches of values. This is done by
+   the threads of the parallel mode when they become idle (see parallel.c),
+   so that they do not keep much memory. */
 void
-mpfr_free_cache (void)
+mpfr_free_tmp_cache (void)
 {
-  /* Before mpz caching */
-  mpfr_bernoulli_freecache();
-
 #if MPFR_MY_MPZ_INIT
-  { /* Avoid mixed declarations and code for ISO C90 support. */
-    int i;
-    MPFR_ASSERTD (n_alloc >= 0 && n_alloc <= numberof (mpz_tab));
-    for (i = 0; i < n_alloc; i++)
-      (__gmpz_clear)(&mpz_tab[i]);
-    n_alloc = 0;
-  }
+  int i;
+
+  MPFR_ASSERTD (n_alloc >= 0 && n_alloc <= numberof (mpz_tab));
+  for (i = 0; i < n_alloc; i++)
+    (__gmpz_clear)(&mpz_tab[i]);
+  n_alloc = 0;
 #endif
 
+  mpfr_scratch_release ();
+}
+
+/* Free the caches selected by way. Without --enable-shared-cache, all the
+   caches are local to the current thread (or global if MPFR is not built
+   as thread safe). With --enable-shared-cache, the caches of the constants
+   are global, and the other caches (Bernoulli numbers, mpz_t's) are local.
+   Note: the global cache must not be freed while other threads may use it,
+   otherwise they would have to recompute the constants. */
+void
+mpfr_free_cache2 (mpfr_free_cache_t way)
+{
+  if ((unsigned int) way & MPFR_FREE_LOCAL_CACHE)
+    {
+      /* Before mpz caching */
+      mpfr_bernoulli_freecache();
+      mpfr_explog_tab_freecache ();
+      mpfr_free_tmp_cache ();
+    }
+
+#ifdef MPFR_WANT_SHARED_CACHE
+  if ((unsigned int) way & MPFR_FREE_GLOBAL_CACHE)
+#else
+  if ((unsigned int) way & MPFR_FREE_LOCAL_CACHE)
+#endif
+    {
 #ifndef MPFR_USE_LOGGING
-  mpfr_clear_cache (__gmpfr_cache_const_pi);
-  mpfr_clear_cache (__gmpfr_cache_const_log2);
+      mpfr_clear_cache (__gmpfr_cache_const_pi);
+      mpfr_clear_cache (__gmpfr_cache_const_log2);
 #else
-  mpfr_clear_cache (__gmpfr_normal_pi);
-  mpfr_clear_cache (__gmpfr_normal_log2);
-  mpfr_clear_cache (__gmpfr_logging_pi);
-  mpfr_clear_cache (__gmpfr_logging_log2);
+      mpfr_clear_cache (__gmpfr_normal_pi);
+      mpfr_clear_cache (__gmpfr_normal_log2);
+      mpfr_clear_cache (__gmpfr_logging_pi);
+      mpfr_clear_cache (__gmpfr_logging_log2);
 #endif
-  mpfr_clear_cache (__gmpfr_cache_const_euler);
-  mpfr_clear_cache (__gmpfr_cache_const_catalan);
+      mpfr_clear_cache (__gmpfr_cache_const_euler);
+      mpfr_clear_cache (__gmpfr_cache_const_catalan);
+      mpfr_clear_cache (__gmpfr_cache_const_two_over_pi);
+      mpfr_const_log2_freecache ();
+      mpfr_cache_unmap_files ();
+    }
+}
+
+void
+mpfr_free_cache (void)
+{
+  mpfr_free_cache2 ((mpfr_free_cache_t)
+                    (MPFR_FREE_LOCAL_CACHE | MPFR_FREE_GLOBAL_CACHE));
 }
@@ -0,0 +1,243 @@
+/* mpfr_exp_n, mpfr_log_n, mpfr_sin_n, mpfr_cos_n -- elementary functions
+   over arrays
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* Minimum number of elements per thread. The threads of the pool (see
+   parallel.c) are created once and keep their thread-local tables and
+   caches (see explog_tab.c) between calls, so that a chunk only needs to
+   amortize the wake-up of a thread, about the cost of a few tens of
+   evaluations in small precision. */
+#ifndef MPFR_FUN_N_MT_MIN_ELEMS
+# define MPFR_FUN_N_MT_MIN_ELEMS 2048
+#endif
+
+/* Set y[i] to f(x[i]) for 0 <= i < n. Each element gives exactly the same
+   result, ternary value and flags as the scalar function, but the work that
+   only depends on the exponent range is done once per array:
+
+   - for mpfr_exp_n, the bound s such that any x with EXP(x) <= s can
+     neither overflow nor underflow, so that the inputs of a target
+     precision up to MPFR_EXPLOG_TAB_THRESHOLD with
+     -PREC(y) <= EXP(x) <= s directly go to the table-driven algorithm
+     (see explog_tab.c), without the overflow/underflow tests of mpfr_exp;
+   - for mpfr_log_n, the positive regular inputs different from 1 of a
+     target precision up to MPFR_EXPLOG_TAB_THRESHOLD directly go to the
+     table-driven algorithm;
+   - the other inputs are given to the scalar function.
+
+   The tables of explog_tab.c and the constant caches are thread-local, so
+   that they are filled at most once per array (and per thread).
+
+   If mpfr_get_nthreads() > 1, the array is split into consecutive chunks
+   of at least MPFR_FUN_N_MT_MIN_ELEMS elements, evaluated by different
+   threads (see mpfr_parallel_run) with the exponent range of the caller;
+   their flags are merged into the flags of the caller. Thus the results,
+   the ternary values and the flags do not depend on the number of
+   threads. */
+
+typedef int (*mpfr_fun_n_elem) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t,
+                                mpfr_exp_t);
+
+typedef struct {
+  mpfr_fun_n_elem f;
+  mpfr_ptr *y;
+  mpfr_ptr *x;
+  unsigned long n;
+  mpfr_rnd_t rnd;
+  int *inex;
+  mpfr_exp_t emin, emax, s;
+  mpfr_flags_t flags;
+  int ret;
+} mpfr_fun_n_task_t;
+
+static int
+exp_elem (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd, mpfr_exp_t s)
+{
+  mpfr_exp_t emin, emax;
+  int inex;
+
+  if (MPFR_PREC (y) > MPFR_EXPLOG_TAB_THRESHOLD || MPFR_IS_SINGULAR (x) ||
+      MPFR_GET_EXP (x) > s || MPFR_GET_EXP (x) < - MPFR_PREC (y))
+    return mpfr_exp (y, x, rnd);
+
+  emin = __gmpfr_emin;
+  emax = __gmpfr_emax;
+  __gmpfr_emin = MPFR_EXT_EMIN;
+  __gmpfr_emax = MPFR_EXT_EMAX;
+  if (! mpfr_exp_tab (y, x, rnd, &inex))
+    inex = mpfr_exp_2 (y, x, rnd);
+  __gmpfr_emin = emin;
+  __gmpfr_emax = emax;
+  return mpfr_check_range (y, inex, rnd);
+}
+
+static int
+log_elem (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd, mpfr_exp_t s)
+{
+  mpfr_exp_t emin, emax;
+  mpfr_flags_t flags;
+  int inex, ok;
+
+  (void) s;  /* the bound s is only used by exp_elem */
+  if (MPFR_PREC (y) > MPFR_EXPLOG_TAB_THRESHOLD || MPFR_IS_SINGULAR (x) ||
+      MPFR_IS_NEG (x) || (MPFR_GET_EXP (x) == 1 && mpfr_cmp_ui (x, 1) == 0))
+    return mpfr_log (y, x, rnd);
+
+  emin = __gmpfr_emin;
+  emax = __gmpfr_emax;
+  __gmpfr_emin = MPFR_EXT_EMIN;
+  __gmpfr_emax = MPFR_EXT_EMAX;
+  /* like mpfr_log, do not keep the flags of mpfr_log_tab */
+  flags = __gmpfr_flags;
+  ok = mpfr_log_tab (y, x, rnd, &inex);
+  __gmpfr_flags = flags;
+  __gmpfr_emin = emin;
+  __gmpfr_emax = emax;
+  return ok ? mpfr_check_range (y, inex, rnd) : mpfr_log (y, x, rnd);
+}
+
+static int
+sin_elem (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd, mpfr_exp_t s)
+{
+  (void) s;  /* the bound s is only used by exp_elem */
+  return mpfr_sin (y, x, rnd);
+}
+
+static int
+cos_elem (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd, mpfr_exp_t s)
+{
+  (void) s;  /* the bound s is only used by exp_elem */
+  return mpfr_cos (y, x, rnd);
+}
+
+static void
+mpfr_fun_n_task (void *p)
+{
+  mpfr_fun_n_task_t *t = (mpfr_fun_n_task_t *) p;
+  mpfr_flags_t saved_flags = __gmpfr_flags;
+  mpfr_exp_t saved_emin = __gmpfr_emin, saved_emax = __gmpfr_emax;
+  unsigned long i;
+  int inex;
+
+  /* this task may run in a new thread, with the default exponent range */
+  __gmpfr_flags = 0;
+  __gmpfr_emin = t->emin;
+  __gmpfr_emax = t->emax;
+  t->ret = 0;
+  for (i = 0; i < t->n; i++)
+    {
+      inex = t->f (t->y[i], t->x[i], t->rnd, t->s);
+      if (t->inex != NULL)
+        t->inex[i] = inex;
+      t->ret |= inex != 0;
+    }
+  t->flags = __gmpfr_flags;
+  __gmpfr_flags = saved_flags;
+  __gmpfr_emin = saved_emin;
+  __gmpfr_emax = saved_emax;
+}
+
+static int
+mpfr_fun_n (mpfr_fun_n_elem f, mpfr_ptr *y, mpfr_ptr *const x,
+            unsigned long n, mpfr_rnd_t rnd, int *inex)
+{
+  mpfr_fun_n_task_t *t;
+  mpfr_exp_t s, l;
+  unsigned long q, r, k;
+  unsigned int i, nt;
+  int ret;
+  MPFR_TMP_DECL (marker);
+
+  /* 2^s <= min(emax, 1-emin)/2, so that |x| < 2^s implies
+     2^emin < exp(x) < 2^(emax-1) */
+  l = MIN (__gmpfr_emax, 1 - __gmpfr_emin);
+  for (s = -1; s < 30 && ((mpfr_exp_t) 1 << (s + 2)) <= l; s++)
+    ;
+  if (l < 8)
+    s = MPFR_EXP_MIN;
+
+  nt = mpfr_get_nthreads ();
+  if (n / MPFR_FUN_N_MT_MIN_ELEMS < nt)
+    nt = (unsigned int) (n / MPFR_FUN_N_MT_MIN_ELEMS);
+  if (nt == 0)
+    nt = 1;
+
+  MPFR_TMP_MARK (marker);
+  t = (mpfr_fun_n_task_t *) MPFR_TMP_ALLOC (nt * sizeof (mpfr_fun_n_task_t));
+  q = n / nt;
+  r = n % nt;
+  for (i = 0, k = 0; i < nt; i++)
+    {
+      t[i].f = f;
+      t[i].y = y + k;
+      t[i].x = x + k;
+      t[i].n = q + (i < r);
+      t[i].rnd = rnd;
+      t[i].inex = inex == NULL ? NULL : inex + k;
+      t[i].emin = __gmpfr_emin;
+      t[i].emax = __gmpfr_emax;
+      t[i].s = s;
+      k += t[i].n;
+    }
+  MPFR_ASSERTD (k == n);
+
+  mpfr_parallel_run (mpfr_fun_n_task, t, sizeof (mpfr_fun_n_task_t), nt);
+
+  ret = 0;
+  for (i = 0; i < nt; i++)
+    {
+      __gmpfr_flags |= t[i].flags;
+      ret |= t[i].ret;
+    }
+  MPFR_TMP_FREE (marker);
+  return ret;
+}
+
+int
+mpfr_exp_n (mpfr_ptr *y, mpfr_ptr *const x, unsigned long n,
+            mpfr_rnd_t rnd, int *inex)
+{
+  return mpfr_fun_n (exp_elem, y, x, n, rnd, inex);
+}
+
+int
+mpfr_log_n (mpfr_ptr *y, mpfr_ptr *const x, unsigned long n,
+            mpfr_rnd_t rnd, int *inex)
+{
+  return mpfr_fun_n (log_elem, y, x, n, rnd, inex);
+}
+
+int
+mpfr_sin_n (mpfr_ptr *y, mpfr_ptr *const x, unsigned long n,
+            mpfr_rnd_t rnd, int *inex)
+{
+  return mpfr_fun_n (sin_elem, y, x, n, rnd, inex);
+}
+
+int
+mpfr_cos_n (mpfr_ptr *y, mpfr_ptr *const x, unsigned long n,
+            mpfr_rnd_t rnd, int *inex)
+{
+  return mpfr_fun_n (cos_elem, y, x, n, rnd, inex);
+}
@@ -43,10 +43,18 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 # define MPFR_DIV_THRESHOLD 25 /* limbs */
 #endif
 
+#ifndef MPFR_DIV_PRE_THRESHOLD
+# define MPFR_DIV_PRE_THRESHOLD 8 /* limbs */
+#endif
+
 #ifndef MPFR_EXP_2_THRESHOLD
 # define MPFR_EXP_2_THRESHOLD 100 /* bits */
 #endif
 
+#ifndef MPFR_EXPLOG_TAB_THRESHOLD
+# define MPFR_EXPLOG_TAB_THRESHOLD 256 /* bits */
+#endif
+
 #ifndef MPFR_EXP_THRESHOLD
 # define MPFR_EXP_THRESHOLD 25000 /* bits */
 #endif
@@ -55,6 +63,18 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 # define MPFR_SINCOS_THRESHOLD 30000 /* bits */
 #endif
 
+#ifndef MPFR_PAYNE_HANEK_THRESHOLD
+# define MPFR_PAYNE_HANEK_THRESHOLD 16 /* exponent of the argument */
+#endif
+
+#ifndef MPFR_LOG_UI_THRESHOLD1
+# define MPFR_LOG_UI_THRESHOLD1 300 /* bits */
+#endif
+
+#ifndef MPFR_LOG_UI_THRESHOLD2
+# define MPFR_LOG_UI_THRESHOLD2 10 /* bits per term */
+#endif
+
 #ifndef MPFR_AI_THRESHOLD1
 # define MPFR_AI_THRESHOLD1 -13107 /* threshold for negative input of mpfr_ai */
 #endif
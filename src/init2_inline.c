@@ -0,0 +1,73 @@
+/* mpfr_init2_inline -- initialize a floating-point number with given
+   precision, its significand being stored in a buffer given by the user
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* The buffer buf of n bytes (aligned like a mp_size_t and a mp_limb_t, as
+   the buffer declared by MPFR_DECL_SMALL) gets the same layout as a block
+   allocated by mpfr_init2: a size field followed by the limbs, the size
+   being negated to mark the significand as inline (MPFR_IS_INLINE_ALLOC).
+   Then mpfr_clear does not free the significand, and mpfr_set_prec and
+   mpfr_prec_round keep it in the buffer while the new precision fits, and
+   move it to the heap otherwise (with mpfr_inline_to_heap). If the buffer
+   is too small for p, x is initialized by mpfr_init2. */
+void
+mpfr_init2_inline (mpfr_ptr x, mpfr_prec_t p, void *buf, size_t n)
+{
+  mp_size_t xsize;
+
+  MPFR_ASSERTN (MPFR_PREC_COND (p));
+
+  xsize = MPFR_PREC2LIMBS (p);
+  if (MPFR_UNLIKELY (n < MPFR_MALLOC_SIZE (xsize)))
+    {
+      mpfr_init2 (x, p);
+      return;
+    }
+
+  MPFR_PREC(x) = p;
+  MPFR_EXP (x) = MPFR_EXP_INVALID;
+  MPFR_SET_POS(x);
+  MPFR_SET_MANT_PTR(x, buf);
+  MPFR_SET_ALLOC_SIZE(x, - (mp_size_t) ((n - sizeof (mpfr_size_limb_t))
+                                        / MPFR_BYTES_PER_MP_LIMB));
+  MPFR_SET_NAN(x);
+}
+
+/* Move the inline significand of x to a block of n limbs allocated with the
+   memory functions, n being at least the current number of limbs of x, and
+   keep its value. The buffer is no longer used by x. */
+void
+mpfr_inline_to_heap (mpfr_ptr x, mp_size_t n)
+{
+  mpfr_limb_ptr tmp;
+
+  MPFR_ASSERTD (MPFR_IS_INLINE_ALLOC (x));
+  MPFR_ASSERTD (n >= MPFR_LIMB_SIZE (x));
+
+  tmp = (mpfr_limb_ptr) (*__gmp_allocate_func) (MPFR_MALLOC_SIZE (n));
+  MPN_COPY ((mp_limb_t *) ((mpfr_size_limb_t *) tmp + 1), MPFR_MANT (x),
+            MPFR_LIMB_SIZE (x));
+  MPFR_SET_MANT_PTR(x, tmp);
+  MPFR_SET_ALLOC_SIZE(x, n);
+}
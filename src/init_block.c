@@ -0,0 +1,127 @@
+/* mpfr_init_block, mpfr_clear_block -- initialize and clear several
+   floating-point numbers with a single allocation
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#ifdef HAVE_CONFIG_H
+#undef HAVE_STDARG
+#include "config.h"     /* for a build within gmp */
+#endif
+
+#if HAVE_STDARG
+# include <stdarg.h>
+#else
+# include <varargs.h>
+#endif
+
+#include "mpfr-impl.h"
+
+/* Like the MPFR_GROUP_* macros, the significands of the variables are
+   carved from a single block, but each one is given to mpfr_init2_inline
+   as a buffer (with its own size field), so that the variables can be used
+   like those of mpfr_inits2: they can be cleared separately, their
+   precision can be changed (a significand that no longer fits in its part
+   of the block is moved to the heap), and they can be swapped with one
+   another. The block is freed by mpfr_clear_block, which must be called
+   after all the variables are cleared, or with the variables to clear. */
+
+/* Explicit support for K&R compiler */
+void
+#if HAVE_STDARG
+mpfr_init_block (mpfr_block_ptr b, mpfr_prec_t p, ...)
+#else
+mpfr_init_block (va_alist)
+ va_dcl
+#endif
+{
+  va_list arg;
+  mpfr_ptr y;
+  size_t k, stride;
+  char *m;
+#if !HAVE_STDARG
+  mpfr_block_ptr b;
+  mpfr_prec_t p;
+#endif
+
+  /* first pass: count the variables (possibly none) */
+#if HAVE_STDARG
+  va_start (arg, p);
+#else
+  va_start(arg);
+  b =  va_arg (arg, mpfr_block_ptr);
+  p =  va_arg (arg, mpfr_prec_t);
+#endif
+  for (k = 0; (mpfr_ptr) va_arg (arg, mpfr_ptr) != 0; k++)
+    ;
+  va_end (arg);
+
+  MPFR_ASSERTN (MPFR_PREC_COND (p));
+  /* each part starts with a size field, thus must be aligned like it */
+  stride = MPFR_MALLOC_SIZE (MPFR_PREC2LIMBS (p));
+  stride = (stride + sizeof (mpfr_size_limb_t) - 1)
+    / sizeof (mpfr_size_limb_t) * sizeof (mpfr_size_limb_t);
+  MPFR_ASSERTN (k <= ((size_t) -1) / stride);
+  b->_mpfr_bytes = k * stride;
+  b->_mpfr_mem = k == 0 ? NULL : (*__gmp_allocate_func) (k * stride);
+
+  /* second pass: initialize the variables */
+  m = (char *) b->_mpfr_mem;
+#if HAVE_STDARG
+  va_start (arg, p);
+#else
+  va_start(arg);
+  b =  va_arg (arg, mpfr_block_ptr);
+  p =  va_arg (arg, mpfr_prec_t);
+#endif
+  while ((y = (mpfr_ptr) va_arg (arg, mpfr_ptr)) != 0)
+    {
+      mpfr_init2_inline (y, p, m, stride);
+      m += stride;
+    }
+  va_end (arg);
+}
+
+void
+#if HAVE_STDARG
+mpfr_clear_block (mpfr_block_ptr b, ...)
+#else
+mpfr_clear_block (va_alist)
+ va_dcl
+#endif
+{
+  va_list arg;
+  mpfr_ptr x;
+#if HAVE_STDARG
+  va_start (arg, b);
+#else
+  mpfr_block_ptr b;
+  va_start(arg);
+  b =  va_arg (arg, mpfr_block_ptr);
+#endif
+  while ((x = (mpfr_ptr) va_arg (arg, mpfr_ptr)) != 0)
+    mpfr_clear (x);
+  va_end (arg);
+
+  if (b->_mpfr_mem != NULL)
+    (*__gmp_free_func) (b->_mpfr_mem, b->_mpfr_bytes);
+  b->_mpfr_mem = NULL;
+  b->_mpfr_bytes = 0;
+}
@@ -111,6 +111,16 @@ mpfr_log (mpfr_ptr r, mpfr_srcptr a, mpfr_rnd_t rnd_mode)
       p += GMP_NUMB_BITS - (p%GMP_NUMB_BITS); */
 
   MPFR_SAVE_EXPO_MARK (expo);
+
+  /* Small precision: table-driven algorithm, see explog_tab.c */
+  if (q <= MPFR_EXPLOG_TAB_THRESHOLD &&
+      mpfr_log_tab (r, a, rnd_mode, &inexact))
+    {
+      MPFR_SAVE_EXPO_FREE (expo);
+      return mpfr_check_range (r, inexact, rnd_mode);
+    }
+
+  MPFR_ZIV_ADAPT (loop, p);
   MPFR_GROUP_INIT_2 (group, p, tmp1, tmp2);
 
   MPFR_ZIV_INIT (loop, p);
@@ -0,0 +1,221 @@
+/* mpfr_log_ui -- compute natural logarithm of an unsigned long
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* Auxiliary function: with x = p/2^k, compute the terms from n1 to n2
+   (excluded) of sum((-x)^(i-n1)/(i+1), i = n1..n2-1) as
+   T[0] / (Q[0] * 2^(k*(n2-n1-1))), where Q[0] = (n1+1)*...*n2.
+   Compute P[0] = (-p)^(n2-n1) only when need_P is non-zero.
+   Need 1+ceil(log(n2-n1)/log(2)) cells in T[],P[],Q[]. */
+static void
+S (mpz_t *T, mpz_t *P, mpz_t *Q, unsigned long n1, unsigned long n2,
+   long p, unsigned long k, int need_P)
+{
+  if (n2 == n1 + 1)
+    {
+      mpz_set_ui (T[0], 1);
+      mpz_set_ui (Q[0], n2);
+      if (need_P)
+        mpz_set_si (P[0], - p);
+    }
+  else
+    {
+      unsigned long m = (n1 / 2) + (n2 / 2) + (n1 & 1UL & n2);
+
+      /* S(n1,n2) = S(n1,m) + (-x)^(m-n1) S(m,n2), thus
+         T = T1 * Q2 * 2^(k*(n2-m)) + P1 * Q1 * T2, Q = Q1 * Q2,
+         P = P1 * P2 */
+      S (T, P, Q, n1, m, p, k, 1);
+      S (T + 1, P + 1, Q + 1, m, n2, p, k, need_P);
+      mpz_mul (T[0], T[0], Q[1]);
+      mpz_mul_2exp (T[0], T[0], k * (n2 - m));
+      mpz_mul (T[1], T[1], P[0]);
+      mpz_mul (T[1], T[1], Q[0]);
+      mpz_add (T[0], T[0], T[1]);
+      mpz_mul (Q[0], Q[0], Q[1]);
+      if (need_P)
+        mpz_mul (P[0], P[0], P[1]);
+    }
+}
+
+/* Compute log(n) as suggested in the TODO file: with 2/3 <= n/2^k < 4/3,
+   log(n) = k*log(2) + log(1+x) with x = (n-2^k)/2^k = p/2^kk, |x| <= 1/3,
+   p odd. The cached value of log(2) is used, and
+   log(1+x) = x*sum((-x)^i/(i+1)) is evaluated by binary splitting.
+   Each term gains at least kk-b bits, where |p| < 2^b, but costs about
+   kk+log2(i) bits in the integers of the binary splitting, which makes it
+   slower than mpfr_log (table-driven in small precision, AGM otherwise)
+   unless n is close to a power of 2. Thus the binary splitting is only
+   used when the precision of the result is at least MPFR_LOG_UI_THRESHOLD1
+   and kk-b >= MPFR_LOG_UI_THRESHOLD2; mpfr_log is called on n otherwise. */
+int
+mpfr_log_ui (mpfr_ptr x, unsigned long n, mpfr_rnd_t rnd_mode)
+{
+  unsigned long k, kk, b, d, N, lgN, i, u;
+  long p;
+  mpfr_prec_t w;
+  mpz_t *T, *P, *Q;
+  mpfr_t t, q;
+  int inexact;
+  MPFR_GROUP_DECL (group);
+  MPFR_TMP_DECL (marker);
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  MPFR_LOG_FUNC
+    (("n=%lu rnd=%d", n, rnd_mode),
+     ("x[%Pu]=%.*Rg inexact=%d", mpfr_get_prec (x), mpfr_log_prec, x,
+      inexact));
+
+  if (n <= 2)
+    {
+      if (n == 0)
+        {
+          /* log(0) is an exact -infinity */
+          MPFR_SET_INF (x);
+          MPFR_SET_NEG (x);
+          MPFR_SET_DIVBY0 ();
+          MPFR_RET (0);
+        }
+      else if (n == 1)
+        {
+          /* only case where the result is exact */
+          MPFR_SET_ZERO (x);
+          MPFR_SET_POS (x);
+          MPFR_RET (0);
+        }
+      return mpfr_const_log2 (x, rnd_mode);
+    }
+
+  /* Argument reduction: with 2^(b-1) <= n < 2^b, k = b-1 if
+     3*(n-2^(b-1)) < 2^(b-1), and k = b otherwise. Then p = n - 2^k, and
+     |p| <= 2^k/3 < LONG_MAX, thus p fits in a long. */
+  for (b = 0, u = n; u != 0; u >>= 1)
+    b++;
+  d = n - (1UL << (b - 1));
+  if (d <= ((1UL << (b - 1)) - 1) / 3)
+    {
+      k = b - 1;
+      p = (long) d;
+    }
+  else
+    {
+      k = b;
+      /* 2^b - n, computed modulo ULONG_MAX+1 */
+      p = - (long) (((1UL << (b - 1)) - n) + (1UL << (b - 1)));
+    }
+
+  /* x = p/2^kk with p odd (if p <> 0) */
+  kk = k;
+  if (p != 0)
+    while ((p & 1) == 0)
+      {
+        p /= 2;
+        kk --;
+      }
+  /* |p| < 2^b, thus each term gains at least kk-b >= 1 bits */
+  for (b = 0, u = SAFE_ABS (unsigned long, p); u != 0; u >>= 1)
+    b++;
+  MPFR_ASSERTD (p == 0 || kk > b);
+
+  if (p != 0 && (MPFR_PREC (x) < MPFR_LOG_UI_THRESHOLD1 ||
+                 kk - b < MPFR_LOG_UI_THRESHOLD2))
+    {
+      mpfr_t nn;
+      mp_limb_t np[(sizeof (unsigned long) * CHAR_BIT - 1)
+                   / GMP_NUMB_BITS + 1];
+
+      MPFR_TMP_INIT1 (np, nn, sizeof (unsigned long) * CHAR_BIT);
+      inexact = mpfr_set_ui (nn, n, MPFR_RNDN);
+      MPFR_ASSERTD (inexact == 0);
+      return mpfr_log (x, nn, rnd_mode);
+    }
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  w = MPFR_PREC (x) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (x)) + 10;
+  MPFR_GROUP_INIT_2 (group, w, t, q);
+
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      /* log(1+x) = x*sum((-x)^i/(i+1), i=0..N-1) with an error less than
+         |x|^(N+1)*3/2 <= 2^(-w-1) since |x| <= 1/3 and |x|^N <= 2^(-w) */
+      if (p != 0)
+        {
+          N = (w - 1) / (kk - b) + 1;
+          lgN = MPFR_INT_CEIL_LOG2 (N) + 1;
+          MPFR_TMP_MARK (marker);
+          T = (mpz_t *) MPFR_TMP_ALLOC (3 * lgN * sizeof (mpz_t));
+          P = T + lgN;
+          Q = P + lgN;
+          for (i = 0; i < lgN; i++)
+            {
+              mpz_init (T[i]);
+              mpz_init (P[i]);
+              mpz_init (Q[i]);
+            }
+          S (T, P, Q, 0, N, p, kk, 0);
+          /* log(1+x) = p*T[0] / (Q[0] * 2^(kk*N)) */
+          mpfr_set_z (t, T[0], MPFR_RNDN);
+          mpfr_mul_si (t, t, p, MPFR_RNDN);
+          mpfr_set_z (q, Q[0], MPFR_RNDN);
+          mpfr_div (t, t, q, MPFR_RNDN);
+          mpfr_div_2ui (t, t, kk * N, MPFR_RNDN);
+          for (i = 0; i < lgN; i++)
+            {
+              mpz_clear (T[i]);
+              mpz_clear (P[i]);
+              mpz_clear (Q[i]);
+            }
+          MPFR_TMP_FREE (marker);
+          /* Four roundings with a relative error <= 2^(-w) each, on a
+             value less than log(3/2) < 0.41, plus the truncation error:
+             the absolute error on t is less than 2^(2-w). */
+        }
+      else
+        MPFR_SET_ZERO (t);
+
+      /* argument reconstruction: q = k*log(2) with two roundings, thus
+         with an error less than 2.01*2^(-w)*k*log(2) < 4*2^(-w)*log(n)
+         since |log(n) - k*log(2)| < 0.41 and log(n) >= log(3) > 1.09 */
+      mpfr_const_log2 (q, MPFR_RNDN);
+      mpfr_mul_ui (q, q, k, MPFR_RNDN);
+      mpfr_add (t, t, q, MPFR_RNDN);
+      /* The total error is less than 2^(2-w) + 2^(EXP(t)+2-w)
+         + 2^(EXP(t)-w-1) < 2^(EXP(t)+4-w), since EXP(t) >= 1. */
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (t, w - 4, MPFR_PREC (x), rnd_mode)))
+        break;
+
+      MPFR_ZIV_NEXT (loop, w);
+      MPFR_GROUP_REPREC_2 (group, w, t, q);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  inexact = mpfr_set (x, t, rnd_mode);
+  MPFR_GROUP_CLEAR (group);
+
+  MPFR_SAVE_EXPO_FREE (expo);
+  return mpfr_check_range (x, inexact, rnd_mode);
+}
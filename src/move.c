@@ -0,0 +1,56 @@
+/* mpfr_move -- move a floating-point number to another variable,
+   transferring its significand
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* Set dst to the value and the precision of src, then clear src (as
+   mpfr_clear does). The significand of src is transferred to dst, whose
+   significand is freed, except when it is stored in a buffer given to
+   mpfr_init2_inline (possibly by mpfr_init_block): as this buffer may not
+   live as long as dst, the significand is then copied into dst. No
+   flag is modified, even if src is NaN. */
+void
+mpfr_move (mpfr_ptr dst, mpfr_ptr src)
+{
+  if (MPFR_UNLIKELY (dst == src))
+    return;
+
+  if (MPFR_UNLIKELY (MPFR_IS_INLINE_ALLOC (src)))
+    {
+      mpfr_set_prec (dst, MPFR_PREC (src));
+      if (! MPFR_IS_SINGULAR (src))
+        MPN_COPY (MPFR_MANT (dst), MPFR_MANT (src), MPFR_LIMB_SIZE (src));
+      MPFR_SIGN (dst) = MPFR_SIGN (src);
+      MPFR_EXP (dst) = MPFR_EXP (src);
+      mpfr_clear (src);
+    }
+  else
+    {
+      mpfr_clear (dst);
+      MPFR_PREC (dst) = MPFR_PREC (src);
+      MPFR_SIGN (dst) = MPFR_SIGN (src);
+      MPFR_EXP (dst) = MPFR_EXP (src);
+      MPFR_MANT (dst) = MPFR_MANT (src);
+      MPFR_MANT (src) = (mp_limb_t *) 0;
+    }
+}
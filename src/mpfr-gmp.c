@@ -311,14 +311,23 @@ MPFR_THREAD_ATTR void * (*mpfr_allocate_func) (size_t) = 0;
 MPFR_THREAD_ATTR void * (*mpfr_reallocate_func) (void *, size_t, size_t) = 0;
 MPFR_THREAD_ATTR void   (*mpfr_free_func) (void *, size_t) = 0;
 
+/* With --enable-scratch-arena, the blocks are allocated in the per-thread
+   arena (see scratch.c), which avoids calls to the memory functions. */
+#ifdef MPFR_WANT_SCRATCH_ARENA
+# define TMP_HEAP_ALLOC(n) mpfr_scratch_alloc (n)
+# define TMP_HEAP_FREE(p, n) mpfr_scratch_free (p, n)
+#else
+# define TMP_HEAP_ALLOC(n) (*__gmp_allocate_func) (n)
+# define TMP_HEAP_FREE(p, n) (*__gmp_free_func) (p, n)
+#endif
+
 void *
 mpfr_tmp_allocate (struct tmp_marker **tmp_marker, size_t size)
 {
   struct tmp_marker *head;
 
-  head = (struct tmp_marker *)
-    (*__gmp_allocate_func) (sizeof (struct tmp_marker));
-  head->ptr = (*__gmp_allocate_func) (size);
+  head = (struct tmp_marker *) TMP_HEAP_ALLOC (sizeof (struct tmp_marker));
+  head->ptr = TMP_HEAP_ALLOC (size);
   head->size = size;
   head->next = *tmp_marker;
   *tmp_marker = head;
@@ -333,9 +342,9 @@ mpfr_tmp_free (struct tmp_marker *tmp_marker)
   while (tmp_marker != NULL)
     {
       t = tmp_marker;
-      (*__gmp_free_func) (t->ptr, t->size);
+      TMP_HEAP_FREE (t->ptr, t->size);
       tmp_marker = t->next;
-      (*__gmp_free_func) (t, sizeof (struct tmp_marker));
+      TMP_HEAP_FREE (t, sizeof (struct tmp_marker));
     }
 }
 
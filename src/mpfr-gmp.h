@@ -336,6 +336,29 @@ __MPFR_DECLSPEC void mpfr_tmp_free _MPFR_PROTO ((struct tmp_marker *));
   } while (0)
 #endif
 
+/* udiv_qrnnd_preinv macro, adapted from GMP 5.0.2, file gmp-impl.h.
+   Divide the two-limb number {nh, nl} by d, where the most significant
+   bit of d is set and nh < d, with di = invert_limb (d). */
+#ifndef udiv_qrnnd_preinv
+#define udiv_qrnnd_preinv(q, r, nh, nl, d, di)                          \
+  do {                                                                  \
+    mp_limb_t _qh, _ql, _r, _mask;                                      \
+    umul_ppmm (_qh, _ql, (nh), (di));                                   \
+    add_ssaaaa (_qh, _ql, _qh, _ql, (nh) + 1, (nl));                    \
+    _r = (nl) - _qh * (d);                                              \
+    _mask = - (mp_limb_t) (_r > _ql); /* both > and >= are OK */        \
+    _qh += _mask;                                                       \
+    _r += _mask & (d);                                                  \
+    if (MPFR_UNLIKELY (_r >= (d)))                                      \
+      {                                                                 \
+        _r -= (d);                                                      \
+        _qh++;                                                          \
+      }                                                                 \
+    (r) = _r;                                                           \
+    (q) = _qh;                                                          \
+  } while (0)
+#endif
+
 /* udiv_qr_3by2 macro, adapted from GMP 5.0.2, file gmp-impl.h.
    Compute quotient the quotient and remainder for n / d. Requires d
    >= B^2 / 2 and n < d B. dinv is the inverse
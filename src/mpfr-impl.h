@@ -196,11 +196,15 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 extern "C" {
 #endif
 
-/* Cache struct */
+/* Cache struct. If mapped is non-zero, the significand of x is in a
+   read-only mapping of a file (see mpfr_import_cache), thus must not be
+   freed or reallocated. */
 struct __gmpfr_cache_s {
   mpfr_t x;
   int inexact;
   int (*func)(mpfr_ptr, mpfr_rnd_t);
+  int mapped;
+  MPFR_LOCK_DECL(lock)
 };
 typedef struct __gmpfr_cache_s mpfr_cache_t[1];
 typedef struct __gmpfr_cache_s *mpfr_cache_ptr;
@@ -210,12 +214,14 @@ __MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_exp_t   __gmpfr_emin;
 __MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_exp_t   __gmpfr_emax;
 __MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_prec_t  __gmpfr_default_fp_bit_precision;
 __MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_rnd_t   __gmpfr_default_rounding_mode;
-__MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_cache_t __gmpfr_cache_const_euler;
-__MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_cache_t __gmpfr_cache_const_catalan;
+__MPFR_DECLSPEC extern MPFR_THREAD_ATTR unsigned int __gmpfr_nthreads;
+__MPFR_DECLSPEC extern MPFR_CACHE_ATTR mpfr_cache_t __gmpfr_cache_const_euler;
+__MPFR_DECLSPEC extern MPFR_CACHE_ATTR mpfr_cache_t __gmpfr_cache_const_catalan;
+__MPFR_DECLSPEC extern MPFR_CACHE_ATTR mpfr_cache_t __gmpfr_cache_const_two_over_pi;
 
 #ifndef MPFR_USE_LOGGING
-__MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_cache_t __gmpfr_cache_const_pi;
-__MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_cache_t __gmpfr_cache_const_log2;
+__MPFR_DECLSPEC extern MPFR_CACHE_ATTR mpfr_cache_t __gmpfr_cache_const_pi;
+__MPFR_DECLSPEC extern MPFR_CACHE_ATTR mpfr_cache_t __gmpfr_cache_const_log2;
 #else
 /* Two constants are used by the logging functions (via mpfr_fprintf,
    then mpfr_log, for the base conversion): pi and log(2). Since the
@@ -257,6 +263,7 @@ __MPFR_DECLSPEC extern const mpfr_t __gmpfr_const_log2_RNDU;
   ((mpfr_rnd_t) __gmpfr_default_rounding_mode)
 #define mpfr_get_default_prec() \
   ((mpfr_prec_t) __gmpfr_default_fp_bit_precision)
+#define mpfr_get_nthreads() ((unsigned int) __gmpfr_nthreads)
 
 /* Flags related macros. */
 /* Note: Function-like macros that modify __gmpfr_flags are not defined
@@ -898,9 +905,11 @@ typedef intmax_t mpfr_eexp_t;
  ************** Rounding mode macros  *****************
  ******************************************************/
 
-/* MPFR_RND_MAX gives the number of supported rounding modes by all functions.
- * Once faithful rounding is implemented, MPFR_RNDA should be changed
- * to MPFR_RNDF. But this will also require more changes in the tests.
+/* MPFR_RND_MAX gives the number of rounding modes that yield a correctly
+ * rounded result with a meaningful ternary value. MPFR_RNDF (faithful
+ * rounding) is accepted by all functions, but is not included here since
+ * neither the result nor the ternary value are fully specified, so that
+ * the tests looping over the rounding modes cannot check it.
  */
 #define MPFR_RND_MAX ((mpfr_rnd_t)((MPFR_RNDA)+1))
 
@@ -982,6 +991,11 @@ typedef union { mp_size_t s; mp_limb_t l; } mpfr_size_limb_t;
 #define MPFR_GET_REAL_PTR(x) \
    ((mp_limb_t*) ((mpfr_size_limb_t*) MPFR_MANT(x) - 1))
 
+/* A significand stored in a buffer given to mpfr_init2_inline has the same
+   layout, but its alloc size is the opposite of the number of limbs of the
+   buffer, so that it is never freed nor reallocated. */
+#define MPFR_IS_INLINE_ALLOC(x) (MPFR_GET_ALLOC_SIZE(x) < 0)
+
 /* Temporary memory handling */
 #ifndef TMP_SALLOC
 /* GMP 4.1.x or below or internals */
@@ -1030,8 +1044,8 @@ typedef union { mp_size_t s; mp_limb_t l; } mpfr_size_limb_t;
 #define mpfr_const_catalan(_d,_r) mpfr_cache(_d,__gmpfr_cache_const_catalan,_r)
 
 #define MPFR_DECL_INIT_CACHE(_cache,_func)                           \
-  MPFR_THREAD_ATTR mpfr_cache_t _cache =                             \
-    {{{{0,MPFR_SIGN_POS,0,(mp_limb_t*)0}},0,_func}}
+  MPFR_CACHE_ATTR mpfr_cache_t _cache =                              \
+    {{{{0,MPFR_SIGN_POS,0,(mp_limb_t*)0}},0,_func,0 MPFR_LOCK_INITIALIZER}}
 
 
 
@@ -1375,7 +1389,7 @@ typedef struct {
             _mask = MPFR_LIMB_ONE << (_sh - 1);                             \
             _rb = _sp[0] & _mask;                                           \
             _sb = _sp[0] & (_mask - 1);                                     \
-            if (MPFR_UNLIKELY (_sb == 0) &&                                 \
+            if (MPFR_UNLIKELY (_sb == 0) && (rnd) != MPFR_RNDF &&           \
                 ((rnd) == MPFR_RNDN || _rb == 0))                           \
               { /* TODO: Improve it */                                      \
                 mp_limb_t *_tmp;                                            \
@@ -1392,7 +1406,7 @@ typedef struct {
             /* Compute Rounding Bit and Sticky Bit - see note above */      \
             _rb = _sp[-1] & MPFR_LIMB_HIGHBIT;                              \
             _sb = _sp[-1] & (MPFR_LIMB_HIGHBIT-1);                          \
-            if (MPFR_UNLIKELY (_sb == 0) &&                                 \
+            if (MPFR_UNLIKELY (_sb == 0) && (rnd) != MPFR_RNDF &&           \
                 ((rnd) == MPFR_RNDN || _rb == 0))                           \
               {                                                             \
                 mp_limb_t *_tmp;                                            \
@@ -1433,6 +1447,14 @@ typedef struct {
                 _destp[0] &= ~(_ulp - 1);                                   \
               }                                                             \
           }                                                                 \
+        else if (MPFR_UNLIKELY ((rnd) == MPFR_RNDF))                        \
+          { /* Faithful rounding: round to nearest, ignoring the ties */    \
+            /* and the sticky bit (the ternary value is not specified). */  \
+            if (_rb == 0)                                                   \
+              goto trunc;                                                   \
+            else                                                            \
+              goto addoneulp;                                               \
+          }                                                                 \
         else                                                                \
           { /* Directed rounding mode */                                    \
             if (MPFR_LIKELY (MPFR_IS_LIKE_RNDZ (rnd,                        \
@@ -1488,10 +1510,17 @@ typedef struct {
 
 /* Return TRUE if b is non singular and we can round it to precision 'prec'
    and determine the ternary value, with rounding mode 'rnd', and with
-   error at most 'error' */
+   error at most 'error'.
+   For MPFR_RNDF, the rounding of b with MPFR_RNDF (i.e. to nearest, ties
+   being ignored) is a faithful rounding of the exact value as soon as the
+   error is at most 1/2 ulp, i.e. err >= prec + 1, thus there is no need to
+   look at the bits of b. */
 #define MPFR_CAN_ROUND(b,err,prec,rnd)                                       \
- (!MPFR_IS_SINGULAR (b) && mpfr_round_p (MPFR_MANT (b), MPFR_LIMB_SIZE (b),  \
-                                         (err), (prec) + ((rnd)==MPFR_RNDN)))
+ (!MPFR_IS_SINGULAR (b) &&                                                   \
+  ((rnd) == MPFR_RNDF ?                                                      \
+   (err) > 0 && (mpfr_uexp_t) (err) > (mpfr_uexp_t) (prec) :                 \
+   mpfr_round_p (MPFR_MANT (b), MPFR_LIMB_SIZE (b),                          \
+                 (err), (prec) + ((rnd)==MPFR_RNDN))))
 
 /* Copy the sign and the significand, and handle the exponent in exp. */
 #define MPFR_SETRAW(inexact,dest,src,exp,rnd)                           \
@@ -1602,11 +1631,136 @@ typedef struct {
 #define MPFR_ADD_PREC(P,X) \
   (MPFR_ASSERTN ((X) <= MPFR_PREC_MAX - (P)), (P) + (X))
 
-#ifndef MPFR_USE_LOGGING
+/* Adaptive initial precision of the Ziv loops (--enable-ziv-adaptive, see
+   ziv_adapt.c). MPFR_ZIV_ADAPT (x, p), to be used after MPFR_ZIV_DECL (x)
+   and before the working variables are allocated with precision p, adds
+   to p a number of guard bits learned from the previous calls, in a
+   thread-local record of this loop, for the precision bucket of p. Each
+   first failure of the rounding test, i.e. the first MPFR_ZIV_NEXT of
+   the call, is counted in this bucket. Without --enable-ziv-adaptive,
+   MPFR_ZIV_ADAPT does nothing. */
+#ifdef MPFR_WANT_ZIV_ADAPTIVE
+
+#define MPFR_ZIV_ADAPT_BUCKETS 32
+#define MPFR_ZIV_ADAPT_LEVELS 6
+
+typedef struct {
+  unsigned long calls, fails;     /* in the current window */
+  int level;                      /* current number of guard bits */
+  float rate[MPFR_ZIV_ADAPT_LEVELS];  /* last failure rate at each level */
+  unsigned char age[MPFR_ZIV_ADAPT_LEVELS];  /* 0 if unknown rate */
+} mpfr_ziv_adapt_bucket_t;
+
+typedef struct {
+  mpfr_ziv_adapt_bucket_t b[MPFR_ZIV_ADAPT_BUCKETS];
+} mpfr_ziv_adapt_t;
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+__MPFR_DECLSPEC mpfr_prec_t mpfr_ziv_adapt_enter _MPFR_PROTO
+  ((mpfr_ziv_adapt_t *, int *, mpfr_prec_t));
+__MPFR_DECLSPEC void mpfr_ziv_adapt_fail _MPFR_PROTO ((mpfr_ziv_adapt_t *,
+                                                       int));
+#if defined (__cplusplus)
+}
+#endif
+
+#define MPFR_ZIV_ADAPT_DECL(_x)                                         \
+  mpfr_ziv_adapt_t *_x ## _adapt = NULL;                                \
+  int _x ## _bucket = -1;
+
+#define MPFR_ZIV_ADAPT(_x, _p)                                          \
+  do                                                                    \
+    {                                                                   \
+      static MPFR_THREAD_ATTR mpfr_ziv_adapt_t _x ## _adapt_data;       \
+      _x ## _adapt = &_x ## _adapt_data;                                \
+      (_p) = mpfr_ziv_adapt_enter (_x ## _adapt, &_x ## _bucket, _p);   \
+    }                                                                   \
+  while (0)
+
+#define MPFR_ZIV_ADAPT_NEXT(_x)                                         \
+  (_x ## _bucket >= 0 ?                                                 \
+   (mpfr_ziv_adapt_fail (_x ## _adapt, _x ## _bucket),                  \
+    _x ## _bucket = -1, (void) 0) : (void) 0)
+
+#else
+
+#define MPFR_ZIV_ADAPT_DECL(_x)
+#define MPFR_ZIV_ADAPT(_x, _p) ((void) 0)
+#define MPFR_ZIV_ADAPT_NEXT(_x) ((void) 0)
+
+#endif
+
+#if defined (MPFR_WANT_ZIV_STATS)
+
+# ifdef MPFR_USE_LOGGING
+#  error "Enable either `Logging' or `ziv-stats', not both"
+# endif
+
+/* Statistics on the Ziv loops (--enable-ziv-stats, see ziv_stats.c): each
+   MPFR_ZIV_DECL declares a thread-local record, registered at its first
+   use, with the number of calls, the histogram of the number of
+   iterations (updated by each MPFR_ZIV_NEXT, so that a loop left by a
+   return is still counted), the maximum working precision, and the time
+   spent between MPFR_ZIV_INIT and MPFR_ZIV_FREE. A MPFR_ZIV_FREE reached
+   without MPFR_ZIV_INIT (special cases leaving before the loop) is
+   ignored. */
+
+typedef struct mpfr_ziv_site_s {
+  mpfr_ziv_stats_t s;
+  struct mpfr_ziv_site_s *next;
+} mpfr_ziv_site_t;
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+__MPFR_DECLSPEC double mpfr_ziv_stats_enter _MPFR_PROTO ((mpfr_ziv_site_t *,
+                                                          const char *,
+                                                          mpfr_prec_t));
+__MPFR_DECLSPEC void mpfr_ziv_stats_next _MPFR_PROTO ((mpfr_ziv_site_t *,
+                                                       unsigned int,
+                                                       mpfr_prec_t));
+__MPFR_DECLSPEC void mpfr_ziv_stats_leave _MPFR_PROTO ((mpfr_ziv_site_t *,
+                                                        double));
+#if defined (__cplusplus)
+}
+#endif
+
+#define MPFR_ZIV_DECL(_x)                                               \
+  MPFR_ZIV_ADAPT_DECL (_x)                                              \
+  mpfr_prec_t _x;                                                       \
+  unsigned int _x ## _cpt;                                              \
+  double _x ## _t0 = -1.0;                                              \
+  static MPFR_THREAD_ATTR mpfr_ziv_site_t _x ## _site
+
+#define MPFR_ZIV_INIT(_x, _p)                                           \
+  do                                                                    \
+    {                                                                   \
+      (_x) = GMP_NUMB_BITS;                                             \
+      _x ## _cpt = 1;                                                   \
+      _x ## _t0 = mpfr_ziv_stats_enter (&_x ## _site, __func__, _p);    \
+    }                                                                   \
+  while (0)
 
-#define MPFR_ZIV_DECL(_x) mpfr_prec_t _x
+#define MPFR_ZIV_NEXT(_x, _p)                                           \
+  do                                                                    \
+    {                                                                   \
+      (_p) = MPFR_ADD_PREC (_p, _x);                                    \
+      (_x) = (_p) / 2;                                                  \
+      MPFR_ZIV_ADAPT_NEXT (_x);                                         \
+      mpfr_ziv_stats_next (&_x ## _site, ++ _x ## _cpt, _p);            \
+    }                                                                   \
+  while (0)
+
+#define MPFR_ZIV_FREE(_x) mpfr_ziv_stats_leave (&_x ## _site, _x ## _t0)
+
+#elif !defined (MPFR_USE_LOGGING)
+
+#define MPFR_ZIV_DECL(_x) MPFR_ZIV_ADAPT_DECL (_x) mpfr_prec_t _x
 #define MPFR_ZIV_INIT(_x, _p) (_x) = GMP_NUMB_BITS
-#define MPFR_ZIV_NEXT(_x, _p) ((_p) = MPFR_ADD_PREC (_p, _x), (_x) = (_p)/2)
+#define MPFR_ZIV_NEXT(_x, _p) \
+  ((_p) = MPFR_ADD_PREC (_p, _x), (_x) = (_p)/2, MPFR_ZIV_ADAPT_NEXT (_x))
 #define MPFR_ZIV_FREE(x)
 
 #else
@@ -1626,6 +1780,7 @@ typedef struct {
    in LOG_PRINT. */
 
 #define MPFR_ZIV_DECL(_x)                                               \
+  MPFR_ZIV_ADAPT_DECL (_x)                                              \
   mpfr_prec_t _x;                                                       \
   int _x ## _cpt = 1;                                                   \
   static unsigned long  _x ## _loop = 0, _x ## _bad = 0;                \
@@ -1658,6 +1813,7 @@ typedef struct {
     {                                                                   \
       (_p) = MPFR_ADD_PREC (_p, _x);                                    \
       (_x) = (_p) / 2;                                                  \
+      MPFR_ZIV_ADAPT_NEXT (_x);                                         \
       if (mpfr_log_level >= 0)                                          \
         _x ## _bad += (_x ## _cpt == 1);                                \
       _x ## _cpt ++;                                                    \
@@ -1792,6 +1948,18 @@ __MPFR_DECLSPEC extern mpfr_prec_t mpfr_log_prec;
 # define MPFR_GROUP_STATIC_SIZE 16
 #endif
 
+/* With --enable-scratch-arena, the mantissas of the groups that do not fit
+   in tab are allocated in the per-thread arena (see scratch.c). */
+#ifdef MPFR_WANT_SCRATCH_ARENA
+# define MPFR_GROUP_ALLOC(n) mpfr_scratch_alloc (n)
+# define MPFR_GROUP_REALLOC(p, o, n) mpfr_scratch_realloc (p, o, n)
+# define MPFR_GROUP_FREE(p, n) mpfr_scratch_free (p, n)
+#else
+# define MPFR_GROUP_ALLOC(n) (*__gmp_allocate_func) (n)
+# define MPFR_GROUP_REALLOC(p, o, n) (*__gmp_reallocate_func) (p, o, n)
+# define MPFR_GROUP_FREE(p, n) (*__gmp_free_func) (p, n)
+#endif
+
 struct mpfr_group_t {
   size_t     alloc;
   mp_limb_t *mant;
@@ -1805,7 +1973,7 @@ struct mpfr_group_t {
                 (unsigned long) (g).alloc));                     \
  if (MPFR_UNLIKELY ((g).alloc != 0)) {                           \
    MPFR_ASSERTD ((g).mant != (g).tab);                           \
-   (*__gmp_free_func) ((g).mant, (g).alloc);                     \
+   MPFR_GROUP_FREE ((g).mant, (g).alloc);                        \
  }} while (0)
 
 #define MPFR_GROUP_INIT_TEMPLATE(g, prec, num, handler) do {            \
@@ -1818,7 +1986,7 @@ struct mpfr_group_t {
  if (MPFR_UNLIKELY (_size * (num) > MPFR_GROUP_STATIC_SIZE))            \
    {                                                                    \
      (g).alloc = (num) * _size * sizeof (mp_limb_t);                    \
-     (g).mant = (mp_limb_t *) (*__gmp_allocate_func) ((g).alloc);       \
+     (g).mant = (mp_limb_t *) MPFR_GROUP_ALLOC ((g).alloc);             \
    }                                                                    \
  else                                                                   \
    {                                                                    \
@@ -1868,10 +2036,10 @@ struct mpfr_group_t {
  _size = MPFR_PREC2LIMBS (_prec);                                       \
  (g).alloc = (num) * _size * sizeof (mp_limb_t);                        \
  if (MPFR_LIKELY (_oalloc == 0))                                        \
-   (g).mant = (mp_limb_t *) (*__gmp_allocate_func) ((g).alloc);         \
+   (g).mant = (mp_limb_t *) MPFR_GROUP_ALLOC ((g).alloc);               \
  else                                                                   \
    (g).mant = (mp_limb_t *)                                             \
-     (*__gmp_reallocate_func) ((g).mant, _oalloc, (g).alloc);           \
+     MPFR_GROUP_REALLOC ((g).mant, _oalloc, (g).alloc);                 \
  MPFR_LOG_MSG (("GROUP_REPREC: newptr = 0x%lX, newsize = %lu\n",        \
                 (unsigned long) (g).mant, (unsigned long) (g).alloc));  \
  handler;                                                               \
@@ -1940,6 +2108,10 @@ __MPFR_DECLSPEC mpfr_exp_t mpfr_ceil_mul _MPFR_PROTO ((mpfr_exp_t, int, int));
 
 __MPFR_DECLSPEC int mpfr_exp_2 _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_exp_3 _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_exp_tab _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
+                                               mpfr_rnd_t, int *));
+__MPFR_DECLSPEC int mpfr_log_tab _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
+                                               mpfr_rnd_t, int *));
 __MPFR_DECLSPEC int mpfr_powerof2_raw _MPFR_PROTO ((mpfr_srcptr));
 
 __MPFR_DECLSPEC int mpfr_pow_general _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
@@ -1980,11 +2152,42 @@ __MPFR_DECLSPEC int mpfr_sum_sort _MPFR_PROTO ((mpfr_srcptr *const,
                                                 unsigned long, mpfr_srcptr *,
                                                 mpfr_prec_t *));
 
+/* A regular number z whose exponent is e, where e may be outside the
+   extended exponent range (see sum_wide.c). */
+typedef struct {
+  mpfr_exp_t e;
+  mpfr_ptr z;
+} mpfr_wide_term_t;
+
+__MPFR_DECLSPEC int mpfr_sum_wide _MPFR_PROTO ((mpfr_ptr, mpfr_wide_term_t *,
+                                                unsigned long, mpfr_rnd_t));
+
+/* The bits added to an accumulator by mpfr_acc_add_raw must have weights
+   in [MPFR_ACC_LSB_MIN, MPFR_ACC_MSB_MAX], so that the exponents of its
+   chunks (including the ones receiving the carries) are representable. */
+#define MPFR_ACC_MARGIN (16 * GMP_NUMB_BITS)
+#define MPFR_ACC_LSB_MIN (MPFR_EXP_MIN + MPFR_ACC_MARGIN)
+#define MPFR_ACC_MSB_MAX (MPFR_EXP_MAX - MPFR_ACC_MARGIN)
+
+__MPFR_DECLSPEC void mpfr_acc_add_raw _MPFR_PROTO ((mpfr_acc_ptr,
+                                                   const mp_limb_t *,
+                                                   mp_size_t, mpfr_exp_t,
+                                                   int));
+
+/* Maximum total number of limbs of the exact products that mpfr_dot keeps
+   to sum them with mpfr_sum; above, they are added to an accumulator as
+   soon as they are computed (see dot.c). */
+#ifndef MPFR_DOT_KEEP_MAX
+# define MPFR_DOT_KEEP_MAX 16384
+#endif
+
 __MPFR_DECLSPEC int mpfr_get_cputime _MPFR_PROTO ((void));
 
 __MPFR_DECLSPEC void mpfr_nexttozero _MPFR_PROTO ((mpfr_ptr));
 __MPFR_DECLSPEC void mpfr_nexttoinf _MPFR_PROTO ((mpfr_ptr));
 
+__MPFR_DECLSPEC void mpfr_inline_to_heap _MPFR_PROTO ((mpfr_ptr, mp_size_t));
+
 __MPFR_DECLSPEC int mpfr_const_pi_internal _MPFR_PROTO ((mpfr_ptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_const_log2_internal _MPFR_PROTO((mpfr_ptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_const_euler_internal _MPFR_PROTO((mpfr_ptr, mpfr_rnd_t));
@@ -1997,6 +2200,8 @@ __MPFR_DECLSPEC void mpfr_init_cache _MPFR_PROTO ((mpfr_cache_t,
 __MPFR_DECLSPEC void mpfr_clear_cache _MPFR_PROTO ((mpfr_cache_t));
 __MPFR_DECLSPEC int  mpfr_cache _MPFR_PROTO ((mpfr_ptr, mpfr_cache_t,
                                               mpfr_rnd_t));
+__MPFR_DECLSPEC void mpfr_cache_lock _MPFR_PROTO ((mpfr_cache_t,
+                                                   mpfr_prec_t));
 
 __MPFR_DECLSPEC void mpfr_mulhigh_n _MPFR_PROTO ((mpfr_limb_ptr,
                         mpfr_limb_srcptr, mpfr_limb_srcptr, mp_size_t));
@@ -2006,6 +2211,9 @@ __MPFR_DECLSPEC void mpfr_sqrhigh_n _MPFR_PROTO ((mpfr_limb_ptr,
                         mpfr_limb_srcptr, mp_size_t));
 __MPFR_DECLSPEC mp_limb_t mpfr_divhigh_n _MPFR_PROTO ((mpfr_limb_ptr,
                         mpfr_limb_ptr, mpfr_limb_ptr, mp_size_t));
+#if GMP_NUMB_BITS == 64
+__MPFR_DECLSPEC mp_limb_t mpfr_rec_sqrt_limb _MPFR_PROTO ((mp_limb_t));
+#endif
 
 __MPFR_DECLSPEC int mpfr_round_p _MPFR_PROTO ((mp_limb_t *, mp_size_t,
                                                mpfr_exp_t, mpfr_prec_t));
@@ -2021,9 +2229,22 @@ __MPFR_DECLSPEC void mpfr_rand_raw _MPFR_PROTO((mpfr_limb_ptr, gmp_randstate_t,
 
 __MPFR_DECLSPEC mpz_srcptr mpfr_bernoulli_cache _MPFR_PROTO ((unsigned long));
 __MPFR_DECLSPEC void mpfr_bernoulli_freecache _MPFR_PROTO ((void));
+__MPFR_DECLSPEC void mpfr_const_log2_freecache _MPFR_PROTO ((void));
+__MPFR_DECLSPEC void mpfr_explog_tab_freecache _MPFR_PROTO ((void));
+__MPFR_DECLSPEC void mpfr_cache_unmap_files _MPFR_PROTO ((void));
 
 __MPFR_DECLSPEC int mpfr_sincos_fast _MPFR_PROTO((mpfr_t, mpfr_t,
                                                   mpfr_srcptr, mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_const_two_over_pi_internal _MPFR_PROTO ((mpfr_ptr,
+                                                                  mpfr_rnd_t));
+__MPFR_DECLSPEC void mpfr_payne_hanek _MPFR_PROTO ((mpfr_ptr, long *,
+                                                    mpfr_srcptr));
+
+/* Maximum precision of the cache of 2/Pi used by mpfr_payne_hanek. Beyond
+   it, 2/Pi is recomputed for each call instead of extending the cache. */
+#ifndef MPFR_PAYNE_HANEK_CACHE_MAX
+# define MPFR_PAYNE_HANEK_CACHE_MAX MPFR_PREC_MAX
+#endif
 
 __MPFR_DECLSPEC double mpfr_scale2 _MPFR_PROTO((double, int));
 
@@ -2036,6 +2257,37 @@ __MPFR_DECLSPEC void mpfr_gamma_one_and_two_third _MPFR_PROTO((mpfr_ptr, mpfr_pt
 __MPFR_DECLSPEC void mpfr_mpz_init _MPFR_PROTO((mpz_ptr));
 __MPFR_DECLSPEC void mpfr_mpz_clear _MPFR_PROTO((mpz_ptr));
 
+#ifdef MPFR_WANT_SCRATCH_ARENA
+__MPFR_DECLSPEC void *mpfr_scratch_alloc _MPFR_PROTO((size_t));
+__MPFR_DECLSPEC void *mpfr_scratch_realloc _MPFR_PROTO((void *, size_t,
+                                                        size_t));
+__MPFR_DECLSPEC void mpfr_scratch_free _MPFR_PROTO((void *, size_t));
+#endif
+
+typedef void (*mpfr_task_func) _MPFR_PROTO((void *));
+__MPFR_DECLSPEC void mpfr_parallel_run _MPFR_PROTO((mpfr_task_func, void *,
+                                                    size_t, unsigned int));
+__MPFR_DECLSPEC void mpfr_parallel_init _MPFR_PROTO((unsigned int));
+__MPFR_DECLSPEC void mpfr_free_tmp_cache _MPFR_PROTO((void));
+
+/* Parallel binary splitting (see bs_mt.c) */
+#ifndef MPFR_BS_MT_THRESHOLD
+# define MPFR_BS_MT_THRESHOLD 4096 /* terms */
+#endif
+#ifndef MPFR_BS_MT_LIMBS
+# define MPFR_BS_MT_LIMBS 1000
+#endif
+#define MPFR_BS_SPLIT_P(nthreads, n) \
+  ((nthreads) > 1 && (n) >= MPFR_BS_MT_THRESHOLD)
+typedef void (*mpfr_bs_func) _MPFR_PROTO((void *, unsigned long,
+                                          unsigned long, unsigned int));
+__MPFR_DECLSPEC void mpfr_bs_split _MPFR_PROTO((mpfr_bs_func, void *, void *,
+                                                unsigned long, unsigned long,
+                                                unsigned long, unsigned int));
+__MPFR_DECLSPEC void mpfr_bs_mul _MPFR_PROTO((mpz_ptr *, mpz_srcptr *,
+                                              mpz_srcptr *, int,
+                                              unsigned int));
+
 #if defined (__cplusplus)
 }
 #endif
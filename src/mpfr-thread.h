@@ -48,4 +48,30 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 # endif
 #endif
 
+/* With --enable-shared-cache, the caches of the constants are shared by
+   all the threads (thus they are not thread-local), and the accesses to
+   each cache are protected by a read-write lock. */
+#ifdef MPFR_WANT_SHARED_CACHE
+# ifndef MPFR_USE_THREAD_SAFE
+#  error "--enable-shared-cache needs a thread-safe build of MPFR"
+# endif
+# include <pthread.h>
+# define MPFR_CACHE_ATTR
+# define MPFR_LOCK_DECL(_lock) pthread_rwlock_t _lock;
+# define MPFR_LOCK_INITIALIZER , PTHREAD_RWLOCK_INITIALIZER
+# define MPFR_LOCK_READ(_lock)                                 \
+  MPFR_ASSERTN (pthread_rwlock_rdlock (&(_lock)) == 0)
+# define MPFR_LOCK_WRITE(_lock)                                \
+  MPFR_ASSERTN (pthread_rwlock_wrlock (&(_lock)) == 0)
+# define MPFR_UNLOCK(_lock)                                    \
+  MPFR_ASSERTN (pthread_rwlock_unlock (&(_lock)) == 0)
+#else
+# define MPFR_CACHE_ATTR MPFR_THREAD_ATTR
+# define MPFR_LOCK_DECL(_lock)
+# define MPFR_LOCK_INITIALIZER
+# define MPFR_LOCK_READ(_lock)  ((void) 0)
+# define MPFR_LOCK_WRITE(_lock) ((void) 0)
+# define MPFR_UNLOCK(_lock)     ((void) 0)
+#endif
+
 #endif
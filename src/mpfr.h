@@ -92,8 +92,9 @@ typedef unsigned int    mpfr_flags_t;
    MPFR_RNDU must appear just before MPFR_RNDD (see
    MPFR_IS_RNDUTEST_OR_RNDDNOTTEST in mpfr-impl.h).
 
-   MPFR_RNDF has been added, though not implemented yet, in order to avoid
-   to break the ABI once faithful rounding gets implemented.
+   MPFR_RNDF is the faithful rounding: the result is either the rounding
+   toward -Inf or the rounding toward +Inf of the exact value, and the
+   ternary value is not specified.
 
    If you change the order of the rounding modes, please update the routines
    in texceptions.c which assume 0=RNDN, 1=RNDZ, 2=RNDU, 3=RNDD, 4=RNDA.
@@ -104,7 +105,7 @@ typedef enum {
   MPFR_RNDU,    /* round toward +Inf */
   MPFR_RNDD,    /* round toward -Inf */
   MPFR_RNDA,    /* round away from zero */
-  MPFR_RNDF,    /* faithful rounding (not implemented yet) */
+  MPFR_RNDF,    /* faithful rounding */
   MPFR_RNDNA=-1 /* round to nearest, with ties away from zero (mpfr_round) */
 } mpfr_rnd_t;
 
@@ -229,6 +230,97 @@ typedef __mpfr_struct mpfr_t[1];
 typedef __mpfr_struct *mpfr_ptr;
 typedef const __mpfr_struct *mpfr_srcptr;
 
+/* Exact accumulator for sums (see the mpfr_acc_* functions). The fields
+   are internal: the finite part of the accumulated value is held in
+   _mpfr_size chunks of limbs _mpfr_d, whose positions are given by the
+   increasing indices _mpfr_idx (see acc.c), and _mpfr_state records the
+   special values that have been added. */
+typedef struct {
+  mp_size_t    _mpfr_size;
+  mp_size_t    _mpfr_alloc;
+  mpfr_exp_t  *_mpfr_idx;
+  mp_limb_t   *_mpfr_d;
+  int          _mpfr_state;
+} __mpfr_acc_struct;
+
+typedef __mpfr_acc_struct mpfr_acc_t[1];
+typedef __mpfr_acc_struct *mpfr_acc_ptr;
+typedef const __mpfr_acc_struct *mpfr_acc_srcptr;
+
+/* Divisor with precomputed data (see mpfr_divisor_init and mpfr_div_pre).
+   The fields are internal: _mpfr_v is a copy of the divisor, _mpfr_dinv
+   the inverse of its one or two limbs (if it has at most two limbs), and
+   _mpfr_inv an approximation of the inverse of its significand (if it is
+   large enough), or has a null significand pointer. */
+typedef struct {
+  __mpfr_struct _mpfr_v;
+  __mpfr_struct _mpfr_inv;
+  mp_limb_t     _mpfr_dinv;
+} __mpfr_divisor_struct;
+
+typedef __mpfr_divisor_struct mpfr_divisor_t[1];
+typedef __mpfr_divisor_struct *mpfr_divisor_ptr;
+typedef const __mpfr_divisor_struct *mpfr_divisor_srcptr;
+
+/* Array of numbers of the same precision (see the mpfr_array_* functions).
+   The fields are internal: _mpfr_tab is the table of the _mpfr_alloc
+   elements, allocated with their significands in a single block, the
+   significand of the i-th element being at _mpfr_mant + i * (the size of a
+   significand of precision _mpfr_prec), and _mpfr_size elements are used. */
+typedef struct {
+  mpfr_prec_t    _mpfr_prec;
+  mpfr_size_t    _mpfr_size;
+  mpfr_size_t    _mpfr_alloc;
+  __mpfr_struct *_mpfr_tab;
+  mp_limb_t     *_mpfr_mant;
+} __mpfr_array_struct;
+
+typedef __mpfr_array_struct mpfr_array_t[1];
+typedef __mpfr_array_struct *mpfr_array_ptr;
+typedef const __mpfr_array_struct *mpfr_array_srcptr;
+
+/* Block holding the significands of several variables (see mpfr_init_block
+   and mpfr_clear_block). The fields are internal: _mpfr_mem is the block of
+   _mpfr_bytes bytes, allocated with the memory functions. */
+typedef struct {
+  void       *_mpfr_mem;
+  mpfr_size_t _mpfr_bytes;
+} __mpfr_block_struct;
+
+typedef __mpfr_block_struct mpfr_block_t[1];
+typedef __mpfr_block_struct *mpfr_block_ptr;
+
+/* Caches that can be freed by mpfr_free_cache2: the local cache is the one
+   of the current thread, the global cache is the one shared by all the
+   threads (only with --enable-shared-cache). */
+typedef enum {
+  MPFR_FREE_LOCAL_CACHE  = 1,
+  MPFR_FREE_GLOBAL_CACHE = 2
+} mpfr_free_cache_t;
+
+/* Statistics on the Ziv loops of a function, see mpfr_ziv_stats_get
+   (only recorded with --enable-ziv-stats). iter[k] is the number of calls
+   which needed k+1 iterations, the last entry counting all the calls with
+   at least MPFR_ZIV_STATS_BINS iterations. */
+#define MPFR_ZIV_STATS_BINS 8
+typedef struct {
+  const char    *name;
+  unsigned long  calls;
+  unsigned long  iter[MPFR_ZIV_STATS_BINS];
+  mpfr_prec_t    max_prec;
+  double         time;
+} mpfr_ziv_stats_t;
+
+/* Constants for mpfr_prewarm_cache */
+#define MPFR_CACHE_PI      1
+#define MPFR_CACHE_LOG2    2
+#define MPFR_CACHE_EULER   4
+#define MPFR_CACHE_CATALAN 8
+#define MPFR_CACHE_ALL (MPFR_CACHE_PI    | \
+                        MPFR_CACHE_LOG2  | \
+                        MPFR_CACHE_EULER | \
+                        MPFR_CACHE_CATALAN)
+
 /* For those who need a direct and fast access to the sign field.
    However it is not in the API, thus use it at your own risk: it might
    not be supported, or change name, in further versions!
@@ -330,6 +422,14 @@ __MPFR_DECLSPEC int mpfr_buildopt_tls_p          _MPFR_PROTO ((void));
 __MPFR_DECLSPEC int mpfr_buildopt_decimal_p      _MPFR_PROTO ((void));
 __MPFR_DECLSPEC int mpfr_buildopt_gmpinternals_p _MPFR_PROTO ((void));
 __MPFR_DECLSPEC const char * mpfr_buildopt_tune_case _MPFR_PROTO ((void));
+__MPFR_DECLSPEC int mpfr_buildopt_zivstats_p     _MPFR_PROTO ((void));
+__MPFR_DECLSPEC int mpfr_ziv_stats_get _MPFR_PROTO ((mpfr_ziv_stats_t *,
+                                                     unsigned long));
+__MPFR_DECLSPEC void mpfr_ziv_stats_reset _MPFR_PROTO ((void));
+__MPFR_DECLSPEC int mpfr_buildopt_scratch_p      _MPFR_PROTO ((void));
+__MPFR_DECLSPEC void mpfr_scratch_set_max _MPFR_PROTO ((size_t));
+__MPFR_DECLSPEC size_t mpfr_scratch_get_max _MPFR_PROTO ((void));
+__MPFR_DECLSPEC void mpfr_scratch_release _MPFR_PROTO ((void));
 
 __MPFR_DECLSPEC mpfr_exp_t mpfr_get_emin     _MPFR_PROTO ((void));
 __MPFR_DECLSPEC int        mpfr_set_emin     _MPFR_PROTO ((mpfr_exp_t));
@@ -378,6 +478,8 @@ __MPFR_DECLSPEC int
   mpfr_check_range _MPFR_PROTO ((mpfr_ptr, int, mpfr_rnd_t));
 
 __MPFR_DECLSPEC void mpfr_init2 _MPFR_PROTO ((mpfr_ptr, mpfr_prec_t));
+__MPFR_DECLSPEC void mpfr_init2_inline _MPFR_PROTO ((mpfr_ptr, mpfr_prec_t,
+                                                     void *, size_t));
 __MPFR_DECLSPEC void mpfr_init _MPFR_PROTO ((mpfr_ptr));
 __MPFR_DECLSPEC void mpfr_clear _MPFR_PROTO ((mpfr_ptr));
 
@@ -387,6 +489,12 @@ __MPFR_DECLSPEC void
   mpfr_inits _MPFR_PROTO ((mpfr_ptr, ...)) __MPFR_SENTINEL_ATTR;
 __MPFR_DECLSPEC void
   mpfr_clears _MPFR_PROTO ((mpfr_ptr, ...)) __MPFR_SENTINEL_ATTR;
+__MPFR_DECLSPEC void
+  mpfr_init_block _MPFR_PROTO ((mpfr_block_ptr, mpfr_prec_t, ...))
+  __MPFR_SENTINEL_ATTR;
+__MPFR_DECLSPEC void
+  mpfr_clear_block _MPFR_PROTO ((mpfr_block_ptr, ...))
+  __MPFR_SENTINEL_ATTR;
 
 __MPFR_DECLSPEC int
   mpfr_prec_round _MPFR_PROTO ((mpfr_ptr, mpfr_prec_t, mpfr_rnd_t));
@@ -553,6 +661,13 @@ __MPFR_DECLSPEC int mpfr_mul _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
 __MPFR_DECLSPEC int mpfr_div _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
                                            mpfr_srcptr, mpfr_rnd_t));
 
+__MPFR_DECLSPEC void mpfr_divisor_init _MPFR_PROTO ((mpfr_divisor_ptr,
+                                                     mpfr_srcptr));
+__MPFR_DECLSPEC void mpfr_divisor_clear _MPFR_PROTO ((mpfr_divisor_ptr));
+__MPFR_DECLSPEC int mpfr_div_pre _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
+                                               mpfr_divisor_srcptr,
+                                               mpfr_rnd_t));
+
 __MPFR_DECLSPEC int mpfr_add_ui _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
                                               unsigned long, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_sub_ui _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
@@ -608,6 +723,8 @@ __MPFR_DECLSPEC int mpfr_log10 _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
                                              mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_log1p _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
                                              mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_log_ui _MPFR_PROTO ((mpfr_ptr, unsigned long,
+                                              mpfr_rnd_t));
 
 __MPFR_DECLSPEC int mpfr_exp _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_exp2 _MPFR_PROTO ((mpfr_ptr,mpfr_srcptr,mpfr_rnd_t));
@@ -688,6 +805,7 @@ __MPFR_DECLSPEC int mpfr_fits_intmax_p _MPFR_PROTO((mpfr_srcptr, mpfr_rnd_t));
 __MPFR_DECLSPEC void mpfr_extract _MPFR_PROTO ((mpz_ptr, mpfr_srcptr,
                                                 unsigned int));
 __MPFR_DECLSPEC void mpfr_swap _MPFR_PROTO ((mpfr_ptr, mpfr_ptr));
+__MPFR_DECLSPEC void mpfr_move _MPFR_PROTO ((mpfr_ptr, mpfr_ptr));
 __MPFR_DECLSPEC void mpfr_dump _MPFR_PROTO ((mpfr_srcptr));
 
 __MPFR_DECLSPEC int mpfr_nan_p _MPFR_PROTO((mpfr_srcptr));
@@ -783,8 +901,45 @@ __MPFR_DECLSPEC int mpfr_fms _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr, mpfr_srcptr,
                                            mpfr_srcptr, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_sum _MPFR_PROTO ((mpfr_ptr, mpfr_ptr *const,
                                            unsigned long, mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_dot _MPFR_PROTO ((mpfr_ptr, mpfr_ptr *const,
+                                           mpfr_ptr *const, unsigned long,
+                                           mpfr_rnd_t));
+
+__MPFR_DECLSPEC void mpfr_acc_init _MPFR_PROTO ((mpfr_acc_ptr));
+__MPFR_DECLSPEC void mpfr_acc_clear _MPFR_PROTO ((mpfr_acc_ptr));
+__MPFR_DECLSPEC void mpfr_acc_add _MPFR_PROTO ((mpfr_acc_ptr, mpfr_srcptr));
+__MPFR_DECLSPEC void mpfr_acc_add_array _MPFR_PROTO ((mpfr_acc_ptr,
+                                                      mpfr_ptr *const,
+                                                      unsigned long));
+__MPFR_DECLSPEC void mpfr_acc_merge _MPFR_PROTO ((mpfr_acc_ptr,
+                                                  mpfr_acc_srcptr));
+__MPFR_DECLSPEC int mpfr_acc_get _MPFR_PROTO ((mpfr_ptr, mpfr_acc_srcptr,
+                                               mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_sum_mt _MPFR_PROTO ((mpfr_ptr, mpfr_ptr *const,
+                                              unsigned long, mpfr_rnd_t,
+                                              unsigned int));
+__MPFR_DECLSPEC int mpfr_exp_n _MPFR_PROTO ((mpfr_ptr *, mpfr_ptr *const,
+                                             unsigned long, mpfr_rnd_t,
+                                             int *));
+__MPFR_DECLSPEC int mpfr_log_n _MPFR_PROTO ((mpfr_ptr *, mpfr_ptr *const,
+                                             unsigned long, mpfr_rnd_t,
+                                             int *));
+__MPFR_DECLSPEC int mpfr_sin_n _MPFR_PROTO ((mpfr_ptr *, mpfr_ptr *const,
+                                             unsigned long, mpfr_rnd_t,
+                                             int *));
+__MPFR_DECLSPEC int mpfr_cos_n _MPFR_PROTO ((mpfr_ptr *, mpfr_ptr *const,
+                                             unsigned long, mpfr_rnd_t,
+                                             int *));
+__MPFR_DECLSPEC void mpfr_set_nthreads _MPFR_PROTO ((unsigned int));
+__MPFR_DECLSPEC unsigned int mpfr_get_nthreads _MPFR_PROTO ((void));
+__MPFR_DECLSPEC void mpfr_free_threads _MPFR_PROTO ((void));
 
 __MPFR_DECLSPEC void mpfr_free_cache _MPFR_PROTO ((void));
+__MPFR_DECLSPEC void mpfr_free_cache2 _MPFR_PROTO ((mpfr_free_cache_t));
+__MPFR_DECLSPEC void mpfr_prewarm_cache _MPFR_PROTO ((mpfr_prec_t,
+                                                      unsigned int));
+__MPFR_DECLSPEC int mpfr_export_cache _MPFR_PROTO ((const char *));
+__MPFR_DECLSPEC int mpfr_import_cache _MPFR_PROTO ((const char *));
 
 __MPFR_DECLSPEC int  mpfr_subnormalize _MPFR_PROTO ((mpfr_ptr, int,
                                                      mpfr_rnd_t));
@@ -804,6 +959,17 @@ __MPFR_DECLSPEC void   mpfr_custom_init_set   _MPFR_PROTO ((mpfr_ptr, int,
                                              mpfr_exp_t, mpfr_prec_t, void *));
 __MPFR_DECLSPEC int    mpfr_custom_get_kind   _MPFR_PROTO ((mpfr_srcptr));
 
+__MPFR_DECLSPEC void mpfr_array_init2 _MPFR_PROTO ((mpfr_array_ptr,
+                                                    size_t, mpfr_prec_t));
+__MPFR_DECLSPEC void mpfr_array_clear _MPFR_PROTO ((mpfr_array_ptr));
+__MPFR_DECLSPEC void mpfr_array_resize _MPFR_PROTO ((mpfr_array_ptr,
+                                                     size_t));
+__MPFR_DECLSPEC mpfr_ptr mpfr_array_get _MPFR_PROTO ((mpfr_array_ptr,
+                                                      size_t));
+__MPFR_DECLSPEC size_t mpfr_array_size _MPFR_PROTO ((mpfr_array_srcptr));
+__MPFR_DECLSPEC mpfr_prec_t mpfr_array_get_prec
+                                      _MPFR_PROTO ((mpfr_array_srcptr));
+
 #if defined (__cplusplus)
 }
 #endif
@@ -824,6 +990,20 @@ __MPFR_DECLSPEC int    mpfr_custom_get_kind   _MPFR_PROTO ((mpfr_srcptr));
   MPFR_EXTENSION mp_limb_t __gmpfr_local_tab_##_x[((_p)-1)/GMP_NUMB_BITS+1]; \
   MPFR_EXTENSION mpfr_t _x = {{(_p),1,__MPFR_EXP_NAN,__gmpfr_local_tab_##_x}}
 
+/* Declare a variable _x whose significand is stored in a local buffer for
+   the precisions up to _pmax (the first member of the union gives room for
+   the size field and the alignment). The variable must be initialized by
+   mpfr_small_init2 and cleared by mpfr_clear. See the MPFR manual. */
+#define MPFR_DECL_SMALL(_x, _pmax)                                      \
+  union { mp_size_t _mpfr_s;                                            \
+    mp_limb_t _mpfr_d[((_pmax)-1)/GMP_NUMB_BITS+1+                      \
+                      (sizeof (mp_size_t)-1)/sizeof (mp_limb_t)+1]; }  \
+    __gmpfr_small_tab_##_x;                                             \
+  mpfr_t _x
+#define mpfr_small_init2(_x, _p)                                        \
+  mpfr_init2_inline ((_x), (_p), &__gmpfr_small_tab_##_x,               \
+                     sizeof (__gmpfr_small_tab_##_x))
+
 #if MPFR_USE_C99_FEATURE
 /* C99 & C11 version: functions with multiple inputs supported */
 #define mpfr_round_nearest_away(func, rop, ...)                         \
@@ -1014,6 +1194,10 @@ __MPFR_DECLSPEC int    mpfr_custom_get_kind   _MPFR_PROTO ((mpfr_srcptr));
   : (x)->_mpfr_exp == __MPFR_EXP_NAN ? (mpfr_int) MPFR_NAN_KIND         \
   : (mpfr_int) MPFR_ZERO_KIND * MPFR_SIGN (x) )
 
+#define mpfr_array_get(a,i) ((mpfr_ptr) ((a)->_mpfr_tab + (i)))
+#define mpfr_array_size(a) ((a)->_mpfr_size)
+#define mpfr_array_get_prec(a) ((a)->_mpfr_prec)
+
 
 #endif /* MPFR_USE_NO_MACRO */
 
@@ -163,6 +163,10 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   mpfr_t ta, tb, tc;
   int inexact1, inexact2;
 
+  /* with MPFR_RNDF, the results may differ */
+  if (rnd_mode == MPFR_RNDF)
+    return mpfr_mul2 (a, b, c, rnd_mode);
+
   mpfr_init2 (ta, MPFR_PREC (a));
   mpfr_init2 (tb, MPFR_PREC (b));
   mpfr_init2 (tc, MPFR_PREC (c));
@@ -203,6 +207,146 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 
 /****** END OF CHECK *******/
 
+/* Special code for PREC(a) < GMP_NUMB_BITS and b, c with one limb each:
+   the product is computed with a single umul_ppmm and rounded inline,
+   avoiding the temporary allocation and the generic rounding code. */
+static int
+mpfr_mul_1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode,
+            mpfr_prec_t p)
+{
+  mpfr_exp_t ax;
+  int sign, inexact;
+  mpfr_prec_t sh = GMP_NUMB_BITS - p;
+  mp_limb_t a0, l, rb, sb, mask = MPFR_LIMB_MASK (sh);
+
+  MPFR_ASSERTD (p < GMP_NUMB_BITS);
+
+  sign = MPFR_MULT_SIGN (MPFR_SIGN (b), MPFR_SIGN (c));
+  ax = MPFR_GET_EXP (b) + MPFR_GET_EXP (c);
+  umul_ppmm (a0, l, MPFR_MANT (b)[0], MPFR_MANT (c)[0]);
+  if (a0 < MPFR_LIMB_HIGHBIT)
+    {
+      ax --;
+      a0 = (a0 << 1) | (l >> (GMP_NUMB_BITS - 1));
+      l <<= 1;
+    }
+  rb = a0 & (MPFR_LIMB_ONE << (sh - 1));
+  sb = ((a0 & mask) ^ rb) | l;
+  a0 &= ~mask;
+
+  MPFR_SET_SIGN (a, sign);
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inexact = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (a0 & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF || MPFR_IS_LIKE_RNDZ (rnd_mode,
+                                                         MPFR_IS_NEG (a)))
+    inexact = -1; /* truncate */
+  else
+    {
+      inexact = 1;
+      a0 += MPFR_LIMB_ONE << sh;
+      if (MPFR_UNLIKELY (a0 == 0))
+        {
+          a0 = MPFR_LIMB_HIGHBIT;
+          ax ++;
+        }
+    }
+
+  MPFR_MANT (a)[0] = a0;
+  if (MPFR_UNLIKELY (ax > __gmpfr_emax))
+    return mpfr_overflow (a, rnd_mode, sign);
+  if (MPFR_UNLIKELY (ax < __gmpfr_emin))
+    {
+      /* As in the generic code: in round to nearest, round to zero
+         when the exact result is not larger than 2^(emin-2). */
+      if (rnd_mode == MPFR_RNDN &&
+          (ax < __gmpfr_emin - 1 ||
+           (inexact >= 0 && a0 == MPFR_LIMB_HIGHBIT)))
+        rnd_mode = MPFR_RNDZ;
+      return mpfr_underflow (a, rnd_mode, sign);
+    }
+  MPFR_SET_EXP (a, ax);
+  MPFR_RET (inexact * MPFR_INT_SIGN (a));
+}
+
+/* Special code for GMP_NUMB_BITS < PREC(a) < 2*GMP_NUMB_BITS and b, c
+   with two limbs each. */
+static int
+mpfr_mul_2 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode,
+            mpfr_prec_t p)
+{
+  mpfr_exp_t ax;
+  int sign, inexact;
+  mpfr_prec_t sh = 2 * GMP_NUMB_BITS - p;
+  mp_limb_t h, m, l, z, t1, t0, rb, sb, mask = MPFR_LIMB_MASK (sh);
+  mp_limb_t *bp = MPFR_MANT (b), *cp = MPFR_MANT (c);
+
+  MPFR_ASSERTD (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS);
+
+  sign = MPFR_MULT_SIGN (MPFR_SIGN (b), MPFR_SIGN (c));
+  ax = MPFR_GET_EXP (b) + MPFR_GET_EXP (c);
+
+  /* {h, m, l, z} = {bp, 2} * {cp, 2} */
+  umul_ppmm (h, m, bp[1], cp[1]);
+  umul_ppmm (l, z, bp[0], cp[0]);
+  umul_ppmm (t1, t0, bp[1], cp[0]);
+  add_ssaaaa (h, m, h, m, 0, t1);
+  l += t0;
+  m += l < t0;
+  h += m == 0 && l < t0;
+  umul_ppmm (t1, t0, bp[0], cp[1]);
+  add_ssaaaa (h, m, h, m, 0, t1);
+  l += t0;
+  m += l < t0;
+  h += m == 0 && l < t0;
+  if (h < MPFR_LIMB_HIGHBIT)
+    {
+      ax --;
+      h = (h << 1) | (m >> (GMP_NUMB_BITS - 1));
+      m = (m << 1) | (l >> (GMP_NUMB_BITS - 1));
+      l <<= 1;
+    }
+  rb = m & (MPFR_LIMB_ONE << (sh - 1));
+  sb = ((m & mask) ^ rb) | l | z;
+  m &= ~mask;
+
+  MPFR_SET_SIGN (a, sign);
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inexact = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (m & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF || MPFR_IS_LIKE_RNDZ (rnd_mode,
+                                                         MPFR_IS_NEG (a)))
+    inexact = -1; /* truncate */
+  else
+    {
+      inexact = 1;
+      m += MPFR_LIMB_ONE << sh;
+      h += m == 0;
+      if (MPFR_UNLIKELY (h == 0 && m == 0))
+        {
+          h = MPFR_LIMB_HIGHBIT;
+          ax ++;
+        }
+    }
+
+  MPFR_MANT (a)[0] = m;
+  MPFR_MANT (a)[1] = h;
+  if (MPFR_UNLIKELY (ax > __gmpfr_emax))
+    return mpfr_overflow (a, rnd_mode, sign);
+  if (MPFR_UNLIKELY (ax < __gmpfr_emin))
+    {
+      if (rnd_mode == MPFR_RNDN &&
+          (ax < __gmpfr_emin - 1 ||
+           (inexact >= 0 && h == MPFR_LIMB_HIGHBIT && m == 0)))
+        rnd_mode = MPFR_RNDZ;
+      return mpfr_underflow (a, rnd_mode, sign);
+    }
+  MPFR_SET_EXP (a, ax);
+  MPFR_RET (inexact * MPFR_INT_SIGN (a));
+}
+
 /* Multiply 2 mpfr_t */
 
 /* Note: mpfr_sqr will call mpfr_mul if bn > MPFR_SQR_THRESHOLD,
@@ -294,6 +438,16 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   bq = MPFR_GET_PREC (b);
   cq = MPFR_GET_PREC (c);
 
+  if (MPFR_GET_PREC (a) < GMP_NUMB_BITS &&
+      bq <= GMP_NUMB_BITS && cq <= GMP_NUMB_BITS)
+    return mpfr_mul_1 (a, b, c, rnd_mode, MPFR_GET_PREC (a));
+
+  if (GMP_NUMB_BITS < MPFR_GET_PREC (a) &&
+      MPFR_GET_PREC (a) < 2 * GMP_NUMB_BITS &&
+      GMP_NUMB_BITS < bq && bq <= 2 * GMP_NUMB_BITS &&
+      GMP_NUMB_BITS < cq && cq <= 2 * GMP_NUMB_BITS)
+    return mpfr_mul_2 (a, b, c, rnd_mode, MPFR_GET_PREC (a));
+
   MPFR_ASSERTN ((mpfr_uprec_t) bq + cq <= MPFR_PREC_MAX);
 
   bn = MPFR_PREC2LIMBS (bq); /* number of limbs of b */
@@ -500,8 +654,10 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
         MPFR_ASSERTD (MPFR_LIMB_MSB (tmp[tn-1]) != 0);
 
         /* if the most significant bit b1 is zero, we have only p-1 correct
-           bits */
-        if (MPFR_UNLIKELY (!mpfr_round_p (tmp, tn, p + b1 - 1, MPFR_PREC(a)
+           bits; with MPFR_RNDF, since p - 1 > PREC(a), the approximation
+           can always be rounded */
+        if (MPFR_UNLIKELY (rnd_mode != MPFR_RNDF &&
+                           !mpfr_round_p (tmp, tn, p + b1 - 1, MPFR_PREC(a)
                                           + (rnd_mode == MPFR_RNDN))))
           {
             tmp -= k - tn; /* tmp may have changed, FIX IT!!!!! */
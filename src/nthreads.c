@@ -0,0 +1,46 @@
+/* mpfr_set_nthreads, mpfr_get_nthreads -- set/get the number of threads
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* Maximum number of threads that the functions with a threaded mode (such
+   as mpfr_exp at large precision) may use. The default is 1, i.e., these
+   functions run in the calling thread. Like the exponent range, this value
+   is local to each thread; in particular, it is 1 in the threads of the
+   pool (see parallel.c), so that a task does not use the threaded mode by
+   itself. The pool is grown to n-1 threads here, so that the threads are
+   not created by the first function using them. */
+MPFR_THREAD_ATTR unsigned int __gmpfr_nthreads = 1;
+
+void
+mpfr_set_nthreads (unsigned int n)
+{
+  __gmpfr_nthreads = n == 0 ? 1 : n;
+  mpfr_parallel_init (__gmpfr_nthreads - 1);
+}
+
+#undef mpfr_get_nthreads
+unsigned int
+mpfr_get_nthreads (void)
+{
+  return __gmpfr_nthreads;
+}
@@ -0,0 +1,290 @@
+/* parallel.c -- run independent tasks, in several threads if enabled
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+
+#include "mpfr-impl.h"
+
+/* The parallel variants of some functions (such as mpfr_sum_mt) split their
+   work into n independent tasks: task i is func (args + i * size), where
+   args points to an array of n structures of size bytes. The tasks must not
+   modify the caller's data except through their own structure.
+
+   If MPFR has been configured with --enable-parallel, the tasks are run by
+   a pool of persistent threads and by the calling thread, which runs the
+   tasks of its own call that have not been started yet while it waits for
+   the other ones (thus a task may call mpfr_parallel_run too, as in the
+   parallel binary splitting, without any risk of deadlock). The pool is
+   shared by all the threads of the process; it grows to n-1 threads when
+   mpfr_set_nthreads (n) is called or at the first call with n tasks, and
+   its threads are joined by mpfr_free_threads.
+   So the threads are not created for each call, and their local caches of
+   values (constants, Bernoulli numbers) are kept between the calls; only
+   their temporary memory is freed when they become idle.
+   Otherwise (or if no thread can be
+   created), the tasks are run one after the other in the calling thread,
+   so that the result never depends on the number of threads.
+
+   Note: the exponent range and the flags are thread-local, so that they are
+   not seen by the threads of the pool. The tasks must thus not depend on
+   them (e.g., they should only use the mpn layer or exact operations), and
+   any flag must be returned in the task structure. */
+
+#ifdef MPFR_WANT_PARALLEL
+
+#ifndef MPFR_USE_THREAD_SAFE
+# error "--enable-parallel needs a thread-safe build of MPFR"
+#endif
+
+#include <pthread.h>
+
+/* A job: the tasks of a call to mpfr_parallel_run. */
+typedef struct mpfr_job_s {
+  mpfr_task_func func;
+  char *args;
+  size_t size;
+  unsigned int n;           /* number of tasks */
+  unsigned int next;        /* next task to be started */
+  unsigned int done;        /* number of finished tasks */
+  struct mpfr_job_s *link;  /* next job in the queue */
+} mpfr_job_t;
+
+/* A set of threads. Each thread gets a pointer to its set, which is kept
+   until all its threads have been joined, even if a new set has been
+   created in the meantime. */
+typedef struct {
+  pthread_t *th;
+  unsigned int size;        /* number of threads */
+  unsigned int alloc;       /* allocated size of th */
+  int stop;                 /* nonzero if the threads must terminate */
+} mpfr_pool_t;
+
+/* The pool, the fields of the sets of threads and the queue are protected
+   by pool_lock. The queue contains the jobs having tasks that have not been
+   started yet. */
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+static mpfr_pool_t *pool = NULL;
+static mpfr_job_t *pool_head = NULL, *pool_tail = NULL;
+
+/* Return the next task of the job j, and remove j from the queue if this
+   is its last task. */
+static unsigned int
+pool_take (mpfr_job_t *j)
+{
+  unsigned int i = j->next++;
+
+  if (j->next == j->n)
+    {
+      mpfr_job_t **q, *prev = NULL;
+
+      for (q = &pool_head; *q != j; q = &(*q)->link)
+        prev = *q;
+      *q = j->link;
+      if (pool_tail == j)
+        pool_tail = prev;
+    }
+  return i;
+}
+
+static void *
+pool_worker (void *p)
+{
+  mpfr_pool_t *self = (mpfr_pool_t *) p;
+
+  pthread_mutex_lock (&pool_lock);
+  for (;;)
+    {
+      mpfr_job_t *j = pool_head;
+
+      /* The tasks not started yet will be run by the calling threads. */
+      if (self->stop)
+        break;
+      else if (j != NULL)
+        {
+          unsigned int i = pool_take (j);
+
+          pthread_mutex_unlock (&pool_lock);
+          j->func (j->args + i * j->size);
+          pthread_mutex_lock (&pool_lock);
+          if (++j->done == j->n)
+            pthread_cond_broadcast (&pool_done);
+        }
+      else
+        {
+          /* Idle: give back the temporary memory, but keep the caches of
+             values (such as the constants) for the next tasks. */
+          pthread_mutex_unlock (&pool_lock);
+          mpfr_free_tmp_cache ();
+          pthread_mutex_lock (&pool_lock);
+          if (pool_head == NULL && ! self->stop)
+            pthread_cond_wait (&pool_work, &pool_lock);
+        }
+    }
+  pthread_mutex_unlock (&pool_lock);
+  /* free the caches of this thread (but not the shared cache, which may
+     still be used by the other threads) */
+  mpfr_free_cache2 (MPFR_FREE_LOCAL_CACHE);
+  return NULL;
+}
+
+/* Grow the pool to at least n threads if possible (with pool_lock held). */
+static void
+pool_grow (unsigned int n)
+{
+  if (n == 0)
+    return;
+  if (pool == NULL)
+    {
+      pool = (mpfr_pool_t *) (*__gmp_allocate_func) (sizeof (mpfr_pool_t));
+      pool->th = NULL;
+      pool->size = pool->alloc = 0;
+      pool->stop = 0;
+    }
+  if (n > pool->alloc)
+    {
+      pool->th = pool->alloc == 0 ?
+        (pthread_t *) (*__gmp_allocate_func) (n * sizeof (pthread_t)) :
+        (pthread_t *) (*__gmp_reallocate_func)
+        (pool->th, pool->alloc * sizeof (pthread_t), n * sizeof (pthread_t));
+      pool->alloc = n;
+    }
+  while (pool->size < n &&
+         pthread_create (&pool->th[pool->size], NULL, pool_worker,
+                         pool) == 0)
+    pool->size++;
+}
+
+/* Grow the pool to n threads (for mpfr_set_nthreads). */
+void
+mpfr_parallel_init (unsigned int n)
+{
+  pthread_mutex_lock (&pool_lock);
+  pool_grow (n);
+  pthread_mutex_unlock (&pool_lock);
+}
+
+/* Terminate and join the threads of the pool. The pool is detached while
+   pool_lock is held, so that a concurrent call does not join the same
+   threads, and a concurrent mpfr_parallel_run creates a new pool instead
+   of growing this one. The threads cannot be joined with pool_lock held,
+   since they need it to terminate. */
+void
+mpfr_free_threads (void)
+{
+  mpfr_pool_t *p;
+  unsigned int i;
+
+  pthread_mutex_lock (&pool_lock);
+  p = pool;
+  pool = NULL;
+  if (p != NULL)
+    {
+      p->stop = 1;
+      pthread_cond_broadcast (&pool_work);
+    }
+  pthread_mutex_unlock (&pool_lock);
+  if (p == NULL)
+    return;
+  for (i = 0; i < p->size; i++)
+    pthread_join (p->th[i], NULL);
+  if (p->alloc != 0)
+    (*__gmp_free_func) (p->th, p->alloc * sizeof (pthread_t));
+  (*__gmp_free_func) (p, sizeof (mpfr_pool_t));
+}
+
+void
+mpfr_parallel_run (mpfr_task_func func, void *args, size_t size,
+                   unsigned int n)
+{
+  mpfr_job_t j;
+  unsigned int i;
+
+  if (n <= 1)
+    {
+      if (n == 1)
+        func (args);
+      return;
+    }
+
+  pthread_mutex_lock (&pool_lock);
+  pool_grow (n - 1);
+  if (pool == NULL || pool->size == 0)
+    {
+      pthread_mutex_unlock (&pool_lock);
+      for (i = 0; i < n; i++)
+        func ((char *) args + i * size);
+      return;
+    }
+
+  j.func = func;
+  j.args = (char *) args;
+  j.size = size;
+  j.n = n;
+  j.next = j.done = 0;
+  j.link = NULL;
+  if (pool_tail == NULL)
+    pool_head = &j;
+  else
+    pool_tail->link = &j;
+  pool_tail = &j;
+  pthread_cond_broadcast (&pool_work);
+
+  /* Run the tasks of this job that have not been started, then wait for
+     the other ones. */
+  while (j.done < n)
+    if (j.next < n)
+      {
+        i = pool_take (&j);
+        pthread_mutex_unlock (&pool_lock);
+        func ((char *) args + i * size);
+        pthread_mutex_lock (&pool_lock);
+        j.done++;
+      }
+    else
+      pthread_cond_wait (&pool_done, &pool_lock);
+  pthread_mutex_unlock (&pool_lock);
+}
+
+#else
+
+void
+mpfr_parallel_init (unsigned int n)
+{
+}
+
+void
+mpfr_free_threads (void)
+{
+}
+
+void
+mpfr_parallel_run (mpfr_task_func func, void *args, size_t size,
+                   unsigned int n)
+{
+  unsigned int i;
+
+  for (i = 0; i < n; i++)
+    func ((char *) args + i * size);
+}
+
+#endif
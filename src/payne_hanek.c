@@ -0,0 +1,237 @@
+/* mpfr_payne_hanek -- argument reduction for huge trigonometric arguments
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* Cache of 2/Pi. It is only read by mpfr_payne_hanek below, directly in
+   its significand. */
+MPFR_DECL_INIT_CACHE (__gmpfr_cache_const_two_over_pi,
+                      mpfr_const_two_over_pi_internal);
+
+/* Set x to 2/Pi rounded with rnd_mode. Don't need to save/restore the
+   exponent range: the cache does it. Pi is not taken from its cache, so
+   that this cache is not extended to the (possibly huge) precision of x. */
+int
+mpfr_const_two_over_pi_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
+{
+  mpfr_t t;
+  mpfr_prec_t p;
+  int inex;
+  MPFR_ZIV_DECL (loop);
+
+  p = MPFR_PREC (x) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (x)) + 10;
+  mpfr_init2 (t, p);
+  MPFR_ZIV_INIT (loop, p);
+  for (;;)
+    {
+      mpfr_const_pi_internal (t, MPFR_RNDN); /* relative error <= 2^(-p) */
+      mpfr_ui_div (t, 2, t, MPFR_RNDN);     /* error <= 2 ulps */
+      if (MPFR_CAN_ROUND (t, p - 2, MPFR_PREC (x), rnd_mode))
+        break;
+      MPFR_ZIV_NEXT (loop, p);
+      mpfr_set_prec (t, p);
+    }
+  MPFR_ZIV_FREE (loop);
+  inex = mpfr_set (x, t, rnd_mode);
+  mpfr_clear (t);
+  return inex;
+}
+
+/* Payne-Hanek argument reduction. Let m = PREC(r) and x a regular number.
+   If q is NULL, set r to an approximation of x - 2k*Pi in [-Pi,Pi], as
+   mpfr_remainder (r, x, 2*Pi) would do, with |r - (x - 2k*Pi)| <= 2^(2-m).
+   Otherwise, set r to an approximation of x - k*Pi/2 in [-Pi/4,Pi/4], as
+   mpfr_remquo (r, q, x, Pi/2) would do, with |r - (x - k*Pi/2)| <=
+   2^(1-m), and *q to k mod 4.
+
+   Contrary to mpfr_remainder, Pi is never computed at precision EXP(x)+m:
+   let x = X*2^a with X an integer of xn limbs, and C = 2/Pi = 0.c1 c2 ...
+   in binary. The bits c_j with j <= a-2 contribute multiples of 4 to
+   x*2/Pi, and the bits c_j with j > N = EXP(x)+m+g contribute less than
+   X*2^(a-N) < 2^(-m-g). Thus Y = x*2/Pi mod 4 is obtained from the window
+   of L = N-a+2 = xn*B+m+g+2 bits G = floor(C*2^N) mod 2^L, since Y = (X*G
+   mod 2^L) / 2^(L-2), up to 2^(-m-g). Only these bits of the cached value
+   of 2/Pi are read, so that, once the cache has been extended to N bits
+   (once for all the calls), the cost only depends on the precisions of x
+   and r, not on the exponent of x. The cache is freed by mpfr_free_cache;
+   to bound its memory, MPFR can be built with MPFR_PAYNE_HANEK_CACHE_MAX
+   defined to some number of bits: for larger N, 2/Pi is then computed in
+   a temporary variable for each call.
+
+   The cache being correctly rounded to at least N bits, its error
+   contributes X*2^a*2^(-N-1) < 2^(-m-g-1), so that the error on Y is at
+   most 2^(1-m-g). Then r = V*Pi/2 with |V| <= 2, where V = Y or Y-4 in the
+   first case, and |V| <= 1/2, where V = Y - round(Y), in the second case:
+   - the error on Y contributes at most Pi/2*2^(1-m-g) <= 2^(-2-m) with g=4;
+   - Pi is rounded to nearest on m+3 bits, which contributes at most
+     |V|*2^(-m-3) <= 2^(-m-2);
+   - the final rounding contributes 1/2 ulp(r), i.e. at most 2^(1-m) since
+     |r| < 4 in the first case, and 2^(-1-m) since |r| < 1 in the second
+     case.
+   The total is less than 2^(2-m), resp. 2^(1-m). */
+#define PH_GUARD 4
+
+#define PH_BIT(p, i) (((p)[(i) / GMP_NUMB_BITS] >> ((i) % GMP_NUMB_BITS)) & 1)
+
+/* Keep only the nbits low bits of {p, n}. */
+static void
+ph_mask (mp_limb_t *p, mp_size_t n, mpfr_prec_t nbits)
+{
+  mp_size_t k = MPFR_PREC2LIMBS (nbits);
+
+  if (k < n)
+    MPN_ZERO (p + k, n - k);
+  if (nbits % GMP_NUMB_BITS != 0)
+    p[k - 1] &= MPFR_LIMB_MASK (nbits % GMP_NUMB_BITS);
+}
+
+/* Set {gp, gn} to the bits s to s+gn*B-1 of the significand {cp, cn} of
+   c = 2/Pi, with s = cn*B-N >= 0 (the bits above cp[cn-1] being 0). */
+static void
+ph_window (mp_limb_t *gp, mp_size_t gn, mpfr_srcptr c, mpfr_exp_t N)
+{
+  mp_limb_t *cp = MPFR_MANT (c);
+  mp_size_t cn = MPFR_LIMB_SIZE (c), i;
+  mpfr_exp_t s, qs;
+  int r0;
+
+  MPFR_ASSERTD (MPFR_GET_EXP (c) == 0);
+  s = (mpfr_exp_t) cn * GMP_NUMB_BITS - N;
+  MPFR_ASSERTD (s >= 0);
+  qs = s / GMP_NUMB_BITS;
+  r0 = s % GMP_NUMB_BITS;
+  for (i = 0; i < gn; i++)
+    {
+      mp_limb_t lo, hi;
+
+      lo = qs + i < cn ? cp[qs + i] : 0;
+      hi = qs + i + 1 < cn ? cp[qs + i + 1] : 0;
+      gp[i] = r0 == 0 ? lo : (lo >> r0) | (hi << (GMP_NUMB_BITS - r0));
+    }
+}
+
+void
+mpfr_payne_hanek (mpfr_ptr r, long *q, mpfr_srcptr x)
+{
+  mpfr_prec_t m = MPFR_PREC (r);
+  mpfr_exp_t ex, N;
+  mpfr_prec_t L;
+  mp_size_t xn, gn, h;
+  mp_limb_t *gp, *pp, *pip;
+  mpfr_t v, pi;
+  int neg, cnt;
+  MPFR_TMP_DECL (marker);
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x));
+
+  ex = MPFR_GET_EXP (x);
+  xn = MPFR_LIMB_SIZE (x);
+  MPFR_ASSERTN (ex <= MPFR_PREC_MAX - m - PH_GUARD);
+  N = ex + m + PH_GUARD;
+  L = (mpfr_prec_t) xn * GMP_NUMB_BITS + m + PH_GUARD + 2;
+  gn = MPFR_PREC2LIMBS (L);
+
+  MPFR_TMP_MARK (marker);
+  gp = MPFR_TMP_LIMBS_ALLOC (gn);
+  pp = MPFR_TMP_LIMBS_ALLOC (gn + xn);
+
+  /* G = floor(C*2^N) mod 2^L: with C = {cp, cn} / 2^(cn*B), these are the
+     bits s to s+L-1 of {cp, cn}, with s = cn*B-N >= 0. */
+  if (N <= MPFR_PAYNE_HANEK_CACHE_MAX)
+    {
+      mpfr_cache_lock (__gmpfr_cache_const_two_over_pi, N);
+      ph_window (gp, gn, __gmpfr_cache_const_two_over_pi->x, N);
+      MPFR_UNLOCK (__gmpfr_cache_const_two_over_pi->lock);
+    }
+  else
+    {
+      mpfr_t c;
+      MPFR_SAVE_EXPO_DECL (expo);
+
+      MPFR_SAVE_EXPO_MARK (expo);
+      mpfr_init2 (c, N);
+      mpfr_const_two_over_pi_internal (c, MPFR_RNDN);
+      ph_window (gp, gn, c, N);
+      mpfr_clear (c);
+      MPFR_SAVE_EXPO_FREE (expo);
+    }
+  ph_mask (gp, gn, L);
+
+  /* Y*2^(L-2) = X*G mod 2^L, in {pp, gn} */
+  mpn_mul (pp, gp, gn, MPFR_MANT (x), xn);
+  ph_mask (pp, gn, L);
+
+  /* V*2^(L-2) in {pp, gn}, with the sign neg */
+  neg = 0;
+  if (q == NULL)
+    {
+      if (PH_BIT (pp, L - 1))  /* Y >= 2: V = Y - 4 */
+        {
+          mpn_neg (pp, pp, gn);
+          ph_mask (pp, gn, L);
+          neg = 1;
+        }
+    }
+  else
+    {
+      int k = 2 * PH_BIT (pp, L - 1) + PH_BIT (pp, L - 2);
+
+      /* V = Y - k in [0,1) */
+      ph_mask (pp, gn, L - 2);
+      if (PH_BIT (pp, L - 3))  /* V >= 1/2: V = Y - (k+1) */
+        {
+          mpn_neg (pp, pp, gn);
+          ph_mask (pp, gn, L - 2);
+          neg = 1;
+          k++;
+        }
+      *q = MPFR_IS_NEG (x) ? (- k) & 3 : k & 3;
+    }
+  if (MPFR_IS_NEG (x))
+    neg = ! neg;
+
+  for (h = gn - 1; h >= 0 && pp[h] == 0; h--)
+    ;
+  if (h < 0)
+    {
+      MPFR_SET_ZERO (r);
+      MPFR_SET_POS (r);
+    }
+  else
+    {
+      /* r = V*Pi/2 */
+      count_leading_zeros (cnt, pp[h]);
+      if (cnt != 0)
+        mpn_lshift (pp, pp, h + 1, cnt);
+      MPFR_TMP_INIT1 (pp, v, (mpfr_prec_t) (h + 1) * GMP_NUMB_BITS);
+      MPFR_SET_EXP (v, (mpfr_exp_t) (h + 1) * GMP_NUMB_BITS - cnt
+                    - (L - 2));
+      MPFR_TMP_INIT (pip, pi, m + 3, MPFR_PREC2LIMBS (m + 3));
+      mpfr_const_pi (pi, MPFR_RNDN);
+      mpfr_mul (r, v, pi, MPFR_RNDN);
+      mpfr_div_2ui (r, r, 1, MPFR_RNDN);
+      if (neg)
+        MPFR_CHANGE_SIGN (r);
+    }
+  MPFR_TMP_FREE (marker);
+}
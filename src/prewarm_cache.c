@@ -0,0 +1,50 @@
+/* mpfr_prewarm_cache -- compute constants in advance
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+
+#include "mpfr-impl.h"
+
+/* Compute the constants selected by consts (MPFR_CACHE_PI, etc.) at
+   precision prec, so that the next calls to the corresponding mpfr_const_*
+   functions with a precision up to prec only round the cached value.
+   With --enable-shared-cache, this can be done at startup, before the
+   creation of the threads, which will then all use these values. The flags
+   are not modified. */
+void
+mpfr_prewarm_cache (mpfr_prec_t prec, unsigned int consts)
+{
+  mpfr_t x;
+  mpfr_flags_t saved_flags = __gmpfr_flags;
+
+  MPFR_ASSERTN (prec >= MPFR_PREC_MIN && prec <= MPFR_PREC_MAX);
+  mpfr_init2 (x, prec);
+  if (consts & MPFR_CACHE_PI)
+    mpfr_const_pi (x, MPFR_RNDN);
+  if (consts & MPFR_CACHE_LOG2)
+    mpfr_const_log2 (x, MPFR_RNDN);
+  if (consts & MPFR_CACHE_EULER)
+    mpfr_const_euler (x, MPFR_RNDN);
+  if (consts & MPFR_CACHE_CATALAN)
+    mpfr_const_catalan (x, MPFR_RNDN);
+  mpfr_clear (x);
+  __gmpfr_flags = saved_flags;
+}
@@ -32,55 +32,15 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
       *((x)+i) = ~*((y)+i);                             \
   }
 
-/* Put in X a p-bit approximation of 1/sqrt(A),
-   where X = {x, n}/B^n, n = ceil(p/GMP_NUMB_BITS),
-   A = 2^(1+as)*{a, an}/B^an, as is 0 or 1, an = ceil(ap/GMP_NUMB_BITS),
-   where B = 2^GMP_NUMB_BITS.
-
-   We have 1 <= A < 4 and 1/2 <= X < 1.
-
-   The error in the approximate result with respect to the true
-   value 1/sqrt(A) is bounded by 1 ulp(X), i.e., 2^{-p} since 1/2 <= X < 1.
-
-   Note: x and a are left-aligned, i.e., the most significant bit of
-   a[an-1] is set, and so is the most significant bit of the output x[n-1].
-
-   If p is not a multiple of GMP_NUMB_BITS, the extra low bits of the input
-   A are taken into account to compute the approximation of 1/sqrt(A), but
-   whether or not they are zero, the error between X and 1/sqrt(A) is bounded
-   by 1 ulp(X) [in precision p].
-   The extra low bits of the output X (if p is not a multiple of GMP_NUMB_BITS)
-   are set to 0.
-
-   Assumptions:
-   (1) A should be normalized, i.e., the most significant bit of a[an-1]
-       should be 1. If as=0, we have 1 <= A < 2; if as=1, we have 2 <= A < 4.
-   (2) p >= 12
-   (3) {a, an} and {x, n} should not overlap
-   (4) GMP_NUMB_BITS >= 12 and is even
-
-   Note: this routine is much more efficient when ap is small compared to p,
-   including the case where ap <= GMP_NUMB_BITS, thus it can be used to
-   implement an efficient mpfr_rec_sqrt_ui function.
-
-   References:
-   [1] Modern Computer Algebra, Richard Brent and Paul Zimmermann,
-   http://www.loria.fr/~zimmerma/mca/pub226.html
+/* the following T1 and T2 are bipartite tables giving initial
+   approximation for the inverse square root, with 13-bit input split in
+   5+4+4, and 11-bit output. More precisely, if 2048 <= i < 8192,
+   with i = a*2^8 + b*2^4 + c, we use for approximation of
+   2048/sqrt(i/2048) the value x = T1[16*(a-8)+b] + T2[16*(a-8)+c].
+   The largest error is obtained for i = 2054, where x = 2044,
+   and 2048/sqrt(i/2048) = 2045.006576...
 */
-static void
-mpfr_mpn_rec_sqrt (mpfr_limb_ptr x, mpfr_prec_t p,
-                   mpfr_limb_srcptr a, mpfr_prec_t ap, int as)
-
-{
-  /* the following T1 and T2 are bipartite tables giving initial
-     approximation for the inverse square root, with 13-bit input split in
-     5+4+4, and 11-bit output. More precisely, if 2048 <= i < 8192,
-     with i = a*2^8 + b*2^4 + c, we use for approximation of
-     2048/sqrt(i/2048) the value x = T1[16*(a-8)+b] + T2[16*(a-8)+c].
-     The largest error is obtained for i = 2054, where x = 2044,
-     and 2048/sqrt(i/2048) = 2045.006576...
-  */
-  static short int T1[384] = {
+static const short int T1[384] = {
 2040, 2033, 2025, 2017, 2009, 2002, 1994, 1987, 1980, 1972, 1965, 1958, 1951,
 1944, 1938, 1931, /* a=8 */
 1925, 1918, 1912, 1905, 1899, 1892, 1886, 1880, 1874, 1867, 1861, 1855, 1849,
@@ -130,32 +90,118 @@ mpfr_mpn_rec_sqrt (mpfr_limb_ptr x, mpfr_prec_t p,
 1040, 1039, 1038, 1037, 1036, 1035, 1034, 1033, 1032, 1031, 1030, 1029, 1028,
 1027, 1026, 1025 /* a=31 */
 };
-  static unsigned char T2[384] = {
-    7, 7, 6, 6, 5, 5, 4, 4, 4, 3, 3, 2, 2, 1, 1, 0, /* a=8 */
-    6, 5, 5, 5, 4, 4, 3, 3, 3, 2, 2, 2, 1, 1, 0, 0, /* a=9 */
-    5, 5, 4, 4, 4, 3, 3, 3, 2, 2, 2, 1, 1, 1, 0, 0, /* a=10 */
-    4, 4, 3, 3, 3, 3, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, /* a=11 */
-    3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0, /* a=12 */
-    3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0, 0, /* a=13 */
-    3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 0, 0, 0, 0, /* a=14 */
-    2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, /* a=15 */
-    2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, /* a=16 */
-    2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, /* a=17 */
-    3, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 0, /* a=18 */
-    2, 2, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, /* a=19 */
-    1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, /* a=20 */
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, /* a=21 */
-    1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* a=22 */
-    2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, /* a=23 */
-    1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* a=24 */
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, /* a=25 */
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, /* a=26 */
-    1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* a=27 */
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, /* a=28 */
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, /* a=29 */
-    1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* a=30 */
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0  /* a=31 */
+static const unsigned char T2[384] = {
+  7, 7, 6, 6, 5, 5, 4, 4, 4, 3, 3, 2, 2, 1, 1, 0, /* a=8 */
+  6, 5, 5, 5, 4, 4, 3, 3, 3, 2, 2, 2, 1, 1, 0, 0, /* a=9 */
+  5, 5, 4, 4, 4, 3, 3, 3, 2, 2, 2, 1, 1, 1, 0, 0, /* a=10 */
+  4, 4, 3, 3, 3, 3, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, /* a=11 */
+  3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0, /* a=12 */
+  3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0, 0, /* a=13 */
+  3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 0, 0, 0, 0, /* a=14 */
+  2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, /* a=15 */
+  2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, /* a=16 */
+  2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, /* a=17 */
+  3, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 0, /* a=18 */
+  2, 2, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, /* a=19 */
+  1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, /* a=20 */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, /* a=21 */
+  1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* a=22 */
+  2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, /* a=23 */
+  1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* a=24 */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, /* a=25 */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, /* a=26 */
+  1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* a=27 */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, /* a=28 */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, /* a=29 */
+  1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* a=30 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0  /* a=31 */
 };
+
+#if GMP_NUMB_BITS == 64
+/* Return an approximation x of 2^62/sqrt(a/2^64), where 2^62 <= a < 2^64,
+   i.e., x/2^62 approximates 1/sqrt(A) with 1/4 <= A = a/2^64 < 1.
+   The 11-bit approximation from T1 and T2 is refined by two Newton
+   iterations x <- x + x*(1-A*x^2)/2, the first one with 32-bit arithmetic
+   and the second one with the full limb a, which gives a relative error
+   of about 2^-38. The callers only use x to get a nearby value, and then
+   check their result with an exact remainder. */
+mp_limb_t
+mpfr_rec_sqrt_limb (mp_limb_t a)
+{
+  unsigned long i, ab, ac;
+  mp_limb_t x0, x1, t, e, h, l;
+
+  MPFR_ASSERTD (a >= MPFR_LIMB_HIGHBIT >> 1);
+
+  /* 11-bit initial approximation: x0/2^10 ~ 1/sqrt(A) */
+  i = a >> (GMP_NUMB_BITS - 13);
+  ab = i >> 4;
+  ac = (ab & 0x3F0) | (i & 0x0F);
+  x0 = (mp_limb_t) T1[ab - 0x80] + (mp_limb_t) T2[ac - 0x80];
+
+  /* first iteration with the 32 most significant bits of a:
+     t = A*x0^2 * 2^52 < 2^54, and x1/2^30 ~ 1/sqrt(A) */
+  t = x0 * x0 * (a >> 32);
+  if (t <= MPFR_LIMB_ONE << 52)
+    x1 = (x0 << 20) + ((x0 * ((MPFR_LIMB_ONE << 52) - t)) >> 33);
+  else
+    x1 = (x0 << 20) - ((x0 * (t - (MPFR_LIMB_ONE << 52))) >> 33);
+
+  /* second iteration: x1^2 < 2^62, and h = A*x1^2 * 2^60 */
+  umul_ppmm (h, l, x1 * x1, a);
+  if (h <= MPFR_LIMB_ONE << 60)
+    {
+      e = (MPFR_LIMB_ONE << 60) - h;
+      return (x1 << 32) + ((x1 * (e >> 16)) >> 13);
+    }
+  else
+    {
+      e = h - (MPFR_LIMB_ONE << 60);
+      return (x1 << 32) - ((x1 * (e >> 16)) >> 13);
+    }
+}
+#endif
+
+/* Put in X a p-bit approximation of 1/sqrt(A),
+   where X = {x, n}/B^n, n = ceil(p/GMP_NUMB_BITS),
+   A = 2^(1+as)*{a, an}/B^an, as is 0 or 1, an = ceil(ap/GMP_NUMB_BITS),
+   where B = 2^GMP_NUMB_BITS.
+
+   We have 1 <= A < 4 and 1/2 <= X < 1.
+
+   The error in the approximate result with respect to the true
+   value 1/sqrt(A) is bounded by 1 ulp(X), i.e., 2^{-p} since 1/2 <= X < 1.
+
+   Note: x and a are left-aligned, i.e., the most significant bit of
+   a[an-1] is set, and so is the most significant bit of the output x[n-1].
+
+   If p is not a multiple of GMP_NUMB_BITS, the extra low bits of the input
+   A are taken into account to compute the approximation of 1/sqrt(A), but
+   whether or not they are zero, the error between X and 1/sqrt(A) is bounded
+   by 1 ulp(X) [in precision p].
+   The extra low bits of the output X (if p is not a multiple of GMP_NUMB_BITS)
+   are set to 0.
+
+   Assumptions:
+   (1) A should be normalized, i.e., the most significant bit of a[an-1]
+       should be 1. If as=0, we have 1 <= A < 2; if as=1, we have 2 <= A < 4.
+   (2) p >= 12
+   (3) {a, an} and {x, n} should not overlap
+   (4) GMP_NUMB_BITS >= 12 and is even
+
+   Note: this routine is much more efficient when ap is small compared to p,
+   including the case where ap <= GMP_NUMB_BITS, thus it can be used to
+   implement an efficient mpfr_rec_sqrt_ui function.
+
+   References:
+   [1] Modern Computer Algebra, Richard Brent and Paul Zimmermann,
+   http://www.loria.fr/~zimmerma/mca/pub226.html
+*/
+static void
+mpfr_mpn_rec_sqrt (mpfr_limb_ptr x, mpfr_prec_t p,
+                   mpfr_limb_srcptr a, mpfr_prec_t ap, int as)
+
+{
   mp_size_t n = LIMB_SIZE(p);   /* number of limbs of X */
   mp_size_t an = LIMB_SIZE(ap); /* number of limbs of A */
 
@@ -433,6 +479,130 @@ mpfr_mpn_rec_sqrt (mpfr_limb_ptr x, mpfr_prec_t p,
     }
 }
 
+#if GMP_NUMB_BITS == 64
+/* Return non-zero iff t^2 * (n1*B + n0) <= 2^254, where B = 2^64. */
+static int
+mpfr_rec_sqrt1_le (mp_limb_t t, mp_limb_t n1, mp_limb_t n0)
+{
+  mp_limb_t t1, t0, h, m, l, z, p1, p0;
+
+  umul_ppmm (t1, t0, t, t);
+  /* {h, m, l, z} = {t1, t0} * {n1, n0} */
+  umul_ppmm (h, m, t1, n1);
+  umul_ppmm (l, z, t0, n0);
+  umul_ppmm (p1, p0, t1, n0);
+  add_ssaaaa (h, m, h, m, 0, p1);
+  l += p0;
+  m += l < p0;
+  h += m == 0 && l < p0;
+  umul_ppmm (p1, p0, t0, n1);
+  add_ssaaaa (h, m, h, m, 0, p1);
+  l += p0;
+  m += l < p0;
+  h += m == 0 && l < p0;
+  return h < (MPFR_LIMB_ONE << 62) ||
+    (h == (MPFR_LIMB_ONE << 62) && (m | l | z) == 0);
+}
+
+/* Special code for PREC(r) < GMP_NUMB_BITS and PREC(u) <= GMP_NUMB_BITS,
+   u > 0. With N = n1*B + n0 as in mpfr_sqrt1 (sqrt.c), we compute
+   T = floor(2^127/sqrt(N)) from mpfr_rec_sqrt_limb and one more Newton
+   iteration, then check T exactly with mpfr_rec_sqrt1_le. The result is
+   never exact, except when u is a power of 4, which is handled first. */
+static int
+mpfr_rec_sqrt1 (mpfr_ptr r, mpfr_srcptr u, mpfr_rnd_t rnd_mode)
+{
+  mpfr_prec_t p = MPFR_GET_PREC (r);
+  mpfr_prec_t sh = GMP_NUMB_BITS - p;
+  mpfr_exp_t exp_u = MPFR_GET_EXP (u), exp_r;
+  mp_limb_t u0 = MPFR_MANT (u)[0], n1, n0, x, h, l, p1, p0, c, t, rb, mask;
+  int inex;
+
+  if (((mpfr_uexp_t) exp_u & 1) != 0)
+    {
+      if (u0 == MPFR_LIMB_HIGHBIT)
+        {
+          /* u = 2^(exp_u-1) with exp_u-1 even */
+          MPFR_MANT (r)[0] = MPFR_LIMB_HIGHBIT;
+          MPFR_EXP (r) = (3 - exp_u) / 2;
+          return mpfr_check_range (r, 0, rnd_mode);
+        }
+      n1 = u0 >> 1;
+      n0 = u0 << (GMP_NUMB_BITS - 1);
+      exp_r = (1 - exp_u) / 2;
+    }
+  else
+    {
+      n1 = u0;
+      n0 = 0;
+      exp_r = 1 - exp_u / 2;
+    }
+
+  /* x/2^62 ~ 1/sqrt(A) with A = N/2^128; let {h, l} = x^2 (with 124
+     fractional bits), and {p1, p0} ~ A*x^2 (with 124 fractional bits,
+     the low limbs of the product being neglected) */
+  x = mpfr_rec_sqrt_limb (n1);
+  umul_ppmm (h, l, x, x);
+  umul_ppmm (p1, p0, h, n1);
+  umul_ppmm (c, t, l, n1);
+  add_ssaaaa (p1, p0, p1, p0, 0, c);
+  if (n0 != 0) /* n0 = 2^63 */
+    add_ssaaaa (p1, p0, p1, p0, 0, h >> 1);
+
+  /* Newton iteration: T = 2x + x*(1-A*x^2), with 63 fractional bits */
+  t = x >= MPFR_LIMB_HIGHBIT ? MPFR_LIMB_MAX : x << 1;
+  if (p1 < MPFR_LIMB_ONE << 60)
+    {
+      /* 1-A*x^2 = {h, l}/2^124 */
+      sub_ddmmss (h, l, MPFR_LIMB_ONE << 60, 0, p1, p0);
+      umul_ppmm (p1, p0, x, h);
+      umul_ppmm (c, l, x, l);
+      p0 += c;
+      p1 += p0 < c;
+      c = (p1 << 4) | (p0 >> 60);
+      t = t + c < t ? MPFR_LIMB_MAX : t + c;
+    }
+  else
+    {
+      sub_ddmmss (h, l, p1, p0, MPFR_LIMB_ONE << 60, 0);
+      umul_ppmm (p1, p0, x, h);
+      umul_ppmm (c, l, x, l);
+      p0 += c;
+      p1 += p0 < c;
+      c = (p1 << 4) | (p0 >> 60);
+      t -= c;
+    }
+
+  /* exact correction: t^2 * N <= 2^254 < (t+1)^2 * N */
+  while (!mpfr_rec_sqrt1_le (t, n1, n0))
+    t --;
+  while (t != MPFR_LIMB_MAX && mpfr_rec_sqrt1_le (t + 1, n1, n0))
+    t ++;
+  MPFR_ASSERTD (t >= MPFR_LIMB_HIGHBIT);
+
+  /* the sticky bit is always 1 since the result is not exact */
+  mask = MPFR_LIMB_MASK (sh);
+  rb = t & (MPFR_LIMB_ONE << (sh - 1));
+  t &= ~mask;
+  if (rnd_mode == MPFR_RNDN ? rb == 0
+      : rnd_mode == MPFR_RNDF || MPFR_IS_LIKE_RNDZ (rnd_mode, 0))
+    inex = -1;
+  else
+    {
+      inex = 1;
+      t += MPFR_LIMB_ONE << sh;
+      if (MPFR_UNLIKELY (t == 0))
+        {
+          t = MPFR_LIMB_HIGHBIT;
+          exp_r ++;
+        }
+    }
+  MPFR_MANT (r)[0] = t;
+  MPFR_EXP (r) = exp_r;
+  return mpfr_check_range (r, inex, rnd_mode);
+}
+#endif
+
 int
 mpfr_rec_sqrt (mpfr_ptr r, mpfr_srcptr u, mpfr_rnd_t rnd_mode)
 {
@@ -487,6 +657,11 @@ mpfr_rec_sqrt (mpfr_ptr r, mpfr_srcptr u, mpfr_rnd_t rnd_mode)
 
   MPFR_SET_POS(r);
 
+#if GMP_NUMB_BITS == 64
+  if (MPFR_GET_PREC (r) < GMP_NUMB_BITS && MPFR_GET_PREC (u) <= GMP_NUMB_BITS)
+    return mpfr_rec_sqrt1 (r, u, rnd_mode);
+#endif
+
   rp = MPFR_PREC(r); /* output precision */
   up = MPFR_PREC(u); /* input precision */
   wp = rp + 11;      /* initial working precision */
@@ -520,7 +695,9 @@ mpfr_rec_sqrt (mpfr_ptr r, mpfr_srcptr u, mpfr_rnd_t rnd_mode)
       /* If the input was not truncated, the error is at most one ulp;
          if the input was truncated, the error is at most two ulps
          (see algorithms.tex). */
-      if (MPFR_LIKELY (mpfr_round_p (x, wn, wp - (wp < up),
+      if (MPFR_LIKELY (rnd_mode == MPFR_RNDF ?
+                       wp - (wp < up) > rp :
+                       mpfr_round_p (x, wn, wp - (wp < up),
                                      rp + (rnd_mode == MPFR_RNDN))))
         break;
 
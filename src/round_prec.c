@@ -54,7 +54,6 @@ mpfr_prec_round (mpfr_ptr x, mpfr_prec_t prec, mpfr_rnd_t rnd_mode)
   mp_limb_t *tmp, *xp;
   int carry, inexact;
   mpfr_prec_t nw, ow;
-  MPFR_TMP_DECL(marker);
 
   MPFR_ASSERTN (MPFR_PREC_COND (prec));
 
@@ -69,7 +68,13 @@ mpfr_prec_round (mpfr_ptr x, mpfr_prec_t prec, mpfr_rnd_t rnd_mode)
       /* FIXME: Variable can't be created using custom allocation,
          MPFR_DECL_INIT or GROUP_ALLOC: How to detect? */
       ow = MPFR_GET_ALLOC_SIZE(x);
-      if (nw > ow)
+      if (MPFR_UNLIKELY (ow < 0))
+        {
+          /* inline significand (mpfr_init2_inline) */
+          if (nw > - ow)
+            mpfr_inline_to_heap (x, nw);
+        }
+      else if (nw > ow)
        {
          /* Realloc significand */
          mpfr_limb_ptr tmpx = (mpfr_limb_ptr) (*__gmp_reallocate_func)
@@ -91,9 +96,16 @@ mpfr_prec_round (mpfr_ptr x, mpfr_prec_t prec, mpfr_rnd_t rnd_mode)
 
   /* x is a non-zero real number */
 
-  MPFR_TMP_MARK(marker);
-  tmp = MPFR_TMP_LIMBS_ALLOC (nw);
+  /* The rounding is done in place, without temporary memory. When the
+     precision decreases, the rounded significand is written in the nw most
+     significant limbs, then moved down: this is correct since
+     mpfr_round_raw reads the other limbs before writing the result, which
+     is either a copy of the same limbs or the result of mpn_add_1 with the
+     same source and destination. When the precision does not decrease,
+     mpfr_round_raw supports the same source and destination. */
   xp = MPFR_MANT(x);
+  ow = MPFR_LIMB_SIZE (x);
+  tmp = ow > nw ? xp + (ow - nw) : xp;
   carry = mpfr_round_raw (tmp, xp, MPFR_PREC(x), MPFR_IS_NEG(x),
                           prec, rnd_mode, &inexact);
   MPFR_PREC(x) = prec;
@@ -113,10 +125,9 @@ mpfr_prec_round (mpfr_ptr x, mpfr_prec_t prec, mpfr_rnd_t rnd_mode)
             MPN_ZERO(xp, nw - 1);
         }
     }
-  else
-    MPN_COPY(xp, tmp, nw);
+  else if (tmp != xp)
+    MPN_COPY_INCR (xp, tmp, nw);
 
-  MPFR_TMP_FREE(marker);
   return inexact;
 }
 
@@ -125,6 +136,8 @@ mpfr_prec_round (mpfr_ptr x, mpfr_prec_t prec, mpfr_rnd_t rnd_mode)
 /* assuming b is an approximation to x in direction rnd1 with error at
    most 2^(MPFR_EXP(b)-err), returns 1 if one is able to round exactly
    x to precision prec with direction rnd2, and 0 otherwise.
+   If rnd2 is MPFR_RNDF, returns 1 if rounding b to precision prec with
+   MPFR_RNDF yields a faithful rounding of x.
 
    Side effects: none.
 */
@@ -153,6 +166,10 @@ mpfr_can_round_raw (const mp_limb_t *bp, mp_size_t bn, int neg, mpfr_exp_t err0,
 
   if (MPFR_UNLIKELY(err0 < 0 || (mpfr_uexp_t) err0 <= prec))
     return 0;  /* can't round */
+  else if (rnd2 == MPFR_RNDF)
+    /* The error is at most 1/2 ulp, thus rounding b with MPFR_RNDF (to
+       nearest) gives a faithful rounding of x whatever rnd1. */
+    return 1;
   else if (MPFR_UNLIKELY (prec > (mpfr_prec_t) bn * GMP_NUMB_BITS))
     { /* then ulp(b) < precision < error */
       return rnd2 == MPFR_RNDN && (mpfr_uexp_t) err0 - 2 >= prec;
@@ -49,6 +49,10 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
  * a natural generalization. Indeed, a number with 1-bit precision can
  * be seen as a subnormal number with more precision.
  *
+ * With rnd_mode = MPFR_RNDF (faithful rounding), xp is rounded to nearest,
+ * except that a tie is rounded away from zero and the sticky bits are not
+ * looked at when the rounding bit is 1.
+ *
  * MPFR_RNDNA is now supported, but needs to be tested [TODO] and is
  * still not part of the API. In particular, the MPFR_RNDNA value (-1)
  * may change in the future without notice, and this will be the case
@@ -123,7 +127,8 @@ mpfr_round_raw_generic(
       MPFR_ASSERTD(k >= 0);
       sb = xp[k] & lomask;  /* First non-significant bits */
       /* Rounding to nearest? */
-      if (MPFR_LIKELY (rnd_mode == MPFR_RNDN || rnd_mode == MPFR_RNDNA))
+      if (MPFR_LIKELY (rnd_mode == MPFR_RNDN || rnd_mode == MPFR_RNDNA ||
+                       rnd_mode == MPFR_RNDF))
         {
           /* Rounding to nearest */
           mp_limb_t rbmask = MPFR_LIMB_ONE << (GMP_NUMB_BITS - 1 - rw);
@@ -135,6 +140,13 @@ mpfr_round_raw_generic(
             /* FIXME: *inexp is not set. First, add a testcase that
                triggers the bug (at least with a sanitizer). */
             goto rnd_RNDN_add_one_ulp; /* like rounding away from zero */
+          if (MPFR_UNLIKELY (rnd_mode == MPFR_RNDF))
+            {
+              /* Faithful rounding: no need to look at the sticky bits. */
+              if (use_inexp)
+                *inexp = 1-2*neg; /* neg == 0 ? 1 : -1 */
+              goto rnd_RNDN_add_one_ulp;
+            }
           sb &= ~rbmask; /* first bits after the rounding bit */
           while (MPFR_UNLIKELY(sb == 0) && k > 0)
             sb = xp[--k];
@@ -0,0 +1,284 @@
+/* Per-thread scratch arena for the temporary memory (--enable-scratch-arena).
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+#ifdef MPFR_WANT_SCRATCH_ARENA
+
+/* The arena is a stack of chunks obtained from the GMP memory functions,
+   each chunk being twice as large as the previous one (at least
+   MPFR_SCRATCH_MIN_CHUNK bytes). A block is allocated at the top of the
+   current chunk, after a header giving the offset of the previous block
+   in the chunk. The temporary memory (MPFR_TMP_ALLOC above MPFR_ALLOCA_MAX
+   and MPFR_GROUP) is almost always freed in the reverse order of its
+   allocation, in which case freeing a block just moves the top back. But
+   this order is not required: a block freed while it is not at the top is
+   only marked as free, and it is popped when the blocks above it are.
+
+   When a chunk becomes empty, the top goes back to the previous chunk, and
+   the empty chunk is kept as the next one, so that the following
+   computations allocate nothing: the memory is given back to the system
+   only by mpfr_scratch_release (also called by mpfr_free_cache), or when
+   a larger chunk is needed. The total size of the chunks of a thread is
+   bounded by mpfr_scratch_set_max; the blocks which do not fit below this
+   bound are allocated directly with the GMP memory functions.
+
+   Everything is thread-local, thus no lock is needed. The blocks must be
+   freed by the thread that allocated them, which is the case of the
+   temporary memory of a function. */
+
+#ifndef MPFR_SCRATCH_MIN_CHUNK
+# define MPFR_SCRATCH_MIN_CHUNK 65536
+#endif
+
+#ifndef MPFR_SCRATCH_MAX
+# define MPFR_SCRATCH_MAX 1048576
+#endif
+
+/* The blocks are aligned like the blocks returned by malloc. */
+union scratch_align {
+  mp_limb_t l;
+  double d;
+  long double ld;
+  void *p;
+};
+
+#define SCRATCH_ROUND(n) \
+  (((n) + sizeof (union scratch_align) - 1) & \
+   ~ (sizeof (union scratch_align) - 1))
+
+struct scratch_chunk {
+  struct scratch_chunk *prev;
+  struct scratch_chunk *next;
+  size_t size;  /* number of bytes available for the blocks */
+  size_t used;  /* offset of the top */
+  size_t last;  /* offset of the header of the top block, or NONE */
+};
+
+struct scratch_block {
+  size_t prev;  /* offset of the header of the previous block, or NONE */
+  size_t state; /* LIVE, FREED or HEAP */
+};
+
+#define NONE  ((size_t) -1)
+#define LIVE  0
+#define FREED 1
+#define HEAP  2
+
+#define CHUNK_HEADER SCRATCH_ROUND (sizeof (struct scratch_chunk))
+#define BLOCK_HEADER SCRATCH_ROUND (sizeof (struct scratch_block))
+#define CHUNK_DATA(c) ((char *) (c) + CHUNK_HEADER)
+#define CHUNK_BLOCK(c, o) ((struct scratch_block *) (CHUNK_DATA (c) + (o)))
+
+static MPFR_THREAD_ATTR struct scratch_chunk *scratch_top = NULL;
+static MPFR_THREAD_ATTR size_t scratch_total = 0;
+static MPFR_THREAD_ATTR size_t scratch_max = MPFR_SCRATCH_MAX;
+
+/* Free the chunks after c (all empty). */
+static void
+free_chunks_after (struct scratch_chunk *c)
+{
+  struct scratch_chunk *n = c->next, *t;
+
+  c->next = NULL;
+  while (n != NULL)
+    {
+      t = n->next;
+      scratch_total -= CHUNK_HEADER + n->size;
+      (*__gmp_free_func) (n, CHUNK_HEADER + n->size);
+      n = t;
+    }
+}
+
+/* Make the top chunk a chunk with at least need free bytes, and return it,
+   or return NULL if this would exceed the maximum size of the arena. */
+static struct scratch_chunk *
+new_chunk (size_t need)
+{
+  struct scratch_chunk *c = scratch_top;
+  size_t size;
+
+  if (c != NULL && c->next != NULL)
+    {
+      if (c->next->size >= need)
+        return scratch_top = c->next;
+      free_chunks_after (c);
+    }
+
+  size = c == NULL ? MPFR_SCRATCH_MIN_CHUNK : 2 * c->size;
+  if (size < need)
+    size = need;
+  if (size > scratch_max || scratch_total + CHUNK_HEADER + size > scratch_max)
+    {
+      size = need;
+      if (size > scratch_max ||
+          scratch_total + CHUNK_HEADER + size > scratch_max)
+        return NULL;
+    }
+
+  c = (struct scratch_chunk *) (*__gmp_allocate_func) (CHUNK_HEADER + size);
+  scratch_total += CHUNK_HEADER + size;
+  c->prev = scratch_top;
+  c->next = NULL;
+  c->size = size;
+  c->used = 0;
+  c->last = NONE;
+  if (scratch_top != NULL)
+    scratch_top->next = c;
+  return scratch_top = c;
+}
+
+void *
+mpfr_scratch_alloc (size_t n)
+{
+  struct scratch_chunk *c = scratch_top;
+  struct scratch_block *b;
+  size_t need;
+
+  if (MPFR_UNLIKELY (n > scratch_max))
+    goto heap;
+  need = BLOCK_HEADER + SCRATCH_ROUND (n);
+  if (MPFR_UNLIKELY (c == NULL || c->size - c->used < need))
+    {
+      c = new_chunk (need);
+      if (c == NULL)
+        goto heap;
+    }
+  b = CHUNK_BLOCK (c, c->used);
+  b->prev = c->last;
+  b->state = LIVE;
+  c->last = c->used;
+  c->used += need;
+  return (char *) b + BLOCK_HEADER;
+
+ heap:
+  b = (struct scratch_block *) (*__gmp_allocate_func) (BLOCK_HEADER + n);
+  b->state = HEAP;
+  return (char *) b + BLOCK_HEADER;
+}
+
+void
+mpfr_scratch_free (void *p, size_t n)
+{
+  struct scratch_block *b, *t;
+  struct scratch_chunk *c;
+
+  b = (struct scratch_block *) ((char *) p - BLOCK_HEADER);
+  if (MPFR_UNLIKELY (b->state == HEAP))
+    {
+      (*__gmp_free_func) (b, BLOCK_HEADER + n);
+      return;
+    }
+  MPFR_ASSERTD (b->state == LIVE);
+  b->state = FREED;
+
+  /* Pop the free blocks at the top. */
+  c = scratch_top;
+  for (;;)
+    {
+      while (c->last != NONE && (t = CHUNK_BLOCK (c, c->last))->state == FREED)
+        {
+          c->used = c->last;
+          c->last = t->prev;
+        }
+      if (c->used != 0 || c->prev == NULL)
+        break;
+      scratch_top = c = c->prev;
+    }
+}
+
+void *
+mpfr_scratch_realloc (void *p, size_t old, size_t n)
+{
+  struct scratch_chunk *c = scratch_top;
+  void *q;
+
+  /* Grow or shrink the top block in place. */
+  if (c != NULL && c->last != NONE &&
+      (char *) p == (char *) CHUNK_BLOCK (c, c->last) + BLOCK_HEADER &&
+      n <= scratch_max &&
+      c->size - c->last >= BLOCK_HEADER + SCRATCH_ROUND (n))
+    {
+      c->used = c->last + BLOCK_HEADER + SCRATCH_ROUND (n);
+      return p;
+    }
+
+  q = mpfr_scratch_alloc (n);
+  memcpy (q, p, MIN (old, n));
+  mpfr_scratch_free (p, old);
+  return q;
+}
+
+void
+mpfr_scratch_release (void)
+{
+  struct scratch_chunk *c = scratch_top;
+
+  if (c == NULL)
+    return;
+  free_chunks_after (c);
+  if (c->used == 0)
+    {
+      MPFR_ASSERTD (c->prev == NULL);
+      scratch_total -= CHUNK_HEADER + c->size;
+      (*__gmp_free_func) (c, CHUNK_HEADER + c->size);
+      scratch_top = NULL;
+    }
+}
+
+void
+mpfr_scratch_set_max (size_t n)
+{
+  scratch_max = n;
+  if (scratch_total > n)
+    mpfr_scratch_release ();
+}
+
+size_t
+mpfr_scratch_get_max (void)
+{
+  return scratch_max;
+}
+
+#else
+
+/* Without --enable-scratch-arena, the temporary memory is allocated
+   directly with the GMP memory functions, and there is nothing to bound
+   or to release. */
+
+void
+mpfr_scratch_release (void)
+{
+}
+
+void
+mpfr_scratch_set_max (size_t n)
+{
+}
+
+size_t
+mpfr_scratch_get_max (void)
+{
+  return 0;
+}
+
+#endif
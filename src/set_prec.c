@@ -38,10 +38,21 @@ mpfr_set_prec (mpfr_ptr x, mpfr_prec_t p)
   xoldsize = MPFR_GET_ALLOC_SIZE (x);
   if (MPFR_UNLIKELY (xsize > xoldsize))
     {
-      tmp = (mpfr_limb_ptr) (*__gmp_reallocate_func)
-        (MPFR_GET_REAL_PTR(x), MPFR_MALLOC_SIZE(xoldsize), MPFR_MALLOC_SIZE(xsize));
-      MPFR_SET_MANT_PTR(x, tmp);
-      MPFR_SET_ALLOC_SIZE(x, xsize);
+      if (MPFR_UNLIKELY (xoldsize < 0))
+        {
+          /* inline significand (mpfr_init2_inline): keep the buffer
+             if it is large enough */
+          if (xsize > - xoldsize)
+            mpfr_inline_to_heap (x, xsize);
+        }
+      else
+        {
+          tmp = (mpfr_limb_ptr) (*__gmp_reallocate_func)
+            (MPFR_GET_REAL_PTR(x), MPFR_MALLOC_SIZE(xoldsize),
+             MPFR_MALLOC_SIZE(xsize));
+          MPFR_SET_MANT_PTR(x, tmp);
+          MPFR_SET_ALLOC_SIZE(x, xsize);
+        }
     }
   MPFR_PREC (x) = p;
   MPFR_SET_NAN (x); /* initializes to NaN */
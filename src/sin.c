@@ -81,6 +81,7 @@ mpfr_sin (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
     }
 
   m = precy + MPFR_INT_CEIL_LOG2 (precy) + 13;
+  MPFR_ZIV_ADAPT (loop, m);
   expx = MPFR_GET_EXP (x);
 
   mpfr_init (c);
@@ -96,21 +97,31 @@ mpfr_sin (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
                         the reduction. */
         {
           reduce = 1;
-          /* As expx + m - 1 will silently be converted into mpfr_prec_t
-             in the mpfr_set_prec call, the assert below may be useful to
-             avoid undefined behavior. */
-          MPFR_ASSERTN (expx + m - 1 <= MPFR_PREC_MAX);
-          mpfr_set_prec (c, expx + m - 1);
           mpfr_set_prec (xr, m);
-          mpfr_const_pi (c, MPFR_RNDN);
-          mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
-          mpfr_remainder (xr, x, c, MPFR_RNDN);
+          if (expx >= MPFR_PAYNE_HANEK_THRESHOLD)
+            {
+              mpfr_payne_hanek (xr, NULL, x);
+              /* c approximates Pi with an error <= 2^(-m) */
+              mpfr_set_prec (c, m + 1);
+              mpfr_const_pi (c, MPFR_RNDN);
+            }
+          else
+            {
+              /* As expx + m - 1 will silently be converted into
+                 mpfr_prec_t in the mpfr_set_prec call, the assert below
+                 may be useful to avoid undefined behavior. */
+              MPFR_ASSERTN (expx + m - 1 <= MPFR_PREC_MAX);
+              mpfr_set_prec (c, expx + m - 1);
+              mpfr_const_pi (c, MPFR_RNDN);
+              mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
+              mpfr_remainder (xr, x, c, MPFR_RNDN);
+              mpfr_div_2ui (c, c, 1, MPFR_RNDN);
+            }
           /* The analysis is similar to that of cos.c:
              |xr - x - 2kPi| <= 2^(2-m). Thus we can decide the sign
              of sin(x) if xr is at distance at least 2^(2-m) of both
              0 and +/-Pi. */
-          mpfr_div_2ui (c, c, 1, MPFR_RNDN);
-          /* Since c approximates Pi with an error <= 2^(2-expx-m) <= 2^(-m),
+          /* Since c approximates Pi with an error <= 2^(-m) in both cases,
              it suffices to check that c - |xr| >= 2^(2-m). */
           if (MPFR_IS_POS (xr))
             mpfr_sub (c, c, xr, MPFR_RNDZ);
@@ -141,12 +141,21 @@ mpfr_sin_cos (mpfr_ptr y, mpfr_ptr z, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       if (expx >= 2) /* reduce the argument */
         {
           reduce = 1;
-          mpfr_set_prec (c, expx + m - 1);
           mpfr_set_prec (xr, m);
-          mpfr_const_pi (c, MPFR_RNDN);
-          mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
-          mpfr_remainder (xr, x, c, MPFR_RNDN);
-          mpfr_div_2ui (c, c, 1, MPFR_RNDN);
+          if (expx >= MPFR_PAYNE_HANEK_THRESHOLD)
+            {
+              mpfr_payne_hanek (xr, NULL, x);
+              mpfr_set_prec (c, m + 1);
+              mpfr_const_pi (c, MPFR_RNDN);
+            }
+          else
+            {
+              mpfr_set_prec (c, expx + m - 1);
+              mpfr_const_pi (c, MPFR_RNDN);
+              mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
+              mpfr_remainder (xr, x, c, MPFR_RNDN);
+              mpfr_div_2ui (c, c, 1, MPFR_RNDN);
+            }
           if (MPFR_IS_POS (xr))
             mpfr_sub (c, c, xr, MPFR_RNDZ);
           else
@@ -174,8 +183,7 @@ mpfr_sin_cos (mpfr_ptr y, mpfr_ptr z, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
         err = m;
       else
         err = MPFR_GET_EXP (c) + (mpfr_exp_t) (m - 3);
-      if (!mpfr_can_round (c, err, MPFR_RNDN, MPFR_RNDZ,
-                           MPFR_PREC (z) + (rnd_mode == MPFR_RNDN)))
+      if (!MPFR_CAN_ROUND (c, err, MPFR_PREC (z), rnd_mode))
         goto next_step;
 
       /* we can't set z now, because in case z = x, and the mpfr_can_round()
@@ -197,8 +205,7 @@ mpfr_sin_cos (mpfr_ptr y, mpfr_ptr z, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       /* the absolute error on c is at most 2^(err-m), which we must put
          in the form 2^(EXP(c)-err). */
       err = MPFR_GET_EXP (c) + (mpfr_exp_t) m - err;
-      if (mpfr_can_round (c, err, MPFR_RNDN, MPFR_RNDZ,
-                          MPFR_PREC (y) + (rnd_mode == MPFR_RNDN)))
+      if (MPFR_CAN_ROUND (c, err, MPFR_PREC (y), rnd_mode))
         break;
       /* check for huge cancellation */
       if (err < (mpfr_exp_t) MPFR_PREC (y))
@@ -453,6 +460,238 @@ sin_bs_aux (mpz_t Q0, mpz_t S0, mpz_t C0, mpz_srcptr p, mpfr_prec_t r,
   return l;
 }
 
+/* Set S/(2^l*Q) and C/(2^l*Q) to approximations of sin(X+X2) and
+   cos(X+X2), where S/(2^l*Q) ~ sin(X), C/(2^l*Q) ~ cos(X), and similarly
+   for X2 with S2, C2, Q2 and l2, then reduce Q, S and C to prec bits.
+   If the errors on the two inputs are bounded by e*2^(-prec) and
+   e2*2^(-prec), the error on the result is bounded by (e+e2+2)*2^(-prec).
+   S2 and C2 are destroyed. The products are computed with nthreads
+   threads (see mpfr_bs_mul). Return the new value of l. */
+static unsigned long
+sincos_combine (mpz_ptr Q, mpz_ptr S, mpz_ptr C, unsigned long l,
+                mpz_srcptr Q2, mpz_ptr S2, mpz_ptr C2, unsigned long l2,
+                mpfr_prec_t prec, unsigned int nthreads)
+{
+  mpz_t y, z;
+  mpz_ptr r[4];
+  mpz_srcptr a[4], b[4];
+
+  /* s <- s*c2+c*s2, c <- c*c2-s*s2, using Karatsuba:
+     a = s+c, b = s2+c2, t = a*b, d = s*s2, e = c*c2,
+     s <- t - d - e, c <- e - d */
+  mpz_init (y);
+  mpz_init (z);
+  mpz_add (y, S, C); /* a */
+  mpz_add (z, C2, S2); /* b */
+  r[0] = C; /* e */
+  a[0] = C;
+  b[0] = C2;
+  r[1] = S2; /* d */
+  a[1] = S;
+  b[1] = S2;
+  r[2] = Q;
+  a[2] = Q;
+  b[2] = Q2;
+  r[3] = y; /* t */
+  a[3] = y;
+  b[3] = z;
+  mpfr_bs_mul (r, a, b, 4, nthreads);
+  mpz_sub (S, y, S2); /* t - d */
+  mpz_sub (S, S, C); /* t - d - e */
+  mpz_sub (C, C, S2); /* e - d */
+  mpz_clear (y);
+  mpz_clear (z);
+  l += l2;
+  /* reduce Q to prec bits */
+  l += reduce (Q, Q, prec);
+  /* reduce S,C to prec bits */
+  l -= reduce2 (S, C, prec);
+  return l;
+}
+
+/* Threaded mode (see mpfr_set_nthreads): the blocks of x in sincos_aux
+   are independent until their combination, so that the series of the
+   different blocks are evaluated by parallel tasks, then the blocks are
+   combined by a binary tree of products instead of one after the other.
+   S/Q and C/Q may then differ from the serial code in the last bits, but
+   since the error bound of sincos_combine is symmetric, the bound
+   (11j-2)*2^(-prec) of the serial code still holds, so that the result
+   of mpfr_sincos_fast does not depend on the number of threads. */
+
+/* Minimum working precision (in bits) for the threaded mode. */
+#ifndef MPFR_SINCOS_MT_THRESHOLD
+# define MPFR_SINCOS_MT_THRESHOLD 50000
+#endif
+
+typedef struct {
+  mpz_t Q, S, C;    /* sin(X) ~ S/(2^l*Q), cos(X) ~ C/(2^l*Q) */
+  mpz_t y;          /* X = y/2^r, or r = 0 if S, C, Q and l are known */
+  mpfr_prec_t r;
+  unsigned long l;
+} mpfr_sincos_block_t;
+
+typedef struct {
+  mpfr_sincos_block_t **b;
+  int n;
+  unsigned int task, ntasks, nthreads;
+  mpfr_prec_t prec;
+} mpfr_sincos_task_t;
+
+/* evaluate the series of the blocks b[task], b[task+ntasks], ... */
+static void
+mpfr_sincos_series_task (void *p)
+{
+  mpfr_sincos_task_t *t = (mpfr_sincos_task_t *) p;
+  mpfr_sincos_block_t *c;
+  int i;
+
+  for (i = t->task; i < t->n; i += t->ntasks)
+    {
+      c = t->b[i];
+      if (c->r != 0)
+        c->l = sin_bs_aux (c->Q, c->S, c->C, c->y, c->r, t->prec);
+    }
+}
+
+/* combine b[2i] and b[2i+1] into b[2i], for i = task, task+ntasks, ...
+   less than n */
+static void
+mpfr_sincos_combine_task (void *p)
+{
+  mpfr_sincos_task_t *t = (mpfr_sincos_task_t *) p;
+  mpfr_sincos_block_t *u, *v;
+  int i;
+
+  for (i = t->task; i < t->n; i += t->ntasks)
+    {
+      u = t->b[2 * i];
+      v = t->b[2 * i + 1];
+      u->l = sincos_combine (u->Q, u->S, u->C, u->l, v->Q, v->S, v->C, v->l,
+                             t->prec, t->nthreads);
+    }
+}
+
+/* Same as the loop of sincos_aux below: set Q, S, C such that
+   S/(2^l*Q) ~ sin(x) and C/(2^l*Q) ~ cos(x), where l is the return value,
+   and set *jp to the number of loops of the serial code. The input values
+   of Q, S and C must be 1, 0 and 1. */
+static unsigned long
+sincos_aux_mt (mpz_ptr Q, mpz_ptr S, mpz_ptr C, mpfr_srcptr x,
+               mpfr_prec_t prec_s, unsigned long *jp, unsigned int nthreads)
+{
+  mpfr_sincos_block_t *blk, **b;
+  mpfr_sincos_task_t *t;
+  mpfr_prec_t sh;
+  mpfr_t x2;
+  mpz_t y;
+  unsigned long j, l = 0;
+  unsigned int k, ntasks;
+  int i, n, nb;
+  MPFR_TMP_DECL (marker);
+
+  MPFR_TMP_MARK (marker);
+  n = MPFR_INT_CEIL_LOG2 (prec_s) + 2; /* maximum number of blocks */
+  blk = (mpfr_sincos_block_t *) MPFR_TMP_ALLOC (n * sizeof (*blk));
+  b = (mpfr_sincos_block_t **) MPFR_TMP_ALLOC (n * sizeof (*b));
+  t = (mpfr_sincos_task_t *) MPFR_TMP_ALLOC (nthreads * sizeof (*t));
+
+  /* Extract the blocks as in sincos_aux; the block of the last bits, for
+     which sin(X) ~ X and cos(X) ~ 1, is computed directly. */
+  mpfr_init2 (x2, MPFR_PREC(x));
+  mpz_init (y);
+  mpfr_set (x2, x, MPFR_RNDN); /* exact */
+  for (sh = 1, j = 0, nb = 0; mpfr_cmp_ui (x2, 0) != 0 && sh <= prec_s;
+       sh <<= 1, j++)
+    {
+      mpfr_sincos_block_t *c = blk + nb;
+
+      if (sh <= prec_s / 2)
+        {
+          mpfr_mul_2exp (x2, x2, sh, MPFR_RNDN); /* exact */
+          mpfr_get_z (y, x2, MPFR_RNDZ);
+          if (mpz_cmp_ui (y, 0) == 0)
+            continue;
+          mpfr_sub_z (x2, x2, y, MPFR_RNDN); /* should be exact */
+        }
+      mpz_init (c->Q);
+      mpz_init (c->S);
+      mpz_init (c->C);
+      mpz_init (c->y);
+      if (sh > prec_s / 2)
+        {
+          c->l = -mpfr_get_z_2exp (c->S, x2);
+          c->l += sh - 1;
+          mpz_set_ui (c->Q, 1);
+          mpz_set_ui (c->C, 1);
+          mpz_mul_2exp (c->C, c->C, c->l);
+          c->r = 0;
+          mpfr_set_ui (x2, 0, MPFR_RNDN);
+        }
+      else
+        {
+          mpz_swap (c->y, y);
+          c->r = 2 * sh - 1;
+        }
+      b[nb++] = c;
+    }
+  mpz_clear (y);
+  mpfr_clear (x2);
+  MPFR_ASSERTN (nb <= n);
+  *jp = j;
+
+  for (k = 0; k < nthreads; k++)
+    {
+      t[k].b = b;
+      t[k].task = k;
+      t[k].prec = prec_s;
+    }
+
+  /* Evaluate the series in parallel. */
+  ntasks = nthreads < (unsigned int) nb ? nthreads : (unsigned int) nb;
+  for (k = 0; k < ntasks; k++)
+    {
+      t[k].n = nb;
+      t[k].ntasks = ntasks;
+    }
+  mpfr_parallel_run (mpfr_sincos_series_task, t, sizeof (*t), ntasks);
+
+  /* Multiplication tree: at each level, the pairs of adjacent blocks are
+     combined in parallel, the remaining threads being used for the
+     products of each combination. */
+  for (n = nb; n > 1; n = (n + 1) / 2)
+    {
+      unsigned int npairs = n / 2;
+
+      ntasks = nthreads < npairs ? nthreads : npairs;
+      for (k = 0; k < ntasks; k++)
+        {
+          t[k].n = npairs;
+          t[k].ntasks = ntasks;
+          t[k].nthreads = npairs < nthreads ? nthreads / npairs : 1;
+        }
+      mpfr_parallel_run (mpfr_sincos_combine_task, t, sizeof (*t), ntasks);
+      for (i = 0; 2 * i < n; i++)
+        b[i] = b[2 * i];
+    }
+
+  if (nb > 0)
+    {
+      mpz_swap (Q, b[0]->Q);
+      mpz_swap (S, b[0]->S);
+      mpz_swap (C, b[0]->C);
+      l = b[0]->l;
+    }
+  for (i = 0; i < nb; i++)
+    {
+      mpz_clear (blk[i].Q);
+      mpz_clear (blk[i].S);
+      mpz_clear (blk[i].C);
+      mpz_clear (blk[i].y);
+    }
+  MPFR_TMP_FREE (marker);
+  return l;
+}
+
 /* Put in s and c approximations of sin(x) and cos(x) respectively.
    Assumes 0 < x < Pi/4 and PREC(s) = PREC(c) >= 10.
    Return err such that the relative error is bounded by 2^err ulps.
@@ -464,6 +703,7 @@ sincos_aux (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpz_t Q, S, C, Q2, S2, C2, y;
   mpfr_t x2;
   unsigned long l, l2, j, err;
+  unsigned int nthreads = mpfr_get_nthreads ();
 
   MPFR_ASSERTD(MPFR_PREC(s) == MPFR_PREC(c));
 
@@ -484,63 +724,52 @@ sincos_aux (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   mpz_set_ui (S, 0); /* sin(0) = S/(2^l*Q), exact */
   mpz_set_ui (C, 1); /* cos(0) = C/(2^l*Q), exact */
 
-  /* Invariant: x = X + x2/2^(sh-1), where the part X was already treated,
-     S/(2^l*Q) ~ sin(X), C/(2^l*Q) ~ cos(X), and x2/2^(sh-1) < Pi/4.
-     'sh-1' is the number of already shifted bits in x2.
-  */
-
-  for (sh = 1, j = 0; mpfr_cmp_ui (x2, 0) != 0 && sh <= prec_s; sh <<= 1, j++)
+  if (nthreads > 1 && prec_s >= MPFR_SINCOS_MT_THRESHOLD)
+    l = sincos_aux_mt (Q, S, C, x, prec_s, &j, nthreads);
+  else
     {
-      if (sh > prec_s / 2) /* sin(x) = x + O(x^3), cos(x) = 1 + O(x^2) */
-        {
-          l2 = -mpfr_get_z_2exp (S2, x2); /* S2/2^l2 = x2 */
-          l2 += sh - 1;
-          mpz_set_ui (Q2, 1);
-          mpz_set_ui (C2, 1);
-          mpz_mul_2exp (C2, C2, l2);
-          mpfr_set_ui (x2, 0, MPFR_RNDN);
-        }
-      else
-        {
-          /* y <- trunc(x2 * 2^sh) = trunc(x * 2^(2*sh-1)) */
-          mpfr_mul_2exp (x2, x2, sh, MPFR_RNDN); /* exact */
-          mpfr_get_z (y, x2, MPFR_RNDZ); /* round toward zero: now
-                                           0 <= x2 < 2^sh, thus
-                                           0 <= x2/2^(sh-1) < 2^(1-sh) */
-          if (mpz_cmp_ui (y, 0) == 0)
-            continue;
-          mpfr_sub_z (x2, x2, y, MPFR_RNDN); /* should be exact */
-          l2 = sin_bs_aux (Q2, S2, C2, y, 2 * sh - 1, prec_s);
-          /* we now have |S2/Q2/2^l2 - sin(X)| <= 9*2^(prec_s)
-             and |C2/Q2/2^l2 - cos(X)| <= 6*2^(prec_s), with X=y/2^(2sh-1) */
-        }
-      if (sh == 1) /* S=0, C=1 */
-        {
-          l = l2;
-          mpz_swap (Q, Q2);
-          mpz_swap (S, S2);
-          mpz_swap (C, C2);
-        }
-      else
+      /* Invariant: x = X + x2/2^(sh-1), where the part X was already treated,
+         S/(2^l*Q) ~ sin(X), C/(2^l*Q) ~ cos(X), and x2/2^(sh-1) < Pi/4.
+         'sh-1' is the number of already shifted bits in x2.
+      */
+
+      for (sh = 1, j = 0; mpfr_cmp_ui (x2, 0) != 0 && sh <= prec_s;
+           sh <<= 1, j++)
         {
-          /* s <- s*c2+c*s2, c <- c*c2-s*s2, using Karatsuba:
-             a = s+c, b = s2+c2, t = a*b, d = s*s2, e = c*c2,
-             s <- t - d - e, c <- e - d */
-          mpz_add (y, S, C); /* a */
-          mpz_mul (C, C, C2); /* e */
-          mpz_add (C2, C2, S2); /* b */
-          mpz_mul (S2, S, S2); /* d */
-          mpz_mul (y, y, C2); /* a*b */
-          mpz_sub (S, y, S2); /* t - d */
-          mpz_sub (S, S, C); /* t - d - e */
-          mpz_sub (C, C, S2); /* e - d */
-          mpz_mul (Q, Q, Q2);
-          /* after j loops, the error is <= (11j-2)*2^(prec_s) */
-          l += l2;
-          /* reduce Q to prec_s bits */
-          l += reduce (Q, Q, prec_s);
-          /* reduce S,C to prec_s bits, error <= 11*j*2^(prec_s) */
-          l -= reduce2 (S, C, prec_s);
+          if (sh > prec_s / 2) /* sin(x) = x + O(x^3), cos(x) = 1 + O(x^2) */
+            {
+              l2 = -mpfr_get_z_2exp (S2, x2); /* S2/2^l2 = x2 */
+              l2 += sh - 1;
+              mpz_set_ui (Q2, 1);
+              mpz_set_ui (C2, 1);
+              mpz_mul_2exp (C2, C2, l2);
+              mpfr_set_ui (x2, 0, MPFR_RNDN);
+            }
+          else
+            {
+              /* y <- trunc(x2 * 2^sh) = trunc(x * 2^(2*sh-1)) */
+              mpfr_mul_2exp (x2, x2, sh, MPFR_RNDN); /* exact */
+              mpfr_get_z (y, x2, MPFR_RNDZ); /* round toward zero: now
+                                               0 <= x2 < 2^sh, thus
+                                               0 <= x2/2^(sh-1) < 2^(1-sh) */
+              if (mpz_cmp_ui (y, 0) == 0)
+                continue;
+              mpfr_sub_z (x2, x2, y, MPFR_RNDN); /* should be exact */
+              l2 = sin_bs_aux (Q2, S2, C2, y, 2 * sh - 1, prec_s);
+              /* we now have |S2/Q2/2^l2 - sin(X)| <= 9*2^(prec_s)
+                 and |C2/Q2/2^l2 - cos(X)| <= 6*2^(prec_s),
+                 with X=y/2^(2sh-1) */
+            }
+          if (sh == 1) /* S=0, C=1 */
+            {
+              l = l2;
+              mpz_swap (Q, Q2);
+              mpz_swap (S, S2);
+              mpz_swap (C, C2);
+            }
+          else
+            /* after j loops, the error is <= (11j-2)*2^(prec_s) */
+            l = sincos_combine (Q, S, C, l, Q2, S2, C2, l2, prec_s, 1);
         }
     }
 
@@ -610,20 +839,28 @@ mpfr_sincos_fast (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd)
       else /* argument reduction is needed */
         {
           long q;
-          mpfr_t pi;
           int neg = 0;
 
           mpfr_init2 (x_red, w);
-          mpfr_init2 (pi, (MPFR_EXP(x) > 0) ? w + MPFR_EXP(x) : w);
-          mpfr_const_pi (pi, MPFR_RNDN);
-          mpfr_div_2exp (pi, pi, 1, MPFR_RNDN); /* Pi/2 */
-          mpfr_remquo (x_red, &q, x, pi, MPFR_RNDN);
-          /* x = q * (Pi/2 + eps1) + x_red + eps2,
-             where |eps1| <= 1/2*ulp(Pi/2) = 2^(-w-MAX(0,EXP(x))),
-             and eps2 <= 1/2*ulp(x_red) <= 1/2*ulp(Pi/2) = 2^(-w)
-             Since |q| <= x/(Pi/2) <= |x|, we have
-             q*|eps1| <= 2^(-w), thus
-             |x - q * Pi/2 - x_red| <= 2^(1-w) */
+          if (MPFR_GET_EXP (x) >= MPFR_PAYNE_HANEK_THRESHOLD)
+            /* same bound |x - q * Pi/2 - x_red| <= 2^(1-w) as below */
+            mpfr_payne_hanek (x_red, &q, x);
+          else
+            {
+              mpfr_t pi;
+
+              mpfr_init2 (pi, (MPFR_EXP(x) > 0) ? w + MPFR_EXP(x) : w);
+              mpfr_const_pi (pi, MPFR_RNDN);
+              mpfr_div_2exp (pi, pi, 1, MPFR_RNDN); /* Pi/2 */
+              mpfr_remquo (x_red, &q, x, pi, MPFR_RNDN);
+              /* x = q * (Pi/2 + eps1) + x_red + eps2,
+                 where |eps1| <= 1/2*ulp(Pi/2) = 2^(-w-MAX(0,EXP(x))),
+                 and eps2 <= 1/2*ulp(x_red) <= 1/2*ulp(Pi/2) = 2^(-w)
+                 Since |q| <= x/(Pi/2) <= |x|, we have
+                 q*|eps1| <= 2^(-w), thus
+                 |x - q * Pi/2 - x_red| <= 2^(1-w) */
+              mpfr_clear (pi);
+            }
           /* now -Pi/4 <= x_red <= Pi/4: if x_red < 0, consider -x_red */
           if (MPFR_IS_NEG(x_red))
             {
@@ -645,7 +882,6 @@ mpfr_sincos_fast (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd)
               mpfr_swap (ts, tc);
             }
           mpfr_clear (x_red);
-          mpfr_clear (pi);
         }
       /* adjust errors with respect to absolute values */
       errs = err - MPFR_EXP(ts);
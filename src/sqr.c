@@ -20,8 +20,139 @@ along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
 http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
 
+#define MPFR_NEED_LONGLONG_H
 #include "mpfr-impl.h"
 
+/* Special code for PREC(a) < GMP_NUMB_BITS and PREC(b) <= GMP_NUMB_BITS:
+   see mpfr_mul_1 in mul.c. The result is always positive. */
+static int
+mpfr_sqr_1 (mpfr_ptr a, mpfr_srcptr b, mpfr_rnd_t rnd_mode, mpfr_prec_t p)
+{
+  mpfr_exp_t ax;
+  int inexact;
+  mpfr_prec_t sh = GMP_NUMB_BITS - p;
+  mp_limb_t a0, l, rb, sb, mask = MPFR_LIMB_MASK (sh);
+
+  MPFR_ASSERTD (p < GMP_NUMB_BITS);
+
+  ax = 2 * MPFR_GET_EXP (b);
+  umul_ppmm (a0, l, MPFR_MANT (b)[0], MPFR_MANT (b)[0]);
+  if (a0 < MPFR_LIMB_HIGHBIT)
+    {
+      ax --;
+      a0 = (a0 << 1) | (l >> (GMP_NUMB_BITS - 1));
+      l <<= 1;
+    }
+  rb = a0 & (MPFR_LIMB_ONE << (sh - 1));
+  sb = ((a0 & mask) ^ rb) | l;
+  a0 &= ~mask;
+
+  MPFR_SET_POS (a);
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inexact = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (a0 & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF || MPFR_IS_LIKE_RNDZ (rnd_mode, 0))
+    inexact = -1; /* truncate */
+  else
+    {
+      inexact = 1;
+      a0 += MPFR_LIMB_ONE << sh;
+      if (MPFR_UNLIKELY (a0 == 0))
+        {
+          a0 = MPFR_LIMB_HIGHBIT;
+          ax ++;
+        }
+    }
+
+  MPFR_MANT (a)[0] = a0;
+  if (MPFR_UNLIKELY (ax > __gmpfr_emax))
+    return mpfr_overflow (a, rnd_mode, MPFR_SIGN_POS);
+  if (MPFR_UNLIKELY (ax < __gmpfr_emin))
+    {
+      if (rnd_mode == MPFR_RNDN &&
+          (ax < __gmpfr_emin - 1 ||
+           (inexact >= 0 && a0 == MPFR_LIMB_HIGHBIT)))
+        rnd_mode = MPFR_RNDZ;
+      return mpfr_underflow (a, rnd_mode, MPFR_SIGN_POS);
+    }
+  MPFR_SET_EXP (a, ax);
+  MPFR_RET (inexact);
+}
+
+/* Special code for GMP_NUMB_BITS < PREC(a) < 2*GMP_NUMB_BITS and
+   GMP_NUMB_BITS < PREC(b) <= 2*GMP_NUMB_BITS. */
+static int
+mpfr_sqr_2 (mpfr_ptr a, mpfr_srcptr b, mpfr_rnd_t rnd_mode, mpfr_prec_t p)
+{
+  mpfr_exp_t ax;
+  int inexact;
+  mpfr_prec_t sh = 2 * GMP_NUMB_BITS - p;
+  mp_limb_t h, m, l, z, t1, t0, rb, sb, mask = MPFR_LIMB_MASK (sh);
+  mp_limb_t *bp = MPFR_MANT (b);
+
+  MPFR_ASSERTD (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS);
+
+  ax = 2 * MPFR_GET_EXP (b);
+
+  /* {h, m, l, z} = {bp, 2}^2, the cross product being added twice */
+  umul_ppmm (h, m, bp[1], bp[1]);
+  umul_ppmm (l, z, bp[0], bp[0]);
+  umul_ppmm (t1, t0, bp[1], bp[0]);
+  add_ssaaaa (h, m, h, m, 0, t1);
+  l += t0;
+  m += l < t0;
+  h += m == 0 && l < t0;
+  add_ssaaaa (h, m, h, m, 0, t1);
+  l += t0;
+  m += l < t0;
+  h += m == 0 && l < t0;
+  if (h < MPFR_LIMB_HIGHBIT)
+    {
+      ax --;
+      h = (h << 1) | (m >> (GMP_NUMB_BITS - 1));
+      m = (m << 1) | (l >> (GMP_NUMB_BITS - 1));
+      l <<= 1;
+    }
+  rb = m & (MPFR_LIMB_ONE << (sh - 1));
+  sb = ((m & mask) ^ rb) | l | z;
+  m &= ~mask;
+
+  MPFR_SET_POS (a);
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inexact = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (m & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF || MPFR_IS_LIKE_RNDZ (rnd_mode, 0))
+    inexact = -1; /* truncate */
+  else
+    {
+      inexact = 1;
+      m += MPFR_LIMB_ONE << sh;
+      h += m == 0;
+      if (MPFR_UNLIKELY (h == 0 && m == 0))
+        {
+          h = MPFR_LIMB_HIGHBIT;
+          ax ++;
+        }
+    }
+
+  MPFR_MANT (a)[0] = m;
+  MPFR_MANT (a)[1] = h;
+  if (MPFR_UNLIKELY (ax > __gmpfr_emax))
+    return mpfr_overflow (a, rnd_mode, MPFR_SIGN_POS);
+  if (MPFR_UNLIKELY (ax < __gmpfr_emin))
+    {
+      if (rnd_mode == MPFR_RNDN &&
+          (ax < __gmpfr_emin - 1 ||
+           (inexact >= 0 && h == MPFR_LIMB_HIGHBIT && m == 0)))
+        rnd_mode = MPFR_RNDZ;
+      return mpfr_underflow (a, rnd_mode, MPFR_SIGN_POS);
+    }
+  MPFR_SET_EXP (a, ax);
+  MPFR_RET (inexact);
+}
+
 int
 mpfr_sqr (mpfr_ptr a, mpfr_srcptr b, mpfr_rnd_t rnd_mode)
 {
@@ -56,6 +187,14 @@ mpfr_sqr (mpfr_ptr a, mpfr_srcptr b, mpfr_rnd_t rnd_mode)
   ax = 2 * MPFR_GET_EXP (b);
   bq = MPFR_PREC(b);
 
+  if (MPFR_GET_PREC (a) < GMP_NUMB_BITS && bq <= GMP_NUMB_BITS)
+    return mpfr_sqr_1 (a, b, rnd_mode, MPFR_GET_PREC (a));
+
+  if (GMP_NUMB_BITS < MPFR_GET_PREC (a) &&
+      MPFR_GET_PREC (a) < 2 * GMP_NUMB_BITS &&
+      GMP_NUMB_BITS < bq && bq <= 2 * GMP_NUMB_BITS)
+    return mpfr_sqr_2 (a, b, rnd_mode, MPFR_GET_PREC (a));
+
   MPFR_ASSERTN (2 * (mpfr_uprec_t) bq <= MPFR_PREC_MAX);
 
   bn = MPFR_LIMB_SIZE (b); /* number of limbs of b */
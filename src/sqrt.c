@@ -20,8 +20,214 @@ along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
 http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
 
+#define MPFR_NEED_LONGLONG_H
 #include "mpfr-impl.h"
 
+#if GMP_NUMB_BITS == 64
+
+/* Return s = floor(sqrt(N)) where N = n1*B + n0, B = 2^64, n1 >= B/4, and
+   put in {*rh, *rl} the remainder N - s^2, with 0 <= N - s^2 <= 2s.
+   The approximation x of 1/sqrt(n1/B) from mpfr_rec_sqrt_limb gives
+   y ~ sqrt(n1/B) = x*n1/B, which is refined by one Karp-Markstein step
+   s = y + x*(N - y^2)/2; then s is corrected with the exact remainder. */
+static mp_limb_t
+mpfr_sqrtrem2 (mp_limb_t *rh, mp_limb_t *rl, mp_limb_t n1, mp_limb_t n0)
+{
+  mp_limb_t x, y, s, h, l, c;
+
+  x = mpfr_rec_sqrt_limb (n1);
+  umul_ppmm (y, l, n1, x);
+  /* y/2^62 ~ sqrt(n1/B) < 1 */
+  if (MPFR_UNLIKELY (y >= MPFR_LIMB_ONE << 62))
+    y = (MPFR_LIMB_ONE << 62) - 1;
+  y <<= 2;
+  umul_ppmm (h, l, y, y);
+  if (h < n1 || (h == n1 && l <= n0))
+    {
+      sub_ddmmss (h, l, n1, n0, h, l);
+      umul_ppmm (c, l, h, x);
+      c = (c << 1) | (l >> (GMP_NUMB_BITS - 1));
+      s = y + c < y ? MPFR_LIMB_MAX : y + c;
+    }
+  else
+    {
+      sub_ddmmss (h, l, h, l, n1, n0);
+      umul_ppmm (c, l, h, x);
+      c = (c << 1) | (l >> (GMP_NUMB_BITS - 1));
+      s = y - c;
+    }
+
+  /* now s is within a few units from floor(sqrt(N)) */
+  umul_ppmm (h, l, s, s);
+  while (h > n1 || (h == n1 && l > n0))
+    {
+      s --;
+      umul_ppmm (h, l, s, s);
+    }
+  sub_ddmmss (h, l, n1, n0, h, l);
+  /* {h, l} = N - s^2 >= 0, and s is the integer square root when
+     N - s^2 <= 2s */
+  while (h > (s >> (GMP_NUMB_BITS - 1)) ||
+         (h == (s >> (GMP_NUMB_BITS - 1)) && l > (s << 1)))
+    {
+      sub_ddmmss (h, l, h, l, s >> (GMP_NUMB_BITS - 1), (s << 1) | 1);
+      s ++;
+    }
+  *rh = h;
+  *rl = l;
+  return s;
+}
+
+/* Special code for PREC(r) < GMP_NUMB_BITS and PREC(u) <= GMP_NUMB_BITS,
+   u > 0. Let N = u0*B if EXP(u) is even, and N = u0*B/2 otherwise, so that
+   sqrt(u) = sqrt(N)/B * 2^((EXP(u)+1)/2) [with integer division]. */
+static int
+mpfr_sqrt1 (mpfr_ptr r, mpfr_srcptr u, mpfr_rnd_t rnd_mode)
+{
+  mpfr_prec_t p = MPFR_GET_PREC (r);
+  mpfr_prec_t sh = GMP_NUMB_BITS - p;
+  mpfr_exp_t exp_u = MPFR_GET_EXP (u), exp_r;
+  mp_limb_t u0 = MPFR_MANT (u)[0], n1, n0, s, rh, rl, rb, sb;
+  mp_limb_t mask = MPFR_LIMB_MASK (sh);
+  int inex;
+
+  if (((mpfr_uexp_t) exp_u & 1) != 0)
+    {
+      n1 = u0 >> 1;
+      n0 = u0 << (GMP_NUMB_BITS - 1);
+      exp_r = (exp_u + 1) / 2;
+    }
+  else
+    {
+      n1 = u0;
+      n0 = 0;
+      exp_r = exp_u / 2;
+    }
+
+  s = mpfr_sqrtrem2 (&rh, &rl, n1, n0);
+  MPFR_ASSERTD (s >= MPFR_LIMB_HIGHBIT);
+  rb = s & (MPFR_LIMB_ONE << (sh - 1));
+  sb = ((s & mask) ^ rb) | rh | rl;
+  s &= ~mask;
+
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inex = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (s & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF || MPFR_IS_LIKE_RNDZ (rnd_mode, 0))
+    inex = -1; /* truncate */
+  else
+    {
+      inex = 1;
+      s += MPFR_LIMB_ONE << sh;
+      if (MPFR_UNLIKELY (s == 0))
+        {
+          s = MPFR_LIMB_HIGHBIT;
+          exp_r ++;
+        }
+    }
+  MPFR_MANT (r)[0] = s;
+  /* Do not use MPFR_SET_EXP because the range has not been checked yet. */
+  MPFR_EXP (r) = exp_r;
+  return mpfr_check_range (r, inex, rnd_mode);
+}
+
+/* Special code for GMP_NUMB_BITS < PREC(r) < 2*GMP_NUMB_BITS and
+   GMP_NUMB_BITS < PREC(u) <= 2*GMP_NUMB_BITS, u > 0. The square root of
+   N = {n3, n2, n1, n0} is computed as in the Karatsuba square root: first
+   s1 = floor(sqrt(n3*B + n2)) with remainder r1, then the low limb
+   q = floor((r1*B + n1) / (2*s1)), and s = s1*B + q is at most one unit
+   too large, which is detected with the exact square of s. */
+static int
+mpfr_sqrt2 (mpfr_ptr r, mpfr_srcptr u, mpfr_rnd_t rnd_mode)
+{
+  mpfr_prec_t p = MPFR_GET_PREC (r);
+  mpfr_prec_t sh = 2 * GMP_NUMB_BITS - p;
+  mpfr_exp_t exp_u = MPFR_GET_EXP (u), exp_r;
+  mp_limb_t u1 = MPFR_MANT (u)[1], u0 = MPFR_MANT (u)[0];
+  mp_limb_t n3, n2, n1, n0, s1, s0, rh, rl, hi, lo;
+  mp_limb_t t3, t2, t1, t0, c1, c0, rb, sb;
+  mp_limb_t mask = MPFR_LIMB_MASK (sh);
+  int inex;
+
+  if (((mpfr_uexp_t) exp_u & 1) != 0)
+    {
+      n3 = u1 >> 1;
+      n2 = (u1 << (GMP_NUMB_BITS - 1)) | (u0 >> 1);
+      n1 = u0 << (GMP_NUMB_BITS - 1);
+      exp_r = (exp_u + 1) / 2;
+    }
+  else
+    {
+      n3 = u1;
+      n2 = u0;
+      n1 = 0;
+      exp_r = exp_u / 2;
+    }
+  n0 = 0;
+
+  s1 = mpfr_sqrtrem2 (&rh, &rl, n3, n2);
+  /* (r1*B + n1) / (2*s1) = {hi, lo} / s1 with {hi, lo} = floor((r1*B+n1)/2),
+     and hi <= s1 since r1 <= 2*s1 */
+  hi = (rh << (GMP_NUMB_BITS - 1)) | (rl >> 1);
+  lo = (rl << (GMP_NUMB_BITS - 1)) | (n1 >> 1);
+  if (MPFR_LIKELY (hi < s1))
+    udiv_qrnnd (s0, c0, hi, lo, s1);
+  else
+    s0 = MPFR_LIMB_MAX; /* the quotient is B or B+1, thus s >= s1*B+B-1 */
+
+  /* exact correction: decrease s = {s1, s0} while s^2 > N */
+  for (;;)
+    {
+      /* {t3, t2, t1, t0} = s^2 */
+      umul_ppmm (t3, t2, s1, s1);
+      umul_ppmm (t1, t0, s0, s0);
+      umul_ppmm (c1, c0, s1, s0);
+      add_ssaaaa (t3, t2, t3, t2, 0, c1);
+      t1 += c0;
+      t2 += t1 < c0;
+      t3 += t2 == 0 && t1 < c0;
+      add_ssaaaa (t3, t2, t3, t2, 0, c1);
+      t1 += c0;
+      t2 += t1 < c0;
+      t3 += t2 == 0 && t1 < c0;
+      if (t3 < n3 || (t3 == n3 && (t2 < n2 || (t2 == n2 &&
+          (t1 < n1 || (t1 == n1 && t0 <= n0))))))
+        break;
+      s1 -= s0 == 0;
+      s0 --;
+    }
+  MPFR_ASSERTD (s1 >= MPFR_LIMB_HIGHBIT);
+
+  rb = s0 & (MPFR_LIMB_ONE << (sh - 1));
+  sb = ((s0 & mask) ^ rb) | (t3 ^ n3) | (t2 ^ n2) | (t1 ^ n1) | (t0 ^ n0);
+  s0 &= ~mask;
+
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inex = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (s0 & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF || MPFR_IS_LIKE_RNDZ (rnd_mode, 0))
+    inex = -1; /* truncate */
+  else
+    {
+      inex = 1;
+      s0 += MPFR_LIMB_ONE << sh;
+      s1 += s0 == 0;
+      if (MPFR_UNLIKELY (s1 == 0 && s0 == 0))
+        {
+          s1 = MPFR_LIMB_HIGHBIT;
+          exp_r ++;
+        }
+    }
+  MPFR_MANT (r)[0] = s0;
+  MPFR_MANT (r)[1] = s1;
+  MPFR_EXP (r) = exp_r;
+  return mpfr_check_range (r, inex, rnd_mode);
+}
+
+#endif
+
 int
 mpfr_sqrt (mpfr_ptr r, mpfr_srcptr u, mpfr_rnd_t rnd_mode)
 {
@@ -83,6 +289,17 @@ mpfr_sqrt (mpfr_ptr r, mpfr_srcptr u, mpfr_rnd_t rnd_mode)
     }
   MPFR_SET_POS(r);
 
+#if GMP_NUMB_BITS == 64
+  if (MPFR_GET_PREC (r) < GMP_NUMB_BITS && MPFR_GET_PREC (u) <= GMP_NUMB_BITS)
+    return mpfr_sqrt1 (r, u, rnd_mode);
+
+  if (GMP_NUMB_BITS < MPFR_GET_PREC (r) &&
+      MPFR_GET_PREC (r) < 2 * GMP_NUMB_BITS &&
+      GMP_NUMB_BITS < MPFR_GET_PREC (u) &&
+      MPFR_GET_PREC (u) <= 2 * GMP_NUMB_BITS)
+    return mpfr_sqrt2 (r, u, rnd_mode);
+#endif
+
   MPFR_TMP_MARK (marker);
   MPFR_UNSIGNED_MINUS_MODULO (sh, MPFR_GET_PREC (r));
   if (sh == 0 && rnd_mode == MPFR_RNDN)
@@ -147,7 +364,9 @@ mpfr_sqrt (mpfr_ptr r, mpfr_srcptr u, mpfr_rnd_t rnd_mode)
 
   expr = (MPFR_GET_EXP(u) + odd_exp) / 2;  /* exact */
 
-  if (rnd_mode == MPFR_RNDZ || rnd_mode == MPFR_RNDD || sticky == MPFR_LIMB_ZERO)
+  /* the truncation is also a faithful rounding (MPFR_RNDF) */
+  if (rnd_mode == MPFR_RNDZ || rnd_mode == MPFR_RNDD || rnd_mode == MPFR_RNDF
+      || sticky == MPFR_LIMB_ZERO)
     {
       inexact = (sticky == MPFR_LIMB_ZERO) ? 0 : -1;
       goto truncate;
@@ -27,12 +27,16 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 /* Check if we have to check the result of mpfr_sub1sp with mpfr_sub1 */
 #if MPFR_WANT_ASSERT >= 2
 
-int mpfr_sub1sp2 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode);
+int mpfr_sub1sp_ref (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode);
 int mpfr_sub1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 {
   mpfr_t tmpa, tmpb, tmpc;
   int inexb, inexc, inexact, inexact2;
 
+  /* with MPFR_RNDF, the results may differ */
+  if (rnd_mode == MPFR_RNDF)
+    return mpfr_sub1sp_ref (a, b, c, rnd_mode);
+
   mpfr_init2 (tmpa, MPFR_PREC (a));
   mpfr_init2 (tmpb, MPFR_PREC (b));
   mpfr_init2 (tmpc, MPFR_PREC (c));
@@ -44,7 +48,7 @@ int mpfr_sub1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   MPFR_ASSERTN (inexc == 0);
 
   inexact2 = mpfr_sub1 (tmpa, tmpb, tmpc, rnd_mode);
-  inexact  = mpfr_sub1sp2(a, b, c, rnd_mode);
+  inexact  = mpfr_sub1sp_ref (a, b, c, rnd_mode);
 
   if (mpfr_cmp (tmpa, a) || inexact != inexact2)
     {
@@ -66,7 +70,7 @@ int mpfr_sub1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   mpfr_clears (tmpa, tmpb, tmpc, (mpfr_ptr) 0);
   return inexact;
 }
-# define mpfr_sub1sp mpfr_sub1sp2
+# define mpfr_sub1sp mpfr_sub1sp_ref
 #endif  /* MPFR_WANT_ASSERT >= 2 */
 
 /* Debugging support */
@@ -129,6 +133,314 @@ int mpfr_sub1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
  *
  */
 
+/* Special code for p < GMP_NUMB_BITS: the significands fit in one limb
+   and are kept in registers; rb and sb are the round and sticky bits of
+   |b| - |c| after normalization, so that the rounding is done only once. */
+static int
+mpfr_sub1sp1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode,
+              mpfr_prec_t p)
+{
+  mpfr_exp_t bx = MPFR_GET_EXP (b);
+  mpfr_exp_t cx = MPFR_GET_EXP (c);
+  mp_limb_t b0 = MPFR_MANT (b)[0];
+  mp_limb_t c0 = MPFR_MANT (c)[0];
+  unsigned int sh = GMP_NUMB_BITS - p;
+  mp_limb_t mask = MPFR_LIMB_MASK (sh);
+  mp_limb_t a0, rb, sb, t;
+  mpfr_uexp_t d;
+  int cnt, inexact;
+
+  MPFR_ASSERTD (p < GMP_NUMB_BITS);
+
+  if (bx == cx && b0 == c0)
+    {
+      /* Return exact number 0 */
+      if (rnd_mode == MPFR_RNDD)
+        MPFR_SET_NEG (a);
+      else
+        MPFR_SET_POS (a);
+      MPFR_SET_ZERO (a);
+      MPFR_RET (0);
+    }
+  else if (bx < cx || (bx == cx && b0 < c0))
+    {
+      /* Swap b and c and set sign */
+      mpfr_exp_t tx = bx;
+      t = b0;
+      bx = cx; cx = tx;
+      b0 = c0; c0 = t;
+      MPFR_SET_OPPOSITE_SIGN (a, b);
+    }
+  else
+    MPFR_SET_SAME_SIGN (a, b);
+
+  /* Now |b| > |c| */
+  d = (mpfr_uexp_t) bx - cx;
+  if (d <= 1)
+    {
+      /* no bit of c0 is shifted out, since its last bit is 0 */
+      a0 = b0 - (c0 >> d);
+      MPFR_ASSERTD (a0 != 0);
+      count_leading_zeros (cnt, a0);
+      a0 <<= cnt;
+      bx -= cnt;
+      if (MPFR_UNLIKELY (bx < __gmpfr_emin))
+        {
+          MPFR_MANT (a)[0] = a0;
+          if (rnd_mode == MPFR_RNDN &&
+              (bx < __gmpfr_emin - 1 || a0 == MPFR_LIMB_HIGHBIT))
+            rnd_mode = MPFR_RNDZ;
+          return mpfr_underflow (a, rnd_mode, MPFR_SIGN (a));
+        }
+      /* if d = 1 and no bit is lost, the difference has p+1 bits */
+      rb = a0 & (MPFR_LIMB_ONE << (sh - 1));
+      sb = 0;
+      a0 ^= rb;
+    }
+  else if (d < GMP_NUMB_BITS)
+    {
+      t = c0 << (GMP_NUMB_BITS - d); /* bits of c shifted out */
+      a0 = b0 - (c0 >> d) - (t != 0);
+      t = -t; /* now a0 + t / 2^GMP_NUMB_BITS is the exact difference */
+      /* since d >= 2, we lose at most one bit */
+      if (MPFR_LIMB_MSB (a0) == 0)
+        {
+          a0 = (a0 << 1) | (t >> (GMP_NUMB_BITS - 1));
+          t <<= 1;
+          bx--;
+        }
+      rb = a0 & (MPFR_LIMB_ONE << (sh - 1));
+      sb = ((a0 & mask) ^ rb) | t;
+      a0 &= ~mask;
+    }
+  else
+    {
+      /* d > p, thus 0 < c < 1/2 ulp(b): write |b| - |c| as
+         (|b| - ulp(b)) + (ulp(b) - |c|), where the second term is
+         larger than 1/2 ulp(b), thus rb = sb = 1. */
+      a0 = b0 - (MPFR_LIMB_ONE << sh);
+      if (MPFR_LIKELY (MPFR_LIMB_MSB (a0) != 0))
+        rb = sb = 1;
+      else
+        {
+          /* b is a power of 2: |b| - ulp(b) is renormalized with the
+             first bit of the second term, which becomes u - |c| with
+             u = ulp(b)/2 the new ulp. Since |c| < 2^(EXP(c)), we have
+             |c| < u/2 if d > p + 1; otherwise d = p + 1 and |c| >= u/2,
+             the middle case being when c is a power of 2. */
+          a0 = ~mask;
+          bx--;
+          rb = d > (mpfr_uexp_t) p + 1 || c0 == MPFR_LIMB_HIGHBIT;
+          sb = d > (mpfr_uexp_t) p + 1 || c0 != MPFR_LIMB_HIGHBIT;
+        }
+    }
+
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inexact = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (a0 & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF
+             || MPFR_IS_LIKE_RNDZ (rnd_mode, MPFR_IS_NEG (a)))
+    inexact = -1; /* truncate */
+  else
+    {
+      inexact = 1; /* add one ulp */
+      a0 += MPFR_LIMB_ONE << sh;
+      if (MPFR_UNLIKELY (a0 == 0))
+        {
+          a0 = MPFR_LIMB_HIGHBIT;
+          bx++;
+        }
+    }
+
+  /* The exponent cannot decrease below EXP(c) in the inexact case, thus
+     there is no underflow, and no overflow since bx <= EXP(b). */
+  MPFR_ASSERTD (bx >= __gmpfr_emin && bx <= __gmpfr_emax);
+  MPFR_MANT (a)[0] = a0;
+  MPFR_SET_EXP (a, bx);
+  MPFR_RET (inexact * MPFR_INT_SIGN (a));
+}
+
+/* Special code for GMP_NUMB_BITS < p < 2 * GMP_NUMB_BITS. */
+static int
+mpfr_sub1sp2 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode,
+              mpfr_prec_t p)
+{
+  mpfr_exp_t bx = MPFR_GET_EXP (b);
+  mpfr_exp_t cx = MPFR_GET_EXP (c);
+  mp_limb_t b0 = MPFR_MANT (b)[0], b1 = MPFR_MANT (b)[1];
+  mp_limb_t c0 = MPFR_MANT (c)[0], c1 = MPFR_MANT (c)[1];
+  mp_limb_t *ap = MPFR_MANT (a);
+  unsigned int sh = 2 * GMP_NUMB_BITS - p;
+  mp_limb_t mask = MPFR_LIMB_MASK (sh);
+  mp_limb_t a0, a1, rb, sb, t0, t1, th, tl;
+  mpfr_uexp_t d;
+  int cnt, inexact;
+
+  MPFR_ASSERTD (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS);
+
+  if (bx == cx && b1 == c1 && b0 == c0)
+    {
+      /* Return exact number 0 */
+      if (rnd_mode == MPFR_RNDD)
+        MPFR_SET_NEG (a);
+      else
+        MPFR_SET_POS (a);
+      MPFR_SET_ZERO (a);
+      MPFR_RET (0);
+    }
+  else if (bx < cx
+           || (bx == cx && (b1 < c1 || (b1 == c1 && b0 < c0))))
+    {
+      /* Swap b and c and set sign */
+      mpfr_exp_t tx = bx;
+      bx = cx; cx = tx;
+      t0 = b0; b0 = c0; c0 = t0;
+      t1 = b1; b1 = c1; c1 = t1;
+      MPFR_SET_OPPOSITE_SIGN (a, b);
+    }
+  else
+    MPFR_SET_SAME_SIGN (a, b);
+
+  /* Now |b| > |c| */
+  d = (mpfr_uexp_t) bx - cx;
+  if (d <= 1)
+    {
+      /* no bit of c0 is shifted out, since its last bit is 0 */
+      if (d == 0)
+        {
+          t0 = c0;
+          t1 = c1;
+        }
+      else
+        {
+          t0 = (c1 << (GMP_NUMB_BITS - 1)) | (c0 >> 1);
+          t1 = c1 >> 1;
+        }
+      a0 = b0 - t0;
+      a1 = b1 - t1 - (b0 < t0);
+      if (a1 == 0)
+        {
+          MPFR_ASSERTD (a0 != 0);
+          a1 = a0;
+          a0 = 0;
+          bx -= GMP_NUMB_BITS;
+        }
+      count_leading_zeros (cnt, a1);
+      if (cnt != 0)
+        {
+          a1 = (a1 << cnt) | (a0 >> (GMP_NUMB_BITS - cnt));
+          a0 <<= cnt;
+          bx -= cnt;
+        }
+      if (MPFR_UNLIKELY (bx < __gmpfr_emin))
+        {
+          ap[0] = a0;
+          ap[1] = a1;
+          if (rnd_mode == MPFR_RNDN &&
+              (bx < __gmpfr_emin - 1 || mpfr_powerof2_raw (a)))
+            rnd_mode = MPFR_RNDZ;
+          return mpfr_underflow (a, rnd_mode, MPFR_SIGN (a));
+        }
+      /* if d = 1 and no bit is lost, the difference has p+1 bits */
+      rb = a0 & (MPFR_LIMB_ONE << (sh - 1));
+      sb = 0;
+      a0 ^= rb;
+    }
+  else if (d < 2 * GMP_NUMB_BITS)
+    {
+      /* th and tl are the bits of c shifted out */
+      if (d < GMP_NUMB_BITS)
+        {
+          th = c0 << (GMP_NUMB_BITS - d);
+          tl = 0;
+          t0 = (c1 << (GMP_NUMB_BITS - d)) | (c0 >> d);
+          t1 = c1 >> d;
+        }
+      else
+        {
+          unsigned int e = d - GMP_NUMB_BITS;
+
+          if (e == 0)
+            {
+              th = c0;
+              tl = 0;
+            }
+          else
+            {
+              th = (c1 << (GMP_NUMB_BITS - e)) | (c0 >> e);
+              tl = c0 << (GMP_NUMB_BITS - e);
+            }
+          t0 = c1 >> e;
+          t1 = 0;
+        }
+      a0 = b0 - t0;
+      a1 = b1 - t1 - (b0 < t0);
+      if ((th | tl) != 0)
+        {
+          /* subtract one more ulp of a0, and negate th:tl */
+          a1 -= a0 == 0;
+          a0--;
+          tl = -tl;
+          th = ~th + (tl == 0);
+        }
+      /* since d >= 2, we lose at most one bit */
+      if (MPFR_LIMB_MSB (a1) == 0)
+        {
+          a1 = (a1 << 1) | (a0 >> (GMP_NUMB_BITS - 1));
+          a0 = (a0 << 1) | (th >> (GMP_NUMB_BITS - 1));
+          th <<= 1;
+          bx--;
+        }
+      rb = a0 & (MPFR_LIMB_ONE << (sh - 1));
+      sb = ((a0 & mask) ^ rb) | th | tl;
+      a0 &= ~mask;
+    }
+  else
+    {
+      /* d > p, thus 0 < c < 1/2 ulp(b): see mpfr_sub1sp1 */
+      a0 = b0 - (MPFR_LIMB_ONE << sh);
+      a1 = b1 - (a0 > b0);
+      if (MPFR_LIKELY (MPFR_LIMB_MSB (a1) != 0))
+        rb = sb = 1;
+      else
+        {
+          int c_pow2 = c1 == MPFR_LIMB_HIGHBIT && c0 == 0;
+
+          a1 = MPFR_LIMB_MAX;
+          a0 = ~mask;
+          bx--;
+          rb = d > (mpfr_uexp_t) p + 1 || c_pow2;
+          sb = d > (mpfr_uexp_t) p + 1 || !c_pow2;
+        }
+    }
+
+  if (MPFR_LIKELY ((rb | sb) == 0))
+    inexact = 0;
+  else if (rnd_mode == MPFR_RNDN
+           ? rb == 0 || (sb == 0 && (a0 & (MPFR_LIMB_ONE << sh)) == 0)
+           : rnd_mode == MPFR_RNDF
+             || MPFR_IS_LIKE_RNDZ (rnd_mode, MPFR_IS_NEG (a)))
+    inexact = -1; /* truncate */
+  else
+    {
+      inexact = 1; /* add one ulp */
+      a0 += MPFR_LIMB_ONE << sh;
+      a1 += a0 == 0;
+      if (MPFR_UNLIKELY (a1 == 0))
+        {
+          a1 = MPFR_LIMB_HIGHBIT;
+          bx++;
+        }
+    }
+
+  MPFR_ASSERTD (bx >= __gmpfr_emin && bx <= __gmpfr_emax);
+  ap[0] = a0;
+  ap[1] = a1;
+  MPFR_SET_EXP (a, bx);
+  MPFR_RET (inexact * MPFR_INT_SIGN (a));
+}
+
 MPFR_HOT_FUNCTION_ATTR int
 mpfr_sub1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 {
@@ -146,14 +458,21 @@ mpfr_sub1sp (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 
   MPFR_TMP_DECL(marker);
 
-  MPFR_TMP_MARK(marker);
-
   MPFR_ASSERTD(MPFR_PREC(a) == MPFR_PREC(b) && MPFR_PREC(b) == MPFR_PREC(c));
   MPFR_ASSERTD(MPFR_IS_PURE_FP(b));
   MPFR_ASSERTD(MPFR_IS_PURE_FP(c));
 
   /* Read prec and num of limbs */
   p = MPFR_GET_PREC (b);
+
+  if (p < GMP_NUMB_BITS)
+    return mpfr_sub1sp1 (a, b, c, rnd_mode, p);
+
+  if (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS)
+    return mpfr_sub1sp2 (a, b, c, rnd_mode, p);
+
+  MPFR_TMP_MARK(marker);
+
   n = MPFR_PREC2LIMBS (p);
 
   /* Fast cmp of |b| and |c|*/
@@ -1084,6 +1084,11 @@ mpfr_sum (mpfr_ptr sum, mpfr_ptr *const x, unsigned long n, mpfr_rnd_t rnd)
       /* sign of infinities and zeros (0: currently unknown) */
       int sign_inf = 0, sign_zero = 0;
 
+      /* The rounding toward zero is faithful, and sum_aux only deals
+         with the correct rounding modes. */
+      if (rnd == MPFR_RNDF)
+        rnd = MPFR_RNDZ;
+
       MPFR_LOG_MSG (("Check for special inputs (n = %lu >= 3)\n", n));
 
       for (i = 0; i < n; i++)
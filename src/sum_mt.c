@@ -0,0 +1,97 @@
+/* mpfr_sum_mt -- sum of n floating-point numbers, using several threads
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+
+#include "mpfr-impl.h"
+
+/* Minimum number of terms per thread: below that, the cost of the creation
+   of a thread is not negligible compared to the accumulation. */
+#ifndef MPFR_SUM_MT_MIN_TERMS
+# define MPFR_SUM_MT_MIN_TERMS 4096
+#endif
+
+typedef struct {
+  mpfr_ptr *x;
+  unsigned long n;
+  mpfr_acc_t acc;
+} mpfr_sum_task_t;
+
+static void
+mpfr_sum_task (void *p)
+{
+  mpfr_sum_task_t *t = (mpfr_sum_task_t *) p;
+
+  mpfr_acc_add_array (t->acc, t->x, t->n);
+}
+
+/* Set sum to x[0] + ... + x[n-1], correctly rounded, like mpfr_sum, using
+   up to nthreads threads. The array is split into consecutive chunks, each
+   one being accumulated exactly in its own mpfr_acc_t (the accumulators
+   only use the mpn layer, and do not depend on the exponent range or the
+   flags, so that they can be used by other threads). The accumulators are
+   then merged, and the exact sum is rounded once by mpfr_acc_get. Thus the
+   result, the ternary value and the flags are exactly those of mpfr_sum,
+   whatever the number of threads. */
+
+int
+mpfr_sum_mt (mpfr_ptr sum, mpfr_ptr *const x, unsigned long n,
+             mpfr_rnd_t rnd, unsigned int nthreads)
+{
+  mpfr_sum_task_t *t;
+  unsigned long q, r, k;
+  unsigned int i, nt;
+  int inex;
+  MPFR_TMP_DECL (marker);
+
+  MPFR_LOG_FUNC
+    (("n=%lu rnd=%d nthreads=%u", n, rnd, nthreads),
+     ("sum[%Pu]=%.*Rg inexact=%d",
+      mpfr_get_prec (sum), mpfr_log_prec, sum, inex));
+
+  nt = n / MPFR_SUM_MT_MIN_TERMS < nthreads ?
+    (unsigned int) (n / MPFR_SUM_MT_MIN_TERMS) : nthreads;
+  if (nt <= 1)
+    return inex = mpfr_sum (sum, x, n, rnd);
+
+  MPFR_TMP_MARK (marker);
+  t = (mpfr_sum_task_t *) MPFR_TMP_ALLOC (nt * sizeof (mpfr_sum_task_t));
+  q = n / nt;
+  r = n % nt;
+  for (i = 0, k = 0; i < nt; i++)
+    {
+      t[i].x = x + k;
+      t[i].n = q + (i < r);
+      k += t[i].n;
+      mpfr_acc_init (t[i].acc);
+    }
+  MPFR_ASSERTD (k == n);
+
+  mpfr_parallel_run (mpfr_sum_task, t, sizeof (mpfr_sum_task_t), nt);
+
+  for (i = 1; i < nt; i++)
+    mpfr_acc_merge (t[0].acc, t[i].acc);
+  inex = mpfr_acc_get (sum, t[0].acc, rnd);
+  for (i = 0; i < nt; i++)
+    mpfr_acc_clear (t[i].acc);
+  MPFR_TMP_FREE (marker);
+  return inex;
+}
@@ -0,0 +1,222 @@
+/* mpfr_sum_wide -- sum of numbers whose exponents may be out of range
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* Set r to the sum of the n regular numbers p[i].z * 2^(p[i].e - EXP(p[i].z)),
+   correctly rounded, where the exponents p[i].e may be outside the extended
+   exponent range (this is the case of the exact products in mpfr_dot, and
+   of the chunks of an accumulator in mpfr_acc_get). The significands of the
+   p[i].z must be normalized; their exponents are overwritten, and the
+   array p may be reordered.
+
+   All the terms are scaled by 2^(-shift), where shift is the maximum of the
+   p[i].e, so that their exponents are at most 0. The sum is computed in the
+   extended exponent range, then scaled back by 2^shift, which is exact, and
+   mpfr_check_range takes care of the overflow and underflow (MPFR has no
+   subnormals, so that the rounding does not depend on the exponent). The
+   differences between the exponents are computed as mpfr_uexp_t, so that
+   they cannot overflow. If some scaled exponents are below the extended
+   exponent range, which is possible only when the current exponent range
+   is close to the maximum one, the terms are summed by sum_clusters. */
+
+/* Distance e1 - e2 between two exponents e1 >= e2. */
+#define WIDE_DIST(e1,e2) ((mpfr_uexp_t) (e1) - (mpfr_uexp_t) (e2))
+
+static int
+wide_cmp (const void *a, const void *b)
+{
+  mpfr_exp_t ea = ((const mpfr_wide_term_t *) a)->e;
+  mpfr_exp_t eb = ((const mpfr_wide_term_t *) b)->e;
+
+  return ea > eb ? -1 : ea < eb;
+}
+
+/* Sum the n terms p[0..n-1], sorted by decreasing exponents, in the
+   extended exponent range, into r, and return the ternary value; the exact
+   sum is r * 2^(*eref). The precisions of the terms are at most b.
+
+   The terms are split into clusters, separated by gaps of at least
+   g = b + PREC(r) + ceil(log2(n)) + 5 between consecutive exponents. Let S
+   be the sum of a cluster, l the exponent of its last term minus b, and
+   F the sum of the following clusters, so that |F| < 2^(l-PREC(r)-2). If
+   S is not zero, then S is a multiple of 2^l, and no number representable
+   in precision PREC(r) or midpoint other than S itself is at a distance
+   less than 2^(l-PREC(r)-1) from S: thus S + F is rounded like S + t,
+   where t = 0 if F = 0, and t = +/- 2^(l-PREC(r)-3) with the sign of F
+   otherwise. The sign of each S + F is determined from the last cluster
+   to the first one with mpfr_sum in precision 2 (S = 0 if and only if the
+   result is t), then the result is computed from the first cluster whose
+   sum is not zero. Each cluster spans less than n * g bits, thus fits in
+   the extended exponent range (otherwise the precisions of the terms would
+   not fit in memory). */
+static int
+sum_clusters (mpfr_ptr r, mpfr_wide_term_t *p, unsigned long n,
+              mpfr_uexp_t b, mpfr_ptr *tab, mpfr_exp_t *eref,
+              mpfr_rnd_t rnd)
+{
+  unsigned long *start, c, nc, i, j;
+  int *sign;
+  mpfr_uexp_t g, d;
+  mpfr_exp_t et;
+  mp_limb_t tp[1], sp[1];
+  mpfr_t t, s;
+  int inex;
+  MPFR_TMP_DECL (marker);
+
+  MPFR_TMP_MARK (marker);
+  start = (unsigned long *) MPFR_TMP_ALLOC ((n + 1) * sizeof (unsigned long));
+  sign = (int *) MPFR_TMP_ALLOC ((n + 1) * sizeof (int));
+  g = b + (mpfr_uexp_t) MPFR_PREC (r) + MPFR_INT_CEIL_LOG2 (n) + 5;
+
+  /* Split into clusters, and scale each cluster by its first term. */
+  for (i = 0, nc = 0; i < n; i++)
+    {
+      if (i == 0 || WIDE_DIST (p[i-1].e, p[i].e) >= g)
+        start[nc++] = i;
+      d = WIDE_DIST (p[start[nc-1]].e, p[i].e);
+      MPFR_ASSERTN (d <= (mpfr_uexp_t) MPFR_EMAX_MAX - g);
+      MPFR_EXP (p[i].z) = - (mpfr_exp_t) d;
+    }
+  start[nc] = n;
+
+  tp[0] = MPFR_LIMB_HIGHBIT;
+  MPFR_TMP_INIT1 (tp, t, MPFR_PREC_MIN);
+  MPFR_TMP_INIT1 (sp, s, 2);
+  sign[nc] = 0;
+
+  /* From the last cluster: sign[c] is the sign of the sum of the clusters
+     c, c+1, ..., and sign[c] = 2 * sign[c] if the sum of cluster c is not
+     zero. */
+  for (c = nc; c-- > 0; )
+    {
+      j = start[c+1] - start[c];
+      for (i = 0; i < j; i++)
+        tab[i] = p[start[c] + i].z;
+      et = MPFR_EXP (p[start[c+1] - 1].z) - (mpfr_exp_t) b
+        - MPFR_PREC (r) - 2;
+      if (sign[c+1] != 0)
+        {
+          MPFR_EXP (t) = et;
+          MPFR_SET_SIGN (t, sign[c+1] > 0 ? MPFR_SIGN_POS : MPFR_SIGN_NEG);
+          tab[j++] = t;
+        }
+      mpfr_sum (s, tab, j, MPFR_RNDZ);
+      if (MPFR_IS_ZERO (s))
+        sign[c] = 0;
+      else
+        sign[c] = (MPFR_IS_POS (s) ? 1 : -1) *
+          (sign[c+1] != 0 && MPFR_EXP (s) == et ? 1 : 2);
+    }
+
+  /* The first cluster whose sum is not zero (or the first one if the sum
+     is zero). */
+  for (c = 0; c < nc - 1 && (sign[c] == 1 || sign[c] == -1); c++)
+    ;
+  j = start[c+1] - start[c];
+  for (i = 0; i < j; i++)
+    tab[i] = p[start[c] + i].z;
+  if (sign[c+1] != 0)
+    {
+      MPFR_EXP (t) = MPFR_EXP (p[start[c+1] - 1].z) - (mpfr_exp_t) b
+        - MPFR_PREC (r) - 2;
+      MPFR_SET_SIGN (t, sign[c+1] > 0 ? MPFR_SIGN_POS : MPFR_SIGN_NEG);
+      tab[j++] = t;
+    }
+  inex = mpfr_sum (r, tab, j, rnd);
+  *eref = p[start[c]].e;
+  MPFR_TMP_FREE (marker);
+  return inex;
+}
+
+
+int
+mpfr_sum_wide (mpfr_ptr r, mpfr_wide_term_t *p, unsigned long n,
+               mpfr_rnd_t rnd)
+{
+  mpfr_ptr *tab;
+  mpfr_exp_t shift = MPFR_EXP_MIN;  /* maximum exponent of the terms */
+  mpfr_exp_t emin_p = MPFR_EXP_MAX;  /* minimum exponent of the terms */
+  mpfr_uexp_t b = 0;  /* maximum precision of the terms */
+  mpfr_exp_t e;
+  unsigned long i;
+  int inex;
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_TMP_DECL (marker);
+
+  MPFR_ASSERTD (n > 0);
+  for (i = 0; i < n; i++)
+    {
+      if (p[i].e > shift)
+        shift = p[i].e;
+      if (p[i].e < emin_p)
+        emin_p = p[i].e;
+      if ((mpfr_uexp_t) MPFR_PREC (p[i].z) > b)
+        b = MPFR_PREC (p[i].z);
+    }
+
+  MPFR_TMP_MARK (marker);
+  tab = (mpfr_ptr *) MPFR_TMP_ALLOC ((n + 1) * sizeof (mpfr_ptr));
+  MPFR_SAVE_EXPO_MARK (expo);
+  if (MPFR_LIKELY (WIDE_DIST (shift, emin_p) <= (mpfr_uexp_t) MPFR_EMAX_MAX))
+    {
+      for (i = 0; i < n; i++)
+        {
+          MPFR_EXP (p[i].z) = - (mpfr_exp_t) WIDE_DIST (shift, p[i].e);
+          tab[i] = p[i].z;
+        }
+      inex = mpfr_sum (r, tab, n, rnd);
+    }
+  else
+    {
+      qsort (p, n, sizeof (mpfr_wide_term_t), wide_cmp);
+      inex = sum_clusters (r, p, n, b, tab, &shift, rnd);
+    }
+  MPFR_SAVE_EXPO_FREE (expo);
+  MPFR_TMP_FREE (marker);
+
+  if (MPFR_UNLIKELY (MPFR_IS_ZERO (r)))
+    MPFR_RET (inex);  /* exact cancellation */
+
+  /* Scale back by 2^shift, where shift is the exponent of a term. The
+     exponent is clamped so that it stays representable, which does not
+     change the behavior of mpfr_check_range (the result is below
+     2^(emin-2) or above 2^emax); as the exponent of r is in the extended
+     exponent range and is at most 1 + ceil(log2(n)), the tests cannot
+     overflow. */
+  e = MPFR_EXP (r);
+  if (e > 0 && shift > __gmpfr_emax + 1 - e)
+    e = __gmpfr_emax + 1;
+  else if (e < 0 && shift < __gmpfr_emin - 2 - e)
+    e = __gmpfr_emin - 2;
+  else
+    {
+      e += shift;
+      if (e < __gmpfr_emin - 2)
+        e = __gmpfr_emin - 2;
+      else if (e > __gmpfr_emax + 1)
+        e = __gmpfr_emax + 1;
+    }
+  MPFR_EXP (r) = e;
+  return mpfr_check_range (r, inex, rnd);
+}
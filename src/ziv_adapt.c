@@ -0,0 +1,136 @@
+/* Adaptive initial precision of the Ziv loops (--enable-ziv-adaptive).
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+#ifdef MPFR_WANT_ZIV_ADAPTIVE
+
+/* For each Ziv loop using MPFR_ZIV_ADAPT and each bucket of initial
+   precisions p (2^(b-1) < p <= 2^b), the number of extra guard bits is
+   chosen among the levels of guards[] below. At the end of each window of
+   WINDOW calls, the next level is the one among the current level and its
+   two neighbours that minimizes the expected cost per call
+
+     C(p+g) + r(g) * C(p+g+GMP_NUMB_BITS),
+
+   where r(g) is the probability that the rounding test fails at the first
+   iteration with g guard bits (then the second iteration is done with
+   GMP_NUMB_BITS more bits, see MPFR_ZIV_NEXT), and C(q) = q^2 is the cost
+   model of an iteration at precision q. The rate of the current level is
+   the one measured in the window, the rate of a neighbour is the one
+   measured at its last visit if this was less than MAX_AGE windows ago,
+   otherwise it is extrapolated from the current rate, assuming that each
+   guard bit halves the failure rate, which holds for random inputs.
+
+   Since this extrapolation is optimistic (on hard-to-round inputs, the
+   failure rate does not decrease until the guard exceeds their difficulty),
+   a level is explored when it may be worth it, and left after one
+   window if it is not; the stale measures are forgotten, so that the
+   levels are explored again if the workload changes. Thus a workload of
+   random inputs stays at 0 guard bit, and the guard of a workload of
+   hard-to-round inputs goes up until it catches most of them at the first
+   iteration, when this reduces the cost. Everything is thread-local (the
+   records are declared with MPFR_THREAD_ATTR by MPFR_ZIV_ADAPT), thus no
+   lock is needed. */
+
+#define WINDOW  256
+#define MAX_AGE 16
+
+static const int guards[MPFR_ZIV_ADAPT_LEVELS] = { 0, 8, 16, 32, 64, 128 };
+
+static double
+ziv_cost (mpfr_prec_t p, int i, double r)
+{
+  double q = (double) p + guards[i];
+
+  return q * q + r * (q + GMP_NUMB_BITS) * (q + GMP_NUMB_BITS);
+}
+
+/* Estimate the failure rate at level j, r being the rate at the current
+   level i. */
+static double
+ziv_rate (mpfr_ziv_adapt_bucket_t *bk, int i, int j, double r)
+{
+  return bk->age[j] != 0 ? bk->rate[j] :
+    MIN (mpfr_scale2 (r, guards[i] - guards[j]), 1.0);
+}
+
+static void
+ziv_adapt_update (mpfr_ziv_adapt_bucket_t *bk, mpfr_prec_t p)
+{
+  double r, c, c_new;
+  int i = bk->level, j, best;
+
+  r = (double) bk->fails / bk->calls;
+  for (j = 0; j < MPFR_ZIV_ADAPT_LEVELS; j++)
+    if (bk->age[j] != 0 && ++ bk->age[j] > MAX_AGE)
+      bk->age[j] = 0;
+  bk->rate[i] = (float) r;
+  bk->age[i] = 1;
+
+  best = i;
+  c = ziv_cost (p, i, r);
+  for (j = i - 1; j <= i + 1; j += 2)
+    if (j >= 0 && j < MPFR_ZIV_ADAPT_LEVELS &&
+        (c_new = ziv_cost (p, j, ziv_rate (bk, i, j, r))) < c)
+      {
+        best = j;
+        c = c_new;
+      }
+  bk->level = best;
+  bk->calls = 0;
+  bk->fails = 0;
+}
+
+/* Called by MPFR_ZIV_ADAPT: return the initial precision p plus the guard
+   bits of its bucket, and set *bucket to this bucket. */
+mpfr_prec_t
+mpfr_ziv_adapt_enter (mpfr_ziv_adapt_t *a, int *bucket, mpfr_prec_t p)
+{
+  mpfr_ziv_adapt_bucket_t *bk;
+  int b;
+
+  b = MPFR_INT_CEIL_LOG2 (p);
+  if (b >= MPFR_ZIV_ADAPT_BUCKETS)
+    b = MPFR_ZIV_ADAPT_BUCKETS - 1;
+  bk = &a->b[b];
+  if (bk->calls == WINDOW)
+    ziv_adapt_update (bk, p);
+  bk->calls ++;
+  *bucket = b;
+  return p + MIN (guards[bk->level], MPFR_PREC_MAX - p);
+}
+
+/* Called by the first MPFR_ZIV_NEXT of a call. */
+void
+mpfr_ziv_adapt_fail (mpfr_ziv_adapt_t *a, int bucket)
+{
+  a->b[bucket].fails ++;
+}
+
+#else
+
+/* ISO C forbids an empty translation unit. */
+typedef int foo;
+
+#endif
@@ -0,0 +1,163 @@
+/* Statistics on the Ziv loops (--enable-ziv-stats).
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+#ifdef MPFR_WANT_ZIV_STATS
+
+#include <string.h>
+#if defined (HAVE_CLOCK_GETTIME)
+# include <time.h>
+#elif defined (HAVE_GETTIMEOFDAY)
+# include <sys/time.h>
+#else
+# include <time.h>
+#endif
+
+/* The records of the Ziv loops (see MPFR_ZIV_DECL in mpfr-impl.h) are
+   thread-local, like the exponent range, and chained in the order of their
+   first use by the current thread. */
+static MPFR_THREAD_ATTR mpfr_ziv_site_t *ziv_first = NULL;
+static MPFR_THREAD_ATTR mpfr_ziv_site_t *ziv_last = NULL;
+
+/* Return the current time in seconds. */
+static double
+ziv_time (void)
+{
+#if defined (HAVE_CLOCK_GETTIME)
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+#elif defined (HAVE_GETTIMEOFDAY)
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+/* Called by MPFR_ZIV_INIT: count a new call with one iteration at
+   precision p, and return the current time. */
+double
+mpfr_ziv_stats_enter (mpfr_ziv_site_t *site, const char *name, mpfr_prec_t p)
+{
+  if (site->s.name == NULL)
+    {
+      site->s.name = name;
+      site->next = NULL;
+      if (ziv_last == NULL)
+        ziv_first = site;
+      else
+        ziv_last->next = site;
+      ziv_last = site;
+    }
+  site->s.calls ++;
+  site->s.iter[0] ++;
+  if (p > site->s.max_prec)
+    site->s.max_prec = p;
+  return ziv_time ();
+}
+
+/* Called by MPFR_ZIV_NEXT: the current call now does its k-th iteration,
+   at precision p. */
+void
+mpfr_ziv_stats_next (mpfr_ziv_site_t *site, unsigned int k, mpfr_prec_t p)
+{
+  MPFR_ASSERTD (k >= 2);
+  if (k <= MPFR_ZIV_STATS_BINS)
+    {
+      site->s.iter[k - 2] --;
+      site->s.iter[k - 1] ++;
+    }
+  if (p > site->s.max_prec)
+    site->s.max_prec = p;
+}
+
+/* Called by MPFR_ZIV_FREE, t0 being the value returned by
+   mpfr_ziv_stats_enter, or -1 if MPFR_ZIV_INIT was not reached (in which
+   case the call has not been counted). */
+void
+mpfr_ziv_stats_leave (mpfr_ziv_site_t *site, double t0)
+{
+  if (t0 >= 0.0)
+    site->s.time += ziv_time () - t0;
+}
+
+#endif
+
+int
+mpfr_ziv_stats_get (mpfr_ziv_stats_t *stats, unsigned long i)
+{
+#ifdef MPFR_WANT_ZIV_STATS
+  mpfr_ziv_site_t *p, *q;
+  int k;
+
+  /* A function may have several Ziv loops: look for the i-th function name
+     (in the order of the first use), and sum the records of its loops. */
+  for (p = ziv_first; p != NULL; p = p->next)
+    {
+      for (q = ziv_first; q != p; q = q->next)
+        if (strcmp (q->s.name, p->s.name) == 0)
+          break;
+      if (q == p && i-- == 0)
+        break;
+    }
+  if (p == NULL)
+    return 0;
+
+  *stats = p->s;
+  for (q = p->next; q != NULL; q = q->next)
+    if (strcmp (q->s.name, p->s.name) == 0)
+      {
+        stats->calls += q->s.calls;
+        for (k = 0; k < MPFR_ZIV_STATS_BINS; k++)
+          stats->iter[k] += q->s.iter[k];
+        if (q->s.max_prec > stats->max_prec)
+          stats->max_prec = q->s.max_prec;
+        stats->time += q->s.time;
+      }
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+void
+mpfr_ziv_stats_reset (void)
+{
+#ifdef MPFR_WANT_ZIV_STATS
+  mpfr_ziv_site_t *p;
+  int k;
+
+  for (p = ziv_first; p != NULL; p = p->next)
+    {
+      p->s.calls = 0;
+      for (k = 0; k < MPFR_ZIV_STATS_BINS; k++)
+        p->s.iter[k] = 0;
+      p->s.max_prec = 0;
+      p->s.time = 0.0;
+    }
+#endif
+}
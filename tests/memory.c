@@ -43,6 +43,18 @@ struct header {
 static struct header  *tests_memory_list;
 static size_t tests_total_size = 0;
 
+/* With --enable-parallel or --enable-shared-cache, MPFR may allocate and
+   free memory in several threads at the same time. */
+#if defined (MPFR_WANT_PARALLEL) || defined (MPFR_WANT_SHARED_CACHE)
+#include <pthread.h>
+static pthread_mutex_t tests_memory_mutex = PTHREAD_MUTEX_INITIALIZER;
+# define TESTS_MEMORY_LOCK() pthread_mutex_lock (&tests_memory_mutex)
+# define TESTS_MEMORY_UNLOCK() pthread_mutex_unlock (&tests_memory_mutex)
+#else
+# define TESTS_MEMORY_LOCK() ((void) 0)
+# define TESTS_MEMORY_UNLOCK() ((void) 0)
+#endif
+
 /* Return a pointer to a pointer to the found block (so it can be updated
    when unlinking). */
 /* FIXME: This is a O(n) search, while it could be done in nearly
@@ -85,6 +97,7 @@ static void *
 tests_allocate (size_t size)
 {
   struct header  *h;
+  void           *ptr;
 
   if (size == 0)
     {
@@ -92,6 +105,7 @@ tests_allocate (size_t size)
       abort ();
     }
 
+  TESTS_MEMORY_LOCK ();
   tests_addsize (size);
 
   h = (struct header *) mpfr_default_allocate (sizeof (*h));
@@ -99,8 +113,9 @@ tests_allocate (size_t size)
   tests_memory_list = h;
 
   h->size = size;
-  h->ptr = mpfr_default_allocate (size);
-  return h->ptr;
+  ptr = h->ptr = mpfr_default_allocate (size);
+  TESTS_MEMORY_UNLOCK ();
+  return ptr;
 }
 
 static void *
@@ -115,6 +130,7 @@ tests_reallocate (void *ptr, size_t old_size, size_t new_size)
       abort ();
     }
 
+  TESTS_MEMORY_LOCK ();
   hp = tests_memory_find (ptr);
   if (hp == NULL)
     {
@@ -137,8 +153,9 @@ tests_reallocate (void *ptr, size_t old_size, size_t new_size)
   tests_addsize (new_size);
 
   h->size = new_size;
-  h->ptr = mpfr_default_reallocate (ptr, old_size, new_size);
-  return h->ptr;
+  ptr = h->ptr = mpfr_default_reallocate (ptr, old_size, new_size);
+  TESTS_MEMORY_UNLOCK ();
+  return ptr;
 }
 
 static struct header **
@@ -169,8 +186,11 @@ tests_free_nosize (void *ptr)
 static void
 tests_free (void *ptr, size_t size)
 {
-  struct header  **hp = tests_free_find (ptr);
-  struct header  *h = *hp;
+  struct header  **hp, *h;
+
+  TESTS_MEMORY_LOCK ();
+  hp = tests_free_find (ptr);
+  h = *hp;
 
   if (h->size != size)
     {
@@ -183,6 +203,7 @@ tests_free (void *ptr, size_t size)
 
   tests_total_size -= size;
   tests_free_nosize (ptr);
+  TESTS_MEMORY_UNLOCK ();
 }
 
 void *
@@ -104,6 +104,25 @@ void bad_cases _MPFR_PROTO ((int (*)(FLIST), int (*)(FLIST),
                              const char *, int, mpfr_exp_t, mpfr_exp_t,
                              mpfr_prec_t, mpfr_prec_t, mpfr_prec_t, int));
 void flags_out _MPFR_PROTO ((unsigned int));
+void tests_random_significand _MPFR_PROTO ((mpfr_ptr));
+mpfr_exp_t tests_random_exp_diff _MPFR_PROTO ((void));
+void tests_check_random_exp _MPFR_PROTO ((int (*) (mpfr_ptr, mpfr_srcptr,
+                                                   mpfr_srcptr, mpfr_rnd_t),
+                                          int (*) (mpfr_ptr, mpfr_srcptr,
+                                                   mpfr_srcptr, mpfr_rnd_t),
+                                          const char *, mpfr_prec_t, int));
+void tests_random_small _MPFR_PROTO ((mpfr_ptr, mpfr_prec_t));
+void tests_random_small_pos _MPFR_PROTO ((mpfr_ptr, mpfr_prec_t));
+void tests_check_small_prec _MPFR_PROTO ((int (*) (mpfr_ptr, mpfr_srcptr,
+                                                   mpfr_rnd_t),
+                                          int (*) (mpfr_ptr, mpfr_srcptr,
+                                                   mpfr_srcptr, mpfr_rnd_t),
+                                          const char *, mpfr_prec_t,
+                                          void (*) (mpfr_ptr, mpfr_prec_t),
+                                          mpfr_exp_t));
+void tests_check_nthreads _MPFR_PROTO ((int (*) (mpfr_ptr, mpfr_rnd_t),
+                                        const char *, mpfr_prec_t,
+                                        mpfr_prec_t));
 
 int mpfr_cmp_str _MPFR_PROTO ((mpfr_srcptr x, const char *, int, mpfr_rnd_t));
 #define mpfr_cmp_str1(x,s) mpfr_cmp_str(x,s,10,MPFR_RNDN)
@@ -0,0 +1,329 @@
+/* Test file for the mpfr_acc_* functions.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+#define NMAX 300
+
+/* Check that the accumulation of x[0..n-1] gives the same result, ternary
+   value and flags as mpfr_sum, whether the numbers are added one by one,
+   with mpfr_acc_add_array, or in several accumulators that are merged. */
+static void
+check_acc (mpfr_ptr *const x, unsigned long n, mpfr_prec_t prec,
+           const char *s)
+{
+  mpfr_acc_t a, b[3];
+  mpfr_t r1, r2;
+  mpfr_flags_t flags1, flags2;
+  unsigned long i;
+  int k, rnd, inex1, inex2;
+
+  mpfr_inits2 (prec, r1, r2, (mpfr_ptr) 0);
+  for (k = 0; k < 3; k++)
+    {
+      mpfr_acc_init (a);
+      if (k == 0)
+        for (i = 0; i < n; i++)
+          mpfr_acc_add (a, x[i]);
+      else if (k == 1)
+        mpfr_acc_add_array (a, x, n);
+      else
+        {
+          /* interleaved terms in three accumulators, merged into a */
+          for (i = 0; i < 3; i++)
+            mpfr_acc_init (b[i]);
+          for (i = 0; i < n; i++)
+            mpfr_acc_add (b[i % 3], x[i]);
+          mpfr_acc_merge (a, b[0]);
+          mpfr_acc_merge (b[1], b[2]);
+          mpfr_acc_merge (a, b[1]);
+          for (i = 0; i < 3; i++)
+            mpfr_acc_clear (b[i]);
+        }
+
+      RND_LOOP (rnd)
+        {
+          mpfr_clear_flags ();
+          inex1 = mpfr_sum (r1, x, n, (mpfr_rnd_t) rnd);
+          flags1 = __gmpfr_flags;
+          mpfr_clear_flags ();
+          inex2 = mpfr_acc_get (r2, a, (mpfr_rnd_t) rnd);
+          flags2 = __gmpfr_flags;
+          if (! (SAME_VAL (r1, r2) && SAME_SIGN (inex1, inex2) &&
+                 flags1 == flags2))
+            {
+              printf ("Error in check_acc (%s, k = %d) for n = %lu, %s\n",
+                      s, k, n, mpfr_print_rnd_mode ((mpfr_rnd_t) rnd));
+              for (i = 0; i < n; i++)
+                {
+                  printf ("x[%lu] = ", i);
+                  mpfr_dump (x[i]);
+                }
+              printf ("Expected ");
+              mpfr_dump (r1);
+              printf ("  with inex ~ %d, flags =", inex1);
+              flags_out (flags1);
+              printf ("Got      ");
+              mpfr_dump (r2);
+              printf ("  with inex ~ %d, flags =", inex2);
+              flags_out (flags2);
+              exit (1);
+            }
+        }
+      mpfr_acc_clear (a);
+    }
+  mpfr_clears (r1, r2, (mpfr_ptr) 0);
+}
+
+static void
+check_special (void)
+{
+  mpfr_t t[4];
+  mpfr_ptr x[4];
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      mpfr_init2 (t[i], 20);
+      x[i] = t[i];
+    }
+
+  check_acc (x, 0, 10, "n = 0");
+
+  mpfr_set_zero (x[0], -1);
+  mpfr_set_zero (x[1], -1);
+  mpfr_set_zero (x[2], 1);
+  check_acc (x, 1, 10, "-0");
+  check_acc (x, 2, 10, "-0 -0");
+  check_acc (x, 3, 10, "-0 -0 +0");
+
+  mpfr_set_ui (x[0], 7, MPFR_RNDN);
+  mpfr_set_si (x[1], -7, MPFR_RNDN);
+  check_acc (x, 2, 10, "exact cancellation");
+  check_acc (x, 3, 10, "exact cancellation and +0");
+  mpfr_set_zero (x[2], -1);
+  check_acc (x, 3, 10, "exact cancellation and -0");
+
+  mpfr_set_inf (x[2], -1);
+  check_acc (x, 3, 10, "-Inf");
+  mpfr_set_inf (x[3], -1);
+  check_acc (x, 4, 10, "-Inf -Inf");
+  mpfr_set_inf (x[3], 1);
+  check_acc (x, 4, 10, "-Inf +Inf");
+  mpfr_set_nan (x[1]);
+  check_acc (x, 2, 10, "NaN");
+
+  for (i = 0; i < 4; i++)
+    mpfr_clear (t[i]);
+}
+
+/* Overflow and underflow of the result, with a reduced exponent range. */
+static void
+check_extreme (void)
+{
+  mpfr_t t[3];
+  mpfr_ptr x[3];
+  mpfr_exp_t emin, emax;
+  int i, j;
+
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  set_emin (-100);
+  set_emax (100);
+  for (i = 0; i < 3; i++)
+    {
+      mpfr_init2 (t[i], 30);
+      x[i] = t[i];
+    }
+  for (j = 0; j < 100; j++)
+    {
+      for (i = 0; i < 3; i++)
+        {
+          mpfr_urandomb (x[i], RANDS);
+          if (mpfr_zero_p (x[i]))
+            mpfr_set_ui (x[i], 1, MPFR_RNDN);
+          mpfr_set_exp (x[i], (j & 1) ? 100 : -100 + (randlimb () % 3));
+          if (randlimb () & 1)
+            mpfr_neg (x[i], x[i], MPFR_RNDN);
+        }
+      check_acc (x, 3, MPFR_PREC_MIN + j % 40, "extreme");
+    }
+  for (i = 0; i < 3; i++)
+    mpfr_clear (t[i]);
+  set_emin (emin);
+  set_emax (emax);
+}
+
+static void
+check_random (void)
+{
+  mpfr_t t[NMAX];
+  mpfr_ptr x[NMAX];
+  int i, m;
+
+  for (i = 0; i < NMAX; i++)
+    {
+      mpfr_init (t[i]);
+      x[i] = t[i];
+    }
+  for (m = 0; m < 500; m++)
+    {
+      unsigned long n = randlimb () % (NMAX + 1);
+      int range = (m % 4 == 0) ? 1000 : 100;
+
+      for (i = 0; i < (int) n; i++)
+        {
+          mpfr_set_prec (x[i], MPFR_PREC_MIN + randlimb () % 300);
+          mpfr_urandomb (x[i], RANDS);
+          if (MPFR_NOTZERO (x[i]))
+            mpfr_set_exp (x[i], (mpfr_exp_t) (randlimb () % range)
+                          - range / 2);
+          if (randlimb () & 1)
+            mpfr_neg (x[i], x[i], MPFR_RNDN);
+        }
+      /* the second half cancels the first half, up to the last bits */
+      if (m % 3 == 0)
+        for (i = 0; i < (int) n / 2; i++)
+          {
+            mpfr_set_prec (x[n-1-i], mpfr_get_prec (x[i]));
+            mpfr_neg (x[n-1-i], x[i], MPFR_RNDN);
+            if (MPFR_NOTZERO (x[i]) && (randlimb () & 1))
+              mpfr_nextabove (x[n-1-i]);
+          }
+      check_acc (x, n, MPFR_PREC_MIN + randlimb () % 300, "random");
+    }
+  for (i = 0; i < NMAX; i++)
+    mpfr_clear (t[i]);
+}
+
+/* Many terms: the size of the accumulator must stay bounded. */
+static void
+check_stream (void)
+{
+  mpfr_acc_t a;
+  mpfr_t x, r;
+  unsigned long i;
+
+  mpfr_acc_init (a);
+  mpfr_inits2 (100, x, r, (mpfr_ptr) 0);
+  for (i = 0; i < 100000; i++)
+    {
+      mpfr_set_ui_2exp (x, 2 * i + 1, -20, MPFR_RNDN);
+      mpfr_acc_add (a, x);
+      mpfr_neg (x, x, MPFR_RNDN);
+      mpfr_mul_2ui (x, x, 1, MPFR_RNDN);
+      mpfr_acc_add (a, x);
+    }
+  MPFR_ASSERTN (a->_mpfr_size <= 4);
+  /* the sum is -(1 + 3 + ... + 199999) / 2^20 = -10^10 / 2^20 */
+  mpfr_acc_get (r, a, MPFR_RNDN);
+  mpfr_set_si_2exp (x, -9765625, -10, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_equal_p (r, x));
+  mpfr_acc_clear (a);
+  mpfr_clears (x, r, (mpfr_ptr) 0);
+}
+
+/* Numbers with large gaps between their exponents, and alternating
+   signs: the accumulator must stay small (the gaps take no memory). */
+static void
+check_gaps (void)
+{
+  mpfr_acc_t a;
+  mpfr_t t[4], r;
+  mpfr_ptr x[4];
+  mpfr_exp_t emin, emax;
+  int i, j;
+
+  mpfr_init2 (r, 53);
+  for (i = 0; i < 4; i++)
+    {
+      mpfr_init2 (t[i], 10 + 50 * i);
+      x[i] = t[i];
+    }
+
+  /* 1 + 2^(-10^9) - 2^(-10^9) + ... */
+  mpfr_acc_init (a);
+  mpfr_set_ui (x[0], 1, MPFR_RNDN);
+  mpfr_set_ui_2exp (x[1], 1, -1000000000, MPFR_RNDN);
+  mpfr_acc_add (a, x[0]);
+  for (j = 0; j < 1000; j++)
+    {
+      mpfr_acc_add (a, x[1]);
+      mpfr_neg (x[1], x[1], MPFR_RNDN);
+    }
+  MPFR_ASSERTN (a->_mpfr_size <= 4);
+  mpfr_acc_get (r, a, MPFR_RNDU);
+  MPFR_ASSERTN (mpfr_cmp_ui (r, 1) == 0);
+  mpfr_acc_add (a, x[1]);
+  mpfr_acc_get (r, a, MPFR_RNDU);
+  mpfr_nextbelow (r);
+  MPFR_ASSERTN (mpfr_cmp_ui (r, 1) == 0);
+  mpfr_acc_clear (a);
+
+  /* Whole exponent range: the exponents of the chunks span more than the
+     extended exponent range. */
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  set_emin (MPFR_EMIN_MIN);
+  set_emax (MPFR_EMAX_MAX);
+  for (j = 0; j < 100; j++)
+    {
+      for (i = 0; i < 4; i++)
+        {
+          mpfr_urandomb (x[i], RANDS);
+          if (mpfr_zero_p (x[i]))
+            mpfr_set_ui (x[i], 1, MPFR_RNDN);
+          if (randlimb () & 1)
+            mpfr_neg (x[i], x[i], MPFR_RNDN);
+        }
+      mpfr_set_exp (x[0], MPFR_EMAX_MAX - (j % 3));
+      mpfr_set_exp (x[1], MPFR_EMIN_MIN + (j % 5));
+      mpfr_set_exp (x[2], 0);
+      if (j & 1)
+        mpfr_neg (x[3], x[0], MPFR_RNDN);
+      else
+        mpfr_set_exp (x[3], MPFR_EMIN_MIN);
+      check_acc (x, 4, MPFR_PREC_MIN + j % 60, "gaps");
+      check_acc (x, 2, MPFR_PREC_MIN + j % 60, "gaps");
+    }
+  set_emin (emin);
+  set_emax (emax);
+
+  for (i = 0; i < 4; i++)
+    mpfr_clear (t[i]);
+  mpfr_clear (r);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_special ();
+  check_extreme ();
+  check_random ();
+  check_stream ();
+  check_gaps ();
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -63,7 +63,10 @@ main (void)
 
   check_special ();
   for(p = 2 ; p < 200 ; p++)
-    check_random (p);
+    {
+      check_random (p);
+      tests_check_random_exp (mpfr_add1, mpfr_add1sp, "mpfr_add1sp", p, 0);
+    }
   check_overflow ();
 
   tests_end_mpfr ();
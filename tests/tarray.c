@@ -0,0 +1,175 @@
+/* Test file for mpfr_array_init2, mpfr_array_clear, mpfr_array_resize and
+   mpfr_array_get.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+/* Check that the elements i0 <= i < i1 of a are NaN of precision p, and
+   that the elements i < i0 are equal to the elements of b. */
+static void
+check_elements (mpfr_array_ptr a, mpfr_t *b, size_t i0, size_t i1,
+                mpfr_prec_t p)
+{
+  size_t i;
+
+  if (mpfr_array_size (a) != i1 || mpfr_array_get_prec (a) != p)
+    {
+      printf ("Error, wrong size or precision of the array: %lu %lu\n",
+              (unsigned long) mpfr_array_size (a),
+              (unsigned long) mpfr_array_get_prec (a));
+      exit (1);
+    }
+  for (i = 0; i < i1; i++)
+    {
+      mpfr_ptr x = mpfr_array_get (a, i);
+
+      if (mpfr_get_prec (x) != p ||
+          (i < i0 ? ! SAME_VAL (x, b[i]) : ! mpfr_nan_p (x)))
+        {
+          printf ("Error for element %lu of %lu (precision %lu)\n",
+                  (unsigned long) i, (unsigned long) i1, (unsigned long) p);
+          printf ("got "); mpfr_dump (x);
+          if (i < i0)
+            {
+              printf ("expected "); mpfr_dump (b[i]);
+            }
+          exit (1);
+        }
+    }
+}
+
+/* Fill the array with random values (also stored in b), grow and shrink
+   it, and compute with its elements. */
+static void
+check_array (mpfr_prec_t p, size_t n)
+{
+  mpfr_array_t a;
+  mpfr_t *b, z;
+  size_t i, m;
+  int inex1, inex2;
+
+  b = (mpfr_t *) malloc (4 * n * sizeof (mpfr_t));
+  if (b == NULL)
+    {
+      printf ("Cannot allocate memory\n");
+      exit (1);
+    }
+  for (i = 0; i < 4 * n; i++)
+    mpfr_init2 (b[i], p);
+  mpfr_init2 (z, p);
+
+  mpfr_array_init2 (a, n, p);
+  check_elements (a, b, 0, n, p);
+  for (i = 0; i < n; i++)
+    {
+      mpfr_urandomb (b[i], RANDS);
+      if (i % 3 == 0)
+        mpfr_neg (b[i], b[i], MPFR_RNDN);
+      mpfr_set (mpfr_array_get (a, i), b[i], MPFR_RNDN);
+    }
+  check_elements (a, b, n, n, p);
+
+  /* grow one element at a time, then by a large amount */
+  for (m = n; m < 2 * n + 1; m++)
+    {
+      mpfr_array_resize (a, m + 1);
+      check_elements (a, b, m, m + 1, p);
+      mpfr_urandomb (b[m], RANDS);
+      mpfr_set (mpfr_array_get (a, m), b[m], MPFR_RNDN);
+    }
+  mpfr_array_resize (a, 4 * n);
+  check_elements (a, b, 2 * n + 1, 4 * n, p);
+
+  /* shrink, then grow: the new elements are NaN again */
+  mpfr_array_resize (a, n / 2);
+  check_elements (a, b, n / 2, n / 2, p);
+  mpfr_array_resize (a, n);
+  check_elements (a, b, n / 2, n, p);
+  for (i = n / 2; i < n; i++)
+    mpfr_set (mpfr_array_get (a, i), b[i], MPFR_RNDN);
+
+  /* the elements can be used as any variable, also as input and output
+     of the same function */
+  for (i = 0; i + 1 < n; i++)
+    {
+      mpfr_ptr x = mpfr_array_get (a, i), y = mpfr_array_get (a, i + 1);
+
+      inex1 = mpfr_add (z, b[i], b[i + 1], MPFR_RNDN);
+      inex2 = mpfr_add (x, x, y, MPFR_RNDN);
+      if (! SAME_VAL (x, z) || inex1 != inex2)
+        {
+          printf ("Error in mpfr_add on elements of an array\n");
+          exit (1);
+        }
+      mpfr_set (b[i], z, MPFR_RNDN);
+      inex1 = mpfr_sin (z, b[i + 1], MPFR_RNDN);
+      inex2 = mpfr_sin (y, y, MPFR_RNDN);
+      if (! SAME_VAL (y, z) || inex1 != inex2)
+        {
+          printf ("Error in mpfr_sin on elements of an array\n");
+          exit (1);
+        }
+      mpfr_set (b[i + 1], z, MPFR_RNDN);
+    }
+  check_elements (a, b, n, n, p);
+
+  mpfr_array_clear (a);
+  mpfr_clear (z);
+  for (i = 0; i < 4 * n; i++)
+    mpfr_clear (b[i]);
+  free (b);
+}
+
+/* An empty array can be resized and cleared. */
+static void
+check_empty (void)
+{
+  mpfr_array_t a;
+
+  mpfr_array_init2 (a, 0, 17);
+  check_elements (a, NULL, 0, 0, 17);
+  mpfr_array_resize (a, 0);
+  mpfr_array_clear (a);
+
+  mpfr_array_init2 (a, 0, 17);
+  mpfr_array_resize (a, 3);
+  check_elements (a, NULL, 0, 3, 17);
+  mpfr_array_clear (a);
+  mpfr_array_clear (a);
+}
+
+int
+main (void)
+{
+  mpfr_prec_t p;
+
+  tests_start_mpfr ();
+
+  check_empty ();
+  for (p = MPFR_PREC_MIN; p <= 3 * GMP_NUMB_BITS + 1; p++)
+    check_array (p, 1 + randlimb () % 20);
+  check_array (1000, 100);
+  check_array (53, 1000);
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -77,12 +77,50 @@ check_gmpinternals_p (void)
 #endif
 }
 
+static void
+check_zivstats_p (void)
+{
+#ifdef MPFR_WANT_ZIV_STATS
+  if (!mpfr_buildopt_zivstats_p())
+    {
+      printf ("Error: mpfr_buildopt_zivstats_p should return true\n");
+      exit (1);
+    }
+#else
+  if (mpfr_buildopt_zivstats_p())
+    {
+      printf ("Error: mpfr_buildopt_zivstats_p should return false\n");
+      exit (1);
+    }
+#endif
+}
+
+static void
+check_scratch_p (void)
+{
+#ifdef MPFR_WANT_SCRATCH_ARENA
+  if (!mpfr_buildopt_scratch_p())
+    {
+      printf ("Error: mpfr_buildopt_scratch_p should return true\n");
+      exit (1);
+    }
+#else
+  if (mpfr_buildopt_scratch_p())
+    {
+      printf ("Error: mpfr_buildopt_scratch_p should return false\n");
+      exit (1);
+    }
+#endif
+}
+
 int
 main (void)
 {
   check_tls_p();
   check_decimal_p();
   check_gmpinternals_p();
+  check_zivstats_p();
+  check_scratch_p();
 
   return 0;
 }
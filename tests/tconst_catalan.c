@@ -50,6 +50,8 @@ main (int argc, char *argv[])
     }
   mpfr_clear (x);
 
+  tests_check_nthreads (mpfr_const_catalan_internal, "mpfr_const_catalan_internal", 70000, 0);
+
   test_generic (2, 200, 1);
 
   tests_end_mpfr ();
@@ -106,6 +106,8 @@ main (int argc, char *argv[])
   mpfr_clear (z);
   mpfr_clear (t);
 
+  tests_check_nthreads (mpfr_const_euler_internal, "mpfr_const_euler_internal", 70000, 0);
+
   test_generic (2, 200, 1);
 
   tests_end_mpfr ();
@@ -134,6 +134,48 @@ check_cache (void)
   mpfr_clear (x);
 }
 
+/* Check that mpfr_const_log2_internal gives the same results when it
+   extends the terms computed at a smaller precision (when the precision
+   increases) as from scratch. */
+#define NINC 40
+static void
+check_incremental (void)
+{
+  mpfr_t x[NINC], y;
+  mpfr_rnd_t rnd[NINC];
+  int inex[NINC], i, inex2;
+
+  mpfr_free_cache ();
+  for (i = 0; i < NINC; i++)
+    {
+      mpfr_init2 (x[i], (i == 0 ? MPFR_PREC_MIN : mpfr_get_prec (x[i-1]))
+                  + 1 + randlimb () % 300);
+      rnd[i] = RND_RAND ();
+      inex[i] = mpfr_const_log2_internal (x[i], rnd[i]);
+    }
+  mpfr_init (y);
+  for (i = 0; i < NINC; i++)
+    {
+      mpfr_free_cache ();
+      mpfr_set_prec (y, mpfr_get_prec (x[i]));
+      inex2 = mpfr_const_log2_internal (y, rnd[i]);
+      if (! (mpfr_equal_p (x[i], y) && SAME_SIGN (inex[i], inex2)))
+        {
+          printf ("Error in check_incremental for prec = %lu, %s\n",
+                  (unsigned long) mpfr_get_prec (y),
+                  mpfr_print_rnd_mode (rnd[i]));
+          printf ("Expected ");
+          mpfr_dump (y);
+          printf ("Got      ");
+          mpfr_dump (x[i]);
+          exit (1);
+        }
+      mpfr_clear (x[i]);
+    }
+  mpfr_clear (y);
+  mpfr_free_cache ();
+}
+
 /* Wrapper for tgeneric */
 static int
 my_const_log2 (mpfr_ptr x, mpfr_srcptr y, mpfr_rnd_t r)
@@ -202,6 +244,8 @@ main (int argc, char *argv[])
 
   check_large ();
   check_cache ();
+  check_incremental ();
+  tests_check_nthreads (mpfr_const_log2_internal, "mpfr_const_log2_internal", 70000, 20000);
 
   test_generic (2, 200, 1);
 
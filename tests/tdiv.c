@@ -1268,6 +1268,8 @@ main (int argc, char *argv[])
   test_generic (2, 800, 50);
   test_bad ();
   test_extreme ();
+  tests_check_small_prec (NULL, mpfr_div, "mpfr_div", 2 * GMP_NUMB_BITS,
+                          tests_random_small, 10);
 
   tests_end_mpfr ();
   return 0;
@@ -0,0 +1,224 @@
+/* Test file for mpfr_divisor_init, mpfr_divisor_clear and mpfr_div_pre.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+/* Check that mpfr_div_pre (q, u, d) with d initialized from v gives the
+   same result, ternary value and flags as mpfr_div (q, u, v), for all the
+   rounding modes (the result of MPFR_RNDF is only checked to be one of
+   the two faithful roundings), also with q = u. */
+static void
+check_one (mpfr_ptr u, mpfr_ptr v, mpfr_prec_t qprec)
+{
+  mpfr_divisor_t d;
+  mpfr_t q1, q2, lo, hi;
+  mpfr_flags_t flags1, flags2;
+  int inex1, inex2, r, alias;
+
+  mpfr_inits2 (qprec, q1, q2, lo, hi, (mpfr_ptr) 0);
+  mpfr_divisor_init (d, v);
+  RND_LOOP (r)
+    for (alias = 0; alias <= (MPFR_PREC (u) == qprec); alias++)
+      {
+        mpfr_rnd_t rnd = (mpfr_rnd_t) r;
+
+        mpfr_clear_flags ();
+        inex2 = mpfr_div (q2, u, v, rnd);
+        flags2 = __gmpfr_flags;
+
+        mpfr_clear_flags ();
+        if (alias)
+          {
+            mpfr_set (q1, u, MPFR_RNDN);
+            inex1 = mpfr_div_pre (q1, q1, d, rnd);
+          }
+        else
+          inex1 = mpfr_div_pre (q1, u, d, rnd);
+        flags1 = __gmpfr_flags;
+
+        if (rnd == MPFR_RNDF)
+          {
+            mpfr_div (lo, u, v, MPFR_RNDD);
+            mpfr_div (hi, u, v, MPFR_RNDU);
+            if (SAME_VAL (q1, lo) || SAME_VAL (q1, hi))
+              continue;
+          }
+        else if (SAME_VAL (q1, q2) && SAME_SIGN (inex1, inex2) &&
+                 flags1 == flags2)
+          continue;
+
+        printf ("Error in mpfr_div_pre, %s%s\n", mpfr_print_rnd_mode (rnd),
+                alias ? " (alias)" : "");
+        printf ("u = "); mpfr_dump (u);
+        printf ("v = "); mpfr_dump (v);
+        printf ("expected "); mpfr_dump (q2);
+        printf ("got      "); mpfr_dump (q1);
+        printf ("inex: expected %d, got %d\n", inex2, inex1);
+        printf ("expected flags:");
+        flags_out (flags2);
+        printf ("got flags:     ");
+        flags_out (flags1);
+        exit (1);
+      }
+  mpfr_divisor_clear (d);
+  mpfr_clears (q1, q2, lo, hi, (mpfr_ptr) 0);
+}
+
+/* Special values and exact quotients. */
+static void
+check_special (void)
+{
+  mpfr_t u, v;
+  int i, j;
+
+  mpfr_inits2 (1000, u, v, (mpfr_ptr) 0);
+  for (i = 0; i < 4; i++)
+    for (j = 0; j < 4; j++)
+      {
+        mpfr_set_nan (u);
+        if (i == 1)
+          mpfr_set_inf (u, -1);
+        else if (i == 2)
+          mpfr_set_zero (u, 1);
+        else if (i == 3)
+          mpfr_set_ui (u, 17, MPFR_RNDN);
+        mpfr_set_nan (v);
+        if (j == 1)
+          mpfr_set_inf (v, 1);
+        else if (j == 2)
+          mpfr_set_zero (v, -1);
+        else if (j == 3)
+          mpfr_set_si (v, -3, MPFR_RNDN);
+        check_one (u, v, 1000);
+        check_one (u, v, 20);
+      }
+
+  /* u = v * w exactly, in the range of the approximate inverse */
+  mpfr_urandomb (v, RANDS);
+  mpfr_set_prec (u, 2000);
+  mpfr_mul_ui (u, v, 12345, MPFR_RNDN);
+  check_one (u, v, 1000);
+  check_one (u, v, 14);
+  mpfr_set (u, v, MPFR_RNDN);
+  check_one (u, v, 1000);
+  mpfr_clears (u, v, (mpfr_ptr) 0);
+}
+
+/* Return a random exponent in the current exponent range, near 0 or near
+   one of its bounds. */
+static mpfr_exp_t
+random_exp (void)
+{
+  mpfr_exp_t emin = mpfr_get_emin (), emax = mpfr_get_emax ();
+  mpfr_exp_t k = (mpfr_exp_t) (randlimb () % 8);
+
+  switch (randlimb () % 4)
+    {
+    case 0:
+      return emin + MIN (k, emax - emin);
+    case 1:
+      return emax - MIN (k, emax - emin);
+    default:
+      k -= 4;
+      return k < emin ? emin : k > emax ? emax : k;
+    }
+}
+
+/* Random operands of precisions up to pmax, near the limbs boundaries of
+   the special code for one and two limbs, and above the threshold of the
+   approximate inverse, with random exponents (see random_exp). */
+static void
+check_random (mpfr_prec_t pmax, int n)
+{
+  mpfr_t u, v;
+  mpfr_prec_t pu, pv, pq;
+  int i;
+
+  mpfr_inits2 (MPFR_PREC_MIN, u, v, (mpfr_ptr) 0);
+  for (i = 0; i < n; i++)
+    {
+      pv = MPFR_PREC_MIN + randlimb () % pmax;
+      switch (randlimb () % 4)
+        {
+        case 0:
+          pq = pu = pv;
+          break;
+        case 1:
+          pq = pv;
+          pu = MPFR_PREC_MIN + randlimb () % pmax;
+          break;
+        default:
+          pq = MPFR_PREC_MIN + randlimb () % pmax;
+          pu = MPFR_PREC_MIN + randlimb () % pmax;
+        }
+      mpfr_set_prec (u, pu);
+      mpfr_set_prec (v, pv);
+      mpfr_urandomb (u, RANDS);
+      mpfr_urandomb (v, RANDS);
+      if (mpfr_zero_p (u) || mpfr_zero_p (v))
+        continue;
+      mpfr_set_exp (u, random_exp ());
+      mpfr_set_exp (v, random_exp ());
+      if (randlimb () % 2)
+        mpfr_neg (u, u, MPFR_RNDN);
+      if (randlimb () % 2)
+        mpfr_neg (v, v, MPFR_RNDN);
+      check_one (u, v, pq);
+    }
+  mpfr_clears (u, v, (mpfr_ptr) 0);
+}
+
+/* Overflow and underflow in reduced and extended exponent ranges. */
+static void
+check_range (void)
+{
+  static mpfr_exp_t ranges[][2] = { { -10, 10 }, { 1, 3 }, { -3, 0 },
+                                    { MPFR_EMIN_MIN, MPFR_EMAX_MAX } };
+  mpfr_exp_t emin, emax;
+  int i;
+
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  for (i = 0; i < numberof (ranges); i++)
+    {
+      set_emin (ranges[i][0]);
+      set_emax (ranges[i][1]);
+      check_random (2 * GMP_NUMB_BITS + 2, 500);
+      check_random (1500, 50);
+      set_emin (emin);
+      set_emax (emax);
+    }
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_special ();
+  check_random (2 * GMP_NUMB_BITS + 2, 3000);
+  check_random (1500, 300);
+  check_range ();
+
+  tests_end_mpfr ();
+  return 0;
+}
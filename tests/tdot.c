@@ -0,0 +1,454 @@
+/* Test file for mpfr_dot.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+#define NMAX 100
+
+/* Compute the dot product with exact products and mpfr_sum, in the
+   extended exponent range, then check the range as the MPFR functions
+   do. The flags are those of the correct result. */
+static int
+dot_ref (mpfr_ptr r, mpfr_ptr *const x, mpfr_ptr *const y, unsigned long n,
+         mpfr_rnd_t rnd)
+{
+  mpfr_t t[NMAX];
+  mpfr_ptr p[NMAX];
+  mpfr_exp_t emin, emax;
+  unsigned long i;
+  int inex;
+
+  MPFR_ASSERTN (n <= NMAX);
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  set_emin (MPFR_EMIN_MIN);
+  set_emax (MPFR_EMAX_MAX);
+  for (i = 0; i < n; i++)
+    {
+      mpfr_init2 (t[i], mpfr_get_prec (x[i]) + mpfr_get_prec (y[i]));
+      inex = mpfr_mul (t[i], x[i], y[i], MPFR_RNDN);
+      MPFR_ASSERTN (inex == 0);
+      p[i] = t[i];
+    }
+  inex = mpfr_sum (r, p, n, rnd);
+  for (i = 0; i < n; i++)
+    mpfr_clear (t[i]);
+  set_emin (emin);
+  set_emax (emax);
+  mpfr_clear_flags ();
+  if (MPFR_IS_NAN (r))
+    __gmpfr_flags = MPFR_FLAGS_NAN;
+  return mpfr_check_range (r, inex, rnd);
+}
+
+static void
+check_dot (mpfr_ptr *const x, mpfr_ptr *const y, unsigned long n,
+           mpfr_prec_t prec, const char *s)
+{
+  mpfr_t r1, r2;
+  mpfr_flags_t flags1, flags2;
+  int rnd, inex1, inex2;
+
+  mpfr_inits2 (prec, r1, r2, (mpfr_ptr) 0);
+  RND_LOOP (rnd)
+    {
+      inex1 = dot_ref (r1, x, y, n, (mpfr_rnd_t) rnd);
+      flags1 = __gmpfr_flags;
+      mpfr_clear_flags ();
+      inex2 = mpfr_dot (r2, x, y, n, (mpfr_rnd_t) rnd);
+      flags2 = __gmpfr_flags;
+      if (! (SAME_VAL (r1, r2) && SAME_SIGN (inex1, inex2) &&
+             flags1 == flags2))
+        {
+          unsigned long i;
+
+          printf ("Error in check_dot (%s) for n = %lu, %s\n", s, n,
+                  mpfr_print_rnd_mode ((mpfr_rnd_t) rnd));
+          for (i = 0; i < n; i++)
+            {
+              printf ("x[%lu] = ", i);
+              mpfr_dump (x[i]);
+              printf ("y[%lu] = ", i);
+              mpfr_dump (y[i]);
+            }
+          printf ("Expected ");
+          mpfr_dump (r1);
+          printf ("  with inex ~ %d, flags =", inex1);
+          flags_out (flags1);
+          printf ("Got      ");
+          mpfr_dump (r2);
+          printf ("  with inex ~ %d, flags =", inex2);
+          flags_out (flags2);
+          exit (1);
+        }
+    }
+
+  /* MPFR_RNDF: the result must be the one with MPFR_RNDD or MPFR_RNDU. */
+  mpfr_dot (r2, x, y, n, MPFR_RNDF);
+  dot_ref (r1, x, y, n, MPFR_RNDD);
+  if (! SAME_VAL (r1, r2))
+    {
+      dot_ref (r1, x, y, n, MPFR_RNDU);
+      if (! SAME_VAL (r1, r2))
+        {
+          printf ("Error in check_dot (%s) for n = %lu, MPFR_RNDF\n", s, n);
+          exit (1);
+        }
+    }
+
+  mpfr_clears (r1, r2, (mpfr_ptr) 0);
+}
+
+static void
+check_special (void)
+{
+  mpfr_t t[8];
+  mpfr_ptr x[4], y[4];
+  int i;
+
+  for (i = 0; i < 8; i++)
+    mpfr_init2 (t[i], 10);
+  for (i = 0; i < 4; i++)
+    {
+      x[i] = t[i];
+      y[i] = t[4+i];
+    }
+
+  /* n = 0 */
+  check_dot (x, y, 0, 10, "n = 0");
+
+  /* zeros with different signs */
+  mpfr_set_zero (x[0], 1);
+  mpfr_set_zero (y[0], -1);
+  mpfr_set_zero (x[1], -1);
+  mpfr_set_zero (y[1], -1);
+  mpfr_set_ui (x[2], 0, MPFR_RNDN);
+  mpfr_set_ui (y[2], 17, MPFR_RNDN);
+  check_dot (x, y, 1, 10, "-0");
+  check_dot (x, y, 2, 10, "-0 + +0");
+  check_dot (x, y, 3, 10, "-0 + +0 + +0");
+
+  /* exact cancellation */
+  mpfr_set_ui (x[0], 3, MPFR_RNDN);
+  mpfr_set_si (y[0], -5, MPFR_RNDN);
+  mpfr_set_ui (x[1], 5, MPFR_RNDN);
+  mpfr_set_ui (y[1], 3, MPFR_RNDN);
+  mpfr_set_zero (x[2], -1);
+  mpfr_set_ui (y[2], 1, MPFR_RNDN);
+  check_dot (x, y, 2, 10, "exact cancellation");
+  check_dot (x, y, 3, 10, "exact cancellation and -0");
+
+  /* infinities and NaN */
+  mpfr_set_inf (x[2], 1);
+  mpfr_set_si (y[2], -1, MPFR_RNDN);
+  check_dot (x, y, 3, 10, "-Inf");
+  mpfr_set_inf (x[3], 1);
+  mpfr_set_inf (y[3], -1);
+  check_dot (x, y, 4, 10, "-Inf + -Inf");
+  mpfr_set_inf (y[3], 1);
+  check_dot (x, y, 4, 10, "-Inf + +Inf");
+  mpfr_set_zero (y[2], 1);
+  check_dot (x, y, 3, 10, "Inf * 0");
+  mpfr_set_nan (y[0]);
+  check_dot (x, y, 1, 10, "NaN");
+
+  for (i = 0; i < 8; i++)
+    mpfr_clear (t[i]);
+}
+
+/* Products whose exponents are outside the current exponent range, and
+   results with overflow or underflow. */
+static void
+check_extreme (void)
+{
+  mpfr_t t[6];
+  mpfr_ptr x[3], y[3];
+  mpfr_exp_t emin, emax;
+  int i, j;
+
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  set_emin (-100);
+  set_emax (100);
+
+  for (i = 0; i < 6; i++)
+    mpfr_init2 (t[i], 20);
+  for (i = 0; i < 3; i++)
+    {
+      x[i] = t[i];
+      y[i] = t[3+i];
+    }
+
+  for (j = 0; j < 200; j++)
+    {
+      /* x[0]*y[0] - x[1]*y[1] + x[2]*y[2] where the first two products
+         are huge or tiny and cancel each other more or less. */
+      mpfr_urandomb (x[0], RANDS);
+      mpfr_urandomb (y[0], RANDS);
+      mpfr_urandomb (x[2], RANDS);
+      mpfr_urandomb (y[2], RANDS);
+      if (mpfr_zero_p (x[0]) || mpfr_zero_p (y[0]))
+        continue;
+      mpfr_set (x[1], x[0], MPFR_RNDN);
+      mpfr_neg (y[1], y[0], MPFR_RNDN);
+      if (j & 1)
+        mpfr_nextabove (y[1]);
+      if (j & 2)
+        {
+          mpfr_set_exp (x[0], 100);
+          mpfr_set_exp (x[1], 100);
+          mpfr_set_exp (y[0], 100 - (j % 7));
+          mpfr_set_exp (y[1], 100 - (j % 7));
+          mpfr_set_exp (x[2], 50 - (j % 13));
+          mpfr_set_exp (y[2], 60);
+        }
+      else
+        {
+          mpfr_set_exp (x[0], -100);
+          mpfr_set_exp (x[1], -100);
+          mpfr_set_exp (y[0], -90 + (j % 7));
+          mpfr_set_exp (y[1], -90 + (j % 7));
+          mpfr_set_exp (x[2], -60 + (j % 13));
+          mpfr_set_exp (y[2], -60);
+        }
+      check_dot (x, y, 2, 10 + j % 20, "extreme, n = 2");
+      check_dot (x, y, 3, 10 + j % 20, "extreme, n = 3");
+    }
+
+  for (i = 0; i < 6; i++)
+    mpfr_clear (t[i]);
+  set_emin (emin);
+  set_emax (emax);
+}
+
+/* With the maximum exponent range, the exponents of the products can span
+   more than the extended exponent range: 2^(2emax-2) - 2^(2emax-2) + 1
+   + s * 2^(2emin-2), with the products in various orders. */
+static void
+check_wide (void)
+{
+  mpfr_t t[8], r, z;
+  mpfr_ptr x[4], y[4];
+  mpfr_exp_t emin, emax;
+  int i, k, s, rnd, inex, up;
+
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  set_emin (MPFR_EMIN_MIN);
+  set_emax (MPFR_EMAX_MAX);
+
+  for (i = 0; i < 8; i++)
+    mpfr_init2 (t[i], 10);
+  mpfr_init2 (r, 10);
+  mpfr_init2 (z, 10);
+
+  for (k = 0; k < 4; k++)
+    for (s = -1; s <= 1; s += 2)
+      {
+        /* the product i is x[(i+k)%4] * y[(i+k)%4] */
+        for (i = 0; i < 4; i++)
+          {
+            x[(i + k) % 4] = t[i];
+            y[(i + k) % 4] = t[4+i];
+          }
+        mpfr_set_ui_2exp (t[0], 1, MPFR_EMAX_MAX - 1, MPFR_RNDN);
+        mpfr_set (t[4], t[0], MPFR_RNDN);
+        mpfr_set (t[1], t[0], MPFR_RNDN);
+        mpfr_neg (t[5], t[0], MPFR_RNDN);
+        mpfr_set_ui_2exp (t[2], 1, MPFR_EMIN_MIN - 1, MPFR_RNDN);
+        mpfr_set_si_2exp (t[6], s, MPFR_EMIN_MIN - 1, MPFR_RNDN);
+        mpfr_set_ui (t[3], 1, MPFR_RNDN);
+        mpfr_set_ui (t[7], 1, MPFR_RNDN);
+
+        RND_LOOP (rnd)
+          {
+            inex = mpfr_dot (r, x, y, 4, (mpfr_rnd_t) rnd);
+            up = rnd == MPFR_RNDU || rnd == MPFR_RNDA;
+            mpfr_set_ui (z, 1, MPFR_RNDN);
+            if (rnd != MPFR_RNDN && up && s > 0)
+              mpfr_nextabove (z);
+            if (rnd != MPFR_RNDN && ! up && s < 0)
+              mpfr_nextbelow (z);
+            if (! mpfr_equal_p (r, z) ||
+                ! SAME_SIGN (inex, rnd == MPFR_RNDN ? - s : up ? 1 : -1))
+              {
+                printf ("Error in check_wide for k=%d s=%d, %s\n", k, s,
+                        mpfr_print_rnd_mode ((mpfr_rnd_t) rnd));
+                printf ("got      "); mpfr_dump (r);
+                printf ("expected "); mpfr_dump (z);
+                printf ("inex = %d\n", inex);
+                exit (1);
+              }
+          }
+
+        /* without the product 1: the result underflows */
+        for (i = 0; i < 3; i++)
+          {
+            x[(i + k) % 3] = t[i];
+            y[(i + k) % 3] = t[4+i];
+          }
+        mpfr_clear_flags ();
+        inex = mpfr_dot (r, x, y, 3, MPFR_RNDN);
+        if (! mpfr_zero_p (r) || MPFR_SIGN (r) != s || ! SAME_SIGN (inex, - s) ||
+            ! mpfr_underflow_p ())
+          {
+            printf ("Error in check_wide (underflow) for k=%d s=%d\n", k, s);
+            printf ("got "); mpfr_dump (r);
+            printf ("inex = %d\n", inex);
+            exit (1);
+          }
+      }
+
+  for (i = 0; i < 8; i++)
+    mpfr_clear (t[i]);
+  mpfr_clear (r);
+  mpfr_clear (z);
+  set_emin (emin);
+  set_emax (emax);
+}
+
+/* Random dot products of n >= nmin terms, whose inputs have precisions
+   in [pmin, pmin+200). */
+static void
+check_random (int iter, unsigned long nmin, mpfr_prec_t pmin)
+{
+  mpfr_t t[2 * NMAX];
+  mpfr_ptr x[NMAX], y[NMAX];
+  int i, j, m;
+
+  for (i = 0; i < 2 * NMAX; i++)
+    mpfr_init (t[i]);
+  for (i = 0; i < NMAX; i++)
+    {
+      x[i] = t[i];
+      y[i] = t[NMAX+i];
+    }
+
+  for (m = 0; m < iter; m++)
+    {
+      unsigned long n = nmin + randlimb () % (NMAX + 1 - nmin);
+      int cancel = randlimb () % 4 == 0;
+
+      for (i = 0; i < (int) n; i++)
+        for (j = 0; j < 2; j++)
+          {
+            mpfr_ptr u = j == 0 ? x[i] : y[i];
+
+            mpfr_set_prec (u, pmin + randlimb () % 200);
+            switch (randlimb () % 32)
+              {
+              case 0:
+                mpfr_set_zero (u, (randlimb () & 1) ? 1 : -1);
+                break;
+              default:
+                mpfr_urandomb (u, RANDS);
+                if (randlimb () & 1)
+                  mpfr_neg (u, u, MPFR_RNDN);
+                if (MPFR_NOTZERO (u))
+                  mpfr_set_exp (u, (mpfr_exp_t) (randlimb () % 200) - 100);
+              }
+          }
+      /* Make the second half of the products cancel the first half,
+         up to the last bits. */
+      if (cancel)
+        for (i = 0; i < (int) n / 2; i++)
+          {
+            mpfr_set_prec (x[n-1-i], mpfr_get_prec (x[i]));
+            mpfr_set_prec (y[n-1-i], mpfr_get_prec (y[i]));
+            mpfr_set (x[n-1-i], x[i], MPFR_RNDN);
+            mpfr_neg (y[n-1-i], y[i], MPFR_RNDN);
+            if (MPFR_NOTZERO (y[i]) && (randlimb () & 1))
+              mpfr_nextabove (y[n-1-i]);
+          }
+      check_dot (x, y, n, MPFR_PREC_MIN + randlimb () % 300, "random");
+    }
+
+  for (i = 0; i < 2 * NMAX; i++)
+    mpfr_clear (t[i]);
+}
+
+/* The products are accumulated as soon as they are computed, so that the
+   memory does not depend on n: with n = 10^5 products, keeping them would
+   exceed the limit of the memory checker (4 MB). */
+static void
+check_large_n (void)
+{
+  unsigned long n = 100000, i;
+  mpfr_ptr *x, *y;
+  mpfr_t a, b, p, r, z;
+  int rnd, inex1, inex2;
+
+  x = (mpfr_ptr *) malloc (n * sizeof (mpfr_ptr));
+  y = (mpfr_ptr *) malloc (n * sizeof (mpfr_ptr));
+  if (x == NULL || y == NULL)
+    {
+      printf ("Can't allocate memory in check_large_n\n");
+      exit (1);
+    }
+  mpfr_inits2 (53, a, b, r, z, (mpfr_ptr) 0);
+  mpfr_init2 (p, 106);
+  mpfr_urandomb (a, RANDS);
+  mpfr_urandomb (b, RANDS);
+  mpfr_neg (b, b, MPFR_RNDN);
+  for (i = 0; i < n; i++)
+    {
+      x[i] = a;
+      y[i] = b;
+    }
+  mpfr_mul (p, a, b, MPFR_RNDN);  /* exact */
+  RND_LOOP (rnd)
+    {
+      inex1 = mpfr_mul_ui (z, p, n, (mpfr_rnd_t) rnd);
+      inex2 = mpfr_dot (r, x, y, n, (mpfr_rnd_t) rnd);
+      if (! (mpfr_equal_p (r, z) && SAME_SIGN (inex1, inex2)))
+        {
+          printf ("Error in check_large_n, %s\n",
+                  mpfr_print_rnd_mode ((mpfr_rnd_t) rnd));
+          printf ("got      "); mpfr_dump (r);
+          printf ("expected "); mpfr_dump (z);
+          printf ("inex = %d instead of %d\n", inex2, inex1);
+          exit (1);
+        }
+    }
+  mpfr_clears (a, b, p, r, z, (mpfr_ptr) 0);
+  free (x);
+  free (y);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_special ();
+  check_extreme ();
+  check_wide ();
+  check_random (500, 0, MPFR_PREC_MIN);
+  /* with at least MPFR_DOT_KEEP_MAX limbs of regular products, unless some
+     inputs are zeros: the products are accumulated one by one */
+  check_random (20, NMAX / 2,
+                (MPFR_DOT_KEEP_MAX / NMAX + 1) * GMP_NUMB_BITS);
+  check_large_n ();
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -272,6 +272,7 @@ tests_end_mpfr (void)
       err = 1;
     }
 
+  mpfr_free_threads ();
   mpfr_free_cache ();
   tests_rand_end ();
 #ifndef MPFR_USE_MINI_GMP
@@ -1037,6 +1038,281 @@ flags_out (unsigned int flags)
   printf (" (%u)\n", flags);
 }
 
+/* Set x to a random significand in [1/2,1), including the special cases
+   of a power of 2 and of a significand with all bits set to 1. Contrary
+   to mpfr_urandomb, the last bits are not necessarily 0. */
+void
+tests_random_significand (mpfr_ptr x)
+{
+  switch (randlimb () % 8)
+    {
+    case 0:
+      mpfr_set_ui_2exp (x, 1, -1, MPFR_RNDN);
+      break;
+    case 1:
+      mpfr_set_ui (x, 1, MPFR_RNDN);
+      mpfr_nextbelow (x);
+      break;
+    default:
+      do
+        mpfr_urandom (x, RANDS, MPFR_RNDN);
+      while (MPFR_IS_ZERO (x));
+      MPFR_SET_EXP (x, 0);
+    }
+}
+
+/* Return a random exponent difference, small ones being more likely. */
+mpfr_exp_t
+tests_random_exp_diff (void)
+{
+  return (randlimb () & 1) ? randlimb () % 4 : randlimb () % (3 * GMP_NUMB_BITS);
+}
+
+/* Check the function f against the reference function ref (for instance
+   mpfr_add1sp against mpfr_add1) at precision p, with random significands
+   and exponent differences, to test all the cases of the special code for
+   one and two limbs. The exponent of the second operand is decreased, or
+   if either is not 0, the exponent of a random operand. */
+void
+tests_check_random_exp (int (*ref) (mpfr_ptr, mpfr_srcptr, mpfr_srcptr,
+                                    mpfr_rnd_t),
+                        int (*f) (mpfr_ptr, mpfr_srcptr, mpfr_srcptr,
+                                  mpfr_rnd_t),
+                        const char *name, mpfr_prec_t p, int either)
+{
+  mpfr_t a1, a2, b, c;
+  int i, r, inex1, inex2;
+
+  mpfr_inits2 (p, a1, a2, b, c, (mpfr_ptr) 0);
+  for (i = 0; i < 200; i++)
+    {
+      tests_random_significand (b);
+      tests_random_significand (c);
+      if (either && (randlimb () & 1))
+        MPFR_SET_EXP (b, MPFR_GET_EXP (b) - tests_random_exp_diff ());
+      else
+        MPFR_SET_EXP (c, MPFR_GET_EXP (c) - tests_random_exp_diff ());
+      RND_LOOP (r)
+        {
+          inex1 = ref (a1, b, c, (mpfr_rnd_t) r);
+          inex2 = f (a2, b, c, (mpfr_rnd_t) r);
+          if (! (mpfr_equal_p (a1, a2) && inex1 == inex2))
+            {
+              printf ("Error in tests_check_random_exp for %s, p = %lu,"
+                      " %s\n", name, (unsigned long) p,
+                      mpfr_print_rnd_mode ((mpfr_rnd_t) r));
+              printf ("b = ");
+              mpfr_dump (b);
+              printf ("c = ");
+              mpfr_dump (c);
+              printf ("Expected ");
+              mpfr_dump (a1);
+              printf ("  with inex = %d\n", inex1);
+              printf ("Got      ");
+              mpfr_dump (a2);
+              printf ("  with inex = %d\n", inex2);
+              exit (1);
+            }
+        }
+    }
+  mpfr_clears (a1, a2, b, c, (mpfr_ptr) 0);
+}
+
+/* Set x to a random number of precision in the same number of limbs as p
+   (one limb if p <= GMP_NUMB_BITS, two limbs otherwise), with a random
+   exponent in [-6, 6]. */
+void
+tests_random_small (mpfr_ptr x, mpfr_prec_t p)
+{
+  mpfr_prec_t lo, hi;
+
+  lo = p <= GMP_NUMB_BITS ? MPFR_PREC_MIN : GMP_NUMB_BITS + 1;
+  hi = p <= GMP_NUMB_BITS ? GMP_NUMB_BITS : 2 * GMP_NUMB_BITS;
+  mpfr_set_prec (x, lo + randlimb () % (hi - lo + 1));
+  do
+    mpfr_urandomb (x, RANDS);
+  while (MPFR_IS_ZERO (x));
+  if (randlimb () % 8 == 0)
+    mpfr_set_ui_2exp (x, 1, -1, MPFR_RNDN);
+  mpfr_set_exp (x, (mpfr_exp_t) (randlimb () % 13) - 6);
+  if (randlimb () & 1)
+    mpfr_neg (x, x, MPFR_RNDN);
+}
+
+/* Set x to a random positive number whose precision fits in the same number
+   of limbs as p (one limb if p <= GMP_NUMB_BITS, two limbs otherwise),
+   including exact squares and powers of 2. */
+void
+tests_random_small_pos (mpfr_ptr x, mpfr_prec_t p)
+{
+  mpfr_prec_t lo, hi;
+
+  lo = p <= GMP_NUMB_BITS ? MPFR_PREC_MIN : GMP_NUMB_BITS + 1;
+  hi = p <= GMP_NUMB_BITS ? GMP_NUMB_BITS : 2 * GMP_NUMB_BITS;
+  mpfr_set_prec (x, lo + randlimb () % (hi - lo + 1));
+  switch (randlimb () % 8)
+    {
+    case 0:
+      mpfr_set_ui (x, 1, MPFR_RNDN);
+      break;
+    case 1:
+      mpfr_set_ui (x, 1, MPFR_RNDN);
+      mpfr_nextbelow (x);
+      break;
+    case 2:
+      /* an exact square */
+      {
+        mpfr_t y;
+
+        mpfr_init2 (y, MPFR_PREC (x) < 2 * MPFR_PREC_MIN ?
+                    MPFR_PREC_MIN : MPFR_PREC (x) / 2);
+        do
+          mpfr_urandomb (y, RANDS);
+        while (MPFR_IS_ZERO (y));
+        mpfr_sqr (x, y, MPFR_RNDN);
+        mpfr_clear (y);
+      }
+      break;
+    default:
+      do
+        mpfr_urandomb (x, RANDS);
+      while (MPFR_IS_ZERO (x));
+    }
+  mpfr_mul_2si (x, x, (long) (randlimb () % 41) - 20, MPFR_RNDN);
+}
+
+/* Check the special code for one and two limbs of the function f1 (unary)
+   or f2 (binary, if f1 is NULL) against the generic code, which is used
+   when the inputs are copied to a larger precision. The target precisions
+   are those less than pmax, and the inputs are generated by random with
+   the target precision as argument. If erange is not 0, the exponent
+   range is reduced to [-erange, erange] so that underflow and overflow
+   also occur. */
+void
+tests_check_small_prec (int (*f1) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t),
+                        int (*f2) (mpfr_ptr, mpfr_srcptr, mpfr_srcptr,
+                                   mpfr_rnd_t),
+                        const char *name, mpfr_prec_t pmax,
+                        void (*random) (mpfr_ptr, mpfr_prec_t),
+                        mpfr_exp_t erange)
+{
+  mpfr_t b, c, bb, cc, a1, a2;
+  mpfr_prec_t p;
+  mpfr_exp_t emin, emax;
+  mpfr_flags_t flags1, flags2;
+  int i, r, inex1, inex2;
+
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  if (erange != 0)
+    {
+      set_emin (-erange);
+      set_emax (erange);
+    }
+  mpfr_inits2 (3 * GMP_NUMB_BITS, bb, cc, (mpfr_ptr) 0);
+  mpfr_inits2 (MPFR_PREC_MIN, b, c, a1, a2, (mpfr_ptr) 0);
+  for (p = MPFR_PREC_MIN; p < pmax; p++)
+    {
+      mpfr_set_prec (a1, p);
+      mpfr_set_prec (a2, p);
+      for (i = 0; i < 20; i++)
+        {
+          random (b, p);
+          mpfr_set (bb, b, MPFR_RNDN);
+          if (f1 == NULL)
+            {
+              random (c, p);
+              mpfr_set (cc, c, MPFR_RNDN);
+            }
+          RND_LOOP (r)
+            {
+              mpfr_clear_flags ();
+              inex1 = f1 != NULL ? f1 (a1, b, (mpfr_rnd_t) r)
+                : f2 (a1, b, c, (mpfr_rnd_t) r);
+              flags1 = __gmpfr_flags;
+              mpfr_clear_flags ();
+              inex2 = f1 != NULL ? f1 (a2, bb, (mpfr_rnd_t) r)
+                : f2 (a2, bb, cc, (mpfr_rnd_t) r);
+              flags2 = __gmpfr_flags;
+              if (! (SAME_VAL (a1, a2) && SAME_SIGN (inex1, inex2) &&
+                     flags1 == flags2))
+                {
+                  printf ("Error in tests_check_small_prec for %s, p = %lu,"
+                          " %s\n", name, (unsigned long) p,
+                          mpfr_print_rnd_mode ((mpfr_rnd_t) r));
+                  printf ("b = ");
+                  mpfr_dump (b);
+                  if (f1 == NULL)
+                    {
+                      printf ("c = ");
+                      mpfr_dump (c);
+                    }
+                  printf ("Expected ");
+                  mpfr_dump (a2);
+                  printf ("  with inex ~ %d, flags =", inex2);
+                  flags_out (flags2);
+                  printf ("Got      ");
+                  mpfr_dump (a1);
+                  printf ("  with inex ~ %d, flags =", inex1);
+                  flags_out (flags1);
+                  exit (1);
+                }
+            }
+        }
+    }
+  mpfr_clears (b, c, bb, cc, a1, a2, (mpfr_ptr) 0);
+  set_emin (emin);
+  set_emax (emax);
+}
+
+/* Check that the threaded mode (see mpfr_set_nthreads) gives the same
+   results for the internal function f of a constant computed at precision
+   prec, from scratch, and if prec0 is not 0, also after a first evaluation
+   at precision prec0 (so that the terms computed at the smaller precision
+   may be extended). prec should be large enough to split the binary
+   splitting between several threads. */
+void
+tests_check_nthreads (int (*f) (mpfr_ptr, mpfr_rnd_t), const char *name,
+                      mpfr_prec_t prec, mpfr_prec_t prec0)
+{
+  unsigned int nthreads[3] = { 2, 3, 8 };
+  mpfr_t x, y;
+  mpfr_rnd_t rnd;
+  int i, j, inex1, inex2;
+
+  mpfr_init2 (x, prec);
+  mpfr_init2 (y, prec);
+  rnd = RND_RAND ();
+  mpfr_free_cache ();
+  inex1 = f (x, rnd);
+  for (i = 0; i < 3; i++)
+    for (j = 0; j < (prec0 != 0 ? 2 : 1); j++)
+      {
+        mpfr_free_cache ();
+        mpfr_set_nthreads (nthreads[i]);
+        if (j == 1)
+          {
+            mpfr_set_prec (y, prec0);
+            f (y, rnd);
+            mpfr_set_prec (y, prec);
+          }
+        inex2 = f (y, rnd);
+        mpfr_set_nthreads (1);
+        if (! (mpfr_equal_p (x, y) && inex1 == inex2))
+          {
+            printf ("Error in tests_check_nthreads for %s (%s) with %u"
+                    " threads, %s\n", name,
+                    j == 0 ? "from scratch" : "incremental", nthreads[i],
+                    mpfr_print_rnd_mode (rnd));
+            printf ("expected inex = %d, got %d\n", inex1, inex2);
+            exit (1);
+          }
+      }
+  mpfr_clear (x);
+  mpfr_clear (y);
+  mpfr_free_cache ();
+}
+
 static void
 abort_called (int x)
 {
@@ -55,7 +55,7 @@ check_default_rnd (void)
           ERROR("ERROR in setting / getting default rounding mode (1)");
         }
     }
-  mpfr_set_default_rounding_mode ((mpfr_rnd_t) MPFR_RND_MAX);
+  mpfr_set_default_rounding_mode ((mpfr_rnd_t) (MPFR_RNDF + 1));
   if (mpfr_get_default_rounding_mode() != MPFR_RNDA)
     ERROR("ERROR in setting / getting default rounding mode (2)");
   mpfr_set_default_rounding_mode((mpfr_rnd_t) -1);
@@ -227,6 +227,99 @@ check_large (void)
   mpfr_clear (z);
 }
 
+/* Check that the threaded mode of mpfr_exp_3 gives the same results as
+   the serial mode (the first precision is above MPFR_EXP_3_MT_THRESHOLD;
+   with the second one and 64 threads, the products of the first chunk
+   are done in parallel too). */
+static void
+check_nthreads (void)
+{
+  mpfr_prec_t p[2] = { 60000, 150000 };
+  unsigned int nthreads[3] = { 2, 5, 64 };
+  mpfr_t x, y, z;
+  int i, j, inex1, inex2;
+  mpfr_rnd_t rnd;
+
+  mpfr_set_nthreads (0);
+  MPFR_ASSERTN (mpfr_get_nthreads () == 1);
+  mpfr_set_nthreads (3);
+  MPFR_ASSERTN (mpfr_get_nthreads () == 3);
+  mpfr_set_nthreads (1);
+
+  for (i = 0; i < 2; i++)
+    {
+      mpfr_inits2 (p[i], x, y, z, (mpfr_ptr) 0);
+      do
+        mpfr_urandomb (x, RANDS);
+      while (MPFR_IS_ZERO (x));
+      /* |x| > 1 for the second precision, so that the result is squared */
+      mpfr_mul_si (x, x, i == 0 ? -1 : 7, MPFR_RNDN);
+      rnd = RND_RAND ();
+      inex1 = mpfr_exp_3 (y, x, rnd);
+      for (j = i; j < 3; j++)
+        {
+          mpfr_set_nthreads (nthreads[j]);
+          inex2 = mpfr_exp_3 (z, x, rnd);
+          mpfr_set_nthreads (1);
+          if (! (mpfr_equal_p (y, z) && inex1 == inex2))
+            {
+              printf ("Error in mpfr_exp_3 for prec = %lu with %u threads,"
+                      " %s\nx = ", (unsigned long) p[i], nthreads[j],
+                      mpfr_print_rnd_mode (rnd));
+              mpfr_dump (x);
+              printf ("expected inex = %d, got %d\n", inex1, inex2);
+              exit (1);
+            }
+        }
+      mpfr_clears (x, y, z, (mpfr_ptr) 0);
+    }
+}
+
+/* Check the table-driven algorithm used up to MPFR_EXPLOG_TAB_THRESHOLD
+   bits against mpfr_exp_2, for arguments of various magnitudes (including
+   large ones, for the reduction by k*log(2)) and both signs. */
+static void
+check_tab (void)
+{
+  mpfr_t x, y, z;
+  mpfr_prec_t p;
+  mpfr_rnd_t rnd;
+  int i, inex1, inex2;
+
+  mpfr_init2 (x, 400);
+  for (p = 2; p <= MPFR_EXPLOG_TAB_THRESHOLD + 64; p += 3)
+    {
+      mpfr_inits2 (p, y, z, (mpfr_ptr) 0);
+      for (i = 0; i < 10; i++)
+        {
+          mpfr_set_prec (x, p + (randlimb () % 128));
+          do
+            mpfr_urandomb (x, RANDS);
+          while (MPFR_IS_ZERO (x));
+          mpfr_mul_2si (x, x, (int) (randlimb () % 48) - 24, MPFR_RNDN);
+          if (randlimb () & 1)
+            mpfr_neg (x, x, MPFR_RNDN);
+          rnd = RND_RAND ();
+          inex1 = mpfr_exp (y, x, rnd);
+          inex2 = mpfr_exp_2 (z, x, rnd);
+          if (! mpfr_equal_p (y, z) || ! SAME_SIGN (inex1, inex2))
+            {
+              printf ("Error in check_tab for prec = %lu, %s\nx = ",
+                      (unsigned long) p, mpfr_print_rnd_mode (rnd));
+              mpfr_dump (x);
+              printf ("got      ");
+              mpfr_dump (y);
+              printf ("expected ");
+              mpfr_dump (z);
+              printf ("inex = %d, expected %d\n", inex1, inex2);
+              exit (1);
+            }
+        }
+      mpfr_clears (y, z, (mpfr_ptr) 0);
+    }
+  mpfr_clear (x);
+}
+
 #define TEST_FUNCTION test_exp
 #define TEST_RANDOM_EMIN -36
 #define TEST_RANDOM_EMAX 36
@@ -979,6 +1072,8 @@ main (int argc, char *argv[])
   test_generic (2, 100, 100);
 
   compare_exp2_exp3 (20, 1000);
+  check_nthreads ();
+  check_tab ();
   check_worst_cases();
   check3("0.0", MPFR_RNDU, "1.0");
   check3("-1e-170", MPFR_RNDU, "1.0");
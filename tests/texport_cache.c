@@ -0,0 +1,229 @@
+/* Test file for mpfr_export_cache and mpfr_import_cache.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+
+#include "mpfr-test.h"
+
+#define FILE_NAME "texport_cache.dat"
+#define CACHE_PREC 2000
+
+static mpfr_cache_ptr
+get_cache (int c)
+{
+  switch (c)
+    {
+    case MPFR_CACHE_PI:
+      return __gmpfr_cache_const_pi;
+    case MPFR_CACHE_LOG2:
+      return __gmpfr_cache_const_log2;
+    case MPFR_CACHE_EULER:
+      return __gmpfr_cache_const_euler;
+    default:
+      return __gmpfr_cache_const_catalan;
+    }
+}
+
+/* Check that the constant c obtained from the cache is correctly rounded,
+   for precisions up to prec, and that it is not recomputed. */
+static void
+check_values (int c, mpfr_prec_t prec)
+{
+  mpfr_t x, y;
+  mpfr_prec_t p;
+  int r, inex1, inex2;
+
+  mpfr_inits2 (prec, x, y, (mpfr_ptr) 0);
+  for (p = MPFR_PREC_MIN; p <= prec; p += 97)
+    {
+      mpfr_set_prec (x, p);
+      mpfr_set_prec (y, p);
+      RND_LOOP (r)
+        {
+          inex1 = mpfr_cache (x, get_cache (c), (mpfr_rnd_t) r);
+          inex2 = (*get_cache (c)->func) (y, (mpfr_rnd_t) r);
+          if (! (SAME_VAL (x, y) && SAME_SIGN (inex1, inex2)))
+            {
+              printf ("Error for constant %d, prec = %lu, %s\n", c,
+                      (unsigned long) p,
+                      mpfr_print_rnd_mode ((mpfr_rnd_t) r));
+              printf ("Expected ");
+              mpfr_dump (y);
+              printf ("Got      ");
+              mpfr_dump (x);
+              exit (1);
+            }
+        }
+    }
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+}
+
+static void
+check_export_import (void)
+{
+  mpfr_t x;
+  int c;
+
+  mpfr_free_cache ();
+  mpfr_prewarm_cache (CACHE_PREC, MPFR_CACHE_PI | MPFR_CACHE_EULER);
+  mpfr_prewarm_cache (CACHE_PREC / 2, MPFR_CACHE_CATALAN);
+  if (mpfr_export_cache (FILE_NAME) != 0)
+    {
+      printf ("Error, mpfr_export_cache failed\n");
+      exit (1);
+    }
+  mpfr_free_cache ();
+
+  mpfr_clear_flags ();
+  if (mpfr_import_cache (FILE_NAME) != 0)
+    {
+      printf ("Error, mpfr_import_cache failed\n");
+      exit (1);
+    }
+  MPFR_ASSERTN (__gmpfr_flags == 0);
+  /* log(2) has been computed by mpfr_const_euler */
+  for (c = MPFR_CACHE_PI; c <= MPFR_CACHE_EULER; c <<= 1)
+    MPFR_ASSERTN (MPFR_PREC (get_cache (c)->x) >= CACHE_PREC);
+  MPFR_ASSERTN (MPFR_PREC (get_cache (MPFR_CACHE_CATALAN)->x) == CACHE_PREC / 2);
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+  MPFR_ASSERTN (get_cache (MPFR_CACHE_PI)->mapped);
+#endif
+
+  for (c = MPFR_CACHE_PI; c <= MPFR_CACHE_CATALAN; c <<= 1)
+    check_values (c, MPFR_PREC (get_cache (c)->x));
+
+  /* The caches are only replaced by more accurate values. */
+  mpfr_free_cache ();
+  mpfr_prewarm_cache (CACHE_PREC, MPFR_CACHE_CATALAN);
+  MPFR_ASSERTN (mpfr_import_cache (FILE_NAME) == 0);
+  MPFR_ASSERTN (MPFR_PREC (get_cache (MPFR_CACHE_CATALAN)->x) == CACHE_PREC);
+  MPFR_ASSERTN (! get_cache (MPFR_CACHE_CATALAN)->mapped);
+
+  /* A larger precision than in the file: the constant is recomputed. */
+  mpfr_init2 (x, 2 * CACHE_PREC);
+  mpfr_const_pi (x, MPFR_RNDN);
+  MPFR_ASSERTN (MPFR_PREC (get_cache (MPFR_CACHE_PI)->x) >= 2 * CACHE_PREC);
+  MPFR_ASSERTN (! get_cache (MPFR_CACHE_PI)->mapped);
+  check_values (MPFR_CACHE_PI, 2 * CACHE_PREC);
+  mpfr_clear (x);
+
+  mpfr_free_cache ();
+}
+
+/* Write size limbs from tab into the file, then check that the import
+   fails and does not modify the cache. */
+static void
+check_bad_file (const mp_limb_t *tab, size_t size, const char *s)
+{
+  FILE *fh;
+  int c;
+
+  fh = fopen (FILE_NAME, "wb");
+  MPFR_ASSERTN (fh != NULL);
+  MPFR_ASSERTN (fwrite (tab, sizeof (mp_limb_t), size, fh) == size);
+  fclose (fh);
+  if (mpfr_import_cache (FILE_NAME) == 0)
+    {
+      printf ("Error, mpfr_import_cache accepts a bad file (%s)\n", s);
+      exit (1);
+    }
+  for (c = MPFR_CACHE_PI; c <= MPFR_CACHE_CATALAN; c <<= 1)
+    MPFR_ASSERTN (MPFR_PREC (get_cache (c)->x) == 0);
+}
+
+static void
+check_errors (void)
+{
+  mp_limb_t *tab;
+  size_t size;
+  FILE *fh;
+
+  mpfr_free_cache ();
+  MPFR_ASSERTN (mpfr_import_cache ("texport_cache.none") != 0);
+
+  /* read the file with pi only */
+  mpfr_prewarm_cache (200, MPFR_CACHE_PI);
+  MPFR_ASSERTN (mpfr_export_cache (FILE_NAME) == 0);
+  mpfr_free_cache ();
+  size = 4 + 6 + MPFR_PREC2LIMBS (200);
+  tab = (mp_limb_t *) malloc (size * sizeof (mp_limb_t));
+  MPFR_ASSERTN (tab != NULL);
+  fh = fopen (FILE_NAME, "rb");
+  MPFR_ASSERTN (fh != NULL);
+  MPFR_ASSERTN (fread (tab, sizeof (mp_limb_t), size, fh) == size);
+  MPFR_ASSERTN (getc (fh) == EOF);
+  fclose (fh);
+  MPFR_ASSERTN (tab[3] == 1 && tab[4] == MPFR_CACHE_PI && tab[5] == 200);
+
+  check_bad_file (tab, 2, "truncated header");
+  check_bad_file (tab, size - 1, "truncated significand");
+  tab[0] ^= 1;
+  check_bad_file (tab, size, "magic number");
+  tab[0] ^= 1;
+  tab[2] ^= 1;
+  check_bad_file (tab, size, "limb size");
+  tab[2] ^= 1;
+  tab[4] = MPFR_CACHE_LOG2;
+  check_bad_file (tab, size, "wrong constant");
+  tab[4] = MPFR_CACHE_PI;
+  tab[size - 1] ^= MPFR_LIMB_HIGHBIT >> 5;
+  check_bad_file (tab, size, "wrong value");
+  tab[size - 1] ^= MPFR_LIMB_HIGHBIT >> 5;
+  /* the low limbs of the significand are only covered by the checksum */
+  tab[10] ^= MPFR_LIMB_HIGHBIT;
+  check_bad_file (tab, size, "corrupted significand");
+  tab[10] ^= MPFR_LIMB_HIGHBIT;
+  tab[7] = 2 - tab[7];
+  check_bad_file (tab, size, "ternary value");
+  tab[7] = 2 - tab[7];
+  tab[9] ^= 1;
+  check_bad_file (tab, size, "checksum");
+  tab[9] ^= 1;
+  tab[5] = 200 + 2 * GMP_NUMB_BITS;
+  check_bad_file (tab, size, "precision too large");
+  tab[5] = 200;
+
+  /* the restored file is accepted (and its mapping freed by
+     mpfr_free_cache) */
+  fh = fopen (FILE_NAME, "wb");
+  MPFR_ASSERTN (fh != NULL);
+  MPFR_ASSERTN (fwrite (tab, sizeof (mp_limb_t), size, fh) == size);
+  fclose (fh);
+  MPFR_ASSERTN (mpfr_import_cache (FILE_NAME) == 0);
+  MPFR_ASSERTN (MPFR_PREC (get_cache (MPFR_CACHE_PI)->x) == 200);
+  mpfr_free_cache ();
+
+  free (tab);
+  remove (FILE_NAME);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_export_import ();
+  check_errors ();
+
+  remove (FILE_NAME);
+  tests_end_mpfr ();
+  return 0;
+}
@@ -0,0 +1,240 @@
+/* Test file for mpfr_exp_n, mpfr_log_n, mpfr_sin_n and mpfr_cos_n.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+typedef int (*fun_n_t) (mpfr_ptr *, mpfr_ptr *const, unsigned long,
+                        mpfr_rnd_t, int *);
+typedef int (*fun_t) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+
+static const char *names[4] = { "exp", "log", "sin", "cos" };
+static fun_n_t funs_n[4] = { mpfr_exp_n, mpfr_log_n, mpfr_sin_n, mpfr_cos_n };
+static fun_t funs[4] = { mpfr_exp, mpfr_log, mpfr_sin, mpfr_cos };
+
+/* The numbers are allocated with the custom interface, so that the memory
+   checker of the test suite (which slows down with many live blocks) only
+   sees the temporary allocations. Change the precision of such a number,
+   with a significand large enough for any precision up to pmax. */
+static void
+set_prec (mpfr_ptr v, mpfr_prec_t p)
+{
+  mpfr_custom_init_set (v, MPFR_NAN_KIND, 0, p,
+                        mpfr_custom_get_significand (v));
+}
+
+/* Fill x[0..n-1] with random numbers of random precisions, including
+   special values, exact cases (0, 1) and huge arguments, and set the
+   precisions of y[0..n-1] and z[0..n-1] randomly, up to pmax. */
+static void
+random_arrays (mpfr_ptr *x, mpfr_ptr *y, mpfr_ptr *z, unsigned long n,
+               mpfr_prec_t pmax)
+{
+  unsigned long i;
+  mpfr_prec_t p;
+
+  for (i = 0; i < n; i++)
+    {
+      set_prec (x[i], MPFR_PREC_MIN + (randlimb () % pmax));
+      p = MPFR_PREC_MIN + (randlimb () % pmax);
+      set_prec (y[i], p);
+      set_prec (z[i], p);
+      switch (randlimb () % 16)
+        {
+        case 0:
+          mpfr_set_nan (x[i]);
+          break;
+        case 1:
+          mpfr_set_inf (x[i], randlimb () % 2 ? 1 : -1);
+          break;
+        case 2:
+          mpfr_set_zero (x[i], randlimb () % 2 ? 1 : -1);
+          break;
+        case 3:
+          mpfr_set_ui (x[i], 1, MPFR_RNDN);
+          break;
+        default:
+          mpfr_urandomb (x[i], RANDS);
+          if (! mpfr_zero_p (x[i]))
+            mpfr_set_exp (x[i], (mpfr_exp_t) (randlimb () % 160) - 100);
+          if (randlimb () % 2)
+            mpfr_neg (x[i], x[i], MPFR_RNDN);
+        }
+    }
+}
+
+/* Compare f_n on x[0..n-1] with the scalar function, for all the rounding
+   modes: results, ternary values, return value and flags. If alias is
+   non-zero, x[i] is first copied to y[i] (which has the precision of z[i]),
+   and y is used both as input and as output. */
+static void
+compare (int f, mpfr_ptr *x, mpfr_ptr *y, mpfr_ptr *z, unsigned long n,
+         int alias)
+{
+  mpfr_ptr *u;
+  int *inex1, *inex2;
+  int r, ret1, ret2;
+  unsigned long i;
+  mpfr_flags_t flags1, flags2;
+
+  inex1 = (int *) malloc (n * sizeof (int));
+  inex2 = (int *) malloc (n * sizeof (int));
+  u = alias ? y : x;
+  RND_LOOP (r)
+    {
+      mpfr_rnd_t rnd = (mpfr_rnd_t) r;
+
+      if (rnd == MPFR_RNDF)
+        continue;
+
+      if (alias)
+        for (i = 0; i < n; i++)
+          mpfr_set (y[i], x[i], MPFR_RNDN);
+
+      mpfr_clear_flags ();
+      ret2 = 0;
+      for (i = 0; i < n; i++)
+        {
+          inex2[i] = funs[f] (z[i], u[i], rnd);
+          ret2 |= inex2[i] != 0;
+        }
+      flags2 = __gmpfr_flags;
+
+      mpfr_clear_flags ();
+      ret1 = funs_n[f] (y, u, n, rnd, inex1);
+      flags1 = __gmpfr_flags;
+
+      for (i = 0; i < n; i++)
+        if (! SAME_VAL (y[i], z[i]) || ! SAME_SIGN (inex1[i], inex2[i]))
+          {
+            printf ("Error in mpfr_%s_n for element %lu, %s%s\n", names[f],
+                    i, mpfr_print_rnd_mode (rnd), alias ? " (alias)" : "");
+            printf ("x = "); mpfr_dump (x[i]);
+            printf ("expected "); mpfr_dump (z[i]);
+            printf ("got      "); mpfr_dump (y[i]);
+            printf ("inex: expected %d, got %d\n", inex2[i], inex1[i]);
+            exit (1);
+          }
+      if ((ret1 != 0) != (ret2 != 0) || flags1 != flags2)
+        {
+          printf ("Error in mpfr_%s_n, %s%s\n", names[f],
+                  mpfr_print_rnd_mode (rnd), alias ? " (alias)" : "");
+          printf ("return value: expected %d, got %d\n", ret2, ret1);
+          printf ("expected flags:");
+          flags_out (flags2);
+          printf ("got flags:     ");
+          flags_out (flags1);
+          exit (1);
+        }
+    }
+  free (inex1);
+  free (inex2);
+}
+
+/* Check each function on arrays of n elements with the current exponent
+   range, and with up to nthreads threads. */
+static void
+check (unsigned long n, mpfr_prec_t pmax, unsigned int nthreads)
+{
+  mpfr_ptr *x, *y, *z;
+  mpfr_t *t;
+  char *m;
+  size_t size;
+  unsigned long i;
+  int f;
+
+  size = mpfr_custom_get_size (MPFR_PREC_MIN + pmax);
+  t = (mpfr_t *) malloc (3 * n * sizeof (mpfr_t));
+  x = (mpfr_ptr *) malloc (3 * n * sizeof (mpfr_ptr));
+  m = (char *) malloc (3 * n * size);
+  y = x + n;
+  z = y + n;
+  for (i = 0; i < 3 * n; i++)
+    {
+      mpfr_custom_init (m + i * size, MPFR_PREC_MIN + pmax);
+      mpfr_custom_init_set (t[i], MPFR_NAN_KIND, 0, MPFR_PREC_MIN + pmax,
+                            m + i * size);
+      x[i] = t[i];
+    }
+
+  mpfr_set_nthreads (nthreads);
+  for (f = 0; f < 4; f++)
+    {
+      random_arrays (x, y, z, n, pmax);
+      compare (f, x, y, z, n, 0);
+      /* the NULL inex array */
+      mpfr_clear_flags ();
+      funs_n[f] (y, x, n, MPFR_RNDN, NULL);
+      compare (f, x, y, z, n, 1);
+    }
+  mpfr_set_nthreads (1);
+
+  free (m);
+  free (x);
+  free (t);
+}
+
+/* In a reduced exponent range, exp overflows and underflows, and the bound
+   of the direct calls to the table-driven algorithm is smaller. */
+static void
+check_reduced_range (void)
+{
+  mpfr_exp_t emin, emax;
+  static mpfr_exp_t ranges[][2] = { { -20, 20 }, { -3, 5 }, { -1000, 8 },
+                                    { -8, 1000 } };
+  int i;
+
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  for (i = 0; i < numberof (ranges); i++)
+    {
+      set_emin (ranges[i][0]);
+      set_emax (ranges[i][1]);
+      check (200, 100, 1);
+      set_emin (emin);
+      set_emax (emax);
+    }
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  /* empty arrays */
+  if (mpfr_exp_n (NULL, NULL, 0, MPFR_RNDN, NULL) != 0 ||
+      mpfr_log_n (NULL, NULL, 0, MPFR_RNDN, NULL) != 0)
+    {
+      printf ("Error for empty arrays\n");
+      exit (1);
+    }
+  check (1, 300, 1);
+  check (100, 300, 1);
+  check_reduced_range ();
+  /* threaded mode, with at least MPFR_FUN_N_MT_MIN_ELEMS = 2048 elements
+     per thread by default */
+  check (20000, 20, 3);
+  check (5000, 60, 7);
+  check (1000, 60, 7);
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -0,0 +1,127 @@
+/* Test file for mpfr_init_block and mpfr_clear_block.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+/* Set the variables of a block to distinct values, compute with them, and
+   check that they do not overlap, by comparing with heap variables. */
+static void
+check_block (mpfr_prec_t p)
+{
+  mpfr_block_t b;
+  mpfr_t x[5], y[5];
+  int i, j;
+
+  mpfr_init_block (b, p, x[0], x[1], x[2], x[3], x[4], (mpfr_ptr) 0);
+  for (i = 0; i < 5; i++)
+    {
+      mpfr_init2 (y[i], p);
+      if (mpfr_get_prec (x[i]) != p || ! mpfr_nan_p (x[i]) ||
+          ! mpfr_check (x[i]))
+        {
+          printf ("Error, variable %d not initialized for p=%lu\n", i,
+                  (unsigned long) p);
+          exit (1);
+        }
+    }
+
+  for (j = 0; j < 10; j++)
+    {
+      for (i = 0; i < 5; i++)
+        {
+          mpfr_urandomb (y[i], RANDS);
+          mpfr_set (x[i], y[i], MPFR_RNDN);
+        }
+      for (i = 0; i < 5; i++)
+        {
+          mpfr_mul (y[i], y[i], y[(i + 1) % 5], MPFR_RNDN);
+          mpfr_mul (x[i], x[i], x[(i + 1) % 5], MPFR_RNDN);
+          mpfr_exp (y[(i + 2) % 5], y[i], MPFR_RNDD);
+          mpfr_exp (x[(i + 2) % 5], x[i], MPFR_RNDD);
+        }
+      for (i = 0; i < 5; i++)
+        if (! SAME_VAL (x[i], y[i]))
+          {
+            printf ("Error for variable %d with p=%lu\n", i,
+                    (unsigned long) p);
+            printf ("got      "); mpfr_dump (x[i]);
+            printf ("expected "); mpfr_dump (y[i]);
+            exit (1);
+          }
+    }
+
+  mpfr_clear_block (b, x[0], x[1], x[2], x[3], x[4], (mpfr_ptr) 0);
+  for (i = 0; i < 5; i++)
+    mpfr_clear (y[i]);
+}
+
+/* The variables are usual variables: they can be swapped, cleared
+   separately and their precision can be changed (the memory functions of
+   the tests check that nothing is freed twice or leaked). */
+static void
+check_usual (void)
+{
+  mpfr_block_t b;
+  mpfr_t x, y, z;
+
+  mpfr_init_block (b, 53, x, y, z, (mpfr_ptr) 0);
+  mpfr_set_ui (x, 1, MPFR_RNDN);
+  mpfr_set_ui (y, 2, MPFR_RNDN);
+  mpfr_swap (x, y);
+  mpfr_set_prec (z, 1000);
+  mpfr_const_pi (z, MPFR_RNDN);
+  mpfr_prec_round (y, 2000, MPFR_RNDN);
+  if (mpfr_cmp_ui (x, 2) != 0 || mpfr_cmp_ui (y, 1) != 0 ||
+      mpfr_cmp_ui (z, 3) <= 0)
+    {
+      printf ("Error in check_usual\n");
+      exit (1);
+    }
+  mpfr_clear (z);
+  mpfr_set_prec (x, 10);
+  mpfr_clear_block (b, x, y, (mpfr_ptr) 0);
+
+  /* the variables can also be cleared before the block */
+  mpfr_init_block (b, 2, x, y, (mpfr_ptr) 0);
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+  mpfr_clear_block (b, (mpfr_ptr) 0);
+
+  /* empty block */
+  mpfr_init_block (b, 17, (mpfr_ptr) 0);
+  mpfr_clear_block (b, (mpfr_ptr) 0);
+}
+
+int
+main (void)
+{
+  mpfr_prec_t p;
+
+  tests_start_mpfr ();
+
+  for (p = MPFR_PREC_MIN; p <= 3 * GMP_NUMB_BITS + 1; p++)
+    check_block (p);
+  check_block (1000);
+  check_usual ();
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -0,0 +1,217 @@
+/* Test file for mpfr_init2_inline and MPFR_DECL_SMALL.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+static void
+check_inline (mpfr_ptr x, int inl, mpfr_prec_t p, const char *s)
+{
+  if ((MPFR_IS_INLINE_ALLOC (x) != 0) != inl || mpfr_get_prec (x) != p ||
+      ! mpfr_check (x))
+    {
+      printf ("Error after %s: expected %s significand of precision %lu,"
+              " got\n", s, inl ? "an inline" : "a heap", (unsigned long) p);
+      printf ("alloc size %ld, precision %lu\n",
+              (long) MPFR_GET_ALLOC_SIZE (x), (unsigned long) MPFR_PREC (x));
+      exit (1);
+    }
+}
+
+/* Compute with inline variables of precision p <= pmax, as input and
+   output, and compare with heap variables. */
+static void
+check_functions (mpfr_prec_t p)
+{
+  MPFR_DECL_SMALL (x, 2 * GMP_NUMB_BITS);
+  MPFR_DECL_SMALL (y, 2 * GMP_NUMB_BITS);
+  mpfr_t u, v;
+  int inex1, inex2;
+  int i;
+
+  mpfr_small_init2 (x, p);
+  mpfr_small_init2 (y, p);
+  check_inline (x, 1, p, "mpfr_small_init2");
+  if (! mpfr_nan_p (x))
+    {
+      printf ("Error, mpfr_small_init2 does not set to NaN\n");
+      exit (1);
+    }
+  mpfr_init2 (u, p);
+  mpfr_init2 (v, p);
+
+  for (i = 0; i < 20; i++)
+    {
+      mpfr_urandomb (u, RANDS);
+      mpfr_urandomb (v, RANDS);
+      mpfr_set (x, u, MPFR_RNDN);
+      mpfr_set (y, v, MPFR_RNDN);
+
+      inex1 = mpfr_add (u, u, v, MPFR_RNDN);
+      inex2 = mpfr_add (x, x, y, MPFR_RNDN);
+      if (! SAME_VAL (x, u) || inex1 != inex2)
+        {
+          printf ("Error in mpfr_add for p=%lu\n", (unsigned long) p);
+          exit (1);
+        }
+      inex1 = mpfr_mul (v, u, v, MPFR_RNDZ);
+      inex2 = mpfr_mul (y, x, y, MPFR_RNDZ);
+      if (! SAME_VAL (y, v) || inex1 != inex2)
+        {
+          printf ("Error in mpfr_mul for p=%lu\n", (unsigned long) p);
+          exit (1);
+        }
+      inex1 = mpfr_sin (u, v, MPFR_RNDU);
+      inex2 = mpfr_sin (x, y, MPFR_RNDU);
+      if (! SAME_VAL (x, u) || inex1 != inex2)
+        {
+          printf ("Error in mpfr_sin for p=%lu\n", (unsigned long) p);
+          exit (1);
+        }
+    }
+  check_inline (x, 1, p, "the computations");
+
+  mpfr_clear (x);
+  mpfr_clear (y);
+  mpfr_clear (u);
+  mpfr_clear (v);
+}
+
+/* Change the precision of inline variables: they stay inline while the
+   precision fits, and are then moved to the heap (mpfr_clear must free
+   them, which is checked by the memory functions of the tests). */
+static void
+check_prec (void)
+{
+  MPFR_DECL_SMALL (x, 2 * GMP_NUMB_BITS);
+  MPFR_DECL_SMALL (y, GMP_NUMB_BITS);
+  mpfr_t z;
+
+  mpfr_small_init2 (x, 17);
+  mpfr_set_prec (x, 2 * GMP_NUMB_BITS);
+  check_inline (x, 1, 2 * GMP_NUMB_BITS, "mpfr_set_prec");
+  mpfr_set_prec (x, 2 * GMP_NUMB_BITS + 1);
+  check_inline (x, 0, 2 * GMP_NUMB_BITS + 1, "mpfr_set_prec");
+  if (! mpfr_nan_p (x))
+    {
+      printf ("Error, mpfr_set_prec does not set to NaN\n");
+      exit (1);
+    }
+  mpfr_set_prec (x, 17);
+  check_inline (x, 0, 17, "mpfr_set_prec");
+  mpfr_clear (x);
+
+  /* mpfr_prec_round keeps the value */
+  mpfr_small_init2 (y, GMP_NUMB_BITS);
+  mpfr_init2 (z, GMP_NUMB_BITS);
+  mpfr_urandomb (z, RANDS);
+  mpfr_set (y, z, MPFR_RNDN);
+  mpfr_prec_round (y, 10, MPFR_RNDN);
+  mpfr_prec_round (z, 10, MPFR_RNDN);
+  check_inline (y, 1, 10, "mpfr_prec_round");
+  mpfr_prec_round (y, 3 * GMP_NUMB_BITS, MPFR_RNDN);
+  mpfr_prec_round (z, 3 * GMP_NUMB_BITS, MPFR_RNDN);
+  check_inline (y, 0, 3 * GMP_NUMB_BITS, "mpfr_prec_round");
+  if (! SAME_VAL (y, z))
+    {
+      printf ("Error, mpfr_prec_round does not keep the value\n");
+      exit (1);
+    }
+  mpfr_clear (y);
+
+  /* a precision larger than the buffer gives a heap significand */
+  mpfr_small_init2 (y, GMP_NUMB_BITS + 1);
+  check_inline (y, 0, GMP_NUMB_BITS + 1, "mpfr_small_init2");
+  mpfr_set_prec_raw (y, GMP_NUMB_BITS);
+  mpfr_set (y, z, MPFR_RNDN);
+  mpfr_clear (y);
+  mpfr_clear (z);
+}
+
+/* The significands of an inline variable and of a heap variable can be
+   swapped, provided that the buffer lives until both are cleared. */
+static void
+check_swap (void)
+{
+  MPFR_DECL_SMALL (x, 53);
+  mpfr_t y;
+
+  mpfr_small_init2 (x, 53);
+  mpfr_init2 (y, 200);
+  mpfr_set_ui (x, 17, MPFR_RNDN);
+  mpfr_const_pi (y, MPFR_RNDN);
+  mpfr_swap (x, y);
+  check_inline (x, 0, 200, "mpfr_swap");
+  check_inline (y, 1, 53, "mpfr_swap");
+  if (mpfr_cmp_ui (y, 17) != 0 || mpfr_cmp_ui (x, 3) <= 0)
+    {
+      printf ("Error in mpfr_swap\n");
+      exit (1);
+    }
+  mpfr_set_prec (y, 10);
+  mpfr_set_ui (y, 5, MPFR_RNDN);
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
+/* mpfr_init2_inline with a buffer given by the user, too small for a
+   size field and one limb in the first case. */
+static void
+check_buffer (void)
+{
+  mp_limb_t buf[4];
+  mpfr_t x;
+
+  mpfr_init2_inline (x, 2, buf, sizeof (mpfr_size_limb_t));
+  check_inline (x, 0, 2, "mpfr_init2_inline");
+  mpfr_clear (x);
+
+  mpfr_init2_inline (x, 2, buf, sizeof (buf));
+  check_inline (x, 1, 2, "mpfr_init2_inline");
+  if (MPFR_GET_ALLOC_SIZE (x) != - (mp_size_t)
+      ((sizeof (buf) - sizeof (mpfr_size_limb_t)) / sizeof (mp_limb_t)))
+    {
+      printf ("Error, wrong number of limbs in the buffer: %ld\n",
+              (long) MPFR_GET_ALLOC_SIZE (x));
+      exit (1);
+    }
+  mpfr_set_prec (x, 2 * GMP_NUMB_BITS);
+  check_inline (x, 1, 2 * GMP_NUMB_BITS, "mpfr_set_prec");
+  mpfr_set_si (x, -1, MPFR_RNDN);
+  mpfr_clear (x);
+}
+
+int
+main (void)
+{
+  mpfr_prec_t p;
+
+  tests_start_mpfr ();
+
+  for (p = MPFR_PREC_MIN; p <= 2 * GMP_NUMB_BITS; p++)
+    check_functions (p);
+  check_prec ();
+  check_swap ();
+  check_buffer ();
+
+  tests_end_mpfr ();
+  return 0;
+}
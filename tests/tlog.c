@@ -265,6 +265,66 @@ x_near_one (void)
   mpfr_clears (x, y, (mpfr_ptr) 0);
 }
 
+/* Check the table-driven algorithm used up to MPFR_EXPLOG_TAB_THRESHOLD
+   bits against the AGM at a larger precision, for arguments of various
+   magnitudes, including arguments close to 1, for which the algorithm
+   falls back to the AGM. */
+static void
+check_tab (void)
+{
+  mpfr_t x, y, z, t;
+  mpfr_prec_t p, pz = MPFR_EXPLOG_TAB_THRESHOLD + 200;
+  mpfr_rnd_t rnd;
+  int i, inex, cmp;
+
+  mpfr_init2 (x, 400);
+  mpfr_init2 (z, pz);
+  for (p = 2; p <= MPFR_EXPLOG_TAB_THRESHOLD + 64; p += 3)
+    {
+      mpfr_inits2 (p, y, t, (mpfr_ptr) 0);
+      for (i = 0; i < 10; i++)
+        {
+          mpfr_set_prec (x, p + (randlimb () % 128));
+          do
+            mpfr_urandomb (x, RANDS);
+          while (MPFR_IS_ZERO (x));
+          if (i < 2)  /* x = 1 +/- tiny */
+            {
+              mpfr_mul_2si (x, x, - (long) (randlimb () % 100), MPFR_RNDN);
+              if (i == 0)
+                mpfr_add_ui (x, x, 1, MPFR_RNDN);
+              else
+                mpfr_ui_sub (x, 1, x, MPFR_RNDN);
+            }
+          else
+            mpfr_mul_2si (x, x, (long) (randlimb () % 2000) - 1000,
+                          MPFR_RNDN);
+          rnd = RND_RAND ();
+          inex = mpfr_log (y, x, rnd);
+          mpfr_log (z, x, MPFR_RNDN);
+          if (! mpfr_can_round (z, pz - 1, MPFR_RNDN, MPFR_RNDZ,
+                                p + (rnd == MPFR_RNDN)))
+            continue;
+          mpfr_set (t, z, rnd);
+          cmp = mpfr_cmp (y, z);
+          if (! mpfr_equal_p (y, t) || (cmp != 0 && ! SAME_SIGN (inex, cmp)))
+            {
+              printf ("Error in check_tab for prec = %lu, %s\nx = ",
+                      (unsigned long) p, mpfr_print_rnd_mode (rnd));
+              mpfr_dump (x);
+              printf ("got      ");
+              mpfr_dump (y);
+              printf ("expected ");
+              mpfr_dump (t);
+              printf ("inex = %d\n", inex);
+              exit (1);
+            }
+        }
+      mpfr_clears (y, t, (mpfr_ptr) 0);
+    }
+  mpfr_clears (x, z, (mpfr_ptr) 0);
+}
+
 #define TEST_FUNCTION test_log
 #define TEST_RANDOM_POS 8
 #include "tgeneric.c"
@@ -346,6 +406,7 @@ main (int argc, char *argv[])
   check2("6.09969788341579732815e+00",MPFR_RNDD,"1.80823924264386204363e+00");
 
   x_near_one ();
+  check_tab ();
 
   test_generic (2, 100, 40);
 
@@ -0,0 +1,131 @@
+/* Test file for mpfr_log_ui.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+/* Compare mpfr_log_ui (y, n) with mpfr_log (z, n) for all rounding modes
+   and precisions from pmin to pmax by step. */
+static void
+compare_log (unsigned long n, mpfr_prec_t pmin, mpfr_prec_t pmax,
+             mpfr_prec_t step)
+{
+  mpfr_t x, y, z;
+  mpfr_prec_t p;
+  int r, inex1, inex2;
+
+  mpfr_init2 (x, sizeof (unsigned long) * CHAR_BIT);
+  mpfr_set_ui (x, n, MPFR_RNDN);
+  for (p = pmin; p <= pmax; p += step)
+    {
+      mpfr_init2 (y, p);
+      mpfr_init2 (z, p);
+      RND_LOOP (r)
+        {
+          inex1 = mpfr_log_ui (y, n, (mpfr_rnd_t) r);
+          inex2 = mpfr_log (z, x, (mpfr_rnd_t) r);
+          if (! mpfr_equal_p (y, z) || ! SAME_SIGN (inex1, inex2))
+            {
+              printf ("Error in mpfr_log_ui for n=%lu, prec=%lu, rnd=%s\n",
+                      n, (unsigned long) p,
+                      mpfr_print_rnd_mode ((mpfr_rnd_t) r));
+              printf ("expected "); mpfr_dump (z);
+              printf ("got      "); mpfr_dump (y);
+              printf ("inex: expected %d, got %d\n", inex2, inex1);
+              exit (1);
+            }
+        }
+      mpfr_clear (y);
+      mpfr_clear (z);
+    }
+  mpfr_clear (x);
+}
+
+static void
+special (void)
+{
+  mpfr_t x;
+  int inex;
+
+  mpfr_init2 (x, 53);
+
+  mpfr_clear_flags ();
+  inex = mpfr_log_ui (x, 0, MPFR_RNDN);
+  if (! mpfr_inf_p (x) || mpfr_sgn (x) > 0 || inex != 0 ||
+      __gmpfr_flags != MPFR_FLAGS_DIVBY0)
+    {
+      printf ("Error for log_ui(0)\n");
+      exit (1);
+    }
+
+  mpfr_clear_flags ();
+  inex = mpfr_log_ui (x, 1, MPFR_RNDD);
+  if (! mpfr_zero_p (x) || MPFR_IS_NEG (x) || inex != 0 ||
+      __gmpfr_flags != 0)
+    {
+      printf ("Error for log_ui(1)\n");
+      exit (1);
+    }
+
+  mpfr_clear (x);
+}
+
+/* Check values of n close to a power of 2, for which the binary splitting
+   is used, and random values of n, in small and large precision. */
+static void
+check_random (void)
+{
+  unsigned long n, d;
+  int i, k;
+
+  for (n = 2; n < 100; n++)
+    compare_log (n, 2, 150, 1);
+  compare_log (ULONG_MAX, 2, 150, 1);
+  compare_log (ULONG_MAX, 300, 3000, 301);
+
+  for (k = 4; k < (int) (sizeof (unsigned long) * CHAR_BIT); k++)
+    {
+      n = 1UL << k;
+      compare_log (n, 2, 100, 7);
+      compare_log (n, 300, 3000, 541);
+      d = randlimb () % (1UL << (k / 2)) + 1;
+      compare_log (n + d, 300, 3000, 541);
+      compare_log (n - d, 300, 3000, 541);
+    }
+
+  for (i = 0; i < 20; i++)
+    {
+      n = randlimb ();
+      compare_log (n, 2, 500, 17);
+    }
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  special ();
+  check_random ();
+
+  tests_end_mpfr ();
+  return 0;
+}
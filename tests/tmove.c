@@ -0,0 +1,140 @@
+/* Test file for mpfr_move.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+/* Check that dst is equal to z with the precision of z, and that its
+   significand is (or is not, if same is zero) the one of z. */
+static void
+check_moved (mpfr_ptr dst, mpfr_ptr z, mp_limb_t *mant, int same,
+             const char *s)
+{
+  if (mpfr_get_prec (dst) != mpfr_get_prec (z) || ! SAME_VAL (dst, z) ||
+      (MPFR_MANT (dst) == mant) != same || ! mpfr_check (dst))
+    {
+      printf ("Error in mpfr_move (%s)\n", s);
+      printf ("got      "); mpfr_dump (dst);
+      printf ("expected "); mpfr_dump (z);
+      exit (1);
+    }
+}
+
+static void
+check_heap (mpfr_prec_t pd, mpfr_prec_t ps)
+{
+  mpfr_t dst, src, z;
+  mp_limb_t *mant;
+  int i;
+
+  mpfr_init2 (dst, pd);
+  mpfr_init2 (z, ps);
+  for (i = 0; i < 5; i++)
+    {
+      mpfr_init2 (src, ps);
+      switch (i)
+        {
+        case 0:
+          mpfr_urandomb (src, RANDS);
+          mpfr_neg (src, src, MPFR_RNDN);
+          break;
+        case 1:
+          mpfr_set_nan (src);
+          break;
+        case 2:
+          mpfr_set_inf (src, -1);
+          break;
+        case 3:
+          mpfr_set_zero (src, -1);
+          break;
+        default:
+          mpfr_const_pi (src, MPFR_RNDN);
+        }
+      mpfr_set (z, src, MPFR_RNDN);
+      mant = MPFR_MANT (src);
+      mpfr_clear_flags ();
+      mpfr_move (dst, src);
+      if (__gmpfr_flags != 0 || MPFR_MANT (src) != NULL)
+        {
+          printf ("Error in mpfr_move, flags or src not cleared\n");
+          exit (1);
+        }
+      check_moved (dst, z, mant, 1, "heap");
+      /* src can be initialized again, and dst used as usual */
+    }
+  mpfr_set_prec (dst, pd + 100);
+  mpfr_set_ui (dst, 1, MPFR_RNDN);
+  mpfr_clear (dst);
+  mpfr_clear (z);
+}
+
+/* The significand of an inline variable is copied, and the significand of
+   an inline destination is not freed. */
+static void
+check_inline (void)
+{
+  MPFR_DECL_SMALL (x, 2 * GMP_NUMB_BITS);
+  MPFR_DECL_SMALL (y, 2 * GMP_NUMB_BITS);
+  mpfr_block_t b;
+  mpfr_t u, v, z;
+  mp_limb_t *mant;
+
+  mpfr_small_init2 (x, 100);
+  mpfr_init2 (u, 1000);
+  mpfr_init2 (z, 100);
+  mpfr_const_log2 (x, MPFR_RNDN);
+  mpfr_set (z, x, MPFR_RNDN);
+  mpfr_move (u, x);
+  check_moved (u, z, NULL, 0, "inline source");
+
+  mpfr_small_init2 (y, 17);
+  mant = MPFR_MANT (u);
+  mpfr_move (y, u);
+  check_moved (y, z, mant, 1, "inline destination");
+  mpfr_clear (y);
+
+  mpfr_init_block (b, 200, u, v, (mpfr_ptr) 0);
+  mpfr_set_prec (z, 200);
+  mpfr_const_pi (u, MPFR_RNDN);
+  mpfr_set (z, u, MPFR_RNDN);
+  mpfr_init2 (y, 3);
+  mpfr_move (y, u);
+  check_moved (y, z, NULL, 0, "block source");
+  mpfr_move (y, y);
+  check_moved (y, z, NULL, 0, "same variable");
+  mpfr_clear_block (b, v, (mpfr_ptr) 0);
+  mpfr_clear (y);
+  mpfr_clear (z);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_heap (53, 53);
+  check_heap (2, 1000);
+  check_heap (1000, 2);
+  check_inline ();
+
+  tests_end_mpfr ();
+  return 0;
+}
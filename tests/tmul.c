@@ -663,6 +663,8 @@ main (int argc, char *argv[])
         49, 3, 2, "0.09375");
   check_max();
   check_min();
+  tests_check_small_prec (NULL, mpfr_mul, "mpfr_mul", 2 * GMP_NUMB_BITS,
+                          tests_random_small, 10);
 
   check_regression ();
   test_generic (2, 500, 100);
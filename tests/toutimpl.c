@@ -65,7 +65,7 @@ main (void)
       exit (1);
     }
   if (mpfr_print_rnd_mode ((mpfr_rnd_t) -1) != NULL ||
-      mpfr_print_rnd_mode (MPFR_RND_MAX) != NULL)
+      mpfr_print_rnd_mode ((mpfr_rnd_t) (MPFR_RNDF + 1)) != NULL)
     {
       printf ("Error for illegal rounding mode values.\n");
       exit (1);
@@ -0,0 +1,223 @@
+/* Test file for mpfr_prewarm_cache and mpfr_free_cache2.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+
+#include "mpfr-test.h"
+
+#ifdef MPFR_WANT_SHARED_CACHE
+#include <pthread.h>
+#endif
+
+#define CACHE_PREC 1000
+
+static mpfr_cache_ptr
+get_cache (int c)
+{
+  switch (c)
+    {
+    case MPFR_CACHE_PI:
+      return __gmpfr_cache_const_pi;
+    case MPFR_CACHE_LOG2:
+      return __gmpfr_cache_const_log2;
+    case MPFR_CACHE_EULER:
+      return __gmpfr_cache_const_euler;
+    default:
+      return __gmpfr_cache_const_catalan;
+    }
+}
+
+static int
+cached_p (int c)
+{
+  return MPFR_PREC (get_cache (c)->x) >= CACHE_PREC;
+}
+
+/* Check that the constant c obtained from the cache is correctly rounded,
+   for all the precisions from 2 to CACHE_PREC by steps of 37. */
+static void
+check_values (int c)
+{
+  mpfr_t x, y;
+  mpfr_prec_t p;
+  int r, inex1, inex2;
+
+  mpfr_inits2 (CACHE_PREC, x, y, (mpfr_ptr) 0);
+  for (p = MPFR_PREC_MIN; p <= CACHE_PREC; p += 37)
+    {
+      mpfr_set_prec (x, p);
+      mpfr_set_prec (y, p);
+      RND_LOOP (r)
+        {
+          inex1 = mpfr_cache (x, get_cache (c), (mpfr_rnd_t) r);
+          inex2 = (*get_cache (c)->func) (y, (mpfr_rnd_t) r);
+          if (! (SAME_VAL (x, y) && SAME_SIGN (inex1, inex2)))
+            {
+              printf ("Error for constant %d, prec = %lu, %s\n", c,
+                      (unsigned long) p,
+                      mpfr_print_rnd_mode ((mpfr_rnd_t) r));
+              printf ("Expected ");
+              mpfr_dump (y);
+              printf ("Got      ");
+              mpfr_dump (x);
+              exit (1);
+            }
+        }
+    }
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+}
+
+static void
+check_prewarm (void)
+{
+  int c;
+
+  mpfr_free_cache ();
+  for (c = MPFR_CACHE_PI; c <= MPFR_CACHE_CATALAN; c <<= 1)
+    MPFR_ASSERTN (! cached_p (c));
+
+  /* the flags are not modified */
+  mpfr_flags_set (MPFR_FLAGS_ALL);
+  mpfr_prewarm_cache (CACHE_PREC, MPFR_CACHE_PI | MPFR_CACHE_LOG2);
+  MPFR_ASSERTN (__gmpfr_flags == MPFR_FLAGS_ALL);
+  mpfr_clear_flags ();
+  mpfr_prewarm_cache (CACHE_PREC, 0);
+  MPFR_ASSERTN (__gmpfr_flags == 0);
+
+  /* Note: mpfr_const_euler and mpfr_const_catalan use pi and log(2), but
+     not the converse. */
+  MPFR_ASSERTN (cached_p (MPFR_CACHE_PI));
+  MPFR_ASSERTN (cached_p (MPFR_CACHE_LOG2));
+  MPFR_ASSERTN (! cached_p (MPFR_CACHE_EULER));
+  MPFR_ASSERTN (! cached_p (MPFR_CACHE_CATALAN));
+
+  mpfr_prewarm_cache (CACHE_PREC, MPFR_CACHE_ALL);
+  for (c = MPFR_CACHE_PI; c <= MPFR_CACHE_CATALAN; c <<= 1)
+    {
+      mpfr_prec_t p = MPFR_PREC (get_cache (c)->x);
+
+      MPFR_ASSERTN (p >= CACHE_PREC);
+      check_values (c);
+      /* the constant has not been recomputed */
+      MPFR_ASSERTN (MPFR_PREC (get_cache (c)->x) == p);
+    }
+}
+
+/* Without --enable-shared-cache, the caches of the constants are local;
+   with --enable-shared-cache, they are global. */
+static void
+check_free_cache2 (void)
+{
+  int c;
+#ifdef MPFR_WANT_SHARED_CACHE
+  int shared = 1;
+#else
+  int shared = 0;
+#endif
+
+  mpfr_prewarm_cache (CACHE_PREC, MPFR_CACHE_ALL);
+  mpfr_free_cache2 (MPFR_FREE_LOCAL_CACHE);
+  for (c = MPFR_CACHE_PI; c <= MPFR_CACHE_CATALAN; c <<= 1)
+    MPFR_ASSERTN (cached_p (c) == shared);
+
+  mpfr_prewarm_cache (CACHE_PREC, MPFR_CACHE_ALL);
+  mpfr_free_cache2 (MPFR_FREE_GLOBAL_CACHE);
+  for (c = MPFR_CACHE_PI; c <= MPFR_CACHE_CATALAN; c <<= 1)
+    MPFR_ASSERTN (cached_p (c) != shared);
+
+  mpfr_free_cache ();
+  for (c = MPFR_CACHE_PI; c <= MPFR_CACHE_CATALAN; c <<= 1)
+    MPFR_ASSERTN (! cached_p (c));
+}
+
+#ifdef MPFR_WANT_SHARED_CACHE
+
+#define NTHREADS 4
+
+static mpfr_t ref[4];
+
+/* Thread j gets the constants in different orders and precisions, while
+   the others may be extending the shared cache. */
+static void *
+start (void *p)
+{
+  int j = *(int *) p, i;
+  mpfr_t x;
+
+  mpfr_init2 (x, CACHE_PREC);
+  for (i = 0; i < 40; i++)
+    {
+      int c = (i + j) % 4;
+
+      mpfr_set_prec (x, mpfr_get_prec (ref[c]) - (i * (j + 1)) % 200);
+      mpfr_cache (x, get_cache (1 << c), MPFR_RNDZ);
+      MPFR_ASSERTN (mpfr_cmp (x, ref[c]) <= 0);
+      mpfr_nextabove (x);
+      MPFR_ASSERTN (mpfr_cmp (x, ref[c]) > 0);
+    }
+  mpfr_clear (x);
+  mpfr_free_cache2 (MPFR_FREE_LOCAL_CACHE);
+  return NULL;
+}
+
+static void
+check_threads (void)
+{
+  pthread_t th[NTHREADS];
+  int arg[NTHREADS], c, j;
+
+  for (c = 0; c < 4; c++)
+    {
+      mpfr_init2 (ref[c], CACHE_PREC);
+      (*get_cache (1 << c)->func) (ref[c], MPFR_RNDZ);
+    }
+  mpfr_free_cache ();
+  for (j = 0; j < NTHREADS; j++)
+    {
+      arg[j] = j;
+      MPFR_ASSERTN (pthread_create (&th[j], NULL, start, &arg[j]) == 0);
+    }
+  for (j = 0; j < NTHREADS; j++)
+    MPFR_ASSERTN (pthread_join (th[j], NULL) == 0);
+  /* the constants have been kept in the shared cache */
+  for (c = 0; c < 4; c++)
+    {
+      MPFR_ASSERTN (MPFR_PREC (get_cache (1 << c)->x) >= CACHE_PREC - 200);
+      mpfr_clear (ref[c]);
+    }
+}
+
+#endif
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_prewarm ();
+  check_free_cache2 ();
+#ifdef MPFR_WANT_SHARED_CACHE
+  check_threads ();
+#endif
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -185,6 +185,8 @@ main (void)
   special ();
   bad_case1 ();
   bad_case2 ();
+  tests_check_small_prec (mpfr_rec_sqrt, NULL, "mpfr_rec_sqrt",
+                          GMP_NUMB_BITS, tests_random_small_pos, 0);
   test_generic (2, 300, 15);
 
   data_check ("data/rec_sqrt", mpfr_rec_sqrt, "mpfr_rec_sqrt");
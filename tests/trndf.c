@@ -0,0 +1,249 @@
+/* Test file for the faithful rounding mode MPFR_RNDF.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+/* With MPFR_RNDF, the result must be either the result with MPFR_RNDD
+   or the result with MPFR_RNDU. The ternary value is not checked since
+   it is not specified. */
+
+struct fun1
+{
+  const char *name;
+  int (*f) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+  int positive;  /* 1 if the input must be positive */
+};
+
+struct fun2
+{
+  const char *name;
+  int (*f) (mpfr_ptr, mpfr_srcptr, mpfr_srcptr, mpfr_rnd_t);
+  int positive;  /* 1 if the first input must be positive */
+};
+
+static const struct fun1 tab1[] = {
+  { "mpfr_set", mpfr_set, 0 },
+  { "mpfr_sqr", mpfr_sqr, 0 },
+  { "mpfr_sqrt", mpfr_sqrt, 1 },
+  { "mpfr_rec_sqrt", mpfr_rec_sqrt, 1 },
+  { "mpfr_cbrt", mpfr_cbrt, 0 },
+  { "mpfr_exp", mpfr_exp, 0 },
+  { "mpfr_exp2", mpfr_exp2, 0 },
+  { "mpfr_expm1", mpfr_expm1, 0 },
+  { "mpfr_log", mpfr_log, 1 },
+  { "mpfr_log1p", mpfr_log1p, 1 },
+  { "mpfr_sin", mpfr_sin, 0 },
+  { "mpfr_cos", mpfr_cos, 0 },
+  { "mpfr_tan", mpfr_tan, 0 },
+  { "mpfr_atan", mpfr_atan, 0 },
+  { "mpfr_sinh", mpfr_sinh, 0 },
+  { "mpfr_tanh", mpfr_tanh, 0 },
+  { "mpfr_lngamma", mpfr_lngamma, 1 }
+};
+
+static const struct fun2 tab2[] = {
+  { "mpfr_add", mpfr_add, 0 },
+  { "mpfr_sub", mpfr_sub, 0 },
+  { "mpfr_mul", mpfr_mul, 0 },
+  { "mpfr_div", mpfr_div, 0 },
+  { "mpfr_pow", mpfr_pow, 1 },
+  { "mpfr_atan2", mpfr_atan2, 0 },
+  { "mpfr_agm", mpfr_agm, 1 }
+};
+
+static void
+random_input (mpfr_ptr x, int positive)
+{
+  mpfr_urandomb (x, RANDS);
+  if (MPFR_IS_ZERO (x))
+    mpfr_set_ui (x, 1, MPFR_RNDN);
+  mpfr_mul_2si (x, x, (long) (randlimb () % 21) - 10, MPFR_RNDN);
+  if (!positive && (randlimb () & 1))
+    mpfr_neg (x, x, MPFR_RNDN);
+}
+
+/* Check that z (obtained with MPFR_RNDF) is either yd or yu. */
+static void
+check_faithful (const char *name, mpfr_srcptr z, mpfr_srcptr yd,
+                mpfr_srcptr yu, mpfr_srcptr x, mpfr_srcptr y)
+{
+  if (SAME_VAL (z, yd) || SAME_VAL (z, yu))
+    return;
+  printf ("Error for %s with MPFR_RNDF\nx = ", name);
+  mpfr_dump (x);
+  if (y != NULL)
+    {
+      printf ("y = ");
+      mpfr_dump (y);
+    }
+  printf ("got          ");
+  mpfr_dump (z);
+  printf ("with RNDD:   ");
+  mpfr_dump (yd);
+  printf ("with RNDU:   ");
+  mpfr_dump (yu);
+  exit (1);
+}
+
+static void
+check_random (mpfr_prec_t pz, int n)
+{
+  mpfr_t x, y, z, yd, yu;
+  mpfr_prec_t px, py;
+  int i, k;
+
+  mpfr_inits2 (pz, z, yd, yu, (mpfr_ptr) 0);
+  mpfr_init (x);
+  mpfr_init (y);
+  for (i = 0; i < n; i++)
+    {
+      /* same precision (e.g. mpfr_add1sp) or random precisions */
+      px = (randlimb () & 1) ? pz : MPFR_PREC_MIN + randlimb () % (2 * pz);
+      py = (randlimb () & 1) ? pz : MPFR_PREC_MIN + randlimb () % (2 * pz);
+      mpfr_set_prec (x, px);
+      mpfr_set_prec (y, py);
+
+      for (k = 0; k < (int) numberof (tab1); k++)
+        {
+          random_input (x, tab1[k].positive);
+          tab1[k].f (z, x, MPFR_RNDF);
+          tab1[k].f (yd, x, MPFR_RNDD);
+          tab1[k].f (yu, x, MPFR_RNDU);
+          check_faithful (tab1[k].name, z, yd, yu, x, NULL);
+        }
+
+      for (k = 0; k < (int) numberof (tab2); k++)
+        {
+          random_input (x, tab2[k].positive);
+          random_input (y, tab2[k].positive);
+          tab2[k].f (z, x, y, MPFR_RNDF);
+          tab2[k].f (yd, x, y, MPFR_RNDD);
+          tab2[k].f (yu, x, y, MPFR_RNDU);
+          check_faithful (tab2[k].name, z, yd, yu, x, y);
+        }
+    }
+  mpfr_clears (x, y, z, yd, yu, (mpfr_ptr) 0);
+}
+
+/* Large precisions, to go through Mulders' short product and division,
+   and through the mpz_tdiv_q code of mpfr_div. */
+static void
+check_large (void)
+{
+  mpfr_t x, y, z, yd, yu;
+  mpfr_prec_t p;
+  int i;
+
+  for (p = 1000; p <= 8000; p += 1750)
+    {
+      mpfr_inits2 (p, x, y, z, yd, yu, (mpfr_ptr) 0);
+      for (i = 0; i < 10; i++)
+        {
+          random_input (x, 0);
+          random_input (y, 0);
+          mpfr_mul (z, x, y, MPFR_RNDF);
+          mpfr_mul (yd, x, y, MPFR_RNDD);
+          mpfr_mul (yu, x, y, MPFR_RNDU);
+          check_faithful ("mpfr_mul", z, yd, yu, x, y);
+          mpfr_div (z, x, y, MPFR_RNDF);
+          mpfr_div (yd, x, y, MPFR_RNDD);
+          mpfr_div (yu, x, y, MPFR_RNDU);
+          check_faithful ("mpfr_div", z, yd, yu, x, y);
+          mpfr_sqr (z, x, MPFR_RNDF);
+          mpfr_sqr (yd, x, MPFR_RNDD);
+          mpfr_sqr (yu, x, MPFR_RNDU);
+          check_faithful ("mpfr_sqr", z, yd, yu, x, NULL);
+        }
+      mpfr_clears (x, y, z, yd, yu, (mpfr_ptr) 0);
+    }
+}
+
+/* Check the correct rounding modes when the result is exact: then the
+   faithful rounding must return the exact result. */
+static void
+check_exact (void)
+{
+  mpfr_t x, y, z;
+  unsigned long n;
+
+  mpfr_inits2 (53, x, y, z, (mpfr_ptr) 0);
+  mpfr_set_ui (x, 3, MPFR_RNDN);
+  mpfr_set_ui (y, 5, MPFR_RNDN);
+  mpfr_add (z, x, y, MPFR_RNDF);
+  MPFR_ASSERTN (mpfr_cmp_ui (z, 8) == 0);
+  mpfr_mul (z, x, y, MPFR_RNDF);
+  MPFR_ASSERTN (mpfr_cmp_ui (z, 15) == 0);
+  mpfr_set_ui (x, 15, MPFR_RNDN);
+  mpfr_div (z, x, y, MPFR_RNDF);
+  MPFR_ASSERTN (mpfr_cmp_ui (z, 3) == 0);
+  mpfr_set_ui (x, 49, MPFR_RNDN);
+  mpfr_sqrt (z, x, MPFR_RNDF);
+  MPFR_ASSERTN (mpfr_cmp_ui (z, 7) == 0);
+  for (n = 0; n < 10; n++)
+    {
+      mpfr_fac_ui (z, n, MPFR_RNDF);
+      mpfr_fac_ui (y, n, MPFR_RNDN);
+      MPFR_ASSERTN (mpfr_equal_p (z, y));
+    }
+  mpfr_clears (x, y, z, (mpfr_ptr) 0);
+}
+
+static void
+check_misc (void)
+{
+  mpfr_t b;
+  mpfr_rnd_t r;
+
+  MPFR_ASSERTN (strcmp (mpfr_print_rnd_mode (MPFR_RNDF), "MPFR_RNDF") == 0);
+
+  r = mpfr_get_default_rounding_mode ();
+  mpfr_set_default_rounding_mode (MPFR_RNDF);
+  MPFR_ASSERTN (mpfr_get_default_rounding_mode () == MPFR_RNDF);
+  mpfr_set_default_rounding_mode (r);
+
+  /* mpfr_can_round with MPFR_RNDF only needs an error of 1/2 ulp */
+  mpfr_init2 (b, 100);
+  mpfr_set_ui (b, 1, MPFR_RNDN);
+  mpfr_nextbelow (b);
+  MPFR_ASSERTN (mpfr_can_round (b, 54, MPFR_RNDN, MPFR_RNDF, 53));
+  MPFR_ASSERTN (mpfr_can_round (b, 54, MPFR_RNDZ, MPFR_RNDF, 53));
+  MPFR_ASSERTN (! mpfr_can_round (b, 53, MPFR_RNDN, MPFR_RNDF, 53));
+  MPFR_ASSERTN (! mpfr_can_round (b, 54, MPFR_RNDN, MPFR_RNDN, 53));
+  mpfr_clear (b);
+}
+
+int
+main (void)
+{
+  mpfr_prec_t p;
+
+  tests_start_mpfr ();
+
+  check_misc ();
+  check_exact ();
+  for (p = MPFR_PREC_MIN; p <= 200; p++)
+    check_random (p, 4);
+  check_large ();
+
+  tests_end_mpfr ();
+  return 0;
+}
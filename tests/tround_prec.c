@@ -22,6 +22,43 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 
 #include "mpfr-test.h"
 
+/* Compare mpfr_prec_round, which rounds in place, with mpfr_set to a new
+   variable, for precisions with more or fewer limbs. */
+static void
+check_random (void)
+{
+  mpfr_t x, y;
+  mpfr_prec_t px, py;
+  mpfr_rnd_t r;
+  int i, inex1, inex2;
+
+  for (i = 0; i < 2000; i++)
+    {
+      px = MPFR_PREC_MIN + randlimb () % (4 * GMP_NUMB_BITS);
+      py = MPFR_PREC_MIN + randlimb () % (4 * GMP_NUMB_BITS);
+      r = RND_RAND ();
+      mpfr_init2 (x, px);
+      mpfr_init2 (y, py);
+      mpfr_urandomb (x, RANDS);
+      if (randlimb () & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      inex1 = mpfr_set (y, x, r);
+      inex2 = mpfr_prec_round (x, py, r);
+      if (! SAME_VAL (x, y) || ! SAME_SIGN (inex1, inex2))
+        {
+          printf ("Error in mpfr_prec_round from %lu to %lu bits, %s\n",
+                  (unsigned long) px, (unsigned long) py,
+                  mpfr_print_rnd_mode (r));
+          printf ("got      "); mpfr_dump (x);
+          printf ("expected "); mpfr_dump (y);
+          printf ("inex1 = %d, inex2 = %d\n", inex1, inex2);
+          exit (1);
+        }
+      mpfr_clear (x);
+      mpfr_clear (y);
+    }
+}
+
 int
 main (void)
 {
@@ -116,6 +153,8 @@ main (void)
 
    mpfr_clear(x);
 
+   check_random ();
+
    tests_end_mpfr ();
    return 0;
 }
@@ -0,0 +1,201 @@
+/* Test file for the scratch arena (--enable-scratch-arena).
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+#ifdef MPFR_WANT_SCRATCH_ARENA
+
+#define NBLOCKS 16
+
+static unsigned char *blk[NBLOCKS];
+static size_t blk_size[NBLOCKS];
+
+static void
+fill (int i)
+{
+  memset (blk[i], i + 1, blk_size[i]);
+}
+
+static void
+check_block (int i)
+{
+  size_t j;
+
+  for (j = 0; j < blk_size[i]; j++)
+    if (blk[i][j] != (unsigned char) (i + 1))
+      {
+        printf ("Error, block %d of size %lu overwritten at %lu\n", i,
+                (unsigned long) blk_size[i], (unsigned long) j);
+        exit (1);
+      }
+}
+
+static size_t
+random_size (void)
+{
+  switch (randlimb () % 4)
+    {
+    case 0:
+      return 1 + randlimb () % 100000;  /* larger than the first chunk */
+    case 1:
+      return 1 + randlimb () % 16;
+    default:
+      return 1 + randlimb () % 5000;
+    }
+}
+
+/* Allocate, reallocate and free random blocks, mostly at the top of the
+   stack of blocks, but also below the top, and check that the blocks do
+   not overlap. */
+static void
+check_alloc (int n)
+{
+  int top = 0, i, k;
+
+  for (k = 0; k < n; k++)
+    {
+      switch (randlimb () % 8)
+        {
+        case 0:
+        case 1:
+        case 2:
+          if (top < NBLOCKS)
+            {
+              blk_size[top] = random_size ();
+              blk[top] = (unsigned char *) mpfr_scratch_alloc (blk_size[top]);
+              fill (top++);
+            }
+          break;
+        case 3:
+        case 4:
+          if (top > 0)
+            {
+              check_block (--top);
+              mpfr_scratch_free (blk[top], blk_size[top]);
+            }
+          break;
+        case 5:
+          /* free a block below the top */
+          if (top > 0)
+            {
+              unsigned char *p;
+              size_t s;
+
+              i = randlimb () % top;
+              check_block (i);
+              p = blk[i];
+              s = blk_size[i];
+              for (top--; i < top; i++)
+                {
+                  blk[i] = blk[i + 1];
+                  blk_size[i] = blk_size[i + 1];
+                  fill (i);
+                }
+              mpfr_scratch_free (p, s);
+            }
+          break;
+        case 6:
+          if (top > 0)
+            {
+              size_t s;
+
+              i = randlimb () % 2 ? top - 1 : randlimb () % top;
+              check_block (i);
+              s = random_size ();
+              blk[i] = (unsigned char *)
+                mpfr_scratch_realloc (blk[i], blk_size[i], s);
+              if (s < blk_size[i])
+                blk_size[i] = s;
+              check_block (i);  /* the common part is preserved */
+              blk_size[i] = s;
+              fill (i);
+            }
+          break;
+        default:
+          /* change the maximum size of the arena, so that some blocks are
+             allocated directly with the memory functions */
+          mpfr_scratch_set_max (randlimb () % 2 ? 100000 : 1048576);
+        }
+    }
+
+  while (top > 0)
+    {
+      check_block (--top);
+      mpfr_scratch_free (blk[top], blk_size[top]);
+    }
+}
+
+#endif
+
+/* Compute with the group and the temporary memory in the arena, and
+   without it, and compare the results. */
+static void
+check_functions (void)
+{
+  mpfr_t x, y, z;
+  size_t max;
+  int inex1, inex2;
+
+  max = mpfr_scratch_get_max ();
+  mpfr_inits2 (20000, x, y, z, (mpfr_ptr) 0);
+  mpfr_const_pi (x, MPFR_RNDN);
+  mpfr_sqrt (x, x, MPFR_RNDN);
+  inex1 = mpfr_sin (y, x, MPFR_RNDN);
+  mpfr_scratch_set_max (0);
+  if (mpfr_scratch_get_max () != 0)
+    {
+      printf ("Error, mpfr_scratch_get_max should return 0\n");
+      exit (1);
+    }
+  inex2 = mpfr_sin (z, x, MPFR_RNDN);
+  mpfr_scratch_set_max (max);
+  if (! mpfr_equal_p (y, z) || inex1 != inex2)
+    {
+      printf ("Error, different results with and without the arena\n");
+      exit (1);
+    }
+  mpfr_clears (x, y, z, (mpfr_ptr) 0);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  if ((mpfr_scratch_get_max () != 0) != (mpfr_buildopt_scratch_p () != 0))
+    {
+      printf ("Error, mpfr_scratch_get_max should return %s\n",
+              mpfr_buildopt_scratch_p () ? "a positive value" : "0");
+      exit (1);
+    }
+#ifdef MPFR_WANT_SCRATCH_ARENA
+  check_alloc (100000);
+  mpfr_scratch_release ();
+  check_alloc (1000);
+#endif
+  check_functions ();
+  mpfr_scratch_release ();
+  check_functions ();
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -365,6 +365,161 @@ test_mpfr_sincos_fast (void)
   mpfr_clear (h);
 }
 
+/* Check mpfr_sin, mpfr_cos and mpfr_sin_cos on huge arguments, for which
+   the argument reduction is done by mpfr_payne_hanek, against a reduction
+   with mpfr_remainder, and check that mpfr_sincos_fast (which reduces
+   modulo Pi/2 instead of 2*Pi) gives the same results as mpfr_sin_cos. */
+static void
+check_huge (void)
+{
+  mpfr_t x, y, z, ys, yc, zs, zc, t, pi;
+  mpfr_prec_t px, py, q;
+  mpfr_exp_t e, err;
+  mpfr_rnd_t r;
+  int i, oks, okc;
+
+  for (i = 0; i < 100; i++)
+    {
+      px = 2 + randlimb () % 200;
+      py = 2 + randlimb () % 300;
+      q = py + 64;
+      e = MPFR_PAYNE_HANEK_THRESHOLD + randlimb () % 5000;
+      mpfr_init2 (x, px);
+      mpfr_inits2 (py, y, z, ys, yc, (mpfr_ptr) 0);
+      mpfr_inits2 (q, zs, zc, t, (mpfr_ptr) 0);
+      mpfr_init2 (pi, e + q + 8);
+      do
+        mpfr_urandomb (x, RANDS);
+      while (MPFR_IS_ZERO (x));
+      mpfr_set_exp (x, e);
+      if (randlimb () & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      mpfr_const_pi (pi, MPFR_RNDN);
+      mpfr_mul_2ui (pi, pi, 1, MPFR_RNDN);
+      mpfr_remainder (t, x, pi, MPFR_RNDN);  /* error <= 2^(2-q) */
+      mpfr_sin (zs, t, MPFR_RNDN);             /* error <= 2^(3-q) */
+      mpfr_cos (zc, t, MPFR_RNDN);             /* error <= 2^(3-q) */
+      r = RND_RAND ();
+      err = q - 3 + mpfr_get_exp (zs);
+      oks = err > 0 && mpfr_can_round (zs, err, MPFR_RNDN, MPFR_RNDZ,
+                                       py + (r == MPFR_RNDN));
+      err = q - 3 + mpfr_get_exp (zc);
+      okc = err > 0 && mpfr_can_round (zc, err, MPFR_RNDN, MPFR_RNDZ,
+                                       py + (r == MPFR_RNDN));
+      mpfr_set (ys, zs, r);
+      mpfr_set (yc, zc, r);
+
+      mpfr_sin (y, x, r);
+      mpfr_cos (z, x, r);
+      if ((oks && ! mpfr_equal_p (y, ys)) || (okc && ! mpfr_equal_p (z, yc)))
+        {
+          printf ("Error in mpfr_sin or mpfr_cos for huge x, rnd=%s\nx=",
+                  mpfr_print_rnd_mode (r));
+          mpfr_dump (x);
+          printf ("expected sin "); mpfr_dump (ys);
+          printf ("got          "); mpfr_dump (y);
+          printf ("expected cos "); mpfr_dump (yc);
+          printf ("got          "); mpfr_dump (z);
+          exit (1);
+        }
+
+      mpfr_sin_cos (y, z, x, r);
+      if ((oks && ! mpfr_equal_p (y, ys)) || (okc && ! mpfr_equal_p (z, yc)))
+        {
+          printf ("Error in mpfr_sin_cos for huge x, rnd=%s\nx=",
+                  mpfr_print_rnd_mode (r));
+          mpfr_dump (x);
+          printf ("expected sin "); mpfr_dump (ys);
+          printf ("got          "); mpfr_dump (y);
+          printf ("expected cos "); mpfr_dump (yc);
+          printf ("got          "); mpfr_dump (z);
+          exit (1);
+        }
+
+      mpfr_sincos_fast (ys, yc, x, r);
+      if (! mpfr_equal_p (y, ys) || ! mpfr_equal_p (z, yc))
+        {
+          printf ("mpfr_sin_cos and mpfr_sincos_fast disagree for huge x,"
+                  " rnd=%s\nx=", mpfr_print_rnd_mode (r));
+          mpfr_dump (x);
+          printf ("yref="); mpfr_dump (y);
+          printf ("y=   "); mpfr_dump (ys);
+          printf ("zref="); mpfr_dump (z);
+          printf ("z=   "); mpfr_dump (yc);
+          exit (1);
+        }
+      mpfr_clears (x, y, z, ys, yc, zs, zc, t, pi, (mpfr_ptr) 0);
+    }
+
+  /* The cache of 2/Pi is extended to an argument of exponent 200000 (unless
+     MPFR_PAYNE_HANEK_CACHE_MAX is smaller) and kept for a smaller exponent,
+     but the cache of Pi is not extended to this precision. */
+  mpfr_free_cache ();
+  mpfr_inits2 (53, x, y, (mpfr_ptr) 0);
+  for (i = 0; i < 2; i++)
+    {
+      mpfr_set_ui_2exp (x, 1, 200000 - 1000 * i, MPFR_RNDN);
+      mpfr_sin (y, x, MPFR_RNDN);
+      if ((200000 + 53 + 4 <= MPFR_PAYNE_HANEK_CACHE_MAX ?
+           MPFR_PREC (__gmpfr_cache_const_two_over_pi->x) < 200000 :
+           MPFR_PREC (__gmpfr_cache_const_two_over_pi->x) != 0) ||
+          MPFR_PREC (__gmpfr_cache_const_pi->x) > 1000)
+        {
+          printf ("Error, wrong caches of 2/Pi and Pi after a huge"
+                  " argument (i = %d)\n", i);
+          printf ("precisions %lu and %lu\n",
+                  (unsigned long)
+                  MPFR_PREC (__gmpfr_cache_const_two_over_pi->x),
+                  (unsigned long) MPFR_PREC (__gmpfr_cache_const_pi->x));
+          exit (1);
+        }
+    }
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+  mpfr_free_cache ();
+}
+
+/* Check that the threaded mode of mpfr_sincos_fast (see mpfr_set_nthreads)
+   gives the same results as the serial mode. */
+static void
+check_nthreads (void)
+{
+  mpfr_prec_t p[2] = { 60000, 100000 };
+  unsigned int nthreads[3] = { 2, 3, 8 };
+  mpfr_t x, s1, c1, s2, c2;
+  int i, j, inex1, inex2;
+  mpfr_rnd_t rnd;
+
+  for (i = 0; i < 2; i++)
+    {
+      mpfr_inits2 (p[i], x, s1, c1, s2, c2, (mpfr_ptr) 0);
+      do
+        mpfr_urandomb (x, RANDS);
+      while (MPFR_IS_ZERO (x));
+      /* a tiny x for the first precision (so that the first blocks are
+         zero), and an argument reduction for the second one */
+      mpfr_mul_2si (x, x, i == 0 ? -100 : 3, MPFR_RNDN);
+      rnd = RND_RAND ();
+      inex1 = mpfr_sincos_fast (s1, c1, x, rnd);
+      for (j = 0; j < 3; j++)
+        {
+          mpfr_set_nthreads (nthreads[j]);
+          inex2 = mpfr_sincos_fast (s2, c2, x, rnd);
+          mpfr_set_nthreads (1);
+          if (! (mpfr_equal_p (s1, s2) && mpfr_equal_p (c1, c2) &&
+                 inex1 == inex2))
+            {
+              printf ("Error in mpfr_sincos_fast for prec = %lu with %u"
+                      " threads, %s\nx = ", (unsigned long) p[i],
+                      nthreads[j], mpfr_print_rnd_mode (rnd));
+              mpfr_dump (x);
+              printf ("expected inex = %d, got %d\n", inex1, inex2);
+              exit (1);
+            }
+        }
+      mpfr_clears (x, s1, c1, s2, c2, (mpfr_ptr) 0);
+    }
+}
+
 static void
 bug20091007 (void)
 {
@@ -685,6 +840,8 @@ main (int argc, char *argv[])
   consistency ();
 
   test_mpfr_sincos_fast ();
+  check_huge ();
+  check_nthreads ();
 
   check_nans ();
 
@@ -163,6 +163,8 @@ main (void)
   check_mpn_sqr ();
 
   check_special ();
+  tests_check_small_prec (mpfr_sqr, NULL, "mpfr_sqr", 2 * GMP_NUMB_BITS,
+                          tests_random_small, 10);
   for (p = 2; p < 200; p++)
     check_random (p);
 
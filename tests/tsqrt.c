@@ -594,6 +594,8 @@ main (void)
   check_diverse ("635030154261163106768013773815762607450069292760790610550915652722277604820131530404842415587328", 160, "796887792767063979679855997149887366668464780637");
   special ();
   check_singular ();
+  tests_check_small_prec (mpfr_sqrt, NULL, "mpfr_sqrt", 2 * GMP_NUMB_BITS,
+                          tests_random_small_pos, 0);
 
   for (p=2; p<200; p++)
     for (k=0; k<200; k++)
@@ -34,7 +34,10 @@ main (void)
 
   check_special ();
   for (p = 2 ; p < 200 ; p++)
-    check_random (p);
+    {
+      check_random (p);
+      tests_check_random_exp (mpfr_sub1, mpfr_sub1sp, "mpfr_sub1sp", p, 1);
+    }
 
   tests_end_mpfr ();
   return 0;
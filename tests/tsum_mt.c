@@ -0,0 +1,155 @@
+/* Test file for mpfr_sum_mt.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+
+#include "mpfr-test.h"
+
+#define NMAX 30000
+
+/* Check that mpfr_sum_mt gives the same result, ternary value and flags as
+   mpfr_sum, for several numbers of threads. */
+static void
+check_sum_mt (mpfr_ptr *const x, unsigned long n, mpfr_prec_t prec,
+              const char *s)
+{
+  mpfr_t r1, r2;
+  mpfr_flags_t flags1, flags2;
+  unsigned int nthreads;
+  int rnd, inex1, inex2;
+
+  mpfr_inits2 (prec, r1, r2, (mpfr_ptr) 0);
+  RND_LOOP (rnd)
+    {
+      mpfr_clear_flags ();
+      inex1 = mpfr_sum (r1, x, n, (mpfr_rnd_t) rnd);
+      flags1 = __gmpfr_flags;
+      for (nthreads = 0; nthreads <= 8; nthreads += 1 + nthreads / 2)
+        {
+          mpfr_clear_flags ();
+          inex2 = mpfr_sum_mt (r2, x, n, (mpfr_rnd_t) rnd, nthreads);
+          flags2 = __gmpfr_flags;
+          if (! (SAME_VAL (r1, r2) && SAME_SIGN (inex1, inex2) &&
+                 flags1 == flags2))
+            {
+              printf ("Error in check_sum_mt (%s) for n = %lu, %u threads,"
+                      " %s\n", s, n, nthreads,
+                      mpfr_print_rnd_mode ((mpfr_rnd_t) rnd));
+              printf ("Expected ");
+              mpfr_dump (r1);
+              printf ("  with inex ~ %d, flags =", inex1);
+              flags_out (flags1);
+              printf ("Got      ");
+              mpfr_dump (r2);
+              printf ("  with inex ~ %d, flags =", inex2);
+              flags_out (flags2);
+              exit (1);
+            }
+        }
+    }
+  mpfr_clears (r1, r2, (mpfr_ptr) 0);
+}
+
+static void
+check_random (mpfr_ptr *x, unsigned long n, int range, int cancel)
+{
+  unsigned long i;
+
+  for (i = 0; i < n; i++)
+    {
+      mpfr_set_prec (x[i], MPFR_PREC_MIN + randlimb () % 100);
+      mpfr_urandomb (x[i], RANDS);
+      if (MPFR_NOTZERO (x[i]))
+        mpfr_set_exp (x[i], (mpfr_exp_t) (randlimb () % range) - range / 2);
+      if (randlimb () & 1)
+        mpfr_neg (x[i], x[i], MPFR_RNDN);
+    }
+  /* the second half cancels the first half, up to the last bits, so that
+     the result depends on terms in different chunks */
+  if (cancel)
+    for (i = 0; i < n / 2; i++)
+      {
+        mpfr_set_prec (x[n-1-i], mpfr_get_prec (x[i]));
+        mpfr_neg (x[n-1-i], x[i], MPFR_RNDN);
+        if (MPFR_NOTZERO (x[i]) && (randlimb () & 1))
+          mpfr_nextabove (x[n-1-i]);
+      }
+  check_sum_mt (x, n, MPFR_PREC_MIN + randlimb () % 200, "random");
+}
+
+static void
+check_special (mpfr_ptr *x, unsigned long n)
+{
+  unsigned long i;
+
+  for (i = 0; i < n; i++)
+    mpfr_set_zero (x[i], -1);
+  check_sum_mt (x, n, 10, "-0");
+  mpfr_set_zero (x[n-1], 1);
+  check_sum_mt (x, n, 10, "-0 and +0");
+
+  for (i = 0; i < n; i++)
+    mpfr_set_si (x[i], i & 1 ? -1 : 1, MPFR_RNDN);
+  check_sum_mt (x, n, 10, "exact cancellation");
+  mpfr_set_inf (x[n-1], -1);
+  check_sum_mt (x, n, 10, "-Inf");
+  mpfr_set_inf (x[0], 1);
+  check_sum_mt (x, n, 10, "+Inf and -Inf");
+  mpfr_set_nan (x[n/2]);
+  mpfr_set_ui (x[0], 1, MPFR_RNDN);
+  check_sum_mt (x, n, 10, "NaN");
+}
+
+int
+main (void)
+{
+  mpfr_t *t;
+  mpfr_ptr *x;
+  unsigned long i;
+
+  tests_start_mpfr ();
+
+  t = (mpfr_t *) malloc (NMAX * sizeof (mpfr_t));
+  x = (mpfr_ptr *) malloc (NMAX * sizeof (mpfr_ptr));
+  MPFR_ASSERTN (t != NULL && x != NULL);
+  for (i = 0; i < NMAX; i++)
+    {
+      mpfr_init (t[i]);
+      x[i] = t[i];
+    }
+
+  check_special (x, NMAX);
+  check_random (x, 100, 100, 0);
+  check_random (x, NMAX, 100, 0);
+  check_random (x, NMAX, 1000, 0);
+  /* the threads of the parallel mode are joined, then created again */
+  mpfr_free_threads ();
+  check_random (x, NMAX, 100, 1);
+  check_random (x, NMAX - 1, 1000, 1);
+
+  for (i = 0; i < NMAX; i++)
+    mpfr_clear (t[i]);
+  free (t);
+  free (x);
+
+  tests_end_mpfr ();
+  return 0;
+}
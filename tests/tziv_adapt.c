@@ -0,0 +1,110 @@
+/* Test file for the adaptive initial precision of the Ziv loops.
+
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+#ifdef MPFR_WANT_ZIV_ADAPTIVE
+
+/* Simulate n calls of a Ziv loop with initial precision p, whose rounding
+   test fails at the first iteration when the guard bits added by
+   mpfr_ziv_adapt_enter are less than hard, and return the maximum number
+   of guard bits, the last one being stored in *last. */
+static int
+simulate (mpfr_ziv_adapt_t *a, mpfr_prec_t p, int hard, unsigned long n,
+          int *last)
+{
+  mpfr_prec_t q;
+  int bucket, g, gmax = 0;
+
+  while (n-- > 0)
+    {
+      q = mpfr_ziv_adapt_enter (a, &bucket, p);
+      MPFR_ASSERTN (q >= p);
+      g = q - p;
+      if (g > gmax)
+        gmax = g;
+      if (g < hard)
+        mpfr_ziv_adapt_fail (a, bucket);
+      *last = g;
+    }
+  return gmax;
+}
+
+/* Drive the record of a loop with forced failures: with hard-to-round
+   inputs, the initial precision must increase until most of them pass the
+   rounding test at the first iteration, then come back to the precision
+   given by the caller when the inputs become easy. */
+static void
+check_forced_failures (mpfr_prec_t p)
+{
+  static mpfr_ziv_adapt_t a;  /* zero-initialized, like in MPFR_ZIV_ADAPT */
+  int g, gmax;
+
+  memset (&a, 0, sizeof (a));
+
+  /* random inputs: no guard bits */
+  gmax = simulate (&a, p, 0, 20000, &g);
+  if (gmax != 0)
+    {
+      printf ("Error for p=%lu, %d guard bits without failures\n",
+              (unsigned long) p, gmax);
+      exit (1);
+    }
+
+  /* all the inputs need at least 40 guard bits */
+  gmax = simulate (&a, p, 40, 20000, &g);
+  if (gmax < 40)
+    {
+      printf ("Error for p=%lu, the initial precision did not increase"
+              " (at most %d guard bits)\n", (unsigned long) p, gmax);
+      exit (1);
+    }
+
+  /* random inputs again */
+  simulate (&a, p, 0, 20000, &g);
+  if (g != 0)
+    {
+      printf ("Error for p=%lu, the initial precision did not decrease"
+              " (%d guard bits)\n", (unsigned long) p, g);
+      exit (1);
+    }
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_forced_failures (100);
+  check_forced_failures (5000);
+
+  tests_end_mpfr ();
+  return 0;
+}
+
+#else
+
+int
+main (void)
+{
+  return 77;
+}
+
+#endif /* MPFR_WANT_ZIV_ADAPTIVE */
@@ -0,0 +1,132 @@
+/* Test file for mpfr_ziv_stats_get and mpfr_ziv_stats_reset.
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-test.h"
+
+/* Check the consistency of the statistics of all the functions, and return
+   the total number of calls. */
+static unsigned long
+check_stats (void)
+{
+  mpfr_ziv_stats_t st;
+  unsigned long i, j, n, total = 0;
+  int k;
+
+  for (i = 0; mpfr_ziv_stats_get (&st, i); i++)
+    {
+      mpfr_ziv_stats_t st2;
+
+      for (k = 0, n = 0; k < MPFR_ZIV_STATS_BINS; k++)
+        n += st.iter[k];
+      if (st.name == NULL || n != st.calls || st.time < 0.0 ||
+          (st.calls == 0 && (st.max_prec != 0 || st.time != 0.0)) ||
+          (st.calls != 0 && st.max_prec < MPFR_PREC_MIN))
+        {
+          printf ("Error in the Ziv statistics of %s\n",
+                  st.name == NULL ? "(null)" : st.name);
+          printf ("calls = %lu, sum of iter = %lu, max_prec = %lu, "
+                  "time = %g\n", st.calls, n, (unsigned long) st.max_prec,
+                  st.time);
+          exit (1);
+        }
+      /* each function name is given only once */
+      for (j = 0; j < i; j++)
+        {
+          mpfr_ziv_stats_get (&st2, j);
+          if (strcmp (st.name, st2.name) == 0)
+            {
+              printf ("Error, %s given twice by mpfr_ziv_stats_get\n",
+                      st.name);
+              exit (1);
+            }
+        }
+      total += st.calls;
+    }
+  return total;
+}
+
+int
+main (void)
+{
+  mpfr_t x, y;
+  unsigned long i;
+
+  tests_start_mpfr ();
+
+  mpfr_inits2 (200, x, y, (mpfr_ptr) 0);
+  for (i = 1; i <= 50; i++)
+    {
+      mpfr_set_ui (x, i, MPFR_RNDN);
+      mpfr_sqrt (x, x, MPFR_RNDN);
+      mpfr_sin (y, x, MPFR_RNDN);
+      mpfr_atan (y, x, MPFR_RNDN);
+    }
+
+  if (! mpfr_buildopt_zivstats_p ())
+    {
+      mpfr_ziv_stats_t st;
+
+      if (mpfr_ziv_stats_get (&st, 0))
+        {
+          printf ("Error, mpfr_ziv_stats_get without --enable-ziv-stats\n");
+          exit (1);
+        }
+    }
+  else
+    {
+      if (check_stats () < 100)
+        {
+          printf ("Error, the Ziv loops of sin and atan were not counted\n");
+          exit (1);
+        }
+      mpfr_ziv_stats_reset ();
+      if (check_stats () != 0)
+        {
+          printf ("Error, mpfr_ziv_stats_reset did not reset the calls\n");
+          exit (1);
+        }
+      mpfr_atan (y, x, MPFR_RNDN);
+      if (check_stats () == 0)
+        {
+          printf ("Error, the Ziv loops of atan were not counted\n");
+          exit (1);
+        }
+
+      /* mpfr_tanh returns 1 for a huge argument before entering its Ziv
+         loop: this call must not be counted (in particular, its time must
+         not be added to the record of mpfr_tanh, registered by the first
+         call). */
+      mpfr_tanh (y, x, MPFR_RNDN);
+      mpfr_ziv_stats_reset ();
+      mpfr_set_ui_2exp (x, 1, 100, MPFR_RNDN);
+      mpfr_tanh (y, x, MPFR_RNDN);
+      if (mpfr_cmp_ui (y, 1) != 0 || check_stats () != 0)
+        {
+          printf ("Error, mpfr_tanh on a huge argument was counted\n");
+          exit (1);
+        }
+    }
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+
+  tests_end_mpfr ();
+  return 0;
+}
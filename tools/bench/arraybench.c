@@ -0,0 +1,144 @@
+/* arraybench.c -- compare mpfr_array_t with arrays of mpfr_t
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: arraybench [n]
+   For several precisions p, compute c[i] = a[i] + b[i] then
+   c[i] = a[i] * b[i] for 0 <= i < n (n = 100000 by default), first with
+   arrays of n mpfr_t initialized by mpfr_init2 (one allocation per number),
+   then with three mpfr_array_t (one allocation per array), and output the
+   average time per element in nanoseconds of the initialization (mpfr_init2
+   or mpfr_array_init2), of the add and mul loops, and of the clear. All the
+   numbers are set before the add loop, so that the memory pages are already
+   mapped. The results must be identical. */
+
+int
+main (int argc, char *argv[])
+{
+  mpfr_prec_t precs[] = { 53, 113, 256, 1024 };
+  unsigned long n = 100000, i;
+  mpfr_t *a, *b, *c;
+  mpfr_array_t aa, ab, ac;
+  gmp_randstate_t state;
+  double t[2][4], t0;
+  int j, k;
+
+  if (argc > 1)
+    n = strtoul (argv[1], NULL, 10);
+  if (argc > 2 || n == 0)
+    {
+      printf ("Usage: arraybench [n]\n");
+      exit (1);
+    }
+
+  a = (mpfr_t *) malloc (3 * n * sizeof (mpfr_t));
+  if (a == NULL)
+    {
+      printf ("Cannot allocate memory\n");
+      exit (1);
+    }
+  b = a + n;
+  c = b + n;
+  gmp_randinit_default (state);
+
+  printf ("%5s %7s %16s %16s %16s %16s\n", "prec", "", "init (ns)",
+          "add (ns)", "mul (ns)", "clear (ns)");
+  for (j = 0; j < (int) (sizeof (precs) / sizeof (precs[0])); j++)
+    {
+      mpfr_prec_t p = precs[j];
+
+      /* arrays of mpfr_t */
+      t0 = get_walltime ();
+      for (i = 0; i < 3 * n; i++)
+        mpfr_init2 (a[i], p);
+      t[0][0] = get_walltime () - t0;
+      for (i = 0; i < n; i++)
+        {
+          mpfr_urandomb (a[i], state);
+          mpfr_urandomb (b[i], state);
+          mpfr_set (c[i], a[i], MPFR_RNDN);
+        }
+      t0 = get_walltime ();
+      for (i = 0; i < n; i++)
+        mpfr_add (c[i], a[i], b[i], MPFR_RNDN);
+      t[0][1] = get_walltime () - t0;
+      t0 = get_walltime ();
+      for (i = 0; i < n; i++)
+        mpfr_mul (c[i], a[i], b[i], MPFR_RNDN);
+      t[0][2] = get_walltime () - t0;
+
+      /* mpfr_array_t, with the same values */
+      t0 = get_walltime ();
+      mpfr_array_init2 (aa, n, p);
+      mpfr_array_init2 (ab, n, p);
+      mpfr_array_init2 (ac, n, p);
+      t[1][0] = get_walltime () - t0;
+      for (i = 0; i < n; i++)
+        {
+          mpfr_set (mpfr_array_get (aa, i), a[i], MPFR_RNDN);
+          mpfr_set (mpfr_array_get (ab, i), b[i], MPFR_RNDN);
+          mpfr_set (mpfr_array_get (ac, i), a[i], MPFR_RNDN);
+        }
+      t0 = get_walltime ();
+      for (i = 0; i < n; i++)
+        mpfr_add (mpfr_array_get (ac, i), mpfr_array_get (aa, i),
+                  mpfr_array_get (ab, i), MPFR_RNDN);
+      t[1][1] = get_walltime () - t0;
+      t0 = get_walltime ();
+      for (i = 0; i < n; i++)
+        mpfr_mul (mpfr_array_get (ac, i), mpfr_array_get (aa, i),
+                  mpfr_array_get (ab, i), MPFR_RNDN);
+      t[1][2] = get_walltime () - t0;
+
+      for (i = 0; i < n; i++)
+        if (! mpfr_equal_p (c[i], mpfr_array_get (ac, i)))
+          {
+            printf ("Error, different results for prec=%lu\n",
+                    (unsigned long) p);
+            exit (1);
+          }
+
+      t0 = get_walltime ();
+      for (i = 0; i < 3 * n; i++)
+        mpfr_clear (a[i]);
+      t[0][3] = get_walltime () - t0;
+      t0 = get_walltime ();
+      mpfr_array_clear (aa);
+      mpfr_array_clear (ab);
+      mpfr_array_clear (ac);
+      t[1][3] = get_walltime () - t0;
+
+      for (k = 0; k < 2; k++)
+        printf ("%5lu %7s %16.2f %16.2f %16.2f %16.2f\n", (unsigned long) p,
+                k == 0 ? "mpfr_t" : "array", t[k][0] * 1000.0 / (3 * n),
+                t[k][1] * 1000.0 / n, t[k][2] * 1000.0 / n,
+                t[k][3] * 1000.0 / (3 * n));
+    }
+
+  gmp_randclear (state);
+  free (a);
+  return 0;
+}
@@ -1,4 +1,4 @@
-/* benchtime.h -- header file for MPFRbench
+/* benchtime.h -- header file for MPFRbench and the other benchmarks
 
 Copyright 1999, 2001-2015 Free Software Foundation, Inc.
 Contributed by the AriC and Caramel projects, INRIA.
@@ -20,6 +20,20 @@ along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
 http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
 
+#include <sys/time.h>
+
+/* get the elapsed time in microseconds (not used by all the programs) */
+#ifdef __GNUC__
+static double get_walltime (void) __attribute__ ((unused));
+#endif
+static double
+get_walltime (void)
+{
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec * 1000000.0 + tv.tv_usec;
+}
 
 /* compute the time to run accurately niter calls of the function for any
    number of inputs */
@@ -64,7 +78,9 @@ unsigned long int ACCURATE_TIME_NOP##func( unsigned long int niter, int n, mpfr_
  }
 
 /* compute the time to run accurately niter calls of the function */
+/* the calls are done with the rounding mode bench_rnd, which must be
+   defined by the file including this header */
 /* functions with 2 operands */
-#define DECLARE_TIME_2OP(func)   DECLARE_TIME_NOP(func, func(z[kn],x[kn],y[kn], MPFR_RNDN), 2 )
+#define DECLARE_TIME_2OP(func)   DECLARE_TIME_NOP(func, func(z[kn],x[kn],y[kn], bench_rnd), 2 )
 /* functions with 1 operand */
-#define DECLARE_TIME_1OP(func)   DECLARE_TIME_NOP(func, func(z[kn],x[kn], MPFR_RNDN), 1 )
+#define DECLARE_TIME_1OP(func)   DECLARE_TIME_NOP(func, func(z[kn],x[kn], bench_rnd), 1 )
@@ -0,0 +1,153 @@
+/* blockbench.c -- compare mpfr_init_block with mpfr_inits2
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: blockbench [n]
+   For several precisions p, evaluate n times (n = 200000 by default) a
+   routine with 10 temporary variables of precision p (the real and
+   imaginary parts of (a + i b)^2 / (c + i d) + (a + i b) * (c + i d)),
+   the temporaries being initialized by mpfr_inits2 and cleared by
+   mpfr_clears, then initialized by mpfr_init_block and cleared by
+   mpfr_clear_block, and output the average time per call in nanoseconds
+   and the speedup. The results must be identical. */
+
+static void
+compute (mpfr_ptr re, mpfr_ptr im, mpfr_srcptr a, mpfr_srcptr b,
+         mpfr_srcptr c, mpfr_srcptr d, mpfr_t *t)
+{
+  mpfr_sqr (t[0], a, MPFR_RNDN);          /* (a + i b)^2 = t2 + i t3 */
+  mpfr_sqr (t[1], b, MPFR_RNDN);
+  mpfr_sub (t[2], t[0], t[1], MPFR_RNDN);
+  mpfr_mul (t[3], a, b, MPFR_RNDN);
+  mpfr_mul_2ui (t[3], t[3], 1, MPFR_RNDN);
+  mpfr_sqr (t[4], c, MPFR_RNDN);          /* |c + i d|^2 = t4 */
+  mpfr_fma (t[4], d, d, t[4], MPFR_RNDN);
+  mpfr_mul (t[5], t[2], c, MPFR_RNDN);    /* (t2 + i t3) (c - i d) */
+  mpfr_fma (t[5], t[3], d, t[5], MPFR_RNDN);
+  mpfr_mul (t[6], t[3], c, MPFR_RNDN);
+  mpfr_fms (t[6], t[2], d, t[6], MPFR_RNDN);
+  mpfr_neg (t[6], t[6], MPFR_RNDN);
+  mpfr_div (t[5], t[5], t[4], MPFR_RNDN);
+  mpfr_div (t[6], t[6], t[4], MPFR_RNDN);
+  mpfr_mul (t[7], a, c, MPFR_RNDN);       /* (a + i b) (c + i d) */
+  mpfr_mul (t[8], b, d, MPFR_RNDN);
+  mpfr_sub (t[7], t[7], t[8], MPFR_RNDN);
+  mpfr_mul (t[9], a, d, MPFR_RNDN);
+  mpfr_fma (t[9], b, c, t[9], MPFR_RNDN);
+  mpfr_add (re, t[5], t[7], MPFR_RNDN);
+  mpfr_add (im, t[6], t[9], MPFR_RNDN);
+}
+
+static void
+f_inits2 (mpfr_ptr re, mpfr_ptr im, mpfr_srcptr a, mpfr_srcptr b,
+          mpfr_srcptr c, mpfr_srcptr d)
+{
+  mpfr_t t[10];
+
+  mpfr_inits2 (mpfr_get_prec (re), t[0], t[1], t[2], t[3], t[4], t[5], t[6],
+               t[7], t[8], t[9], (mpfr_ptr) 0);
+  compute (re, im, a, b, c, d, t);
+  mpfr_clears (t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7], t[8], t[9],
+               (mpfr_ptr) 0);
+}
+
+static void
+f_block (mpfr_ptr re, mpfr_ptr im, mpfr_srcptr a, mpfr_srcptr b,
+         mpfr_srcptr c, mpfr_srcptr d)
+{
+  mpfr_block_t bl;
+  mpfr_t t[10];
+
+  mpfr_init_block (bl, mpfr_get_prec (re), t[0], t[1], t[2], t[3], t[4],
+                   t[5], t[6], t[7], t[8], t[9], (mpfr_ptr) 0);
+  compute (re, im, a, b, c, d, t);
+  mpfr_clear_block (bl, t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7],
+                    t[8], t[9], (mpfr_ptr) 0);
+}
+
+int
+main (int argc, char *argv[])
+{
+  mpfr_prec_t precs[] = { 53, 113, 256, 1024, 4096 };
+  unsigned long n = 200000, i;
+  mpfr_t a, b, c, d, re1, im1, re2, im2;
+  gmp_randstate_t state;
+  double t0, t1;
+  int j;
+
+  if (argc > 1)
+    n = strtoul (argv[1], NULL, 10);
+  if (argc > 2 || n == 0)
+    {
+      printf ("Usage: blockbench [n]\n");
+      exit (1);
+    }
+
+  mpfr_inits (a, b, c, d, re1, im1, re2, im2, (mpfr_ptr) 0);
+  gmp_randinit_default (state);
+
+  printf ("%5s %12s %12s %8s\n", "prec", "inits2 (ns)", "block (ns)",
+          "speedup");
+  for (j = 0; j < (int) (sizeof (precs) / sizeof (precs[0])); j++)
+    {
+      mpfr_prec_t p = precs[j];
+
+      mpfr_set_prec (a, p);
+      mpfr_set_prec (b, p);
+      mpfr_set_prec (c, p);
+      mpfr_set_prec (d, p);
+      mpfr_set_prec (re1, p);
+      mpfr_set_prec (im1, p);
+      mpfr_set_prec (re2, p);
+      mpfr_set_prec (im2, p);
+      mpfr_urandomb (a, state);
+      mpfr_urandomb (b, state);
+      mpfr_urandomb (c, state);
+      mpfr_urandomb (d, state);
+
+      t0 = get_walltime ();
+      for (i = 0; i < n; i++)
+        f_inits2 (re1, im1, a, b, c, d);
+      t0 = get_walltime () - t0;
+      t1 = get_walltime ();
+      for (i = 0; i < n; i++)
+        f_block (re2, im2, a, b, c, d);
+      t1 = get_walltime () - t1;
+
+      if (! mpfr_equal_p (re1, re2) || ! mpfr_equal_p (im1, im2))
+        {
+          printf ("Error, different results for prec=%lu\n",
+                  (unsigned long) p);
+          exit (1);
+        }
+      printf ("%5lu %12.2f %12.2f %8.2f\n", (unsigned long) p,
+              t0 * 1000.0 / n, t1 * 1000.0 / n, t0 / t1);
+    }
+
+  gmp_randclear (state);
+  mpfr_clears (a, b, c, d, re1, im1, re2, im2, (mpfr_ptr) 0);
+  return 0;
+}
@@ -0,0 +1,118 @@
+/* constbench.c -- cost of the constants when the precision increases
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#ifdef HAVE_GETRUSAGE
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+#include "mpfr.h"
+
+/* Usage: constbench [pmax]
+   For each constant (log(2), pi, Euler, Catalan), compare the time of a
+   single computation at precision pmax (10^6 by default, 10^5 for Euler
+   and Catalan) with the total time of the computations at precision
+   pmax/2^k, ..., pmax/4, pmax/2, pmax (repeated precision doubling from
+   1000 bits), and at precision increasing by 20% steps from 1000 bits,
+   as done by a program that increases its working precision. The cache
+   is freed before each of these three computations. */
+
+/* get the time in microseconds */
+static unsigned long
+get_cputime (void)
+{
+#ifdef HAVE_GETRUSAGE
+  struct rusage ru;
+
+  getrusage (RUSAGE_SELF, &ru);
+  return ru.ru_utime.tv_sec * 1000000 + ru.ru_utime.tv_usec
+       + ru.ru_stime.tv_sec * 1000000 + ru.ru_stime.tv_usec;
+#else
+  printf ("\nError, the function getrusage is not available\n");
+  exit (1);
+  return 0;
+#endif
+}
+
+/* Time of the computations of f at precision p0, p0*num/den, ..., pmax,
+   starting with an empty cache. */
+static unsigned long
+ramp (int (*f) (mpfr_ptr, mpfr_rnd_t), mpfr_prec_t p0, mpfr_prec_t pmax,
+      int num, int den)
+{
+  mpfr_t x;
+  mpfr_prec_t p;
+  unsigned long t;
+
+  mpfr_free_cache ();
+  mpfr_init2 (x, pmax);
+  t = get_cputime ();
+  for (p = p0; p < pmax; p = p * num / den)
+    {
+      mpfr_set_prec (x, p);
+      f (x, MPFR_RNDN);
+    }
+  mpfr_set_prec (x, pmax);
+  f (x, MPFR_RNDN);
+  t = get_cputime () - t;
+  mpfr_clear (x);
+  return t;
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const char *name[] = { "log(2)", "pi", "Euler", "Catalan" };
+  int (*f[]) (mpfr_ptr, mpfr_rnd_t) =
+    { mpfr_const_log2, mpfr_const_pi, mpfr_const_euler, mpfr_const_catalan };
+  mpfr_prec_t pmax = 1000000;
+  int i;
+
+  if (argc > 1)
+    pmax = atol (argv[1]);
+  if (argc > 2 || pmax < 1000)
+    {
+      printf ("Usage: constbench [pmax]\n");
+      exit (1);
+    }
+
+  printf ("time in milliseconds\n");
+  printf ("%-8s %10s %10s %10s %10s\n", "constant", "prec", "single",
+          "doubling", "+20%");
+  for (i = 0; i < 4; i++)
+    {
+      mpfr_prec_t p = i < 2 ? pmax : pmax / 10;
+      unsigned long t1, t2, t3;
+
+      if (p < 1000)
+        p = 1000;
+      t1 = ramp (f[i], p, p, 2, 1);
+      t2 = ramp (f[i], 1000, p, 2, 1);
+      t3 = ramp (f[i], 1000, p, 6, 5);
+      printf ("%-8s %10lu %10.1f %10.1f %10.1f\n", name[i], (unsigned long) p,
+              t1 / 1000.0, t2 / 1000.0, t3 / 1000.0);
+    }
+  mpfr_free_cache ();
+  return 0;
+}
@@ -0,0 +1,99 @@
+/* constmtbench.c -- thread scaling of the computation of the constants
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: constmtbench [nthreads [prec]]
+   For each constant computed by binary splitting (log(2), Euler, Catalan),
+   compute it at precision prec (10^7 by default) in the serial mode, then
+   in the threaded mode with 2, 4, 8, ..., nthreads threads (8 by default,
+   see mpfr_set_nthreads), and output the elapsed (wall-clock) time in
+   milliseconds and the speedup compared to the serial mode. The cache is
+   freed before each computation, and the results must be identical.
+   Note: MPFR must have been configured with --enable-parallel, otherwise
+   all the tasks are run in a single thread. At 10^7 bits, Euler's
+   constant takes a few minutes in the serial mode. */
+
+static double
+timing (int (*f) (mpfr_ptr, mpfr_rnd_t), mpfr_ptr y, unsigned int nthreads)
+{
+  double t;
+
+  mpfr_free_cache ();
+  mpfr_set_nthreads (nthreads);
+  t = get_walltime ();
+  f (y, MPFR_RNDN);
+  t = get_walltime () - t;
+  mpfr_set_nthreads (1);
+  return t;
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const char *name[] = { "log(2)", "Euler", "Catalan" };
+  int (*f[]) (mpfr_ptr, mpfr_rnd_t) =
+    { mpfr_const_log2, mpfr_const_euler, mpfr_const_catalan };
+  unsigned int nthreads = 8, k;
+  mpfr_prec_t prec = 10000000;
+  mpfr_t y0, y;
+  double t0, t;
+  int i;
+
+  if (argc > 1)
+    nthreads = atoi (argv[1]);
+  if (argc > 2)
+    prec = atol (argv[2]);
+  if (argc > 3 || nthreads < 1 || prec < MPFR_PREC_MIN)
+    {
+      printf ("Usage: constmtbench [nthreads [prec]]\n");
+      exit (1);
+    }
+
+  mpfr_inits2 (prec, y0, y, (mpfr_ptr) 0);
+  printf ("precision %lu\n", (unsigned long) prec);
+  printf ("%-8s %8s %12s %8s\n", "constant", "threads", "time (ms)",
+          "speedup");
+  for (i = 0; i < 3; i++)
+    {
+      t0 = timing (f[i], y0, 1);
+      printf ("%-8s %8u %12.2f %8.2f\n", name[i], 1, t0 / 1000.0, 1.0);
+      for (k = 2; k <= nthreads; k *= 2)
+        {
+          t = timing (f[i], y, k);
+          if (! mpfr_equal_p (y0, y))
+            {
+              printf ("Error, different results for %s with %u threads\n",
+                      name[i], k);
+              exit (1);
+            }
+          printf ("%-8s %8u %12.2f %8.2f\n", name[i], k, t / 1000.0,
+                  t0 / t);
+        }
+    }
+  mpfr_clears (y0, y, (mpfr_ptr) 0);
+  mpfr_free_cache ();
+  return 0;
+}
@@ -0,0 +1,112 @@
+/* divbench.c -- compare mpfr_div_pre with mpfr_div for a fixed divisor
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: divbench [n]
+   For several precisions p, divide n random numbers (n = 10000 by
+   default) by the same random divisor, all of precision p, with mpfr_div
+   and with mpfr_div_pre (in place), and output the average time per
+   division in microseconds (including mpfr_divisor_init for mpfr_div_pre)
+   and the speedup. The results and the ternary values must be identical. */
+
+int
+main (int argc, char *argv[])
+{
+  mpfr_prec_t precs[] = { 24, 53, 113, 256, 512, 1024, 2048, 4096, 10000,
+                          30000 };
+  unsigned long n = 10000, i;
+  mpfr_t *u, *q, v;
+  mpfr_divisor_t d;
+  int *inex;
+  gmp_randstate_t state;
+  double t0, t1;
+  int k;
+
+  if (argc > 1)
+    n = strtoul (argv[1], NULL, 10);
+  if (argc > 2 || n == 0)
+    {
+      printf ("Usage: divbench [n]\n");
+      exit (1);
+    }
+
+  u = (mpfr_t *) malloc (2 * n * sizeof (mpfr_t));
+  inex = (int *) malloc (2 * n * sizeof (int));
+  if (u == NULL || inex == NULL)
+    {
+      printf ("Cannot allocate memory\n");
+      exit (1);
+    }
+  q = u + n;
+  for (i = 0; i < 2 * n; i++)
+    mpfr_init (u[i]);
+  mpfr_init (v);
+  gmp_randinit_default (state);
+
+  printf ("%6s %12s %12s %8s\n", "prec", "div (us)", "div_pre (us)",
+          "speedup");
+  for (k = 0; k < (int) (sizeof (precs) / sizeof (precs[0])); k++)
+    {
+      for (i = 0; i < 2 * n; i++)
+        mpfr_set_prec (u[i], precs[k]);
+      mpfr_set_prec (v, precs[k]);
+      for (i = 0; i < n; i++)
+        mpfr_urandomb (u[i], state);
+      mpfr_urandomb (v, state);
+
+      t0 = get_walltime ();
+      for (i = 0; i < n; i++)
+        inex[i] = mpfr_div (q[i], u[i], v, MPFR_RNDN);
+      t0 = (get_walltime () - t0) / n;
+
+      t1 = get_walltime ();
+      mpfr_divisor_init (d, v);
+      for (i = 0; i < n; i++)
+        inex[n + i] = mpfr_div_pre (u[i], u[i], d, MPFR_RNDN);
+      mpfr_divisor_clear (d);
+      t1 = (get_walltime () - t1) / n;
+
+      for (i = 0; i < n; i++)
+        if (! mpfr_equal_p (u[i], q[i]) || (inex[i] > 0) != (inex[n + i] > 0)
+            || (inex[i] < 0) != (inex[n + i] < 0))
+          {
+            printf ("Error, different results for prec=%lu\n",
+                    (unsigned long) precs[k]);
+            exit (1);
+          }
+
+      printf ("%6lu %12.3f %12.3f %8.2f\n", (unsigned long) precs[k], t0, t1,
+              t0 / t1);
+    }
+
+  gmp_randclear (state);
+  mpfr_clear (v);
+  for (i = 0; i < 2 * n; i++)
+    mpfr_clear (u[i]);
+  free (inex);
+  free (u);
+  return 0;
+}
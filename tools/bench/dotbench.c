@@ -0,0 +1,181 @@
+/* dotbench.c -- compare mpfr_dot with mpfr_mul + mpfr_sum
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#ifdef HAVE_GETRUSAGE
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+#include "mpfr.h"
+
+/* Usage: dotbench [prec]
+   For n = 10, 100, ..., 10^6, compute the dot product of two arrays of n
+   random numbers of prec bits (53 by default) with mpfr_dot, and with the
+   exact products (mpfr_mul in 2*prec bits) followed by mpfr_sum, which is
+   the usual way to get a correctly rounded dot product without mpfr_dot.
+   Each computation is repeated so that about 10^6 products are done, and
+   the time per product is output. */
+
+/* get the time in microseconds */
+static unsigned long
+get_cputime (void)
+{
+#ifdef HAVE_GETRUSAGE
+  struct rusage ru;
+
+  getrusage (RUSAGE_SELF, &ru);
+  return ru.ru_utime.tv_sec * 1000000 + ru.ru_utime.tv_usec
+       + ru.ru_stime.tv_sec * 1000000 + ru.ru_stime.tv_usec;
+#else
+  printf ("\nError, the function getrusage is not available\n");
+  exit (1);
+  return 0;
+#endif
+}
+
+static mpfr_ptr *
+random_array (unsigned long n, mpfr_prec_t prec, gmp_randstate_t state)
+{
+  mpfr_ptr *p;
+  unsigned long i;
+
+  p = (mpfr_ptr *) malloc (n * sizeof (mpfr_ptr));
+  if (p == NULL)
+    {
+      printf ("Can't allocate memory for %lu numbers\n", n);
+      exit (1);
+    }
+  for (i = 0; i < n; i++)
+    {
+      p[i] = (mpfr_ptr) malloc (sizeof (mpfr_t));
+      if (p[i] == NULL)
+        {
+          printf ("Can't allocate memory for %lu numbers\n", n);
+          exit (1);
+        }
+      mpfr_init2 (p[i], prec);
+      mpfr_urandomb (p[i], state);
+      if (gmp_urandomb_ui (state, 1))
+        mpfr_neg (p[i], p[i], MPFR_RNDN);
+    }
+  return p;
+}
+
+static void
+clear_array (mpfr_ptr *p, unsigned long n)
+{
+  unsigned long i;
+
+  for (i = 0; i < n; i++)
+    {
+      mpfr_clear (p[i]);
+      free (p[i]);
+    }
+  free (p);
+}
+
+/* the dot product without mpfr_dot: the products are stored in n new
+   variables of 2*prec bits */
+static int
+mul_sum (mpfr_ptr r, mpfr_ptr *x, mpfr_ptr *y, unsigned long n)
+{
+  mpfr_t *z;
+  mpfr_ptr *p;
+  unsigned long i;
+  int inex;
+
+  z = (mpfr_t *) malloc (n * sizeof (mpfr_t));
+  p = (mpfr_ptr *) malloc (n * sizeof (mpfr_ptr));
+  if (z == NULL || p == NULL)
+    {
+      printf ("Can't allocate memory for %lu numbers\n", n);
+      exit (1);
+    }
+  for (i = 0; i < n; i++)
+    {
+      mpfr_init2 (z[i], mpfr_get_prec (x[i]) + mpfr_get_prec (y[i]));
+      mpfr_mul (z[i], x[i], y[i], MPFR_RNDN);  /* exact */
+      p[i] = z[i];
+    }
+  inex = mpfr_sum (r, p, n, MPFR_RNDN);
+  for (i = 0; i < n; i++)
+    mpfr_clear (z[i]);
+  free (z);
+  free (p);
+  return inex;
+}
+
+int
+main (int argc, char *argv[])
+{
+  gmp_randstate_t state;
+  mpfr_prec_t prec = 53;
+  unsigned long n;
+
+  if (argc > 1)
+    prec = atol (argv[1]);
+  if (argc > 2 || prec < MPFR_PREC_MIN)
+    {
+      printf ("Usage: dotbench [prec]\n");
+      exit (1);
+    }
+
+  gmp_randinit_default (state);
+  printf ("precision %lu, time per product in nanoseconds\n",
+          (unsigned long) prec);
+  printf ("%8s %12s %12s\n", "n", "mul+sum", "mpfr_dot");
+  for (n = 10; n <= 1000000; n *= 10)
+    {
+      mpfr_ptr *x, *y;
+      mpfr_t r1, r2;
+      unsigned long i, niter, t1, t2;
+
+      x = random_array (n, prec, state);
+      y = random_array (n, prec, state);
+      mpfr_inits2 (prec, r1, r2, (mpfr_ptr) 0);
+      niter = 1 + 1000000 / n;
+
+      t1 = get_cputime ();
+      for (i = 0; i < niter; i++)
+        mul_sum (r1, x, y, n);
+      t1 = get_cputime () - t1;
+
+      t2 = get_cputime ();
+      for (i = 0; i < niter; i++)
+        mpfr_dot (r2, x, y, n, MPFR_RNDN);
+      t2 = get_cputime () - t2;
+
+      if (! mpfr_equal_p (r1, r2))
+        {
+          printf ("Error, different results for n = %lu\n", n);
+          exit (1);
+        }
+      printf ("%8lu %12.2f %12.2f\n", n, 1000.0 * t1 / (niter * n),
+              1000.0 * t2 / (niter * n));
+      mpfr_clears (r1, r2, (mpfr_ptr) 0);
+      clear_array (x, n);
+      clear_array (y, n);
+    }
+  gmp_randclear (state);
+  return 0;
+}
@@ -0,0 +1,90 @@
+/* expbench.c -- compare the serial and threaded modes of mpfr_exp
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: expbench [nthreads [pmax]]
+   For prec = 10^5, 10^6, ..., pmax (10^8 by default), compute exp(x) for
+   a random x in [0,1) of prec bits, in the serial mode, then in the
+   threaded mode with 2, 3, ..., nthreads threads (4 by default, see
+   mpfr_set_nthreads), and output the elapsed (wall-clock) time in
+   milliseconds and the speedup compared to the serial mode. The results
+   must be identical. Note: MPFR must have been configured with
+   --enable-parallel, otherwise all the tasks are run in a single thread.
+   At 10^8 bits, each computation takes several minutes. */
+
+int
+main (int argc, char *argv[])
+{
+  gmp_randstate_t state;
+  unsigned int nthreads = 4, k;
+  mpfr_prec_t prec, pmax = 100000000;
+  mpfr_t x, y0, y;
+  double t0, t;
+
+  if (argc > 1)
+    nthreads = atoi (argv[1]);
+  if (argc > 2)
+    pmax = atol (argv[2]);
+  if (argc > 3 || nthreads < 1 || pmax < MPFR_PREC_MIN)
+    {
+      printf ("Usage: expbench [nthreads [pmax]]\n");
+      exit (1);
+    }
+
+  gmp_randinit_default (state);
+  printf ("%10s %8s %12s %8s\n", "prec", "threads", "time (ms)", "speedup");
+  for (prec = 100000; prec <= pmax; prec *= 10)
+    {
+      mpfr_inits2 (prec, x, y0, y, (mpfr_ptr) 0);
+      mpfr_urandomb (x, state);
+
+      mpfr_set_nthreads (1);
+      t0 = get_walltime ();
+      mpfr_exp (y0, x, MPFR_RNDN);
+      t0 = get_walltime () - t0;
+      printf ("%10lu %8u %12.2f %8.2f\n", (unsigned long) prec, 1,
+              t0 / 1000.0, 1.0);
+
+      for (k = 2; k <= nthreads; k++)
+        {
+          mpfr_set_nthreads (k);
+          t = get_walltime ();
+          mpfr_exp (y, x, MPFR_RNDN);
+          t = get_walltime () - t;
+          if (! mpfr_equal_p (y0, y))
+            {
+              printf ("Error, different results with %u threads\n", k);
+              exit (1);
+            }
+          printf ("%10lu %8u %12.2f %8.2f\n", (unsigned long) prec, k,
+                  t / 1000.0, t0 / t);
+        }
+      mpfr_clears (x, y0, y, (mpfr_ptr) 0);
+    }
+  mpfr_set_nthreads (1);
+  gmp_randclear (state);
+  return 0;
+}
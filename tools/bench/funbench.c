@@ -0,0 +1,139 @@
+/* funbench.c -- compare mpfr_exp_n, mpfr_log_n, mpfr_sin_n and mpfr_cos_n
+   with loops of scalar calls
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: funbench [n [nthreads]]
+   For prec = 53, 113, 256, 1000 and each function, evaluate the function
+   on an array of n random numbers in [-4,4] (in (0,8] for log), n = 10000
+   by default, with a loop of scalar calls and with the array function
+   (in the calling thread, then with nthreads threads, 4 by default), and
+   output the average time per element in microseconds and the speedups.
+   The results must be identical. */
+
+typedef int (*fun_n_t) (mpfr_ptr *, mpfr_ptr *const, unsigned long,
+                        mpfr_rnd_t, int *);
+typedef int (*fun_t) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+
+int
+main (int argc, char *argv[])
+{
+  const char *names[] = { "exp", "log", "sin", "cos" };
+  fun_n_t funs_n[] = { mpfr_exp_n, mpfr_log_n, mpfr_sin_n, mpfr_cos_n };
+  fun_t funs[] = { mpfr_exp, mpfr_log, mpfr_sin, mpfr_cos };
+  mpfr_prec_t precs[] = { 53, 113, 256, 1000 };
+  unsigned long n = 10000, i;
+  unsigned int nthreads = 4;
+  mpfr_t *t;
+  mpfr_ptr *x, *y, *z;
+  gmp_randstate_t state;
+  double t0, t1, t2;
+  int f, k;
+
+  if (argc > 1)
+    n = strtoul (argv[1], NULL, 10);
+  if (argc > 2)
+    nthreads = (unsigned int) strtoul (argv[2], NULL, 10);
+  if (argc > 3 || n == 0)
+    {
+      printf ("Usage: funbench [n [nthreads]]\n");
+      exit (1);
+    }
+
+  t = (mpfr_t *) malloc (3 * n * sizeof (mpfr_t));
+  x = (mpfr_ptr *) malloc (3 * n * sizeof (mpfr_ptr));
+  if (t == NULL || x == NULL)
+    {
+      printf ("Cannot allocate memory\n");
+      exit (1);
+    }
+  y = x + n;
+  z = y + n;
+  for (i = 0; i < 3 * n; i++)
+    {
+      mpfr_init (t[i]);
+      x[i] = t[i];
+    }
+  gmp_randinit_default (state);
+
+  printf ("%6s %4s %12s %12s %8s %12s %8s\n", "prec", "fun", "scalar (us)",
+          "_n (us)", "speedup", "_n mt (us)", "speedup");
+  for (k = 0; k < (int) (sizeof (precs) / sizeof (precs[0])); k++)
+    {
+      for (i = 0; i < 3 * n; i++)
+        mpfr_set_prec (t[i], precs[k]);
+      for (f = 0; f < 4; f++)
+        {
+          for (i = 0; i < n; i++)
+            {
+              mpfr_urandomb (x[i], state);
+              mpfr_mul_2ui (x[i], x[i], 3, MPFR_RNDN);
+              if (f == 1)
+                mpfr_nextabove (x[i]);
+              else
+                mpfr_sub_ui (x[i], x[i], 4, MPFR_RNDN);
+            }
+          /* fill the tables and the caches of the constants */
+          funs[f] (z[0], x[0], MPFR_RNDN);
+
+          t0 = get_walltime ();
+          for (i = 0; i < n; i++)
+            funs[f] (z[i], x[i], MPFR_RNDN);
+          t0 = (get_walltime () - t0) / n;
+          t1 = get_walltime ();
+          funs_n[f] (y, x, n, MPFR_RNDN, NULL);
+          t1 = (get_walltime () - t1) / n;
+          for (i = 0; i < n; i++)
+            if (! mpfr_equal_p (y[i], z[i]))
+              {
+                printf ("Error, different results for %s\n", names[f]);
+                exit (1);
+              }
+          mpfr_set_nthreads (nthreads);
+          t2 = get_walltime ();
+          funs_n[f] (y, x, n, MPFR_RNDN, NULL);
+          t2 = (get_walltime () - t2) / n;
+          mpfr_set_nthreads (1);
+          for (i = 0; i < n; i++)
+            if (! mpfr_equal_p (y[i], z[i]))
+              {
+                printf ("Error, different results for %s (threads)\n",
+                        names[f]);
+                exit (1);
+              }
+          printf ("%6lu %4s %12.3f %12.3f %8.2f %12.3f %8.2f\n",
+                  (unsigned long) precs[k], names[f], t0, t1, t0 / t1, t2,
+                  t0 / t2);
+        }
+    }
+
+  gmp_randclear (state);
+  for (i = 0; i < 3 * n; i++)
+    mpfr_clear (t[i]);
+  free (x);
+  free (t);
+  return 0;
+}
@@ -0,0 +1,122 @@
+/* inlinebench.c -- compare inline significands with mpfr_init2
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: inlinebench [n]
+   For several precisions p, evaluate n times (n = 1000000 by default) the
+   function f below, which computes a*b + a/b with two temporary variables
+   of precision p, first initialized by mpfr_init2, then declared by
+   MPFR_DECL_SMALL, and output the average time per call in nanoseconds and
+   the speedup. The results must be identical. */
+
+#define PMAX 256
+
+static void
+f_heap (mpfr_ptr y, mpfr_srcptr a, mpfr_srcptr b)
+{
+  mpfr_t s, t;
+
+  mpfr_init2 (s, mpfr_get_prec (y));
+  mpfr_init2 (t, mpfr_get_prec (y));
+  mpfr_mul (s, a, b, MPFR_RNDN);
+  mpfr_div (t, a, b, MPFR_RNDN);
+  mpfr_add (y, s, t, MPFR_RNDN);
+  mpfr_clear (s);
+  mpfr_clear (t);
+}
+
+static void
+f_inline (mpfr_ptr y, mpfr_srcptr a, mpfr_srcptr b)
+{
+  MPFR_DECL_SMALL (s, PMAX);
+  MPFR_DECL_SMALL (t, PMAX);
+
+  mpfr_small_init2 (s, mpfr_get_prec (y));
+  mpfr_small_init2 (t, mpfr_get_prec (y));
+  mpfr_mul (s, a, b, MPFR_RNDN);
+  mpfr_div (t, a, b, MPFR_RNDN);
+  mpfr_add (y, s, t, MPFR_RNDN);
+  mpfr_clear (s);
+  mpfr_clear (t);
+}
+
+int
+main (int argc, char *argv[])
+{
+  mpfr_prec_t precs[] = { 53, 113, 128, 192, 256 };
+  unsigned long n = 1000000, i;
+  mpfr_t a, b, y, z;
+  gmp_randstate_t state;
+  double t0, t1;
+  int j;
+
+  if (argc > 1)
+    n = strtoul (argv[1], NULL, 10);
+  if (argc > 2 || n == 0)
+    {
+      printf ("Usage: inlinebench [n]\n");
+      exit (1);
+    }
+
+  mpfr_inits2 (PMAX, a, b, y, z, (mpfr_ptr) 0);
+  gmp_randinit_default (state);
+
+  printf ("%5s %12s %12s %8s\n", "prec", "init2 (ns)", "inline (ns)",
+          "speedup");
+  for (j = 0; j < (int) (sizeof (precs) / sizeof (precs[0])); j++)
+    {
+      mpfr_prec_t p = precs[j];
+
+      mpfr_set_prec (a, p);
+      mpfr_set_prec (b, p);
+      mpfr_set_prec (y, p);
+      mpfr_set_prec (z, p);
+      mpfr_urandomb (a, state);
+      mpfr_urandomb (b, state);
+
+      t0 = get_walltime ();
+      for (i = 0; i < n; i++)
+        f_heap (y, a, b);
+      t0 = get_walltime () - t0;
+      t1 = get_walltime ();
+      for (i = 0; i < n; i++)
+        f_inline (z, a, b);
+      t1 = get_walltime () - t1;
+
+      if (! mpfr_equal_p (y, z))
+        {
+          printf ("Error, different results for prec=%lu\n",
+                  (unsigned long) p);
+          exit (1);
+        }
+      printf ("%5lu %12.2f %12.2f %8.2f\n", (unsigned long) p,
+              t0 * 1000.0 / n, t1 * 1000.0 / n, t0 / t1);
+    }
+
+  gmp_randclear (state);
+  mpfr_clears (a, b, y, z, (mpfr_ptr) 0);
+  return 0;
+}
@@ -0,0 +1,92 @@
+/* logbench.c -- compare mpfr_log_ui with mpfr_log
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: logbench [pmax]
+   For prec = 100, 300, 1000, ..., pmax (10^5 by default), compute log(n)
+   for several unsigned long values of n, with mpfr_log_ui and with
+   mpfr_set_ui followed by mpfr_log, and output the average time of each
+   one in microseconds, and the speedup of mpfr_log_ui. The results must
+   be identical. Each pair of consecutive calls uses n and n+2, so that
+   no result is served twice. */
+
+int
+main (int argc, char *argv[])
+{
+  unsigned long n[] = { 3, 1000001, 1099511628801UL /* 2^40+2^10+1 */,
+                        0, /* ULONG_MAX-58 */
+                        1UL << 20 };
+  mpfr_prec_t prec, pmax = 100000;
+  mpfr_t x, y0, y;
+  double t0, t;
+  int i, j, iter, step;
+
+  n[3] = (unsigned long) -59;
+  if (argc > 1)
+    pmax = atol (argv[1]);
+  if (argc > 2 || pmax < MPFR_PREC_MIN)
+    {
+      printf ("Usage: logbench [pmax]\n");
+      exit (1);
+    }
+
+  printf ("%8s %20s %12s %12s %8s\n", "prec", "n", "log_ui (us)",
+          "log (us)", "speedup");
+  for (prec = 100, step = 0; prec <= pmax;
+       prec = (step++ & 1) ? prec * 10 / 3 : prec * 3)
+    {
+      mpfr_inits2 (prec, y0, y, (mpfr_ptr) 0);
+      mpfr_init2 (x, sizeof (unsigned long) * 8);
+      iter = prec < 10000 ? 1000 : 10;
+      for (i = 0; i < (int) (sizeof (n) / sizeof (n[0])); i++)
+        {
+          /* fill the caches of the constants */
+          mpfr_log_ui (y, n[i], MPFR_RNDN);
+          mpfr_set_ui (x, n[i], MPFR_RNDN);
+          mpfr_log (y0, x, MPFR_RNDN);
+          t = get_walltime ();
+          for (j = 0; j < iter; j++)
+            mpfr_log_ui (y, n[i] + 2 * (j & 1), MPFR_RNDN);
+          t = (get_walltime () - t) / iter;
+          t0 = get_walltime ();
+          for (j = 0; j < iter; j++)
+            {
+              mpfr_set_ui (x, n[i] + 2 * (j & 1), MPFR_RNDN);
+              mpfr_log (y0, x, MPFR_RNDN);
+            }
+          t0 = (get_walltime () - t0) / iter;
+          if (! mpfr_equal_p (y0, y))
+            {
+              printf ("Error, different results for n = %lu\n", n[i]);
+              exit (1);
+            }
+          printf ("%8lu %20lu %12.2f %12.2f %8.2f\n", (unsigned long) prec,
+                  n[i], t, t0, t0 / t);
+        }
+      mpfr_clears (x, y0, y, (mpfr_ptr) 0);
+    }
+  return 0;
+}
@@ -22,11 +22,18 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #ifdef HAVE_GETRUSAGE
 #include <sys/time.h>
 #include <sys/resource.h>
 #endif
 #include "mpfr.h"
+
+/* rounding mode used for all the timed calls: MPFR_RNDN by default,
+   MPFR_RNDF with the -f option, to compare faithful rounding with
+   correct rounding */
+static mpfr_rnd_t bench_rnd = MPFR_RNDN;
+
 #include "benchtime.h"
 
 static unsigned long get_cputime (void);
@@ -249,14 +256,66 @@ compute_globalscore (mpz_t globalscore, int countop, mpz_t zscore[])
   mpz_root (globalscore, globalscore, countop);
 }
 
+/* print the statistics on the Ziv loops (MPFR built with
+   --enable-ziv-stats): for each function, the number of calls, the
+   percentage of calls needing several iterations, the maximum working
+   precision, the time and the histogram of the number of iterations */
+static void
+print_ziv_stats (void)
+{
+  mpfr_ziv_stats_t st;
+  unsigned long i;
+  int k;
+
+  if (! mpfr_buildopt_zivstats_p ())
+    {
+      printf ("MPFR was built without --enable-ziv-stats\n");
+      return;
+    }
+  printf ("%-24s %10s %7s %9s %9s  %s\n", "Ziv loops of", "calls",
+          "retry%", "max prec", "time (s)", "iterations 1, 2, ..., >=8");
+  for (i = 0; mpfr_ziv_stats_get (&st, i); i++)
+    {
+      if (st.calls == 0)
+        continue;
+      printf ("%-24s %10lu %7.3f %9lu %9.3f  ", st.name, st.calls,
+              100.0 * (st.calls - st.iter[0]) / st.calls,
+              (unsigned long) st.max_prec, st.time);
+      for (k = 0; k < MPFR_ZIV_STATS_BINS; k++)
+        printf (k == 0 ? "%lu" : ",%lu", st.iter[k]);
+      printf ("\n");
+    }
+}
+
+static void
+usage (void)
+{
+  printf ("Usage: mpfrbench [-f] [-z]\n");
+  printf ("  -f  use faithful rounding (MPFR_RNDF) instead of MPFR_RNDN\n");
+  printf ("  -z  print the statistics on the Ziv loops (needs MPFR built\n"
+          "      with --enable-ziv-stats)\n");
+  exit (1);
+}
+
 int
-main (void)
+main (int argc, char *argv[])
 {
   int i;
   enum egroupfunc group;
   mpz_t score[NB_BENCH_OP];
   mpz_t globalscore, groupscore[egroup_last];
   gmp_randstate_t randstate;
+  int ziv_stats = 0;
+
+  for (i = 1; i < argc; i++)
+    {
+      if (strcmp (argv[i], "-f") == 0)
+        bench_rnd = MPFR_RNDF;
+      else if (strcmp (argv[i], "-z") == 0)
+        ziv_stats = 1;
+      else
+        usage ();
+    }
 
   gmp_randinit_default (randstate);
 
@@ -275,6 +334,7 @@ main (void)
 #ifdef __GMP_CFLAGS
   printf ("GMP flags    : %s\n", __GMP_CFLAGS);
 #endif
+  printf ("Rounding mode: %s\n", mpfr_print_rnd_mode (bench_rnd));
   printf ("\n\n");
 
   for (i = 0; i < NB_BENCH_OP; i++)
@@ -294,6 +354,9 @@ main (void)
   mpz_div_ui (globalscore, globalscore, 132);
   gmp_printf ("global score : %12Zd\n\n", globalscore);
 
+  if (ziv_stats)
+    print_ziv_stats ();
+
   for (i = 0; i < NB_BENCH_OP; i++)
     {
       mpz_clear (score[i]);
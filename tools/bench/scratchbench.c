@@ -0,0 +1,127 @@
+/* scratchbench.c -- compare the scratch arena with the memory functions
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: scratchbench [n]
+   For several functions and precisions p, evaluate the function on n
+   random numbers (n = 1000 by default) of precision p, with the temporary
+   memory allocated in the scratch arena, then with mpfr_scratch_set_max (0),
+   i.e., with the memory functions as without --enable-scratch-arena, and
+   output the best average time per call over 3 runs in microseconds and the
+   speedup. If MPFR was built without --enable-scratch-arena, both columns
+   use the memory functions. */
+
+static struct {
+  const char *name;
+  int (*f) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+} funs[] = {
+  { "exp", mpfr_exp }, { "log", mpfr_log }, { "sin", mpfr_sin },
+  { "atan", mpfr_atan }, { "tanh", mpfr_tanh }, { "erf", mpfr_erf }
+};
+
+static double
+run (int k, mpfr_t *x, mpfr_ptr y, unsigned long n)
+{
+  unsigned long i;
+  double t;
+
+  funs[k].f (y, x[0], MPFR_RNDN);  /* warm up the caches and the arena */
+  t = get_walltime ();
+  for (i = 0; i < n; i++)
+    funs[k].f (y, x[i], MPFR_RNDN);
+  return (get_walltime () - t) / n;
+}
+
+int
+main (int argc, char *argv[])
+{
+  mpfr_prec_t precs[] = { 128, 256, 512, 1024, 2048, 4096 };
+  unsigned long n = 1000, i;
+  mpfr_t *x, y;
+  gmp_randstate_t state;
+  size_t max;
+  double t, t0 = 0.0, t1 = 0.0;
+  int j, k, r;
+
+  if (argc > 1)
+    n = strtoul (argv[1], NULL, 10);
+  if (argc > 2 || n == 0)
+    {
+      printf ("Usage: scratchbench [n]\n");
+      exit (1);
+    }
+
+  x = (mpfr_t *) malloc (n * sizeof (mpfr_t));
+  if (x == NULL)
+    {
+      printf ("Cannot allocate memory\n");
+      exit (1);
+    }
+  for (i = 0; i < n; i++)
+    mpfr_init (x[i]);
+  mpfr_init (y);
+  gmp_randinit_default (state);
+  max = mpfr_scratch_get_max ();
+
+  printf ("scratch arena: %s\n", mpfr_buildopt_scratch_p () ? "yes" : "no");
+  printf ("%5s %6s %12s %12s %8s\n", "func", "prec", "arena (us)",
+          "malloc (us)", "speedup");
+  for (k = 0; k < (int) (sizeof (funs) / sizeof (funs[0])); k++)
+    for (j = 0; j < (int) (sizeof (precs) / sizeof (precs[0])); j++)
+      {
+        for (i = 0; i < n; i++)
+          {
+            mpfr_set_prec (x[i], precs[j]);
+            mpfr_urandomb (x[i], state);
+          }
+        mpfr_set_prec (y, precs[j]);
+
+        /* alternate the runs and keep the best times, to reduce the
+           effect of the noise */
+        for (r = 0; r < 3; r++)
+          {
+            t = run (k, x, y, n);
+            if (r == 0 || t < t0)
+              t0 = t;
+            mpfr_scratch_set_max (0);
+            t = run (k, x, y, n);
+            if (r == 0 || t < t1)
+              t1 = t;
+            mpfr_scratch_set_max (max);
+          }
+
+        printf ("%5s %6lu %12.3f %12.3f %8.2f\n", funs[k].name,
+                (unsigned long) precs[j], t0, t1, t1 / t0);
+      }
+
+  gmp_randclear (state);
+  mpfr_clear (y);
+  for (i = 0; i < n; i++)
+    mpfr_clear (x[i]);
+  free (x);
+  mpfr_free_cache ();
+  return 0;
+}
@@ -0,0 +1,103 @@
+/* sinbench.c -- time mpfr_sin on arguments of huge exponent
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: sinbench [emax [prec]]
+   For exp = 10^5, 10^6, ..., emax (10^7 by default), compute sin(x) at
+   precision prec (53 by default) for random x of precision prec in
+   [2^(exp-1), 2^exp), and output in milliseconds:
+   - the time of the first call, which extends the cache of 2/Pi used by
+     the argument reduction to about exp bits;
+   - the average time of the next calls, which reuse this cache;
+   - the average time of a call after mpfr_free_cache, i.e., when 2/Pi
+     is computed for each call. */
+
+#define ITER 10
+
+int
+main (int argc, char *argv[])
+{
+  mpfr_exp_t exp, emax = 10000000;
+  mpfr_prec_t prec = 53;
+  mpfr_t x, y;
+  gmp_randstate_t state;
+  double t, t1, t2, t3;
+  int i;
+
+  if (argc > 1)
+    emax = atol (argv[1]);
+  if (argc > 2)
+    prec = atol (argv[2]);
+  if (argc > 3 || prec < MPFR_PREC_MIN)
+    {
+      printf ("Usage: sinbench [emax [prec]]\n");
+      exit (1);
+    }
+
+  mpfr_set_emax (mpfr_get_emax_max ());
+  gmp_randinit_default (state);
+  mpfr_inits2 (prec, x, y, (mpfr_ptr) 0);
+  printf ("%10s %12s %12s %14s\n", "exp", "first (ms)", "next (ms)",
+          "uncached (ms)");
+  for (exp = 100000; exp <= emax; exp *= 10)
+    {
+      mpfr_free_cache ();
+      mpfr_urandomb (x, state);
+      mpfr_set_exp (x, exp);
+      t = get_walltime ();
+      mpfr_sin (y, x, MPFR_RNDN);
+      t1 = (get_walltime () - t) / 1000.0;
+
+      t2 = 0.0;
+      for (i = 0; i < ITER; i++)
+        {
+          mpfr_urandomb (x, state);
+          mpfr_set_exp (x, exp);
+          t = get_walltime ();
+          mpfr_sin (y, x, MPFR_RNDN);
+          t2 += get_walltime () - t;
+        }
+      t2 /= ITER * 1000.0;
+
+      t3 = 0.0;
+      for (i = 0; i < ITER; i++)
+        {
+          mpfr_free_cache ();
+          mpfr_urandomb (x, state);
+          mpfr_set_exp (x, exp);
+          t = get_walltime ();
+          mpfr_sin (y, x, MPFR_RNDN);
+          t3 += get_walltime () - t;
+        }
+      t3 /= ITER * 1000.0;
+
+      printf ("%10ld %12.3f %12.3f %14.3f\n", (long) exp, t1, t2, t3);
+    }
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+  gmp_randclear (state);
+  mpfr_free_cache ();
+  return 0;
+}
@@ -0,0 +1,113 @@
+/* sumbench.c -- scaling of mpfr_sum_mt with the number of threads
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: sumbench [nthreads [n [prec]]]
+   Sum n random numbers of prec bits (by default 10^6 numbers of 53 bits),
+   whose exponents are between -100 and 100, with mpfr_sum and with
+   mpfr_sum_mt for 1, 2, ..., nthreads threads (4 by default), and output
+   the elapsed (wall-clock) time in milliseconds and the speedup compared
+   to mpfr_sum. Note: MPFR must have been configured with --enable-parallel,
+   otherwise mpfr_sum_mt runs in a single thread. */
+
+int
+main (int argc, char *argv[])
+{
+  gmp_randstate_t state;
+  unsigned int nthreads = 4, k;
+  unsigned long n = 1000000, i;
+  mpfr_prec_t prec = 53;
+  mpfr_ptr *x;
+  mpfr_t r0, r;
+  double t0, t;
+
+  if (argc > 1)
+    nthreads = atoi (argv[1]);
+  if (argc > 2)
+    n = strtoul (argv[2], NULL, 10);
+  if (argc > 3)
+    prec = atol (argv[3]);
+  if (argc > 4 || nthreads < 1 || prec < MPFR_PREC_MIN)
+    {
+      printf ("Usage: sumbench [nthreads [n [prec]]]\n");
+      exit (1);
+    }
+
+  gmp_randinit_default (state);
+  x = (mpfr_ptr *) malloc (n * sizeof (mpfr_ptr));
+  if (x == NULL)
+    {
+      printf ("Can't allocate memory for %lu numbers\n", n);
+      exit (1);
+    }
+  for (i = 0; i < n; i++)
+    {
+      x[i] = (mpfr_ptr) malloc (sizeof (mpfr_t));
+      if (x[i] == NULL)
+        {
+          printf ("Can't allocate memory for %lu numbers\n", n);
+          exit (1);
+        }
+      mpfr_init2 (x[i], prec);
+      mpfr_urandomb (x[i], state);
+      if (gmp_urandomb_ui (state, 1))
+        mpfr_neg (x[i], x[i], MPFR_RNDN);
+      mpfr_mul_2si (x[i], x[i], (long) gmp_urandomm_ui (state, 201) - 100,
+                    MPFR_RNDN);
+    }
+  mpfr_inits2 (prec, r0, r, (mpfr_ptr) 0);
+
+  t0 = get_walltime ();
+  mpfr_sum (r0, x, n, MPFR_RNDN);
+  t0 = get_walltime () - t0;
+  printf ("n = %lu, precision %lu\n", n, (unsigned long) prec);
+  printf ("%8s %12s %8s\n", "threads", "time (ms)", "speedup");
+  printf ("%8s %12.2f %8.2f\n", "mpfr_sum", t0 / 1000.0, 1.0);
+
+  for (k = 1; k <= nthreads; k++)
+    {
+      t = get_walltime ();
+      mpfr_sum_mt (r, x, n, MPFR_RNDN, k);
+      t = get_walltime () - t;
+      if (! mpfr_equal_p (r0, r))
+        {
+          printf ("Error, different results with %u threads\n", k);
+          exit (1);
+        }
+      printf ("%8u %12.2f %8.2f\n", k, t / 1000.0, t0 / t);
+    }
+
+  mpfr_clears (r0, r, (mpfr_ptr) 0);
+  for (i = 0; i < n; i++)
+    {
+      mpfr_clear (x[i]);
+      free (x[i]);
+    }
+  free (x);
+  gmp_randclear (state);
+  return 0;
+}
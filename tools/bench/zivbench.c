@@ -0,0 +1,139 @@
+/* zivbench.c -- timings of mpfr_sin and mpfr_log on random and on
+   hard-to-round inputs, to compare builds with and without
+   --enable-ziv-adaptive
+
+Copyright 2015 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "mpfr.h"
+#include "benchtime.h"
+
+/* Usage: zivbench [n [d]]
+   For each function and precision p, evaluate the function at precision p
+   on n random inputs of precision p (n = 10000 by default), then on n
+   hard-to-round inputs of precision p+d (d = 32 by default), whose exact
+   image is within about 2^(-d) ulp of the middle of two numbers of
+   precision p: such an input is f^(-1)(y0) rounded to p+d bits, y0 being
+   a random midpoint. Output the average time per call in microseconds.
+   For mpfr_log, only precisions above the threshold of the table-driven
+   algorithm (256 bits) are used, since the Ziv loop of mpfr_log is not
+   used below. */
+
+typedef int (*fun_t) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+
+static double
+timing (fun_t f, mpfr_t *x, mpfr_ptr y, unsigned long n)
+{
+  unsigned long i;
+  double t;
+
+  t = get_walltime ();
+  for (i = 0; i < n; i++)
+    f (y, x[i], MPFR_RNDN);
+  return (get_walltime () - t) / n;
+}
+
+int
+main (int argc, char *argv[])
+{
+  const char *names[] = { "sin", "log" };
+  fun_t funs[] = { mpfr_sin, mpfr_log };
+  fun_t invs[] = { mpfr_asin, mpfr_exp };
+  mpfr_prec_t precs[2][4] = { { 53, 113, 256, 1000 },
+                              { 300, 500, 1000, 2000 } };
+  unsigned long n = 10000, i;
+  mpfr_prec_t p, d = 32;
+  mpfr_t *x, y, y0;
+  gmp_randstate_t state;
+  double t0, t1;
+  int f, k;
+
+  if (argc > 1)
+    n = strtoul (argv[1], NULL, 10);
+  if (argc > 2)
+    d = (mpfr_prec_t) strtoul (argv[2], NULL, 10);
+  if (argc > 3 || n == 0)
+    {
+      printf ("Usage: zivbench [n [d]]\n");
+      exit (1);
+    }
+
+  x = (mpfr_t *) malloc (n * sizeof (mpfr_t));
+  if (x == NULL)
+    {
+      printf ("Cannot allocate memory\n");
+      exit (1);
+    }
+  for (i = 0; i < n; i++)
+    mpfr_init (x[i]);
+  mpfr_inits2 (MPFR_PREC_MIN, y, y0, (mpfr_ptr) 0);
+  gmp_randinit_default (state);
+
+  printf ("%4s %6s %12s %12s\n", "fun", "prec", "random (us)", "hard (us)");
+  for (f = 0; f < 2; f++)
+    for (k = 0; k < 4; k++)
+      {
+        p = precs[f][k];
+        mpfr_set_prec (y, p);
+        mpfr_set_prec (y0, p + 1);
+
+        /* random inputs in [0,1) for sin, in (0,8] for log */
+        for (i = 0; i < n; i++)
+          {
+            mpfr_set_prec (x[i], p);
+            mpfr_urandomb (x[i], state);
+            if (f == 1)
+              {
+                mpfr_mul_2ui (x[i], x[i], 3, MPFR_RNDN);
+                mpfr_nextabove (x[i]);
+              }
+          }
+        funs[f] (y, x[0], MPFR_RNDN);  /* fill the caches of constants */
+        t0 = timing (funs[f], x, y, n);
+
+        /* hard-to-round inputs: y0 is the middle of two numbers of
+           precision p, in [1/2,1) for sin, in [1/2,2) for log */
+        for (i = 0; i < n; i++)
+          {
+            do
+              mpfr_urandomb (y0, state);
+            while (mpfr_cmp_ui_2exp (y0, 1, -1) < 0);
+            mpfr_set_prec (x[i], p + d);
+            if (mpfr_min_prec (y0) <= p)
+              mpfr_nextabove (y0);
+            if (f == 1 && i % 2)
+              mpfr_mul_2ui (y0, y0, 1, MPFR_RNDN);
+            invs[f] (x[i], y0, MPFR_RNDN);
+          }
+        t1 = timing (funs[f], x, y, n);
+
+        printf ("%4s %6lu %12.3f %12.3f\n", names[f], (unsigned long) p,
+                t0, t1);
+      }
+
+  gmp_randclear (state);
+  mpfr_clears (y, y0, (mpfr_ptr) 0);
+  for (i = 0; i < n; i++)
+    mpfr_clear (x[i]);
+  free (x);
+  return 0;
+}
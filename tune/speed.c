@@ -126,6 +126,30 @@ static double speed_mpfr_mul (struct speed_params *s) {
   SPEED_MPFR_OP (mpfr_mul);
 }
 
+/* Setup mpfr_add and mpfr_sub (same precision: mpfr_add1sp, mpfr_sub1sp) */
+static double speed_mpfr_add (struct speed_params *s) {
+  SPEED_MPFR_OP (mpfr_add);
+}
+static double speed_mpfr_sub (struct speed_params *s) {
+  SPEED_MPFR_OP (mpfr_sub);
+}
+
+/* Setup mpfr_sqr and mpfr_div */
+static double speed_mpfr_sqr (struct speed_params *s) {
+  SPEED_MPFR_FUNC (mpfr_sqr);
+}
+static double speed_mpfr_div (struct speed_params *s) {
+  SPEED_MPFR_OP (mpfr_div);
+}
+
+/* Setup mpfr_sqrt and mpfr_rec_sqrt */
+static double speed_mpfr_sqrt (struct speed_params *s) {
+  SPEED_MPFR_FUNC (mpfr_sqrt);
+}
+static double speed_mpfr_rec_sqrt (struct speed_params *s) {
+  SPEED_MPFR_FUNC (mpfr_rec_sqrt);
+}
+
 
 
 /************************************************
@@ -201,10 +225,119 @@ tune_simple_func (mpfr_prec_t *threshold,
     }
 }
 
+/* Measure mpfr_add and mpfr_sub for all precisions from pstart to pend,
+   to compare the special code for one and two limbs of mpfr_add1sp and
+   mpfr_sub1sp with the generic code. */
+static void
+measure_addsub (mpfr_prec_t pstart, mpfr_prec_t pend)
+{
+  mpfr_prec_t p;
+  double tadd, tsub;
+
+  for (p = pstart; p <= pend; p++)
+    {
+      tadd = domeasure (NULL, speed_mpfr_add, p);
+      tsub = domeasure (NULL, speed_mpfr_sub, p);
+      printf ("prec=%lu mpfr_add=%e mpfr_sub=%e ", p, tadd, tsub);
+      if (p < GMP_NUMB_BITS)
+        printf ("[1 limb]\n");
+      else if (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS)
+        printf ("[2 limbs]\n");
+      else
+        printf ("[generic]\n");
+    }
+}
+
 /*******************************************************
  *            Tune all the threshold of MPFR           *
  * Warning: tune the function in their dependent order!*
  *******************************************************/
+static void
+measure_muldiv (mpfr_prec_t pstart, mpfr_prec_t pend)
+{
+  mpfr_prec_t p;
+  double tmul, tsqr, tdiv;
+
+  for (p = pstart; p <= pend; p++)
+    {
+      tmul = domeasure (NULL, speed_mpfr_mul, p);
+      tsqr = domeasure (NULL, speed_mpfr_sqr, p);
+      tdiv = domeasure (NULL, speed_mpfr_div, p);
+      printf ("prec=%lu mpfr_mul=%e mpfr_sqr=%e mpfr_div=%e ",
+              p, tmul, tsqr, tdiv);
+      if (p < GMP_NUMB_BITS)
+        printf ("[1 limb]\n");
+      else if (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS)
+        printf ("[2 limbs]\n");
+      else
+        printf ("[generic]\n");
+    }
+}
+
+static void
+measure_sqrt (mpfr_prec_t pstart, mpfr_prec_t pend)
+{
+  mpfr_prec_t p;
+  double tsqrt, trec_sqrt;
+
+  for (p = pstart; p <= pend; p++)
+    {
+      tsqrt = domeasure (NULL, speed_mpfr_sqrt, p);
+      trec_sqrt = domeasure (NULL, speed_mpfr_rec_sqrt, p);
+      printf ("prec=%lu mpfr_sqrt=%e mpfr_rec_sqrt=%e ",
+              p, tsqrt, trec_sqrt);
+      if (p < GMP_NUMB_BITS)
+        printf ("[1 limb]\n");
+      else if (GMP_NUMB_BITS < p && p < 2 * GMP_NUMB_BITS)
+        printf ("[2 limbs]\n");
+      else
+        printf ("[generic]\n");
+    }
+}
+
+/* Number of threads for the speedup curves of the threaded mode */
+#ifndef MPFR_SPEED_NTHREADS
+# define MPFR_SPEED_NTHREADS 8
+#endif
+
+/* Speedup curves of the threaded mode of mpfr_sincos_fast (see
+   mpfr_set_nthreads): for prec = pstart, 10*pstart, ..., pend, measure
+   a single call with 1, 2, 4, ..., nthreads threads, which takes long
+   enough in these precisions. The time is the elapsed time when the
+   cycle counter is used. */
+static void
+measure_sincos_mt (mpfr_prec_t pstart, mpfr_prec_t pend,
+                   unsigned int nthreads)
+{
+  gmp_randstate_t state;
+  mpfr_prec_t p;
+
+  gmp_randinit_default (state);
+  for (p = pstart; p <= pend; p *= 10)
+    {
+      mpfr_t x, s, c;
+      double t, t1 = 0.0;
+      unsigned int k;
+
+      mpfr_inits2 (p, x, s, c, (mpfr_ptr) 0);
+      mpfr_urandomb (x, state);
+      for (k = 1; k <= nthreads; k *= 2)
+        {
+          mpfr_set_nthreads (k);
+          speed_starttime ();
+          mpfr_sincos_fast (s, c, x, MPFR_RNDN);
+          t = speed_endtime ();
+          mpfr_set_nthreads (1);
+          if (k == 1)
+            t1 = t;
+          printf ("prec=%lu threads=%u mpfr_sincos_fast=%e speedup=%.2f\n",
+                  (unsigned long) p, k, t, t1 / t);
+        }
+      mpfr_clears (x, s, c, (mpfr_ptr) 0);
+    }
+  gmp_randclear (state);
+}
+
 static void
 all (void)
 {
@@ -256,6 +389,27 @@ all (void)
   tune_simple_func (&mpfr_mul_threshold, speed_mpfr_mul,
                     2*GMP_NUMB_BITS+1, 1000);
 
+  /* Measure mpfr_add and mpfr_sub in small precision */
+  if (verbose)
+    printf ("Measuring mpfr_add and mpfr_sub...\n");
+  measure_addsub (MPFR_PREC_MIN, 3 * GMP_NUMB_BITS);
+
+  /* Measure mpfr_mul, mpfr_sqr and mpfr_div in small precision */
+  if (verbose)
+    printf ("Measuring mpfr_mul, mpfr_sqr and mpfr_div...\n");
+  measure_muldiv (MPFR_PREC_MIN, 3 * GMP_NUMB_BITS);
+
+  /* Measure mpfr_sqrt and mpfr_rec_sqrt in small precision */
+  if (verbose)
+    printf ("Measuring mpfr_sqrt and mpfr_rec_sqrt...\n");
+  measure_sqrt (MPFR_PREC_MIN, 3 * GMP_NUMB_BITS);
+
+  /* Measure the threaded mode of mpfr_sincos_fast in large precision */
+  if (verbose)
+    printf ("Measuring mpfr_sincos_fast with up to %u threads...\n",
+            (unsigned int) MPFR_SPEED_NTHREADS);
+  measure_sincos_mt (100000, 10000000, MPFR_SPEED_NTHREADS);
+
   /* End of tuning */
   time (&end_time);
   if (verbose)